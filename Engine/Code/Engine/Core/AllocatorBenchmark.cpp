@@ -0,0 +1,75 @@
+#include "Engine/Core/AllocatorBenchmark.hpp"
+#include "Engine/Core/PageAllocator.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include <vector>
+
+//roughly the size of a profiler measurement
+struct bench_object_t
+{
+	char m_data[96];
+	bench_object_t* m_next = nullptr;
+};
+
+constexpr int BENCH_PASSES = 20;
+
+// Same pattern for every allocator: fill, free every other object, refill the
+// holes, then free everything. Returns seconds per allocation.
+template <typename ALLOC_FUNC, typename FREE_FUNC>
+static double RunAllocationPattern(uint objectCount, ALLOC_FUNC allocFunc, FREE_FUNC freeFunc)
+{
+	std::vector<bench_object_t*> objects(objectCount, nullptr);
+	uint64_t allocCount = 0;
+
+	uint64_t start = GetPerformanceCounter();
+	for (int pass = 0; pass < BENCH_PASSES; pass++)
+	{
+		for (uint i = 0; i < objectCount; i++)
+			objects[i] = allocFunc();
+
+		for (uint i = 0; i < objectCount; i += 2)
+			freeFunc(objects[i]);
+
+		for (uint i = 0; i < objectCount; i += 2)
+			objects[i] = allocFunc();
+
+		for (uint i = 0; i < objectCount; i++)
+			freeFunc(objects[i]);
+
+		allocCount += objectCount + (objectCount + 1) / 2;
+	}
+	uint64_t elapsed = GetPerformanceCounter() - start;
+
+	return PerformanceCounterToSeconds(elapsed) / (double) allocCount;
+}
+
+void RegisterAllocatorBenchmarkCommands()
+{
+	CommandRegister("bench_page_allocator", BenchmarkPageAllocator, "Compares TPageAllocator against malloc and new. Option: object count");
+}
+
+void BenchmarkPageAllocator(Command& cmd)
+{
+	int objectCount = 10000;
+	cmd.GetNextInt(&objectCount);
+	objectCount = MaxInt(objectCount, 1);
+
+	double mallocTime = RunAllocationPattern((uint) objectCount, 
+		[]() { return (bench_object_t*) malloc(sizeof(bench_object_t)); },
+		[](bench_object_t* obj) { free(obj); });
+
+	double newTime = RunAllocationPattern((uint) objectCount, 
+		[]() { return new bench_object_t(); },
+		[](bench_object_t* obj) { delete obj; });
+
+	TPageAllocator<bench_object_t, 256> pool;
+	double poolTime = RunAllocationPattern((uint) objectCount, 
+		[&pool]() { return pool.Create(); },
+		[&pool](bench_object_t* obj) { pool.Destroy(obj); });
+
+	ConsolePrintf("bench_page_allocator: %d objects of %u bytes, %d passes", objectCount, (uint) sizeof(bench_object_t), BENCH_PASSES);
+	ConsolePrintf("  malloc/free     %8.2f ns per alloc", mallocTime * 1000000000.0);
+	ConsolePrintf("  new/delete      %8.2f ns per alloc", newTime * 1000000000.0);
+	ConsolePrintf("  TPageAllocator  %8.2f ns per alloc (%u pages, %.2fx malloc)", poolTime * 1000000000.0, pool.GetPageCount(), mallocTime / poolTime);
+}
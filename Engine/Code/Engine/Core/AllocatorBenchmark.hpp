@@ -0,0 +1,8 @@
+#pragma once
+
+#include "Engine/Core/Command.hpp"
+
+// Dev console microbenchmarks comparing the engine allocators against malloc/new.
+void RegisterAllocatorBenchmarkCommands();
+
+void BenchmarkPageAllocator(Command& cmd);
@@ -0,0 +1,81 @@
+#include "Engine/Core/ArenaAllocator.hpp"
+#include <stdint.h>
+#include <stdlib.h>
+
+static size_t AlignUp(size_t value, size_t alignment)
+{
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+ArenaAllocator::~ArenaAllocator()
+{
+	Release();
+}
+
+ArenaAllocator::ArenaAllocator(size_t blockSize)
+	: m_blockSize(blockSize)
+{
+}
+
+void* ArenaAllocator::Alloc(size_t size, size_t alignment)
+{
+	ASSERT_OR_DIE((alignment & (alignment - 1)) == 0, "ArenaAllocator: alignment must be a power of two");
+	size_t headerSize = AlignUp(sizeof(block_t), alignof(max_align_t));
+
+	//try the current block first; aligns the address, malloc only promises max_align_t for the block
+	if (m_blocks != nullptr)
+	{
+		unsigned char* base = (unsigned char*) m_blocks;
+		size_t start = AlignUp((uintptr_t) (base + m_blocks->m_offset), alignment) - (uintptr_t) base;
+		if (start + size <= m_blocks->m_size)
+		{
+			m_blocks->m_offset = start + size;
+			m_bytesUsed += size;
+			ASSERT_OR_DIE(((uintptr_t) (base + start) & (alignment - 1)) == 0, "ArenaAllocator: misaligned allocation");
+			return base + start;
+		}
+	}
+
+	//new block, oversized requests get a block of their own
+	size_t blockSize = headerSize + size + alignment;
+	if (blockSize < m_blockSize)
+		blockSize = m_blockSize;
+
+	block_t* block = (block_t*) malloc(blockSize);
+	ASSERT_OR_DIE(block != nullptr, "ArenaAllocator: out of memory");
+	block->next = m_blocks;
+	block->m_size = blockSize;
+	block->m_offset = headerSize;
+	m_blocks = block;
+	m_blockCount++;
+
+	unsigned char* base = (unsigned char*) block;
+	size_t start = AlignUp((uintptr_t) (base + block->m_offset), alignment) - (uintptr_t) base;
+	block->m_offset = start + size;
+	m_bytesUsed += size;
+	ASSERT_OR_DIE(((uintptr_t) (base + start) & (alignment - 1)) == 0, "ArenaAllocator: misaligned allocation");
+	return base + start;
+}
+
+void ArenaAllocator::Release()
+{
+	//newest first, so objects die in the reverse order they were made
+	while (m_finalizers != nullptr)
+	{
+		finalizer_t* next = m_finalizers->next;
+		if (m_finalizers->m_destructor != nullptr)
+			m_finalizers->m_destructor(m_finalizers->m_object);
+
+		m_finalizers = next;
+	}
+
+	while (m_blocks != nullptr)
+	{
+		block_t* next = m_blocks->next;
+		free(m_blocks);
+		m_blocks = next;
+	}
+
+	m_bytesUsed = 0;
+	m_blockCount = 0;
+}
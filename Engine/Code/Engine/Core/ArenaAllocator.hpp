@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Engine/Core/EngineCommon.hpp"
+#include <stddef.h>
+#include <new>
+#include <utility>
+
+// Growing bump allocator for data that shares one lifetime (a level, a loading step).
+// Memory comes from chained blocks and is only given back by Release().
+// Objects made with Create<T>() have their destructors run by Release() in reverse
+// creation order, or earlier through Destroy() if they die before the arena does.
+class ArenaAllocator
+{
+public:
+	~ArenaAllocator();
+	explicit ArenaAllocator(size_t blockSize = 64 * 1024);
+
+	void* Alloc(size_t size, size_t alignment = alignof(max_align_t));
+	void Release();
+
+	template <typename T, typename ...ARGS>
+	T* Create(ARGS&& ...args)
+	{
+		finalizer_t* finalizer = (finalizer_t*) Alloc(GetFinalizerSize<T>() + sizeof(T), alignof(T) > alignof(finalizer_t) ? alignof(T) : alignof(finalizer_t));
+		T* obj = new ((unsigned char*) finalizer + GetFinalizerSize<T>()) T(std::forward<ARGS>(args)...);
+
+		finalizer->m_destructor = [](void* ptr) { ((T*) ptr)->~T(); };
+		finalizer->m_object = obj;
+		finalizer->next = m_finalizers;
+		m_finalizers = finalizer;
+		return obj;
+	}
+
+	// Runs the destructor now; the memory stays reserved until Release()
+	template <typename T>
+	void Destroy(T* obj)
+	{
+		if (obj == nullptr)
+			return;
+
+		finalizer_t* finalizer = (finalizer_t*) ((unsigned char*) obj - GetFinalizerSize<T>());
+		ASSERT_OR_DIE(finalizer->m_object == obj, "ArenaAllocator: destroying an object that wasn't created by this arena");
+		ASSERT_OR_DIE(finalizer->m_destructor != nullptr, "ArenaAllocator: double destroy");
+
+		finalizer->m_destructor(obj);
+		finalizer->m_destructor = nullptr;
+	}
+
+	inline size_t GetBytesUsed() const { return m_bytesUsed; }
+	inline uint GetBlockCount() const { return m_blockCount; }
+
+private:
+	struct block_t
+	{
+		block_t* next;
+		size_t m_size;
+		size_t m_offset;
+	};
+
+	struct finalizer_t
+	{
+		void (*m_destructor)(void*);
+		void* m_object;
+		finalizer_t* next;
+	};
+
+	template <typename T>
+	static constexpr size_t GetFinalizerSize()
+	{
+		//keeps the object right after its finalizer while respecting its alignment
+		return (sizeof(finalizer_t) + alignof(T) - 1) & ~(alignof(T) - 1);
+	}
+
+	block_t* m_blocks = nullptr;
+	finalizer_t* m_finalizers = nullptr;
+	size_t m_blockSize = 0;
+	size_t m_bytesUsed = 0;
+	uint m_blockCount = 0;
+};
+
+//------------------------------------------------------------------------
+// STL adapter so containers can allocate out of an arena:
+//    std::vector<Vector3, TArenaAllocatorAdapter<Vector3>> points(TArenaAllocatorAdapter<Vector3>(&arena));
+// The container must be gone (or cleared and shrunk) before the arena is released.
+template <typename T>
+class TArenaAllocatorAdapter
+{
+public:
+	typedef T value_type;
+
+	TArenaAllocatorAdapter(ArenaAllocator* arena) : m_arena(arena) {}
+	template <typename U> TArenaAllocatorAdapter(const TArenaAllocatorAdapter<U>& other) : m_arena(other.m_arena) {}
+
+	T* allocate(size_t count)
+	{
+		return (T*) m_arena->Alloc(count * sizeof(T), alignof(T));
+	}
+
+	void deallocate(T*, size_t) {}
+
+	template <typename U> bool operator==(const TArenaAllocatorAdapter<U>& other) const { return m_arena == other.m_arena; }
+	template <typename U> bool operator!=(const TArenaAllocatorAdapter<U>& other) const { return m_arena != other.m_arena; }
+
+public:
+	ArenaAllocator* m_arena = nullptr;
+};
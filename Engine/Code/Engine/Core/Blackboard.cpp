@@ -1,6 +1,7 @@
 #include "Engine/Core/Blackboard.hpp"
 #include "Engine/Core/XmlUtilities.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
 
 void Blackboard::PopulateFromXmlElementAttributes(const tinyxml2::XMLElement & element)
 {
@@ -12,6 +13,22 @@ void Blackboard::PopulateFromXmlElementAttributes(const tinyxml2::XMLElement & e
 	}	
 }
 
+void Blackboard::PopulateFromCommandLine(const std::string& commandLine)
+{
+	Strings arguments = Split(commandLine, ' ');
+	for (const std::string& argument : arguments)
+	{
+		if (argument.empty())
+			continue;
+
+		size_t equals = argument.find('=');
+		if (equals == std::string::npos)
+			SetValue(argument, "true");
+		else
+			SetValue(argument.substr(0, equals), argument.substr(equals + 1));
+	}
+}
+
 void Blackboard::SetValue(const std::string & keyName, const std::string & newValue)
 {
 	m_keyValuePairs[keyName] = newValue;
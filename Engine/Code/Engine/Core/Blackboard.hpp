@@ -15,6 +15,7 @@ public:
 	Blackboard() {};
 
 	void PopulateFromXmlElementAttributes( const tinyxml2::XMLElement& element );
+	void PopulateFromCommandLine( const std::string& commandLine ); // "key=value" overrides, a bare "key" sets "true"
 	void SetValue( const std::string& keyName, const std::string& newValue );
 
 	bool GetValue( const std::string& keyName, bool defaultValue ) const;
@@ -25,12 +25,20 @@ void Clock::BeginFrame()
 	m_lastFrameHPC = currentHPC;
 }
 
+void Clock::BeginFrame(uint64_t elapsed)
+{
+	Advance(elapsed);
+	m_lastFrameHPC = GetPerformanceCounter();
+}
+
 void Clock::Reset()
 {
 	m_lastFrameHPC = GetPerformanceCounter();
 	memset(&m_frame, 0, sizeof(m_frame)); //lazy way to set everything to 0
 	memset(&m_total, 0, sizeof(m_total));
 	m_frameCount = 0;
+	m_bankedHPC = 0;
+	m_fixedStepCount = 0;
 }
 
 void Clock::Advance(uint64_t elapsed)
@@ -46,6 +54,20 @@ void Clock::Advance(uint64_t elapsed)
 		elapsed = (uint64_t) ((double) elapsed * m_scale);
 	}
 
+	if (m_fixedStepHPC != 0)
+	{
+		//StepFixed hands this out
+		uint64_t maxBankedHPC = m_fixedStepHPC * m_maxFixedStepsPerFrame;
+		m_bankedHPC += elapsed;
+		m_bankedHPC = m_bankedHPC < maxBankedHPC ? m_bankedHPC : maxBankedHPC;
+		return;
+	}
+
+	ApplyElapsed(elapsed);
+}
+
+void Clock::ApplyElapsed(uint64_t elapsed)
+{
 	double elapsedSeconds = PerformanceCounterToSeconds(elapsed);
 	m_frame.seconds = elapsedSeconds;
 	m_frame.hpc = elapsed;
@@ -83,6 +105,33 @@ void Clock::SetScale(float scale)
 	m_scale = scale;
 }
 
+void Clock::SetFixedStepRate(float stepsPerSecond, unsigned int maxStepsPerFrame)
+{
+	m_fixedStepHPC = stepsPerSecond > 0.f ? ConvertSecondsToPerformanceCounter(1.f / stepsPerSecond) : 0;
+	m_fixedStepRate = stepsPerSecond > 0.f ? stepsPerSecond : 0.f;
+	m_maxFixedStepsPerFrame = maxStepsPerFrame > 0 ? maxStepsPerFrame : 1;
+	m_bankedHPC = 0;
+}
+
+bool Clock::StepFixed()
+{
+	if (m_fixedStepHPC == 0 || m_bankedHPC < m_fixedStepHPC)
+		return false;
+
+	m_bankedHPC -= m_fixedStepHPC;
+	m_fixedStepCount++;
+	ApplyElapsed(m_fixedStepHPC);
+	return true;
+}
+
+float Clock::GetFixedStepAlpha() const
+{
+	if (m_fixedStepHPC == 0)
+		return 1.f;
+
+	return (float) ((double) m_bankedHPC / (double) m_fixedStepHPC);
+}
+
 Clock* GetMasterClock()
 {
 	return g_masterClock;
@@ -103,6 +152,11 @@ void ClockSystemBeginFrame()
 	g_masterClock->BeginFrame();
 }
 
+void ClockSystemBeginFrame(uint64_t elapsed)
+{
+	g_masterClock->BeginFrame(elapsed);
+}
+
 double GetSystemCurrentTime()
 {
 	return g_masterClock->m_total.seconds;
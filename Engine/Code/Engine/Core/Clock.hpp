@@ -25,6 +25,7 @@ public:
 	Clock(const Clock& c) = delete; //enforce NO copy constructor
 
 	void BeginFrame();
+	void BeginFrame(uint64_t elapsed); // a given frame time instead of the wall clock, for replays
 	void Reset();
 	void Advance(uint64_t elapsed);
 
@@ -38,10 +39,25 @@ public:
 	void SetPaused(bool paused); 
 	void SetScale(float scale);
 
+	// Fixed step: frame time (scaled, paused) is banked instead of advancing the clock,
+	// and each StepFixed() advances it and its children by exactly one step. Banked time
+	// past maxStepsPerFrame steps is dropped, so a slow frame slows the game down instead
+	// of making the next frame slower still. 0 steps per second goes back to per frame.
+	void SetFixedStepRate(float stepsPerSecond, unsigned int maxStepsPerFrame = 8);
+	bool StepFixed(); // false once less than a step is banked
+	float GetFixedStepAlpha() const; // banked time in steps [0,1), for render interpolation
+	inline bool IsFixedStep() const { return m_fixedStepHPC != 0; }
+	inline double GetFixedStepSeconds() const { return PerformanceCounterToSeconds(m_fixedStepHPC); }
+	inline float GetFixedStepRate() const { return m_fixedStepRate; }
+	inline unsigned int GetFixedStepCount() const { return m_fixedStepCount; } // since Reset
+
 public:
 	time_unit_t m_frame;
 	time_unit_t m_total;
 
+private:
+	void ApplyElapsed(uint64_t elapsed);
+
 private:
 	double m_scale;
 	bool m_paused;
@@ -49,6 +65,12 @@ private:
 	uint64_t m_lastFrameHPC;
 	unsigned int m_frameCount;
 
+	uint64_t m_fixedStepHPC = 0;
+	float m_fixedStepRate = 0.f;
+	unsigned int m_fixedStepCount = 0;
+	uint64_t m_bankedHPC = 0;
+	unsigned int m_maxFixedStepsPerFrame = 8;
+
 	Clock* m_parent;
 	std::vector<Clock*> m_children;
 };
@@ -63,6 +85,7 @@ void ClockSystemStartup();
 
 // convenience - calls begin frame on the master clock
 void ClockSystemBeginFrame();
+void ClockSystemBeginFrame(uint64_t elapsed);
 
 // I now move this here - as this now refers to the master clock
 // who is keeping track of the starting reference point. 
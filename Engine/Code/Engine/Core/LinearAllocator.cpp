@@ -0,0 +1,106 @@
+#include "Engine/Core/LinearAllocator.hpp"
+#include "Engine/Profiler/Profiler.hpp"
+#include <stdint.h>
+#include <stdlib.h>
+
+static LinearAllocator* g_frameAllocators[2] = { nullptr, nullptr };
+static int g_currentFrameAllocator = 0;
+
+static size_t AlignUp(size_t value, size_t alignment)
+{
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+LinearAllocator::~LinearAllocator()
+{
+	Reset();
+	free(m_buffer);
+}
+
+LinearAllocator::LinearAllocator(size_t capacity)
+	: m_capacity(capacity)
+{
+	m_buffer = (unsigned char*) malloc(capacity);
+	ASSERT_OR_DIE(m_buffer != nullptr, "LinearAllocator: failed to allocate buffer");
+}
+
+void* LinearAllocator::Alloc(size_t size, size_t alignment)
+{
+	ASSERT_OR_DIE((alignment & (alignment - 1)) == 0, "LinearAllocator: alignment must be a power of two");
+
+	//aligns the address, malloc only promises max_align_t for the buffer itself
+	size_t start = AlignUp((uintptr_t) (m_buffer + m_offset), alignment) - (uintptr_t) m_buffer;
+	if (start + size <= m_capacity)
+	{
+		m_offset = start + size;
+		if (m_offset > m_highWater)
+			m_highWater = m_offset;
+
+		ASSERT_OR_DIE(((uintptr_t) (m_buffer + start) & (alignment - 1)) == 0, "LinearAllocator: misaligned allocation");
+		return m_buffer + start;
+	}
+
+	//out of space, hand out a malloc'd block we remember to free on Reset
+	unsigned char* block = (unsigned char*) malloc(sizeof(overflow_t) + alignment - 1 + size);
+	ASSERT_OR_DIE(block != nullptr, "LinearAllocator: out of memory");
+
+	overflow_t* overflow = (overflow_t*) block;
+	overflow->next = m_overflow;
+	m_overflow = overflow;
+	m_overflowCount++;
+
+	unsigned char* result = (unsigned char*) AlignUp((uintptr_t) (block + sizeof(overflow_t)), alignment);
+	ASSERT_OR_DIE(((uintptr_t) result & (alignment - 1)) == 0, "LinearAllocator: misaligned allocation");
+	return result;
+}
+
+void LinearAllocator::Reset()
+{
+	while (m_overflow != nullptr)
+	{
+		overflow_t* next = m_overflow->next;
+		free(m_overflow);
+		m_overflow = next;
+	}
+
+	m_offset = 0;
+	m_overflowCount = 0;
+}
+
+//------------------------------------------------------------------------
+void FrameAllocatorStartup(size_t bytesPerFrame)
+{
+	g_frameAllocators[0] = new LinearAllocator(bytesPerFrame);
+	g_frameAllocators[1] = new LinearAllocator(bytesPerFrame);
+	g_currentFrameAllocator = 0;
+}
+
+void FrameAllocatorShutdown()
+{
+	delete g_frameAllocators[0];
+	delete g_frameAllocators[1];
+	g_frameAllocators[0] = nullptr;
+	g_frameAllocators[1] = nullptr;
+}
+
+void FrameAllocatorBeginFrame()
+{
+	LinearAllocator* finished = g_frameAllocators[g_currentFrameAllocator];
+	PROFILE_COUNTER_ADD("frame alloc bytes", finished->GetUsed());
+	if (finished->GetOverflowCount() > 0)
+		DebuggerPrintf("Frame allocator overflowed %u times (high water %u bytes), raise bytesPerFrame in FrameAllocatorStartup\n", finished->GetOverflowCount(), (uint) finished->GetHighWater());
+
+	//the buffer from two frames ago is free to reuse
+	g_currentFrameAllocator = 1 - g_currentFrameAllocator;
+	g_frameAllocators[g_currentFrameAllocator]->Reset();
+}
+
+void* FrameAlloc(size_t size, size_t alignment)
+{
+	return g_frameAllocators[g_currentFrameAllocator]->Alloc(size, alignment);
+}
+
+LinearAllocator* GetFrameAllocator()
+{
+	return g_frameAllocators[g_currentFrameAllocator];
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Engine/Core/EngineCommon.hpp"
+#include <stddef.h>
+#include <new>
+
+// Bump allocator over one fixed buffer. Individual frees are no-ops, everything
+// goes away on Reset(). Running out of space falls back to malloc (freed on Reset)
+// so an undersized buffer costs speed, not correctness.
+class LinearAllocator
+{
+public:
+	~LinearAllocator();
+	explicit LinearAllocator(size_t capacity);
+
+	void* Alloc(size_t size, size_t alignment = alignof(max_align_t));
+	void Reset();
+
+	inline size_t GetUsed() const { return m_offset; }
+	inline size_t GetCapacity() const { return m_capacity; }
+	inline size_t GetHighWater() const { return m_highWater; }
+	inline uint GetOverflowCount() const { return m_overflowCount; }
+
+private:
+	struct overflow_t
+	{
+		overflow_t* next;
+	};
+
+	unsigned char* m_buffer = nullptr;
+	size_t m_capacity = 0;
+	size_t m_offset = 0;
+	size_t m_highWater = 0;
+
+	overflow_t* m_overflow = nullptr;
+	uint m_overflowCount = 0;
+};
+
+//------------------------------------------------------------------------
+// Frame allocator: two linear buffers swapped in App::BeginFrame, so anything
+// allocated this frame is still valid during the next one. Main thread only.
+void FrameAllocatorStartup(size_t bytesPerFrame = 4 * 1024 * 1024);
+void FrameAllocatorShutdown();
+void FrameAllocatorBeginFrame();
+
+void* FrameAlloc(size_t size, size_t alignment = alignof(max_align_t));
+LinearAllocator* GetFrameAllocator();
+
+//------------------------------------------------------------------------
+// STL adapter so containers can live in frame memory:
+//    std::vector<DrawCall, TFrameAllocatorAdapter<DrawCall>> drawCalls;
+// Never keep such a container alive past the next frame.
+template <typename T>
+class TFrameAllocatorAdapter
+{
+public:
+	typedef T value_type;
+
+	TFrameAllocatorAdapter() {}
+	template <typename U> TFrameAllocatorAdapter(const TFrameAllocatorAdapter<U>&) {}
+
+	T* allocate(size_t count)
+	{
+		return (T*) FrameAlloc(count * sizeof(T), alignof(T));
+	}
+
+	void deallocate(T*, size_t) {}
+
+	template <typename U> bool operator==(const TFrameAllocatorAdapter<U>&) const { return true; }
+	template <typename U> bool operator!=(const TFrameAllocatorAdapter<U>&) const { return false; }
+};
@@ -0,0 +1,461 @@
+#include "Engine/Core/MemoryTracker.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Profiler/Profiler.hpp"
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#include <DbgHelp.h>
+#include <crtdbg.h>
+#include <stdlib.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <new>
+
+#pragma comment(lib, "dbghelp.lib")
+
+#if defined(ENGINE_TRACK_MEMORY)
+
+//every operator new allocation is prefixed with this so delete knows the size and owner
+struct alloc_header_t
+{
+	size_t m_size;
+	uint16_t m_tagIndex;
+	uint16_t m_callsiteIndex;
+	uint32_t m_magic;
+};
+
+constexpr size_t ALLOC_HEADER_SIZE = 16; //keeps the user pointer 16 byte aligned
+constexpr uint32_t ALLOC_MAGIC = 0x4D454D54; //"MEMT"
+constexpr uint32_t FREED_MAGIC = 0x46524545; //"FREE"
+constexpr uint16_t INVALID_CALLSITE = 0xFFFF;
+static_assert(sizeof(alloc_header_t) <= ALLOC_HEADER_SIZE, "alloc_header_t grew past ALLOC_HEADER_SIZE");
+
+//all state is plain static data so it is usable before any constructor runs
+static std::atomic_flag g_trackerLock = ATOMIC_FLAG_INIT;
+static memory_tag_stats_t g_tags[MEMORY_TRACKER_MAX_TAGS];
+static uint32_t g_tagHashes[MEMORY_TRACKER_MAX_TAGS];
+static uint64_t g_tagLastFrameAllocCount[MEMORY_TRACKER_MAX_TAGS];
+static int g_tagCount = 0;
+static memory_callsite_stats_t g_callsites[MEMORY_TRACKER_MAX_CALLSITES];
+
+static uint64_t g_frameAllocCount = 0;
+static uint64_t g_frameAllocBytes = 0;
+static uint64_t g_lastFrameAllocCount = 0;
+static int64_t g_liveBytes = 0;
+
+static bool g_trackerStarted = false;
+static std::thread::id g_mainThreadId;
+static thread_local bool t_insideTracker = false; //keeps the malloc hook from counting our own mallocs
+
+//------------------------------------------------------------------------
+static void TrackerLock()
+{
+	while (g_trackerLock.test_and_set(std::memory_order_acquire)) {}
+}
+
+static void TrackerUnlock()
+{
+	g_trackerLock.clear(std::memory_order_release);
+}
+
+static uint32_t HashTag(const char* tag)
+{
+	//FNV-1a
+	uint32_t hash = 2166136261u;
+	for (const char* c = tag; *c != '\0'; ++c)
+	{
+		hash ^= (uint8_t) *c;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+// lock must be held
+static uint16_t FindOrAddTag(const char* tag)
+{
+	uint32_t hash = HashTag(tag);
+	for (int i = 0; i < g_tagCount; i++)
+	{
+		if (g_tagHashes[i] == hash && strcmp(g_tags[i].m_name, tag) == 0)
+			return (uint16_t) i;
+	}
+
+	//table is full, lump it in with the first tag
+	if (g_tagCount >= MEMORY_TRACKER_MAX_TAGS)
+		return 0;
+
+	strncpy_s(g_tags[g_tagCount].m_name, tag, MEMORY_TRACKER_TAG_LENGTH - 1);
+	g_tagHashes[g_tagCount] = hash;
+	return (uint16_t) g_tagCount++;
+}
+
+// lock must be held
+static uint16_t FindOrAddCallsite(void** callstack, uint16_t depth, uint32_t hash)
+{
+	uint32_t start = hash % MEMORY_TRACKER_MAX_CALLSITES;
+	for (uint32_t probe = 0; probe < MEMORY_TRACKER_MAX_CALLSITES; probe++)
+	{
+		uint32_t index = (start + probe) % MEMORY_TRACKER_MAX_CALLSITES;
+		memory_callsite_stats_t& site = g_callsites[index];
+
+		if (site.m_depth == 0)
+		{
+			site.m_hash = hash;
+			site.m_depth = depth;
+			memcpy(site.m_callstack, callstack, depth * sizeof(void*));
+			return (uint16_t) index;
+		}
+
+		if (site.m_hash == hash && site.m_depth == depth && memcmp(site.m_callstack, callstack, depth * sizeof(void*)) == 0)
+			return (uint16_t) index;
+	}
+
+	return INVALID_CALLSITE;
+}
+
+static const char* GetCurrentTag()
+{
+	if (!g_trackerStarted)
+		return "startup";
+
+	if (std::this_thread::get_id() != g_mainThreadId)
+		return "other threads";
+
+	const char* tag = ProfilerGetActiveTag();
+	return tag != nullptr ? tag : "untagged";
+}
+
+static void RecordAllocation(size_t size, bool tracksLiveBytes, uint16_t* out_tag, uint16_t* out_callsite)
+{
+	//skip this function and the operator/hook that called it
+	void* callstack[MEMORY_TRACKER_CALLSTACK_DEPTH];
+	ULONG hash = 0;
+	uint16_t depth = (uint16_t) RtlCaptureStackBackTrace(2, MEMORY_TRACKER_CALLSTACK_DEPTH, callstack, &hash);
+	const char* tagName = GetCurrentTag();
+
+	TrackerLock();
+
+	uint16_t tag = FindOrAddTag(tagName);
+	memory_tag_stats_t& stats = g_tags[tag];
+	stats.m_totalAllocCount++;
+	stats.m_totalAllocBytes += size;
+	stats.m_frameAllocCount++;
+	stats.m_frameAllocBytes += size;
+
+	uint16_t callsite = INVALID_CALLSITE;
+	if (depth > 0)
+		callsite = FindOrAddCallsite(callstack, depth, (uint32_t) hash);
+	if (callsite != INVALID_CALLSITE)
+	{
+		g_callsites[callsite].m_allocCount++;
+		g_callsites[callsite].m_allocBytes += size;
+	}
+
+	if (tracksLiveBytes)
+	{
+		stats.m_liveBytes += size;
+		g_liveBytes += size;
+	}
+
+	g_frameAllocCount++;
+	g_frameAllocBytes += size;
+
+	TrackerUnlock();
+
+	if (out_tag != nullptr)
+		*out_tag = tag;
+	if (out_callsite != nullptr)
+		*out_callsite = callsite;
+}
+
+static void RecordFree(const alloc_header_t& header)
+{
+	TrackerLock();
+	g_tags[header.m_tagIndex].m_liveBytes -= header.m_size;
+	g_liveBytes -= header.m_size;
+	TrackerUnlock();
+}
+
+static void* TrackedAlloc(size_t size)
+{
+	t_insideTracker = true;
+	unsigned char* block = (unsigned char*) malloc(size + ALLOC_HEADER_SIZE);
+	t_insideTracker = false;
+
+	if (block == nullptr)
+		throw std::bad_alloc();
+
+	alloc_header_t* header = (alloc_header_t*) block;
+	header->m_size = size;
+	header->m_magic = ALLOC_MAGIC;
+	RecordAllocation(size, true, &header->m_tagIndex, &header->m_callsiteIndex);
+
+	return block + ALLOC_HEADER_SIZE;
+}
+
+static void TrackedFree(void* ptr)
+{
+	if (ptr == nullptr)
+		return;
+
+	alloc_header_t* header = (alloc_header_t*) ((unsigned char*) ptr - ALLOC_HEADER_SIZE);
+	ASSERT_OR_DIE(header->m_magic != FREED_MAGIC, "MemoryTracker: double delete");
+	ASSERT_OR_DIE(header->m_magic == ALLOC_MAGIC, "MemoryTracker: deleting memory that was not allocated by operator new");
+
+	header->m_magic = FREED_MAGIC;
+	RecordFree(*header);
+
+	t_insideTracker = true;
+	free(header);
+	t_insideTracker = false;
+}
+
+#if defined(_DEBUG)
+//debug CRT only: counts raw malloc/realloc calls that don't go through operator new
+static int __cdecl CrtAllocHook(int allocType, void* userData, size_t size, int blockType, long requestNumber, const unsigned char* filename, int lineNumber)
+{
+	UNUSED(userData);
+	UNUSED(requestNumber);
+	UNUSED(filename);
+	UNUSED(lineNumber);
+
+	if (t_insideTracker || blockType == _CRT_BLOCK)
+		return TRUE;
+
+	if (allocType == _HOOK_ALLOC || allocType == _HOOK_REALLOC)
+	{
+		t_insideTracker = true;
+		RecordAllocation(size, false, nullptr, nullptr);
+		t_insideTracker = false;
+	}
+
+	return TRUE;
+}
+#endif
+
+//------------------------------------------------------------------------
+void* operator new(size_t size)
+{
+	return TrackedAlloc(size);
+}
+
+void* operator new[](size_t size)
+{
+	return TrackedAlloc(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+	TrackedFree(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+	TrackedFree(ptr);
+}
+
+void operator delete(void* ptr, size_t size) noexcept
+{
+	UNUSED(size);
+	TrackedFree(ptr);
+}
+
+void operator delete[](void* ptr, size_t size) noexcept
+{
+	UNUSED(size);
+	TrackedFree(ptr);
+}
+
+//------------------------------------------------------------------------
+static std::string CallstackToString(const memory_callsite_stats_t& site)
+{
+	static bool symbolsLoaded = false;
+	HANDLE process = GetCurrentProcess();
+	if (!symbolsLoaded)
+	{
+		SymSetOptions(SYMOPT_UNDNAME | SYMOPT_DEFERRED_LOADS | SYMOPT_LOAD_LINES);
+		SymInitialize(process, NULL, TRUE);
+		symbolsLoaded = true;
+	}
+
+	std::string result = "";
+	char symbolBuffer[sizeof(SYMBOL_INFO) + MAX_SYM_NAME];
+	SYMBOL_INFO* symbol = (SYMBOL_INFO*) symbolBuffer;
+
+	for (uint16_t i = 0; i < site.m_depth; i++)
+	{
+		DWORD64 address = (DWORD64) site.m_callstack[i];
+		memset(symbolBuffer, 0, sizeof(symbolBuffer));
+		symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+		symbol->MaxNameLen = MAX_SYM_NAME;
+
+		IMAGEHLP_LINE64 line;
+		line.SizeOfStruct = sizeof(IMAGEHLP_LINE64);
+		DWORD lineDisplacement = 0;
+
+		if (SymFromAddr(process, address, nullptr, symbol))
+		{
+			if (SymGetLineFromAddr64(process, address, &lineDisplacement, &line))
+				result += Stringf("      %s (%s:%u)\n", symbol->Name, line.FileName, line.LineNumber);
+			else
+				result += Stringf("      %s\n", symbol->Name);
+		}
+		else
+		{
+			result += Stringf("      0x%p\n", site.m_callstack[i]);
+		}
+	}
+
+	return result;
+}
+#endif
+
+void MemoryTrackerStartup()
+{
+#if defined(ENGINE_TRACK_MEMORY)
+	g_mainThreadId = std::this_thread::get_id();
+	g_trackerStarted = true;
+
+#if defined(_DEBUG)
+	_CrtSetAllocHook(CrtAllocHook);
+#endif
+
+	CommandRegister("memory_report", MemoryTrackerReportToConsole, "Prints live bytes per tag and top allocation call sites. Option: call site count");
+#endif
+}
+
+void MemoryTrackerShutdown()
+{
+#if defined(ENGINE_TRACK_MEMORY)
+#if defined(_DEBUG)
+	_CrtSetAllocHook(nullptr);
+#endif
+	g_trackerStarted = false;
+#endif
+}
+
+void MemoryTrackerMarkFrame()
+{
+#if defined(ENGINE_TRACK_MEMORY)
+	TrackerLock();
+	g_lastFrameAllocCount = g_frameAllocCount;
+	g_frameAllocCount = 0;
+	g_frameAllocBytes = 0;
+
+	for (int i = 0; i < g_tagCount; i++)
+	{
+		g_tagLastFrameAllocCount[i] = g_tags[i].m_frameAllocCount;
+		g_tags[i].m_frameAllocCount = 0;
+		g_tags[i].m_frameAllocBytes = 0;
+	}
+	TrackerUnlock();
+#endif
+}
+
+bool MemoryTrackerIsEnabled()
+{
+#if defined(ENGINE_TRACK_MEMORY)
+	return true;
+#else
+	return false;
+#endif
+}
+
+uint64_t MemoryTrackerGetFrameAllocationCount()
+{
+#if defined(ENGINE_TRACK_MEMORY)
+	return g_frameAllocCount;
+#else
+	return 0;
+#endif
+}
+
+uint64_t MemoryTrackerGetFrameAllocationBytes()
+{
+#if defined(ENGINE_TRACK_MEMORY)
+	return g_frameAllocBytes;
+#else
+	return 0;
+#endif
+}
+
+uint64_t MemoryTrackerGetLastFrameAllocationCount()
+{
+#if defined(ENGINE_TRACK_MEMORY)
+	return g_lastFrameAllocCount;
+#else
+	return 0;
+#endif
+}
+
+uint64_t MemoryTrackerGetLiveBytes()
+{
+#if defined(ENGINE_TRACK_MEMORY)
+	return (uint64_t) g_liveBytes;
+#else
+	return 0;
+#endif
+}
+
+std::string MemoryTrackerGetReport(uint topCallSites)
+{
+#if defined(ENGINE_TRACK_MEMORY)
+	//allocate the snapshot before taking the lock, operator new needs it too
+	std::vector<memory_tag_stats_t> tags(MEMORY_TRACKER_MAX_TAGS);
+	std::vector<uint64_t> tagLastFrameCounts(MEMORY_TRACKER_MAX_TAGS);
+	std::vector<memory_callsite_stats_t> callsites(MEMORY_TRACKER_MAX_CALLSITES);
+
+	TrackerLock();
+	int tagCount = g_tagCount;
+	memcpy(tags.data(), g_tags, sizeof(g_tags));
+	memcpy(tagLastFrameCounts.data(), g_tagLastFrameAllocCount, sizeof(g_tagLastFrameAllocCount));
+	memcpy(callsites.data(), g_callsites, sizeof(g_callsites));
+	int64_t liveBytes = g_liveBytes;
+	uint64_t lastFrameAllocs = g_lastFrameAllocCount;
+	TrackerUnlock();
+
+	std::string report = Stringf("LIVE BYTES: %lld   ALLOCATIONS LAST FRAME: %llu\n\n", liveBytes, lastFrameAllocs);
+	report += Stringf("%-40s %-14s %-14s %-12s\n", "TAG", "LIVE BYTES", "TOTAL ALLOCS", "LAST FRAME");
+
+	std::vector<int> tagOrder;
+	for (int i = 0; i < tagCount; i++)
+		tagOrder.push_back(i);
+
+	std::sort(tagOrder.begin(), tagOrder.end(), [&tags](int a, int b) { return tags[a].m_liveBytes > tags[b].m_liveBytes; });
+
+	for (int index : tagOrder)
+	{
+		report += Stringf("%-40s %-14lld %-14llu %-12llu\n", tags[index].m_name, tags[index].m_liveBytes, tags[index].m_totalAllocCount, tagLastFrameCounts[index]);
+	}
+
+	//top call sites by allocation count
+	callsites.erase(std::remove_if(callsites.begin(), callsites.end(), [](const memory_callsite_stats_t& site) { return site.m_depth == 0; }), callsites.end());
+	std::sort(callsites.begin(), callsites.end(), [](const memory_callsite_stats_t& a, const memory_callsite_stats_t& b) { return a.m_allocCount > b.m_allocCount; });
+
+	report += "\nTOP CALL SITES\n";
+	for (uint i = 0; i < topCallSites && i < (uint) callsites.size(); i++)
+	{
+		report += Stringf("  #%u  allocs: %llu  bytes: %llu\n", i + 1, callsites[i].m_allocCount, callsites[i].m_allocBytes);
+		report += CallstackToString(callsites[i]);
+	}
+
+	return report;
+#else
+	UNUSED(topCallSites);
+	return "Memory tracking is disabled, define ENGINE_TRACK_MEMORY in EngineBuildPreferences.hpp\n";
+#endif
+}
+
+void MemoryTrackerReportToConsole(Command& cmd)
+{
+	int topCallSites = 10;
+	cmd.GetNextInt(&topCallSites);
+
+	//console lines are capped in length, print the report a line at a time
+	Strings lines = Split(MemoryTrackerGetReport((uint) MaxInt(topCallSites, 0)), '\n');
+	for (const std::string& line : lines)
+		ConsolePrintf("%s", line.c_str());
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Game/EngineBuildPreferences.hpp"
+#include "Engine/Core/Command.hpp"
+#include <stdint.h>
+
+// Opt-in heap tracker, enabled with ENGINE_TRACK_MEMORY in EngineBuildPreferences.hpp.
+// Global operator new/delete are replaced so every allocation is attributed to the
+// profiler scope active on the main thread. In debug CRT builds raw malloc calls are
+// counted through the CRT alloc hook as well (counts and bytes only, not live bytes).
+
+#define MEMORY_TRACKER_MAX_TAGS 256
+#define MEMORY_TRACKER_MAX_CALLSITES 1024
+#define MEMORY_TRACKER_CALLSTACK_DEPTH 6
+#define MEMORY_TRACKER_TAG_LENGTH 64
+
+struct memory_tag_stats_t
+{
+	char m_name[MEMORY_TRACKER_TAG_LENGTH];
+	uint64_t m_totalAllocCount;
+	uint64_t m_totalAllocBytes;
+	int64_t m_liveBytes;
+	uint64_t m_frameAllocCount;
+	uint64_t m_frameAllocBytes;
+};
+
+struct memory_callsite_stats_t
+{
+	uint32_t m_hash;
+	void* m_callstack[MEMORY_TRACKER_CALLSTACK_DEPTH];
+	uint16_t m_depth;
+	uint64_t m_allocCount;
+	uint64_t m_allocBytes;
+};
+
+void MemoryTrackerStartup();
+void MemoryTrackerShutdown();
+void MemoryTrackerMarkFrame();
+
+bool MemoryTrackerIsEnabled();
+uint64_t MemoryTrackerGetFrameAllocationCount(); //frame in progress
+uint64_t MemoryTrackerGetFrameAllocationBytes();
+uint64_t MemoryTrackerGetLastFrameAllocationCount();
+uint64_t MemoryTrackerGetLiveBytes();
+
+std::string MemoryTrackerGetReport(uint topCallSites = 10);
+void MemoryTrackerReportToConsole(Command& cmd);
@@ -1,61 +1,187 @@
 #pragma once
 
-template <typename OBJ_TYPE>
-class TPageAllocator 
+#include "Game/EngineBuildPreferences.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <new>
+#include <utility>
+
+#if defined(ENGINE_DEBUG_PAGE_ALLOCATOR)
+constexpr unsigned char PAGE_ALLOCATOR_FRESH_BYTE = 0xCD; //never handed out
+constexpr unsigned char PAGE_ALLOCATOR_FREED_BYTE = 0xDD; //destroyed, back on the free list
+#endif
+
+// Pool of fixed size objects carved out of pages of OBJECTS_PER_PAGE slots.
+// Pick the page size per type: small pages for rare objects, big ones for hot ones.
+// With ENGINE_DEBUG_PAGE_ALLOCATOR freed slots are poisoned and Destroy checks for
+// double frees and pointers that don't belong to this pool.
+template <typename OBJ_TYPE, unsigned int OBJECTS_PER_PAGE = 64>
+class TPageAllocator
 {
 	struct node_t
 	{
-		node_t* next = nullptr; 
-	}; 
+		node_t* next = nullptr;
+	};
+
+	struct page_t
+	{
+		page_t* next = nullptr;
+	};
 
 public:
-	OBJ_TYPE* Create() 
+	~TPageAllocator()
 	{
-		node_t* head = m_freeList; 
-		if (head == nullptr) 
-		{
-			head = (node_t*) CreateBlock(); 
-		} 
-		else 
+		Clear();
+	}
+
+	template <typename ...ARGS>
+	OBJ_TYPE* Create(ARGS&& ...args)
+	{
+		if (m_freeList == nullptr)
+			CreatePage();
+
+		node_t* head = m_freeList;
+		m_freeList = m_freeList->next;
+
+#if defined(ENGINE_DEBUG_PAGE_ALLOCATOR)
+		unsigned char* state = FindSlotState(head);
+		ASSERT_OR_DIE(state != nullptr && *state == 0, "TPageAllocator: free list is corrupted");
+		*state = 1;
+#endif
+
+		m_liveCount++;
+		OBJ_TYPE* obj = new (head) OBJ_TYPE(std::forward<ARGS>(args)...);
+		return obj;
+	}
+
+	void Destroy(OBJ_TYPE* obj)
+	{
+		if (obj == nullptr)
+			return;
+
+#if defined(ENGINE_DEBUG_PAGE_ALLOCATOR)
+		unsigned char* state = FindSlotState(obj);
+		ASSERT_OR_DIE(state != nullptr, "TPageAllocator: destroying an object that isn't from this pool");
+		ASSERT_OR_DIE(*state == 1, "TPageAllocator: double free");
+		*state = 0;
+#endif
+
+		obj->~OBJ_TYPE();
+
+#if defined(ENGINE_DEBUG_PAGE_ALLOCATOR)
+		memset(obj, PAGE_ALLOCATOR_FREED_BYTE, GetSlotSize());
+#endif
+
+		node_t* iter = (node_t*) obj;
+		iter->next = m_freeList;
+		m_freeList = iter;
+		m_liveCount--;
+	}
+
+	// Releases every page in one go. Objects still alive are NOT destructed,
+	// so only call this on plain data pools or after everything was destroyed.
+	void Clear()
+	{
+		page_t* page = m_pages;
+		while (page != nullptr)
 		{
-			m_freeList = m_freeList->next; 
+			page_t* next = page->next;
+			free(page);
+			page = next;
 		}
 
-		OBJ_TYPE* obj = new (head) OBJ_TYPE(); 
-		return obj; 
+		m_pages = nullptr;
+		m_freeList = nullptr;
+		m_pageCount = 0;
+		m_liveCount = 0;
 	}
 
-	void Destroy(OBJ_TYPE* obj) 
+	inline unsigned int GetLiveCount() const { return m_liveCount; }
+	inline unsigned int GetPageCount() const { return m_pageCount; }
+	inline unsigned int GetCapacity() const { return m_pageCount * OBJECTS_PER_PAGE; }
+
+	static constexpr size_t GetSlotAlignment()
 	{
-		obj->~OBJ_TYPE(); 
-		node_t* iter = (node_t*) obj; 
+		return alignof(OBJ_TYPE) > alignof(node_t) ? alignof(OBJ_TYPE) : alignof(node_t);
+	}
 
-		iter->next = m_freeList; 
-		m_freeList = iter; 
+	static constexpr size_t GetSlotSize()
+	{
+		//slot doubles as a free list node when not in use
+		return RoundUp(sizeof(OBJ_TYPE) > sizeof(node_t) ? sizeof(OBJ_TYPE) : sizeof(node_t), GetSlotAlignment());
 	}
 
-	void Clear()
+private:
+	static constexpr size_t RoundUp(size_t value, size_t alignment)
 	{
-		// freeing memory
-		if (m_freeList != nullptr)
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+	static constexpr size_t GetSlotsOffset()
+	{
+		return RoundUp(sizeof(page_t), GetSlotAlignment());
+	}
+
+	void CreatePage()
+	{
+		static_assert(OBJECTS_PER_PAGE > 0, "TPageAllocator needs at least one object per page");
+		static_assert(alignof(OBJ_TYPE) <= alignof(max_align_t), "TPageAllocator doesn't support over-aligned types");
+
+		size_t pageSize = GetSlotsOffset() + GetSlotSize() * OBJECTS_PER_PAGE;
+#if defined(ENGINE_DEBUG_PAGE_ALLOCATOR)
+		pageSize += OBJECTS_PER_PAGE; //one live/free byte per slot, after the slots
+#endif
+
+		page_t* page = (page_t*) malloc(pageSize);
+		ASSERT_OR_DIE(page != nullptr, "TPageAllocator: out of memory");
+		page->next = m_pages;
+		m_pages = page;
+		m_pageCount++;
+
+		unsigned char* slots = (unsigned char*) page + GetSlotsOffset();
+
+#if defined(ENGINE_DEBUG_PAGE_ALLOCATOR)
+		memset(slots, PAGE_ALLOCATOR_FRESH_BYTE, GetSlotSize() * OBJECTS_PER_PAGE);
+		memset(slots + GetSlotSize() * OBJECTS_PER_PAGE, 0, OBJECTS_PER_PAGE);
+#endif
+
+		//push backwards so slots get handed out in address order
+		for (unsigned int i = OBJECTS_PER_PAGE; i > 0; --i)
 		{
-			node_t* next = m_freeList->next;
-			free(m_freeList);
-
-			while (next != nullptr)
-			{
-				node_t* temp = next->next;
-				free(next);
-				next = temp;
-			}
+			node_t* node = (node_t*) (slots + GetSlotSize() * (i - 1));
+			node->next = m_freeList;
+			m_freeList = node;
 		}
 	}
 
-	OBJ_TYPE* CreateBlock()
+#if defined(ENGINE_DEBUG_PAGE_ALLOCATOR)
+	//returns the live/free byte of the slot, nullptr if ptr isn't the start of a slot of this pool
+	unsigned char* FindSlotState(void* ptr)
 	{
-		return (OBJ_TYPE*) malloc( sizeof(OBJ_TYPE) ); 
+		unsigned char* address = (unsigned char*) ptr;
+		for (page_t* page = m_pages; page != nullptr; page = page->next)
+		{
+			unsigned char* slots = (unsigned char*) page + GetSlotsOffset();
+			unsigned char* slotsEnd = slots + GetSlotSize() * OBJECTS_PER_PAGE;
+			if (address < slots || address >= slotsEnd)
+				continue;
+
+			size_t offset = (size_t) (address - slots);
+			if (offset % GetSlotSize() != 0)
+				return nullptr;
+
+			return slotsEnd + offset / GetSlotSize();
+		}
+
+		return nullptr;
 	}
+#endif
 
-public:
+private:
 	node_t* m_freeList = nullptr;
-}; 
\ No newline at end of file
+	page_t* m_pages = nullptr;
+	unsigned int m_pageCount = 0;
+	unsigned int m_liveCount = 0;
+};
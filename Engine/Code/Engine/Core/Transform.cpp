@@ -1,19 +1,20 @@
 #include "Engine/Core/Transform.hpp"
+#include <algorithm>
+
+std::vector<Transform*> Transform::s_dirtyTransforms;
+std::vector<Transform*> Transform::s_interpolatedTransforms;
+float Transform::s_renderAlpha = 1.f;
 
 Matrix44 transform_t::GetMatrix() const
 {
-	Matrix44 transform = Matrix44();
-	transform.Append(Matrix44::MakeTranslation(position));
-	transform.Append(Matrix44::MakeFromEuler(euler));
-	transform.Append(Matrix44::MakeScale(scale.x, scale.y, scale.z));
-
-	return transform;
+	//T * R * S written out, the rotation basis scaled per axis
+	return Matrix44(rotation.GetRight() * scale.x, rotation.GetUp() * scale.y, rotation.GetForward() * scale.z, position);
 }
 
 void transform_t::SetMatrix(const Matrix44& mat)
 {
 	position = mat.GetPosition();
-	euler = mat.GetEuler();
+	rotation = Quaternion::MakeFromMatrix(mat);
 	scale = mat.GetScale();
 }
 
@@ -32,19 +33,35 @@ Vector3 transform_t::GetPosition() const
 	return position;
 }
 
+void transform_t::SetRotation(const Quaternion& rot)
+{
+	rotation = rot;
+}
+
+void transform_t::Rotate(const Quaternion& rot)
+{
+	rotation = rotation * rot;
+	rotation.Normalize(); //keeps drift out when rotating every frame
+}
+
+Quaternion transform_t::GetRotation() const
+{
+	return rotation;
+}
+
 void transform_t::SetRotationEuler(const Vector3& eulerAngle)
 {
-	euler = eulerAngle;
+	rotation = Quaternion::MakeFromEuler(eulerAngle);
 }
 
 void transform_t::RotateByEuler(const Vector3& eulerAngle)
 {
-	euler += eulerAngle;
+	Rotate(Quaternion::MakeFromEuler(eulerAngle));
 }
 
 Vector3 transform_t::GetEulerAngles() const
 {
-	return euler;
+	return rotation.GetEuler();
 }
 
 void transform_t::SetScale(const Vector3& s)
@@ -59,27 +76,85 @@ Vector3 transform_t::GetScale() const
 
 ///////////////////////
 
+Transform::~Transform()
+{
+	if (m_parent != nullptr)
+		m_parent->RemoveChild(this);
+
+	//children keep their local transform and become roots
+	for (Transform* child : m_children)
+	{
+		child->m_parent = nullptr;
+		child->MarkWorldDirty();
+		child->RefreshInterpolatedAncestor();
+	}
+
+	if (m_isQueuedForUpdate)
+	{
+		std::vector<Transform*>::iterator it = std::find(s_dirtyTransforms.begin(), s_dirtyTransforms.end(), this);
+		*it = s_dirtyTransforms.back();
+		s_dirtyTransforms.pop_back();
+	}
+
+	SetInterpolated(false);
+}
+
 Transform::Transform()
 {
 }
 
+Transform::Transform(const Transform& copy)
+	: m_localTransform(copy.m_localTransform)
+{
+	MakeChild(copy.m_parent);
+}
+
+Transform& Transform::operator=(const Transform& copy)
+{
+	if (this != &copy)
+	{
+		m_localTransform = copy.m_localTransform;
+		MakeChild(copy.m_parent);
+		MarkLocalDirty();
+	}
+
+	return *this;
+}
+
 void Transform::MakeChild(Transform* parent)
 {
+	if (m_parent == parent)
+		return;
+
+	if (m_parent != nullptr)
+		m_parent->RemoveChild(this);
+
 	m_parent = parent;
+	if (m_parent != nullptr)
+		m_parent->m_children.push_back(this);
+
+	MarkWorldDirty();
+	RefreshInterpolatedAncestor();
 }
 
 Matrix44 Transform::GetWorldMatrix() const
 {
-	if (m_parent != nullptr)
-	{
-		Matrix44 mat = m_parent->GetWorldMatrix();
-		mat.Append(GetLocalMatrix());
-		return mat;
-	}
-	else
+	if (m_isWorldDirty)
 	{
-		return GetLocalMatrix();
+		if (m_parent != nullptr)
+		{
+			m_worldMatrix = m_parent->GetWorldMatrix();
+			m_worldMatrix.Append(GetLocalMatrix());
+		}
+		else
+		{
+			m_worldMatrix = GetLocalMatrix();
+		}
+
+		m_isWorldDirty = false;
 	}
+
+	return m_worldMatrix;
 }
 
 void Transform::SetWorldMatrix(const Matrix44& mat)
@@ -113,24 +188,50 @@ Vector3 Transform::GetWorldPosition() const
 	return GetWorldMatrix().GetPosition();
 }
 
+Quaternion Transform::GetWorldRotation() const
+{
+	//assumes uniform scale up the chain, like the rest of the hierarchy
+	if (m_parent != nullptr)
+		return m_parent->GetWorldRotation() * m_localTransform.rotation;
+
+	return m_localTransform.rotation;
+}
+
+void Transform::SetWorldRotation(const Quaternion& rotation)
+{
+	if (m_parent != nullptr)
+		SetLocalRotation(m_parent->GetWorldRotation().GetInverse() * rotation);
+	else
+		SetLocalRotation(rotation);
+}
+
 Matrix44 Transform::GetLocalMatrix() const
 {
-	return m_localTransform.GetMatrix();
+	if (m_isLocalDirty)
+	{
+		m_localMatrix = m_localTransform.GetMatrix();
+		m_isLocalDirty = false;
+	}
+
+	return m_localMatrix;
 }
 
 void Transform::SetLocalMatrix(const Matrix44& mat)
 {
 	m_localTransform.SetMatrix(mat);
+	MarkLocalDirty();
 }
 
 void Transform::SetLocalPosition(const Vector3& pos)
 {
 	m_localTransform.position = pos;
+	MarkLocalDirty();
 }
 
 void Transform::TranslateLocal(const Vector3& offset)
 {
 	m_localTransform.position += offset;
+	MarkLocalDirty();
 }
 
 Vector3 Transform::GetLocalPosition() const
@@ -138,24 +239,44 @@ Vector3 Transform::GetLocalPosition() const
 	return m_localTransform.position;
 }
 
+void Transform::SetLocalRotation(const Quaternion& rotation)
+{
+	m_localTransform.SetRotation(rotation);
+	MarkLocalDirty();
+}
+
+void Transform::RotateLocal(const Quaternion& rotation)
+{
+	m_localTransform.Rotate(rotation);
+	MarkLocalDirty();
+}
+
+Quaternion Transform::GetLocalRotation() const
+{
+	return m_localTransform.rotation;
+}
+
 void Transform::SetLocalRotationEuler(const Vector3& euler)
 {
-	m_localTransform.euler = euler;
+	m_localTransform.SetRotationEuler(euler);
+	MarkLocalDirty();
 }
 
 void Transform::RotateLocalByEuler(const Vector3& euler)
 {
-	m_localTransform.euler += euler;
+	m_localTransform.RotateByEuler(euler);
+	MarkLocalDirty();
 }
 
 Vector3 Transform::GetLocalEulerAngles() const
 {
-	return m_localTransform.euler;
+	return m_localTransform.GetEulerAngles();
 }
 
 void Transform::SetLocalScale(const Vector3& s)
 {
 	m_localTransform.scale = s;
+	MarkLocalDirty();
 }
 
 Vector3 Transform::GetLocalScale() const
@@ -165,12 +286,147 @@ Vector3 Transform::GetLocalScale() const
 
 void Transform::LocalLookAt(const Vector3& localPos, const Vector3& localUp)
 {
-	Matrix44 lookAt = Matrix44::LookAt(GetLocalPosition(), localPos, localUp);
-	SetLocalMatrix(lookAt);
+	SetLocalRotation(Quaternion::LookRotation(localPos - GetLocalPosition(), localUp));
 }
 
 void Transform::WorldLookAt(const Vector3& worldPos, const Vector3& worldUp)
 {
-	Matrix44 lookAt = Matrix44::LookAt(GetWorldPosition(), worldPos, worldUp);
-	SetWorldMatrix(lookAt);
+	SetWorldRotation(Quaternion::LookRotation(worldPos - GetWorldPosition(), worldUp));
 }
+
+void Transform::UpdateDirtyHierarchy()
+{
+	//RefreshHierarchy pulls dirty parents in first, so the order of the list doesn't matter
+	for (size_t i = 0; i < s_dirtyTransforms.size(); i++)
+	{
+		Transform* transform = s_dirtyTransforms[i];
+		transform->m_isQueuedForUpdate = false;
+		transform->RefreshHierarchy();
+	}
+
+	s_dirtyTransforms.clear();
+}
+
+void Transform::SetInterpolated(bool isInterpolated)
+{
+	if (m_isInterpolated == isInterpolated)
+		return;
+
+	m_isInterpolated = isInterpolated;
+	if (m_isInterpolated)
+	{
+		s_interpolatedTransforms.push_back(this);
+		ResetInterpolation();
+	}
+	else
+	{
+		std::vector<Transform*>::iterator it = std::find(s_interpolatedTransforms.begin(), s_interpolatedTransforms.end(), this);
+		*it = s_interpolatedTransforms.back();
+		s_interpolatedTransforms.pop_back();
+	}
+
+	for (Transform* child : m_children)
+		child->RefreshInterpolatedAncestor();
+}
+
+void Transform::ResetInterpolation()
+{
+	m_previousTransform = m_localTransform;
+}
+
+Matrix44 Transform::GetRenderMatrix() const
+{
+	if (!m_isInterpolated && !m_hasInterpolatedAncestor)
+		return GetWorldMatrix();
+
+	Matrix44 local;
+	if (m_isInterpolated)
+	{
+		transform_t blended;
+		blended.position = Interpolate(m_previousTransform.position, m_localTransform.position, s_renderAlpha);
+		blended.rotation = Slerp(m_previousTransform.rotation, m_localTransform.rotation, s_renderAlpha);
+		blended.scale = Interpolate(m_previousTransform.scale, m_localTransform.scale, s_renderAlpha);
+		local = blended.GetMatrix();
+	}
+	else
+	{
+		local = GetLocalMatrix();
+	}
+
+	if (m_parent == nullptr)
+		return local;
+
+	Matrix44 render = m_parent->GetRenderMatrix();
+	render.Append(local);
+	return render;
+}
+
+void Transform::RefreshInterpolatedAncestor()
+{
+	bool hasInterpolatedAncestor = m_parent != nullptr && (m_parent->m_isInterpolated || m_parent->m_hasInterpolatedAncestor);
+	if (m_hasInterpolatedAncestor == hasInterpolatedAncestor)
+		return;
+
+	//the subtree below only changes if this node isn't interpolated itself
+	m_hasInterpolatedAncestor = hasInterpolatedAncestor;
+	if (!m_isInterpolated)
+	{
+		for (Transform* child : m_children)
+			child->RefreshInterpolatedAncestor();
+	}
+}
+
+void Transform::BeginSimulationStep()
+{
+	for (Transform* transform : s_interpolatedTransforms)
+		transform->m_previousTransform = transform->m_localTransform;
+}
+
+void Transform::SetRenderInterpolation(float alpha)
+{
+	s_renderAlpha = alpha;
+}
+
+void Transform::MarkLocalDirty()
+{
+	m_isLocalDirty = true;
+	MarkWorldDirty();
+
+	if (!m_isQueuedForUpdate)
+	{
+		m_isQueuedForUpdate = true;
+		s_dirtyTransforms.push_back(this);
+	}
+}
+
+void Transform::MarkWorldDirty()
+{
+	//a dirty node already has a dirty subtree
+	if (m_isWorldDirty)
+		return;
+
+	m_isWorldDirty = true;
+	for (Transform* child : m_children)
+		child->MarkWorldDirty();
+}
+
+void Transform::RefreshHierarchy()
+{
+	GetWorldMatrix();
+
+	for (Transform* child : m_children)
+	{
+		if (child->m_isWorldDirty)
+			child->RefreshHierarchy();
+	}
+}
+
+void Transform::RemoveChild(Transform* child)
+{
+	std::vector<Transform*>::iterator it = std::find(m_children.begin(), m_children.end(), child);
+	if (it != m_children.end())
+	{
+		*it = m_children.back();
+		m_children.pop_back();
+	}
+}
\ No newline at end of file
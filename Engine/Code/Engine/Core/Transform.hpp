@@ -2,13 +2,15 @@
 
 #include "Engine/Math/Vector3.hpp"
 #include "Engine/Math/Matrix44.hpp"
+#include "Engine/Math/Quaternion.hpp"
+#include <vector>
 
 struct transform_t 
 {
 public:
 	transform_t()
 		: position(Vector3::zero)
-		, euler(Vector3::zero)
+		, rotation(Quaternion::identity)
 		, scale(Vector3::one) {}
 
 	Matrix44 GetMatrix() const; 
@@ -18,6 +20,10 @@ public:
 	void Translate(const Vector3& offset); 
 	Vector3 GetPosition() const; 
 
+	void SetRotation(const Quaternion& rot);
+	void Rotate(const Quaternion& rot); // about the local axes: rotation * rot
+	Quaternion GetRotation() const;
+
 	void SetRotationEuler(const Vector3& eulerAngle); 
 	void RotateByEuler(const Vector3& eulerAngle); 
 	Vector3 GetEulerAngles() const; 
@@ -27,25 +33,34 @@ public:
 
 public:
 	Vector3 position; 
-	Vector3 euler; 
+	Quaternion rotation; 
 	Vector3 scale; 
 
 	// STATICS
 	static transform_t const IDENTITY; 
 };
 
+// Local and world matrices are cached. Setters mark the node dirty (and its whole
+// subtree for the world matrix); getters rebuild lazily, parent first.
+// UpdateDirtyHierarchy() refreshes everything touched this frame in one pass so
+// the render side only does plain loads.
 class Transform 
 {
 public:
-	~Transform() {};
+	~Transform();
 	Transform();
+	Transform(const Transform& copy);
+	Transform& operator=(const Transform& copy);
 
 	void MakeChild(Transform* parent);
+	inline Transform* GetParent() const { return m_parent; }
 
 	Matrix44 GetWorldMatrix() const;
 	void SetWorldMatrix(const Matrix44& mat);
 	Vector3 WorldToLocal(const Vector3& worldPos);
 	Vector3 GetWorldPosition() const;
+	Quaternion GetWorldRotation() const;
+	void SetWorldRotation(const Quaternion& rotation);
 
 	// these just call through to the the member
 	// transform_t 
@@ -56,6 +71,10 @@ public:
 	void TranslateLocal(const Vector3& offset); 
 	Vector3 GetLocalPosition() const; 
 
+	void SetLocalRotation(const Quaternion& rotation);
+	void RotateLocal(const Quaternion& rotation);
+	Quaternion GetLocalRotation() const;
+
 	void SetLocalRotationEuler(const Vector3& euler); 
 	void RotateLocalByEuler(const Vector3& euler); 
 	Vector3 GetLocalEulerAngles() const; 
@@ -66,11 +85,41 @@ public:
 	void LocalLookAt(const Vector3& localPos, const Vector3& localUp = Vector3::up);
 	void WorldLookAt(const Vector3& worldPos, const Vector3& worldUp = Vector3::up);
 
+	static void UpdateDirtyHierarchy();
+
+	// Fixed step interpolation. Opted in transforms keep their local transform from before
+	// the current simulation step, and GetRenderMatrix blends it with the current one by the
+	// render alpha. Anything else renders its world matrix (under any interpolated parents).
+	void SetInterpolated(bool isInterpolated);
+	void ResetInterpolation(); // after a teleport, so it doesn't streak across the jump
+	Matrix44 GetRenderMatrix() const;
+
+	static void BeginSimulationStep(); // call before each step changes anything
+	static void SetRenderInterpolation(float alpha);
+
+private:
+	void MarkLocalDirty();
+	void MarkWorldDirty();
+	void RefreshHierarchy();
+	void RemoveChild(Transform* child);
+	void RefreshInterpolatedAncestor();
+
 private:
 	transform_t m_localTransform; 
 	Transform* m_parent = nullptr;
+	std::vector<Transform*> m_children;
+
+	mutable Matrix44 m_localMatrix;
+	mutable Matrix44 m_worldMatrix;
+	mutable bool m_isLocalDirty = true;
+	mutable bool m_isWorldDirty = true; //if set, every descendant is dirty too
+	bool m_isQueuedForUpdate = false;
+
+	static std::vector<Transform*> s_dirtyTransforms;
 
-	// if you want to do matrix caching or 
-	// anything else, feel free to add 
-	// new members
+	transform_t m_previousTransform;
+	bool m_isInterpolated = false;
+	bool m_hasInterpolatedAncestor = false; //if neither is set, the cached world matrix is the render matrix
+	static std::vector<Transform*> s_interpolatedTransforms;
+	static float s_renderAlpha;
 };
\ No newline at end of file
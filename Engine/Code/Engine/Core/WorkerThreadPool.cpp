@@ -0,0 +1,131 @@
+#include "Engine/Core/WorkerThreadPool.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include <atomic>
+#include <memory>
+
+static WorkerThreadPool* g_workerThreads = nullptr;
+
+struct parallel_for_t
+{
+	std::function<void(uint)> job;
+	uint jobCount = 0;
+	std::atomic<uint> nextJob{ 0 };
+	std::atomic<uint> finishedCount{ 0 };
+};
+
+static void RunParallelFor(parallel_for_t& work)
+{
+	for (uint index = work.nextJob++; index < work.jobCount; index = work.nextJob++)
+	{
+		work.job(index);
+		work.finishedCount++;
+	}
+}
+
+WorkerThreadPool::~WorkerThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		m_isStopping = true;
+		m_jobs.clear();
+	}
+	m_jobAdded.notify_all();
+
+	for (std::thread& thread : m_threads)
+		thread.join();
+}
+
+WorkerThreadPool::WorkerThreadPool(uint threadCount)
+{
+	threadCount = threadCount > 0 ? threadCount : 1;
+	for (uint i = 0; i < threadCount; i++)
+		m_threads.emplace_back([this]() { WorkerMain(); });
+}
+
+void WorkerThreadPool::AddJob(const std::function<void()>& job)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		m_jobs.push_back(job);
+	}
+	m_jobAdded.notify_one();
+}
+
+void WorkerThreadPool::WaitForAll()
+{
+	std::unique_lock<std::mutex> lock(m_lock);
+	m_jobFinished.wait(lock, [this]() { return m_jobs.empty() && m_runningCount == 0; });
+}
+
+void WorkerThreadPool::ParallelFor(uint jobCount, const std::function<void(uint)>& job)
+{
+	if (jobCount == 0)
+		return;
+
+	//shared, a helper can start after everything is claimed and this has returned
+	std::shared_ptr<parallel_for_t> work = std::make_shared<parallel_for_t>();
+	work->job = job;
+	work->jobCount = jobCount;
+
+	uint helperCount = jobCount - 1 < GetThreadCount() ? jobCount - 1 : GetThreadCount();
+	for (uint i = 0; i < helperCount; i++)
+		AddJob([work]() { RunParallelFor(*work); });
+
+	//if the workers are busy with other jobs this thread gets through them alone
+	RunParallelFor(*work);
+	while (work->finishedCount < jobCount)
+		std::this_thread::yield();
+}
+
+uint WorkerThreadPool::GetQueuedJobCount()
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	return (uint) m_jobs.size();
+}
+
+void WorkerThreadPool::WorkerMain()
+{
+	std::unique_lock<std::mutex> lock(m_lock);
+	while (true)
+	{
+		m_jobAdded.wait(lock, [this]() { return m_isStopping || !m_jobs.empty(); });
+		if (m_isStopping)
+			return;
+
+		std::function<void()> job = m_jobs.front();
+		m_jobs.pop_front();
+		m_runningCount++;
+
+		lock.unlock();
+		job();
+		lock.lock();
+
+		m_runningCount--;
+		m_jobFinished.notify_all();
+	}
+}
+
+//------------------------------------------------------------------------
+void WorkerThreadsStartup(uint threadCount)
+{
+	ASSERT_OR_DIE(g_workerThreads == nullptr, "WorkerThreadsStartup called twice");
+
+	if (threadCount == 0)
+	{
+		uint hardwareThreads = std::thread::hardware_concurrency();
+		threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+	}
+
+	g_workerThreads = new WorkerThreadPool(threadCount);
+}
+
+void WorkerThreadsShutdown()
+{
+	delete g_workerThreads;
+	g_workerThreads = nullptr;
+}
+
+WorkerThreadPool* GetWorkerThreads()
+{
+	return g_workerThreads;
+}
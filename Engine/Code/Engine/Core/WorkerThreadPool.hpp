@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Engine/Core/EngineCommon.hpp"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of threads running jobs off one FIFO queue.
+// Jobs must stay away from the renderer and anything else that is main thread only:
+// hand the results back and finish up on the main thread.
+class WorkerThreadPool
+{
+public:
+	~WorkerThreadPool(); // jobs not started yet are dropped, running ones finish first
+	explicit WorkerThreadPool(uint threadCount);
+
+	void AddJob(const std::function<void()>& job);
+	void WaitForAll(); // until the queue is empty and no job is running
+
+	// Runs job(0) to job(jobCount - 1) on the workers and the calling thread, returning once they
+	// are all done. Only waits on its own jobs, so other work queued on the pool doesn't hold it up.
+	void ParallelFor(uint jobCount, const std::function<void(uint)>& job);
+
+	inline uint GetThreadCount() const { return (uint) m_threads.size(); }
+	uint GetQueuedJobCount();
+
+private:
+	void WorkerMain();
+
+private:
+	std::vector<std::thread> m_threads;
+	std::deque<std::function<void()>> m_jobs;
+	std::mutex m_lock;
+	std::condition_variable m_jobAdded;
+	std::condition_variable m_jobFinished;
+	uint m_runningCount = 0;
+	bool m_isStopping = false;
+};
+
+//------------------------------------------------------------------------
+// Shared pool for engine and game work. threadCount 0 means one per hardware thread,
+// minus the main thread.
+void WorkerThreadsStartup(uint threadCount = 0);
+void WorkerThreadsShutdown();
+WorkerThreadPool* GetWorkerThreads();
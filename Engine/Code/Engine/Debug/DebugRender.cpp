@@ -4,6 +4,9 @@
 #include "Engine/Core/DevConsole.hpp"
 #include "Engine/Core/Window.hpp"
 #include "Engine/Renderer/RendererTypes.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
 
 #include "Engine/Debug/DebugRenderTask_Line_2D.hpp"
 #include "Engine/Debug/DebugRenderTask_Quad_2D.hpp"
@@ -41,6 +44,7 @@ void DebugRender::DebugRenderStartup(Renderer* r)
 
 	CommandRegister("debug_toggle", DebugRender::ConsoleToggleVislble, "Toggle debug render.");
 	CommandRegister("debug_clear", DebugRender::ConsoleClear, "Clear debug render.");
+	CommandRegister("debug_soak", DebugRender::ConsoleSoak, "Adds line segments around the 3D camera to soak test debug render. Options: count (100000), seconds (10)");
 }
 
 void DebugRender::DebugRenderShutdown()
@@ -65,57 +69,45 @@ void DebugRender::DebugRenderUpdateAndRender()
 
 	if (m_visible)
 	{
-		r->SetShader(nullptr);
-
+		//tints go into the vertex colors, so each depth mode is a line draw and a triangle draw however many tasks there are
 		for each (DebugRenderTask* task in m_debugRenderTasks)
 		{
-			if (!task->m_is2D)
-			{
-				if (task->m_options.mode == eDebugRenderMode::DEBUG_RENDER_HIDDEN)
-				{
-					r->EnableDepth(COMPARE_GREATER, false);
-				}
-				else if (task->m_options.mode == eDebugRenderMode::DEBUG_RENDER_IGNORE_DEPTH)
-				{
-					r->DisableDepth();
-				}
-				else if (task->m_options.mode == eDebugRenderMode::DEBUG_RENDER_XRAY)
-				{
-					//for xray part
-					r->EnableDepth(COMPARE_GREATER, false); 
-					task->m_alphaFactor = 0.4f;
-					task->Render();
-
-					task->m_alphaFactor = 1.f;
-					r->EnableDepth(COMPARE_LESS, true); 
-				}
-				else
-				{
-					r->EnableDepth(COMPARE_LESS, true); 	
-				}
-
-				task->Render();
-				//reset possible wireframe draw mode
-				r->SetWireFrameDrawModeActive(false);
-			}
+			debug_render_batch_t* batch = task->m_is2D ? &m_overlayBatch : &m_batches[task->m_options.mode];
+			task->AppendVertices(batch, task->GetTint());
 		}
 
+		r->SetShader(nullptr);
+		r->SetUniform("TINT", Vector4(1.f, 1.f, 1.f, 1.f));
+		r->SetCamera(m_3D_camera);
+
+		//depth writers first, so the others test against them; ignore depth last, on top of the rest
+		r->EnableDepth(COMPARE_LESS, true);
+		DrawBatch(m_batches[DEBUG_RENDER_USE_DEPTH]);
+
+		r->EnableDepth(COMPARE_GREATER, false);
+		DrawBatch(m_batches[DEBUG_RENDER_HIDDEN]);
+
+		//for xray part
+		r->SetUniform("TINT", Vector4(1.f, 1.f, 1.f, 0.4f));
+		DrawBatch(m_batches[DEBUG_RENDER_XRAY]);
+		r->SetUniform("TINT", Vector4(1.f, 1.f, 1.f, 1.f));
+		r->EnableDepth(COMPARE_LESS, true);
+		DrawBatch(m_batches[DEBUG_RENDER_XRAY]);
+
 		//to ensure 2D elements are drawn on top
 		r->DisableDepth();
-		for each (DebugRenderTask* task in m_debugRenderTasks)
-		{
-			if (task->m_is2D)
-			{
-				task->Render();
-			}
-		}
+		DrawBatch(m_batches[DEBUG_RENDER_IGNORE_DEPTH]);
 
+		r->SetCamera(m_overlayCamera);
+		DrawBatch(m_overlayBatch);
 		RenderDebugLogf();
 
 		//reset depth setting
 		r->EnableDepth(COMPARE_LESS, true); 
-		//reset tint
-		r->SetUniform("TINT", Vector4(1.f, 1.f, 1.f, 1.f));
+
+		for (int mode = 0; mode < NUM_DEBUG_RENDER_MODES; ++mode)
+			m_batches[mode].Clear();
+		m_overlayBatch.Clear();
 	}
 
 	for (int task_index = 0; task_index < m_debugRenderTasks.size(); ++task_index)
@@ -123,7 +115,7 @@ void DebugRender::DebugRenderUpdateAndRender()
 		DebugRenderTask* task = m_debugRenderTasks[task_index];
 		if (task->IsDead())
 		{
-			delete task;
+			DestroyTask(task);
 
 			size_t size = m_debugRenderTasks.size();
 			m_debugRenderTasks[task_index] = m_debugRenderTasks[size - 1];
@@ -135,6 +127,27 @@ void DebugRender::DebugRenderUpdateAndRender()
 	PostUpdateDebugLogf();
 }
 
+void DebugRender::DrawBatch(debug_render_batch_t& batch)
+{
+	Renderer* r = Renderer::GetInstance();
+
+	if (batch.lines.size() > 0 || batch.triangles.size() > 0)
+	{
+		r->BindSampler();
+		r->BindTexture();
+	}
+
+	if (batch.lines.size() > 0)
+		r->DrawMeshImmediate(batch.lines.data(), (int) batch.lines.size(), eDrawPrimitive::LINES);
+	if (batch.triangles.size() > 0)
+		r->DrawMeshImmediate(batch.triangles.data(), (int) batch.triangles.size(), eDrawPrimitive::TRIANGLES);
+
+	for each (DebugRenderTask* task in batch.unbatched)
+	{
+		task->Render();
+	}
+}
+
 void DebugRender::UpdadeDebugLogf(float deltaSeconds)
 {
 	float width = (float) Window::GetWidth();
@@ -165,7 +178,7 @@ void DebugRender::PostUpdateDebugLogf()
 		DebugRenderTask* task = m_debugLogTasks[task_index];
 		if (task->IsDead())
 		{
-			delete task;
+			DestroyTask(task);
 
 			size_t size = m_debugLogTasks.size();
 			m_debugLogTasks[task_index] = m_debugLogTasks[size - 1];
@@ -178,10 +191,10 @@ void DebugRender::PostUpdateDebugLogf()
 void DebugRender::DebugRenderClear()
 {
 	for (int task_index = 0; task_index < m_debugRenderTasks.size(); ++task_index)
-		delete m_debugRenderTasks[task_index];
+		DestroyTask(m_debugRenderTasks[task_index]);
 
 	for (int log_index = 0; log_index < m_debugLogTasks.size(); ++log_index)
-		delete m_debugLogTasks[log_index];
+		DestroyTask(m_debugLogTasks[log_index]);
 
 	m_debugRenderTasks.clear();
 	m_debugLogTasks.clear();
@@ -203,6 +216,12 @@ void DebugRender::InitAndAddTask(DebugRenderTask* task, float lifetime, const Rg
 	g_DebugRender->m_debugRenderTasks.push_back(task);
 }
 
+void DebugRender::DestroyTask(DebugRenderTask* task)
+{
+	task->~DebugRenderTask();
+	m_taskPool.Destroy((debug_render_task_slot_t*) task);
+}
+
 DebugRender* DebugRender::CreateInstance()
 {
 	if (g_DebugRender == nullptr) 
@@ -229,63 +248,90 @@ void DebugRender::ConsoleClear(Command& cmd)
 	UNUSED(cmd);
 }
 
+void DebugRender::ConsoleSoak(Command& cmd)
+{
+	int count = 100000;
+	int seconds = 10;
+	cmd.GetNextInt(&count);
+	cmd.GetNextInt(&seconds);
+	count = MaxInt(count, 1);
+
+	Vector3 center = Vector3::zero;
+	if (g_DebugRender->m_3D_camera != nullptr)
+		center = g_DebugRender->m_3D_camera->m_transform.GetWorldPosition();
+
+	RandomNumberGenerator& random = GetThreadRandom();
+	uint64_t start = GetPerformanceCounter();
+	for (int line = 0; line < count; ++line)
+	{
+		Vector3 p0 = center + Vector3(random.GetRandomFloatInRange(-50.f, 50.f), random.GetRandomFloatInRange(-50.f, 50.f), random.GetRandomFloatInRange(-50.f, 50.f));
+		Vector3 p1 = p0 + Vector3(random.GetRandomFloatInRange(-2.f, 2.f), random.GetRandomFloatInRange(-2.f, 2.f), random.GetRandomFloatInRange(-2.f, 2.f));
+		eDebugRenderMode mode = (eDebugRenderMode) (line % NUM_DEBUG_RENDER_MODES);
+		DebugRenderLineSegment((float) seconds, p0, Rgba::yellow, p1, Rgba::red, Rgba::white, Rgba::white, mode);
+	}
+	double submitSeconds = PerformanceCounterToSeconds(GetPerformanceCounter() - start);
+
+	ConsolePrintf("debug_soak: %d lines for %d s, submitted in %.2f ms, %u tasks live, pool has %u pages", count, seconds,
+		submitSeconds * 1000.0, g_DebugRender->GetTaskCount(), g_DebugRender->m_taskPool.GetPageCount());
+}
+
 void DebugRender2DQuad(float lifetime, const AABB2& bounds, const Rgba& start_color, const Rgba& end_color, eDebugRenderMode mode)
 {
-	DebugRenderTask_Quad_2D* task = new DebugRenderTask_Quad_2D(bounds);
+	DebugRenderTask_Quad_2D* task = g_DebugRender->CreateTask<DebugRenderTask_Quad_2D>(bounds);
 	g_DebugRender->InitAndAddTask(task, lifetime, start_color, end_color, mode);
 }
 
 void DebugRender2DLine(float lifetime, const Vector2& p0, const Rgba& p0_color, const Vector2& p1, const Rgba& p1_color, const Rgba& start_color, const Rgba& end_color, eDebugRenderMode mode)
 {
-	DebugRenderTask_Line_2D* task = new DebugRenderTask_Line_2D(p0, p1, p0_color, p1_color);
+	DebugRenderTask_Line_2D* task = g_DebugRender->CreateTask<DebugRenderTask_Line_2D>(p0, p1, p0_color, p1_color);
 	g_DebugRender->InitAndAddTask(task, lifetime, start_color, end_color, mode);
 }
 
 void DebugRender2DText(float lifetime, const AABB2& bounds, float cellHeight, const std::string& asciiText, const Rgba& start_color, const Rgba& end_color, const Vector2& alignment, const Rgba& tint, eTextDrawMode textDrawMode, eDebugRenderMode mode)
 {
-	DebugRenderTask_Text_2D* task = new DebugRenderTask_Text_2D(bounds, cellHeight, asciiText, alignment, tint, textDrawMode);
+	DebugRenderTask_Text_2D* task = g_DebugRender->CreateTask<DebugRenderTask_Text_2D>(bounds, cellHeight, asciiText, alignment, tint, textDrawMode);
 	g_DebugRender->InitAndAddTask(task, lifetime, start_color, end_color, mode);
 }
 
 void DebugLogf(const std::string& text, const Rgba& color, float lifetime)
 {
-	DebugRenderTask_Text_2D* task = new DebugRenderTask_Text_2D(AABB2::ZERO_TO_ONE, DEBUG_LOG_HEIGHT, text, Vector2(0, 0.5f), color, eTextDrawMode::OVERRUN);
+	DebugRenderTask_Text_2D* task = g_DebugRender->CreateTask<DebugRenderTask_Text_2D>(AABB2::ZERO_TO_ONE, DEBUG_LOG_HEIGHT, text, Vector2(0, 0.5f), color, eTextDrawMode::OVERRUN);
 	task->m_options = debug_render_options_t(lifetime, Rgba::white, Rgba::white, eDebugRenderMode::DEBUG_RENDER_USE_DEPTH);
 	g_DebugRender->m_debugLogTasks.push_back(task);
 }
 
 void DebugRenderPoint(float lifetime, const Vector3& position, const Rgba& start_color, const Rgba& end_color, eDebugRenderMode mode)
 {
-	DebugRenderTask_Point* task = new DebugRenderTask_Point(position);
+	DebugRenderTask_Point* task = g_DebugRender->CreateTask<DebugRenderTask_Point>(position);
 	g_DebugRender->InitAndAddTask(task, lifetime, start_color, end_color, mode);
 }
 
 void DebugRenderLineSegment(float lifetime, const Vector3& p0, const Rgba& p0_color, const Vector3& p1, const Rgba& p1_color, const Rgba& start_color, const Rgba& end_color, eDebugRenderMode mode)
 {
-	DebugRenderTask_LineSegment* task = new DebugRenderTask_LineSegment(p0, p1, p0_color, p1_color);
+	DebugRenderTask_LineSegment* task = g_DebugRender->CreateTask<DebugRenderTask_LineSegment>(p0, p1, p0_color, p1_color);
 	g_DebugRender->InitAndAddTask(task, lifetime, start_color, end_color, mode);
 }
 
 void DebugRenderBasis(float lifetime, const Matrix44& basis, const Rgba& start_color, const Rgba& end_color, eDebugRenderMode mode)
 {
-	DebugRenderTask_Basis* task = new DebugRenderTask_Basis(basis);
+	DebugRenderTask_Basis* task = g_DebugRender->CreateTask<DebugRenderTask_Basis>(basis);
 	g_DebugRender->InitAndAddTask(task, lifetime, start_color, end_color, mode);
 }
 
 void DebugRenderSphere(float lifetime, const Vector3& pos, float const radius, const Rgba& start_color, const Rgba& end_color, eFillMode fillMode, eDebugRenderMode mode)
 {
-	DebugRenderTask_Sphere* task = new DebugRenderTask_Sphere(pos, radius, fillMode);
+	DebugRenderTask_Sphere* task = g_DebugRender->CreateTask<DebugRenderTask_Sphere>(pos, radius, fillMode);
 	g_DebugRender->InitAndAddTask(task, lifetime, start_color, end_color, mode);
 }
 
 void DebugRenderAABB3(float lifetime, const Vector3& center, const Vector3& dimensions, const Rgba& start_color, const Rgba& end_color, eFillMode fillMode, eDebugRenderMode mode)
 {
-	DebugRenderTask_WireAABB3* task = new DebugRenderTask_WireAABB3(center, dimensions, fillMode);
+	DebugRenderTask_WireAABB3* task = g_DebugRender->CreateTask<DebugRenderTask_WireAABB3>(center, dimensions, fillMode);
 	g_DebugRender->InitAndAddTask(task, lifetime, start_color, end_color, mode);
 }
 
 void DebugRenderQuad(float lifetime, const Vector3& pos, const AABB2& bounds, const Vector3& right, const Vector3& up, Texture* texture, const Rgba& start_color, const Rgba& end_color, eDebugRenderMode mode)
 {
-	DebugRenderTask_Quad* task = new DebugRenderTask_Quad(pos, right, up, bounds, texture);
+	DebugRenderTask_Quad* task = g_DebugRender->CreateTask<DebugRenderTask_Quad>(pos, right, up, bounds, texture);
 	g_DebugRender->InitAndAddTask(task, lifetime, start_color, end_color, mode);
 }
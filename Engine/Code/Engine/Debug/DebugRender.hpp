@@ -3,6 +3,9 @@
 #include "Engine/Debug/DebugRenderTask.hpp"
 #include "Engine/Core/DevConsole.hpp"
 #include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Core/PageAllocator.hpp"
+#include <stddef.h>
+#include <new>
 #include <string>
 #include <vector>
 
@@ -12,6 +15,16 @@ class Texture;
 class Clock;
 class DebugRenderTask_Text_2D;
 
+// Room for any DebugRenderTask, so every kind shares one pool
+constexpr size_t DEBUG_RENDER_TASK_SLOT_SIZE = 160;
+
+struct debug_render_task_slot_t
+{
+	debug_render_task_slot_t() {} // left uninitialized, the task is constructed over it
+
+	alignas(max_align_t) unsigned char bytes[DEBUG_RENDER_TASK_SLOT_SIZE];
+};
+
 class DebugRender
 {
 public:
@@ -40,11 +53,28 @@ public:
 
 	void InitAndAddTask(DebugRenderTask* task, float lifetime, const Rgba& start_color, const Rgba& end_color, eDebugRenderMode mode);
 
+	template <typename TASK_TYPE, typename ...ARGS>
+	TASK_TYPE* CreateTask(ARGS&& ...args)
+	{
+		static_assert(sizeof(TASK_TYPE) <= sizeof(debug_render_task_slot_t), "DebugRender: task doesn't fit in a slot, raise DEBUG_RENDER_TASK_SLOT_SIZE");
+		static_assert(alignof(TASK_TYPE) <= alignof(debug_render_task_slot_t), "DebugRender: task is over-aligned for a slot");
+
+		debug_render_task_slot_t* slot = m_taskPool.Create();
+		return new (slot) TASK_TYPE(std::forward<ARGS>(args)...);
+	}
+	void DestroyTask(DebugRenderTask* task);
+
+	inline uint GetTaskCount() const { return (uint) (m_debugRenderTasks.size() + m_debugLogTasks.size()); }
+
 public:
 	static DebugRender* CreateInstance();
 	static DebugRender* GetInstance(); 
 	static void ConsoleToggleVislble(Command& cmd);
 	static void ConsoleClear(Command& cmd);
+	static void ConsoleSoak(Command& cmd);
+
+private:
+	void DrawBatch(debug_render_batch_t& batch);
 
 public:
 	Camera* m_overlayCamera = nullptr; //2D camera, drawn to NDC
@@ -58,6 +88,10 @@ private:
 	bool m_visible = true;
 
 	ShaderProgram* m_diffuseShader = nullptr; //default shader
+
+	TPageAllocator<debug_render_task_slot_t, 1024> m_taskPool;
+	debug_render_batch_t m_batches[NUM_DEBUG_RENDER_MODES];
+	debug_render_batch_t m_overlayBatch; // 2D tasks, always on top
 };
 
 // Global functions
@@ -1,6 +1,15 @@
 #include "Engine/Debug/DebugRenderTask.hpp"
+#include "Engine/Renderer/MeshBuilder.hpp"
 #include "Engine/Math/MathUtils.hpp"
 
+void debug_render_batch_t::Clear()
+{
+	//keeps the capacity, so a steady stream of debug draws stops allocating
+	lines.clear();
+	triangles.clear();
+	unbatched.clear();
+}
+
 DebugRenderTask::~DebugRenderTask()
 {
 }
@@ -24,3 +33,72 @@ float DebugRenderTask::GetNormalizedAge()
 	}
 	return ClampFloat(normalizeAge, 0.f, 1.f);
 }
+
+Rgba DebugRenderTask::GetTint()
+{
+	return Interpolate(m_options.endColor, m_options.startColor, GetNormalizedAge());
+}
+
+Rgba ModulateColor(const Rgba& color, const Rgba& tint)
+{
+	return Rgba((unsigned char) ((color.r * tint.r) / 255), (unsigned char) ((color.g * tint.g) / 255),
+		(unsigned char) ((color.b * tint.b) / 255), (unsigned char) ((color.a * tint.a) / 255));
+}
+
+void AppendDebugLine(std::vector<VertexPCU>* out, const Vector3& p0, const Rgba& p0_color, const Vector3& p1, const Rgba& p1_color, const Rgba& tint)
+{
+	out->push_back(VertexPCU(p0, ModulateColor(p0_color, tint)));
+	out->push_back(VertexPCU(p1, ModulateColor(p1_color, tint)));
+}
+
+void AppendDebugQuad(std::vector<VertexPCU>* out, const Vector3& p0, const Vector3& p1, const Vector3& p2, const Vector3& p3, const Rgba& tint)
+{
+	out->push_back(VertexPCU(p0, tint, Vector2(0.f, 0.f)));
+	out->push_back(VertexPCU(p1, tint, Vector2(1.f, 0.f)));
+	out->push_back(VertexPCU(p2, tint, Vector2(0.f, 1.f)));
+
+	out->push_back(VertexPCU(p2, tint, Vector2(0.f, 1.f)));
+	out->push_back(VertexPCU(p1, tint, Vector2(1.f, 0.f)));
+	out->push_back(VertexPCU(p3, tint, Vector2(1.f, 1.f)));
+}
+
+void CopyDebugTriangles(std::vector<VertexPCU>* out, const MeshBuilder& mb)
+{
+	out->reserve(out->size() + mb.m_indices.size());
+	for each (uint index in mb.m_indices)
+	{
+		out->push_back(VertexPCU(mb.m_vertices[index]));
+	}
+}
+
+void CopyDebugWireEdges(std::vector<VertexPCU>* out, const MeshBuilder& mb)
+{
+	//what glPolygonMode GL_LINE would draw, so wire shapes join the line batch
+	out->reserve(out->size() + (mb.m_indices.size() * 2));
+	for (size_t face = 0; face + 2 < mb.m_indices.size(); face += 3)
+	{
+		VertexPCU a = VertexPCU(mb.m_vertices[mb.m_indices[face + 0]]);
+		VertexPCU b = VertexPCU(mb.m_vertices[mb.m_indices[face + 1]]);
+		VertexPCU c = VertexPCU(mb.m_vertices[mb.m_indices[face + 2]]);
+
+		out->push_back(a);
+		out->push_back(b);
+		out->push_back(b);
+		out->push_back(c);
+		out->push_back(c);
+		out->push_back(a);
+	}
+}
+
+void AppendDebugVertices(std::vector<VertexPCU>* out, const std::vector<VertexPCU>& vertices, const Rgba& tint)
+{
+	size_t first = out->size();
+	out->resize(first + vertices.size());
+	VertexPCU* vertex = out->data() + first;
+	for each (const VertexPCU& source in vertices)
+	{
+		*vertex = source;
+		vertex->m_color = ModulateColor(source.m_color, tint);
+		vertex++;
+	}
+}
@@ -5,13 +5,19 @@
 #include "Engine/Math/Vector2.hpp"
 #include "Engine/Math/AABB2.hpp"
 #include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Renderer/VertexPCU.hpp"
+#include <vector>
 
-enum eDebugRenderMode 
+class MeshBuilder;
+class DebugRenderTask;
+
+enum eDebugRenderMode
 {
-	DEBUG_RENDER_IGNORE_DEPTH, // will always draw and be visible 
+	DEBUG_RENDER_IGNORE_DEPTH, // will always draw and be visible
 	DEBUG_RENDER_USE_DEPTH,    // draw using normal depth rules
 	DEBUG_RENDER_HIDDEN,       // only draws if it would be hidden by depth
 	DEBUG_RENDER_XRAY,         // always draws, but hidden area will be drawn differently
+	NUM_DEBUG_RENDER_MODES
 };
 
 struct debug_render_options_t
@@ -23,11 +29,22 @@ struct debug_render_options_t
 		, mode(mode)
 	{}
 
-	Rgba startColor; 
-	Rgba endColor; 
-	float totalTimeToLive; 
-	eDebugRenderMode mode; 
-}; 
+	Rgba startColor;
+	Rgba endColor;
+	float totalTimeToLive;
+	eDebugRenderMode mode;
+};
+
+// Everything one depth mode draws in a frame: one line draw and one triangle draw,
+// then the few tasks that need their own (text, textured quads)
+struct debug_render_batch_t
+{
+	void Clear();
+
+	std::vector<VertexPCU> lines;
+	std::vector<VertexPCU> triangles;
+	std::vector<DebugRenderTask*> unbatched;
+};
 
 class DebugRenderTask
 {
@@ -37,14 +54,26 @@ public:
 
 	void Age(float deltaSeconds);
 	float GetNormalizedAge();
+	Rgba GetTint(); // start to end color by age
 	bool IsDead() { return m_timeToLive >= m_options.totalTimeToLive; }
 
-	virtual void Render() = 0;
+	// Adds the task's vertices to batch, colored by tint. Tasks that can't share
+	// the batch's draws add themselves to batch->unbatched and draw in Render
+	virtual void AppendVertices(debug_render_batch_t* batch, const Rgba& tint) = 0;
+	virtual void Render() {}
 
 public:
 	debug_render_options_t m_options;
 	float m_timeToLive = 0;
 
-	float m_alphaFactor = 1.f;
 	bool m_is2D = false;
 };
+
+Rgba ModulateColor(const Rgba& color, const Rgba& tint); // per channel color * tint, like TINT in the shaders
+void AppendDebugLine(std::vector<VertexPCU>* out, const Vector3& p0, const Rgba& p0_color, const Vector3& p1, const Rgba& p1_color, const Rgba& tint);
+void AppendDebugQuad(std::vector<VertexPCU>* out, const Vector3& p0, const Vector3& p1, const Vector3& p2, const Vector3& p3, const Rgba& tint); // 2---3 over 0---1, as DrawTexturedAABB2_3D
+
+// Untinted vertices of a built mesh, once at submission: triangles, or their edges as lines for wire fill
+void CopyDebugTriangles(std::vector<VertexPCU>* out, const MeshBuilder& mb);
+void CopyDebugWireEdges(std::vector<VertexPCU>* out, const MeshBuilder& mb);
+void AppendDebugVertices(std::vector<VertexPCU>* out, const std::vector<VertexPCU>& vertices, const Rgba& tint);
@@ -1,8 +1,6 @@
 #pragma once
 
 #include "Engine/Debug/DebugRenderTask.hpp"
-#include "Engine/Renderer/Renderer.hpp"
-#include "Engine/Debug/DebugRender.hpp"
 
 class DebugRenderTask_Quad_2D : public DebugRenderTask
 {
@@ -11,18 +9,11 @@ public:
 	: DebugRenderTask(),
 		m_bounds(bounds) { m_is2D = true; }
 
-	virtual void Render() override
+	virtual void AppendVertices(debug_render_batch_t* batch, const Rgba& tint) override
 	{
-		Renderer* r = Renderer::GetInstance();
-		DebugRender* dr = DebugRender::GetInstance();
-
-		r->SetCamera(dr->m_overlayCamera);
-
-		Rgba overlayColor = Interpolate(m_options.endColor, m_options.startColor, GetNormalizedAge());
-		overlayColor.a = static_cast<unsigned char>((float) overlayColor.a * m_alphaFactor);
-		r->SetUniform("TINT", overlayColor);
-
-		r->DrawAABB(m_bounds, Rgba::white);
+		AppendDebugQuad(&batch->triangles,
+			Vector3(m_bounds.mins.x, m_bounds.mins.y, 0.f), Vector3(m_bounds.maxs.x, m_bounds.mins.y, 0.f),
+			Vector3(m_bounds.mins.x, m_bounds.maxs.y, 0.f), Vector3(m_bounds.maxs.x, m_bounds.maxs.y, 0.f), tint);
 	}
 
 public:
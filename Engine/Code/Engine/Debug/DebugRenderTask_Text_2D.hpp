@@ -2,7 +2,6 @@
 
 #include "Engine/Debug/DebugRenderTask.hpp"
 #include "Engine/Renderer/Renderer.hpp"
-#include "Engine/Debug/DebugRender.hpp"
 #include <string.h>
 
 class DebugRenderTask_Text_2D : public DebugRenderTask
@@ -17,18 +16,17 @@ public:
 		m_tint(tint),
 		m_textDrawMode(textDrawMode) { m_is2D = true; }
 
+	virtual void AppendVertices(debug_render_batch_t* batch, const Rgba& tint) override
+	{
+		UNUSED(tint);
+		batch->unbatched.push_back(this);
+	}
+
 	virtual void Render() override
 	{
+		//tint baked into the glyphs instead of the TINT uniform, so all debug text shares the renderer's text batch
 		Renderer* r = Renderer::GetInstance();
-		DebugRender* dr = DebugRender::GetInstance();
-
-		r->SetCamera(dr->m_overlayCamera);
-
-		Rgba overlayColor = Interpolate(m_options.endColor, m_options.startColor, GetNormalizedAge());
-		overlayColor.a = static_cast<unsigned char>((float) overlayColor.a * m_alphaFactor);
-		r->SetUniform("TINT", overlayColor);
-
-		r->DrawTextInBox2D(m_bounds, m_asciiText, m_cellHeight, m_tint, 1.f, nullptr, m_textDrawMode, m_alignment);
+		r->DrawTextInBox2D(m_bounds, m_asciiText, m_cellHeight, ModulateColor(m_tint, GetTint()), 1.f, nullptr, m_textDrawMode, m_alignment);
 	}
 
 public:
@@ -1,8 +1,7 @@
 #pragma once
 
 #include "Engine/Debug/DebugRenderTask.hpp"
-#include "Engine/Renderer/Renderer.hpp"
-#include "Engine/Debug/DebugRender.hpp"
+#include "Engine/Math/Matrix44.hpp"
 
 class DebugRenderTask_Basis : public DebugRenderTask
 {
@@ -11,21 +10,12 @@ public:
 		: DebugRenderTask(),
 		m_basis(basis) {}
 
-	virtual void Render() override
+	virtual void AppendVertices(debug_render_batch_t* batch, const Rgba& tint) override
 	{
-		Renderer* r = Renderer::GetInstance();
-		DebugRender* dr = DebugRender::GetInstance();
-
-		r->SetCamera(dr->m_3D_camera);
-
 		Vector3 origin = m_basis.GetPosition();
-		Rgba overlayColor = Interpolate(m_options.endColor, m_options.startColor, GetNormalizedAge());
-		overlayColor.a = static_cast<unsigned char>((float) overlayColor.a * m_alphaFactor);
-		r->SetUniform("TINT", overlayColor);
-
-		r->DrawLine(origin, origin + (m_basis.GetRight() * 6), Rgba::red);
-		r->DrawLine(origin, origin + (m_basis.GetForward() * 6), Rgba::blue);
-		r->DrawLine(origin, origin + (m_basis.GetUp()  * 6), Rgba::green);
+		AppendDebugLine(&batch->lines, origin, Rgba::red, origin + (m_basis.GetRight() * 6), Rgba::red, tint);
+		AppendDebugLine(&batch->lines, origin, Rgba::blue, origin + (m_basis.GetForward() * 6), Rgba::blue, tint);
+		AppendDebugLine(&batch->lines, origin, Rgba::green, origin + (m_basis.GetUp() * 6), Rgba::green, tint);
 	}
 
 public:
@@ -1,8 +1,6 @@
 #pragma once
 
 #include "Engine/Debug/DebugRenderTask.hpp"
-#include "Engine/Renderer/Renderer.hpp"
-#include "Engine/Debug/DebugRender.hpp"
 
 class DebugRenderTask_LineSegment : public DebugRenderTask
 {
@@ -14,18 +12,9 @@ public:
 		m_p0_color(p0_color),
 		m_p1_color(p1_color) {}
 
-	virtual void Render() override
+	virtual void AppendVertices(debug_render_batch_t* batch, const Rgba& tint) override
 	{
-		Renderer* r = Renderer::GetInstance();
-		DebugRender* dr = DebugRender::GetInstance();
-
-		r->SetCamera(dr->m_3D_camera);
-
-		Rgba overlayColor = Interpolate(m_options.endColor, m_options.startColor, GetNormalizedAge());
-		overlayColor.a = static_cast<unsigned char>((float) overlayColor.a * m_alphaFactor);
-		r->SetUniform("TINT", overlayColor);
-
-		r->DrawLine(m_p0, m_p1, m_p0_color, m_p1_color);
+		AppendDebugLine(&batch->lines, m_p0, m_p0_color, m_p1, m_p1_color, tint);
 	}
 
 public:
@@ -1,8 +1,6 @@
 #pragma once
 
 #include "Engine/Debug/DebugRenderTask.hpp"
-#include "Engine/Renderer/Renderer.hpp"
-#include "Engine/Debug/DebugRender.hpp"
 
 class DebugRenderTask_Point : public DebugRenderTask
 {
@@ -11,24 +9,11 @@ public:
 		: DebugRenderTask(),
 		m_position(position) {}
 
-	virtual void Render() override
+	virtual void AppendVertices(debug_render_batch_t* batch, const Rgba& tint) override
 	{
-		Renderer* r = Renderer::GetInstance();
-		DebugRender* dr = DebugRender::GetInstance();
-
-		r->SetCamera(dr->m_3D_camera);
-
-		Rgba overlayColor = Interpolate(m_options.endColor, m_options.startColor, GetNormalizedAge());
-		overlayColor.a = static_cast<unsigned char>((float) overlayColor.a * m_alphaFactor);
-		r->SetUniform("TINT", overlayColor);
-
-// 		r->DrawLine(m_position, m_position + Vector3::right, Rgba::blue);
-// 		r->DrawLine(m_position, m_position + Vector3::forward, Rgba::red);
-// 		r->DrawLine(m_position, m_position + Vector3::up, Rgba::green);
-
-		r->DrawLine(m_position - Vector3::right, m_position + Vector3::right, Rgba::white);
-		r->DrawLine(m_position - Vector3::forward, m_position + Vector3::forward, Rgba::white);
-		r->DrawLine(m_position - Vector3::up, m_position + Vector3::up, Rgba::white);
+		AppendDebugLine(&batch->lines, m_position - Vector3::right, Rgba::white, m_position + Vector3::right, Rgba::white, tint);
+		AppendDebugLine(&batch->lines, m_position - Vector3::forward, Rgba::white, m_position + Vector3::forward, Rgba::white, tint);
+		AppendDebugLine(&batch->lines, m_position - Vector3::up, Rgba::white, m_position + Vector3::up, Rgba::white, tint);
 	}
 
 public:
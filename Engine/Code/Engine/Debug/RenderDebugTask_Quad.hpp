@@ -2,7 +2,6 @@
 
 #include "Engine/Debug/DebugRenderTask.hpp"
 #include "Engine/Renderer/Renderer.hpp"
-#include "Engine/Debug/DebugRender.hpp"
 
 class DebugRenderTask_Quad : public DebugRenderTask
 {
@@ -15,18 +14,26 @@ public:
 		m_bounds(bounds),
 		m_texture(texture) {}
 
-	virtual void Render() override
+	virtual void AppendVertices(debug_render_batch_t* batch, const Rgba& tint) override
 	{
-		Renderer* r = Renderer::GetInstance();
-		DebugRender* dr = DebugRender::GetInstance();
+		//a texture needs its own draw
+		if (m_texture != nullptr)
+		{
+			batch->unbatched.push_back(this);
+			return;
+		}
 
-		r->SetCamera(dr->m_3D_camera);
-
-		Rgba overlayColor = Interpolate(m_options.endColor, m_options.startColor, GetNormalizedAge());
-		overlayColor.a = static_cast<unsigned char>((float) overlayColor.a * m_alphaFactor);
-		r->SetUniform("TINT", overlayColor);
+		//centered on position, like Renderer::DrawPlane
+		Vector2 halfDimensions = m_bounds.GetDimensions() * 0.5f;
+		Vector3 right = m_right * halfDimensions.x;
+		Vector3 up = m_up * halfDimensions.y;
+		AppendDebugQuad(&batch->triangles, m_position - right - up, m_position + right - up, m_position - right + up, m_position + right + up, tint);
+	}
 
-		r->DrawPlane(m_position, m_right, m_up, m_bounds, m_texture, overlayColor);
+	virtual void Render() override
+	{
+		Renderer* r = Renderer::GetInstance();
+		r->DrawPlane(m_position, m_right, m_up, m_bounds, m_texture, GetTint());
 	}
 
 public:
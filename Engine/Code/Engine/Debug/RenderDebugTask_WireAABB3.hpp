@@ -1,8 +1,7 @@
 #pragma once
 
 #include "Engine/Debug/DebugRenderTask.hpp"
-#include "Engine/Renderer/Renderer.hpp"
-#include "Engine/Debug/DebugRender.hpp"
+#include "Engine/Renderer/MeshBuilder.hpp"
 
 class DebugRenderTask_WireAABB3 : public DebugRenderTask
 {
@@ -11,29 +10,24 @@ public:
 		: DebugRenderTask(),
 		m_center(center),
 		m_dimensions(dimensions),
-		m_fillMode(fillMode) {}
-
-	virtual void Render() override
+		m_fillMode(fillMode)
 	{
-		Renderer* r = Renderer::GetInstance();
-		DebugRender* dr = DebugRender::GetInstance();
-
-		r->SetCamera(dr->m_3D_camera);
-
-		Rgba overlayColor = Interpolate(m_options.endColor, m_options.startColor, GetNormalizedAge());
-		overlayColor.a = static_cast<unsigned char>((float) overlayColor.a * m_alphaFactor);
-		r->SetUniform("TINT", overlayColor);
-
-		if (m_fillMode == eFillMode::FILLMODE_SOLID)
-			r->SetWireFrameDrawModeActive(false);
-		else if (m_fillMode == eFillMode::FILLMODE_WIRE)
-			r->SetWireFrameDrawModeActive(true);
+		MeshBuilder mb;
+		mb.AddCube(m_center, m_dimensions, Vector3::one, Rgba::white);
+		if (m_fillMode == eFillMode::FILLMODE_WIRE)
+			CopyDebugWireEdges(&m_vertices, mb);
+		else
+			CopyDebugTriangles(&m_vertices, mb);
+	}
 
-		r->DrawCube(m_center, m_dimensions, overlayColor);
+	virtual void AppendVertices(debug_render_batch_t* batch, const Rgba& tint) override
+	{
+		AppendDebugVertices(m_fillMode == eFillMode::FILLMODE_WIRE ? &batch->lines : &batch->triangles, m_vertices, tint);
 	}
 
 public:
 	Vector3 m_center;
 	Vector3 m_dimensions;
 	eFillMode m_fillMode;
+	std::vector<VertexPCU> m_vertices;
 };
@@ -1,6 +1,11 @@
 #include "Engine/File/File.hpp"
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
 
 // writing on a text file
 #include <iostream>
@@ -45,4 +50,121 @@ bool WriteStringToFile(const char* filename, std::string data)
 	{
 		return false;
 	}
-}
\ No newline at end of file
+}
+
+bool ReadBinaryFile(const char* filename, std::vector<unsigned char>* out_bytes)
+{
+	FILE *fp = nullptr;
+	fopen_s( &fp, filename, "rb" );
+
+	if (fp == nullptr) {
+		return false;
+	}
+
+	fseek(fp, 0L, SEEK_END);
+	size_t size = ftell(fp);
+	fseek(fp, 0L, SEEK_SET);
+
+	out_bytes->resize(size);
+	size_t read = size > 0U ? fread( out_bytes->data(), 1, size, fp ) : 0U;
+	fclose(fp);
+
+	return read == size;
+}
+
+bool WriteBinaryFile(const char* filename, const void* data, size_t byteCount)
+{
+	FILE *fp = nullptr;
+	fopen_s( &fp, filename, "wb" );
+
+	if (fp == nullptr) {
+		return false;
+	}
+
+	size_t written = byteCount > 0U ? fwrite( data, 1, byteCount, fp ) : 0U;
+	fclose(fp);
+
+	return written == byteCount;
+}
+
+bool FileExists(const char* filename)
+{
+	FILE *fp = nullptr;
+	fopen_s( &fp, filename, "rb" );
+
+	if (fp == nullptr) {
+		return false;
+	}
+
+	fclose(fp);
+	return true;
+}
+
+bool GetFileStamp(const char* filename, uint64_t* out_size, int64_t* out_modifiedTime)
+{
+	struct _stat64 info;
+	if (_stat64(filename, &info) != 0) {
+		return false;
+	}
+
+	*out_size = (uint64_t) info.st_size;
+	*out_modifiedTime = (int64_t) info.st_mtime;
+	return true;
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+bool MappedFile::Open(const char* filename)
+{
+	Close();
+
+	HANDLE file = ::CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	m_file = file;
+
+	LARGE_INTEGER size;
+	if (!::GetFileSizeEx(file, &size)) {
+		Close();
+		return false;
+	}
+
+	//empty files can't be mapped, still opened though
+	if (size.QuadPart == 0) {
+		return true;
+	}
+
+	m_mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (m_mapping == nullptr) {
+		Close();
+		return false;
+	}
+
+	m_data = (const unsigned char*) ::MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+	if (m_data == nullptr) {
+		Close();
+		return false;
+	}
+
+	m_size = (size_t) size.QuadPart;
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (m_data != nullptr)
+		::UnmapViewOfFile(m_data);
+	if (m_mapping != nullptr)
+		::CloseHandle(m_mapping);
+	if (m_file != nullptr)
+		::CloseHandle(m_file);
+
+	m_data = nullptr;
+	m_mapping = nullptr;
+	m_file = nullptr;
+	m_size = 0;
+}
@@ -1,6 +1,38 @@
 #pragma once
 
+#include <stdint.h>
 #include <string>
+#include <vector>
 
 void* FileReadToNewBuffer(const char* filename);
 bool WriteStringToFile(const char* filename, std::string data);
+
+// whole file as raw bytes, no text mode translation
+bool ReadBinaryFile(const char* filename, std::vector<unsigned char>* out_bytes);
+bool WriteBinaryFile(const char* filename, const void* data, size_t byteCount);
+bool FileExists(const char* filename);
+bool GetFileStamp(const char* filename, uint64_t* out_size, int64_t* out_modifiedTime); // to tell when a cooked file is out of date
+
+// Read only view of a whole file, mapped instead of read so big files cost no copy
+class MappedFile
+{
+public:
+	~MappedFile();
+	MappedFile() {}
+
+	bool Open(const char* filename);
+	void Close();
+
+	inline const unsigned char* GetData() const { return m_data; }
+	inline size_t GetSize() const { return m_size; }
+
+private:
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+private:
+	void* m_file = nullptr;
+	void* m_mapping = nullptr;
+	const unsigned char* m_data = nullptr;
+	size_t m_size = 0;
+};
@@ -0,0 +1,473 @@
+#include "Engine/Input/InputReplay.hpp"
+#include "Engine/Input/InputSystem.hpp"
+#include "Engine/Core/Clock.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/File/File.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include <algorithm>
+#include <string.h>
+#include <vector>
+
+// File layout (little endian):
+//   header  ReplayHeader below
+//   frames  elapsed hpc (uint32)
+//           changed key count (uint16), then (key, state bits) byte pairs
+//           changed mouse button count (uint8), then (button, state bits) byte pairs
+//           mouse bits (uint8), then position, delta and wheel floats for the bits set
+// Key and button states are only written when they differ from the frame before,
+// so a frame with nobody touching anything is 8 bytes.
+
+static const char REPLAY_MAGIC[4] = { 'T', 'W', 'R', 'P' };
+static const unsigned short REPLAY_VERSION = 1;
+
+enum REPLAY_BUTTON_BITS : unsigned char
+{
+	REPLAY_BUTTON_DOWN = 1 << 0,
+	REPLAY_BUTTON_JUST_PRESSED = 1 << 1,
+	REPLAY_BUTTON_JUST_RELEASED = 1 << 2,
+};
+
+enum REPLAY_MOUSE_BITS : unsigned char
+{
+	REPLAY_MOUSE_POSITION = 1 << 0,
+	REPLAY_MOUSE_DELTA = 1 << 1,
+	REPLAY_MOUSE_WHEEL = 1 << 2,
+};
+
+struct ReplayHeader
+{
+	char magic[4];
+	unsigned short version;
+	unsigned short reserved;
+	unsigned int seed;
+	float fixedStepRate;
+	uint64_t hpcPerSecond;
+	unsigned int frameCount;
+	unsigned int fixedStepCount;
+};
+static_assert(sizeof(ReplayHeader) == 32, "ReplayHeader is written as is, keep it free of padding");
+
+struct InputReplay
+{
+	INPUT_REPLAY_MODE mode = INPUT_REPLAY_MODE::OFF;
+	std::string path;
+	bool headless = false;
+	bool hasFailed = false;
+	InputSystem* input = nullptr;
+	Clock* stepClock = nullptr;
+
+	ReplayHeader header;
+	std::vector<unsigned char> bytes;
+	size_t readOffset = 0;
+	unsigned int frameIndex = 0;
+
+	//state as of the last frame written or read, changes are relative to this
+	unsigned char keyBits[InputSystem::NUM_KEYS];
+	unsigned char mouseButtonBits[InputSystem::NUM_MOUSE_BUTTONS];
+	Vector2 mousePosition;
+
+	//playback profile
+	uint64_t lastFrameHPC = 0;
+	unsigned int lastFixedStepCount = 0;
+	std::vector<float> frameMs;
+	std::vector<unsigned int> frameSteps;
+};
+
+static InputReplay* g_inputReplay = nullptr;
+
+//------------------------------------------------------------------------
+static unsigned char PackButtonState(const KeyButtonState& state)
+{
+	unsigned char bits = 0;
+	bits |= state.isDown ? REPLAY_BUTTON_DOWN : 0;
+	bits |= state.justPressed ? REPLAY_BUTTON_JUST_PRESSED : 0;
+	bits |= state.justReleased ? REPLAY_BUTTON_JUST_RELEASED : 0;
+	return bits;
+}
+
+static KeyButtonState UnpackButtonState(unsigned char bits)
+{
+	KeyButtonState state;
+	state.isDown = (bits & REPLAY_BUTTON_DOWN) != 0;
+	state.justPressed = (bits & REPLAY_BUTTON_JUST_PRESSED) != 0;
+	state.justReleased = (bits & REPLAY_BUTTON_JUST_RELEASED) != 0;
+	return state;
+}
+
+template<typename T>
+static void Write(std::vector<unsigned char>& bytes, const T& value)
+{
+	const unsigned char* data = (const unsigned char*) &value;
+	bytes.insert(bytes.end(), data, data + sizeof(T));
+}
+
+template<typename T>
+static bool Read(InputReplay& replay, T* out_value)
+{
+	if (replay.readOffset + sizeof(T) > replay.bytes.size())
+		return false;
+
+	memcpy(out_value, replay.bytes.data() + replay.readOffset, sizeof(T));
+	replay.readOffset += sizeof(T);
+	return true;
+}
+
+static void ResetTrackedState(InputReplay& replay)
+{
+	memset(replay.keyBits, 0, sizeof(replay.keyBits));
+	memset(replay.mouseButtonBits, 0, sizeof(replay.mouseButtonBits));
+	replay.mousePosition = replay.input->GetMousePosition();
+}
+
+//------------------------------------------------------------------------
+static void WriteFrame(InputReplay& replay, uint64_t elapsed)
+{
+	InputSystem* input = replay.input;
+	std::vector<unsigned char>& bytes = replay.bytes;
+
+	Write(bytes, (unsigned int) std::min<uint64_t>(elapsed, 0xffffffff));
+
+	//count goes in first, patch it once the changes are written
+	size_t countOffset = bytes.size();
+	unsigned short keyCount = 0;
+	Write(bytes, keyCount);
+	for (int keyCode = 0; keyCode < InputSystem::NUM_KEYS; ++keyCode)
+	{
+		unsigned char bits = PackButtonState(input->GetKeyState(keyCode));
+		if (bits != replay.keyBits[keyCode])
+		{
+			replay.keyBits[keyCode] = bits;
+			Write(bytes, (unsigned char) keyCode);
+			Write(bytes, bits);
+			keyCount++;
+		}
+	}
+	memcpy(bytes.data() + countOffset, &keyCount, sizeof(keyCount));
+
+	countOffset = bytes.size();
+	unsigned char buttonCount = 0;
+	Write(bytes, buttonCount);
+	for (int button = 0; button < InputSystem::NUM_MOUSE_BUTTONS; ++button)
+	{
+		unsigned char bits = PackButtonState(input->GetMouseButtonState(button));
+		if (bits != replay.mouseButtonBits[button])
+		{
+			replay.mouseButtonBits[button] = bits;
+			Write(bytes, (unsigned char) button);
+			Write(bytes, bits);
+			buttonCount++;
+		}
+	}
+	bytes[countOffset] = buttonCount;
+
+	Vector2 position = input->GetMousePosition();
+	Vector2 delta = input->GetMouseDelta();
+	unsigned char mouseBits = 0;
+	mouseBits |= position != replay.mousePosition ? REPLAY_MOUSE_POSITION : 0;
+	mouseBits |= delta != Vector2::zero ? REPLAY_MOUSE_DELTA : 0;
+	mouseBits |= input->m_wheelDelta != 0.f ? REPLAY_MOUSE_WHEEL : 0;
+	Write(bytes, mouseBits);
+	if (mouseBits & REPLAY_MOUSE_POSITION)
+	{
+		Write(bytes, position.x);
+		Write(bytes, position.y);
+		replay.mousePosition = position;
+	}
+	if (mouseBits & REPLAY_MOUSE_DELTA)
+	{
+		Write(bytes, delta.x);
+		Write(bytes, delta.y);
+	}
+	if (mouseBits & REPLAY_MOUSE_WHEEL)
+	{
+		Write(bytes, input->m_wheelDelta);
+	}
+
+	replay.header.frameCount++;
+}
+
+static bool ReadFrame(InputReplay& replay, uint64_t* out_elapsed)
+{
+	InputSystem* input = replay.input;
+
+	unsigned int elapsed = 0;
+	if (!Read(replay, &elapsed))
+		return false;
+
+	//recorded on a machine with another counter frequency, go through seconds
+	uint64_t hpcPerSecond = ConvertSecondsToPerformanceCounter(1.f);
+	if (hpcPerSecond == replay.header.hpcPerSecond)
+		*out_elapsed = elapsed;
+	else
+		*out_elapsed = (uint64_t) ((double) elapsed * (double) hpcPerSecond / (double) replay.header.hpcPerSecond);
+
+	unsigned short keyCount = 0;
+	if (!Read(replay, &keyCount))
+		return false;
+	for (unsigned short change = 0; change < keyCount; ++change)
+	{
+		unsigned char keyCode = 0;
+		unsigned char bits = 0;
+		if (!Read(replay, &keyCode) || !Read(replay, &bits))
+			return false;
+		replay.keyBits[keyCode] = bits;
+	}
+
+	unsigned char buttonCount = 0;
+	if (!Read(replay, &buttonCount))
+		return false;
+	for (unsigned char change = 0; change < buttonCount; ++change)
+	{
+		unsigned char button = 0;
+		unsigned char bits = 0;
+		if (!Read(replay, &button) || !Read(replay, &bits) || button >= InputSystem::NUM_MOUSE_BUTTONS)
+			return false;
+		replay.mouseButtonBits[button] = bits;
+	}
+
+	unsigned char mouseBits = 0;
+	Vector2 delta = Vector2::zero;
+	float wheel = 0.f;
+	if (!Read(replay, &mouseBits))
+		return false;
+	if ((mouseBits & REPLAY_MOUSE_POSITION) && !(Read(replay, &replay.mousePosition.x) && Read(replay, &replay.mousePosition.y)))
+		return false;
+	if ((mouseBits & REPLAY_MOUSE_DELTA) && !(Read(replay, &delta.x) && Read(replay, &delta.y)))
+		return false;
+	if ((mouseBits & REPLAY_MOUSE_WHEEL) && !Read(replay, &wheel))
+		return false;
+
+	//every key, not just the changes: live input still arrives and must not leak in
+	for (int keyCode = 0; keyCode < InputSystem::NUM_KEYS; ++keyCode)
+		input->SetKeyState(keyCode, UnpackButtonState(replay.keyBits[keyCode]));
+	for (int button = 0; button < InputSystem::NUM_MOUSE_BUTTONS; ++button)
+		input->SetMouseButtonState(button, UnpackButtonState(replay.mouseButtonBits[button]));
+	input->SetMouseFrame(replay.mousePosition, delta);
+	input->m_wheelDelta = wheel;
+
+	return true;
+}
+
+// A warning dialog would stall a headless run until someone clicks it, so those log and fail the run instead
+static void ReportReplayError(InputReplay& replay, const std::string& message)
+{
+	if (replay.headless)
+	{
+		DebuggerPrintf("%s\n", message.c_str());
+		replay.hasFailed = true;
+		return;
+	}
+
+	ERROR_RECOVERABLE(message);
+}
+
+static void ReportPlayback(InputReplay& replay)
+{
+	unsigned int fixedSteps = replay.stepClock->GetFixedStepCount();
+	bool matches = fixedSteps == replay.header.fixedStepCount;
+
+	std::vector<float> sortedMs = replay.frameMs;
+	std::sort(sortedMs.begin(), sortedMs.end());
+
+	double totalMs = 0.0;
+	for (float ms : sortedMs)
+		totalMs += ms;
+
+	size_t count = sortedMs.size();
+	float averageMs = count > 0 ? (float) (totalMs / (double) count) : 0.f;
+	float medianMs = count > 0 ? sortedMs[count / 2] : 0.f;
+	float p99Ms = count > 0 ? sortedMs[std::min(count - 1, (count * 99) / 100)] : 0.f;
+	float maxMs = count > 0 ? sortedMs.back() : 0.f;
+
+	std::string summary = Stringf("%s: %u frames, %u fixed steps (recorded %u, %s), frame ms avg %.3f median %.3f p99 %.3f max %.3f",
+		replay.path.c_str(), replay.header.frameCount, fixedSteps, replay.header.fixedStepCount, matches ? "match" : "DESYNC",
+		averageMs, medianMs, p99Ms, maxMs);
+
+	ConsolePrintf(matches ? Rgba::green : Rgba::red, "%s", summary.c_str());
+	DebuggerPrintf("%s\n", summary.c_str());
+
+	//one line per frame after the summary: frame, ms, fixed steps taken
+	std::string profile = summary + "\n";
+	for (size_t frame = 0; frame < replay.frameMs.size(); ++frame)
+		profile += Stringf("%u %.4f %u\n", (unsigned int) frame, replay.frameMs[frame], replay.frameSteps[frame]);
+
+	if (!WriteStringToFile((replay.path + ".frametimes.txt").c_str(), profile))
+		ReportReplayError(replay, "Couldn't write replay frame times for " + replay.path);
+}
+
+//------------------------------------------------------------------------
+bool StartInputRecording(const std::string& path, InputSystem* input, Clock* stepClock)
+{
+	ASSERT_OR_DIE(g_inputReplay == nullptr, "A replay is already running");
+
+	InputReplay* replay = new InputReplay();
+	replay->mode = INPUT_REPLAY_MODE::RECORDING;
+	replay->path = path;
+	replay->input = input;
+	replay->stepClock = stepClock;
+
+	//reseed with the base seed, so playback starts the random numbers in the same place
+	unsigned int seed = GetRandomSeed();
+	SetRandomSeed(seed);
+
+	memset(&replay->header, 0, sizeof(replay->header));
+	memcpy(replay->header.magic, REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+	replay->header.version = REPLAY_VERSION;
+	replay->header.seed = seed;
+	replay->header.fixedStepRate = stepClock->GetFixedStepRate();
+	replay->header.hpcPerSecond = ConvertSecondsToPerformanceCounter(1.f);
+	replay->bytes.reserve(64 * 1024);
+	Write(replay->bytes, replay->header);
+
+	stepClock->Reset();
+	ResetTrackedState(*replay);
+	replay->lastFrameHPC = GetPerformanceCounter();
+
+	g_inputReplay = replay;
+	return true;
+}
+
+bool StartInputPlayback(const std::string& path, InputSystem* input, Clock* stepClock, bool headless)
+{
+	ASSERT_OR_DIE(g_inputReplay == nullptr, "A replay is already running");
+
+	InputReplay* replay = new InputReplay();
+	replay->path = path;
+	replay->input = input;
+	replay->stepClock = stepClock;
+	replay->headless = headless;
+
+	if (!ReadBinaryFile(path.c_str(), &replay->bytes)
+		|| !Read(*replay, &replay->header)
+		|| memcmp(replay->header.magic, REPLAY_MAGIC, sizeof(REPLAY_MAGIC)) != 0
+		|| replay->header.version != REPLAY_VERSION)
+	{
+		ReportReplayError(*replay, "Couldn't load replay " + path);
+		if (!headless)
+		{
+			delete replay;
+			return false;
+		}
+
+		//kept around finished, so the app quits after the first frame with the failure
+		replay->mode = INPUT_REPLAY_MODE::FINISHED;
+		g_inputReplay = replay;
+		return false;
+	}
+
+	replay->mode = INPUT_REPLAY_MODE::PLAYING;
+	SetRandomSeed(replay->header.seed);
+	stepClock->SetFixedStepRate(replay->header.fixedStepRate);
+	stepClock->Reset();
+	ResetTrackedState(*replay);
+	replay->frameMs.reserve(replay->header.frameCount);
+	replay->frameSteps.reserve(replay->header.frameCount);
+	replay->lastFrameHPC = GetPerformanceCounter();
+
+	g_inputReplay = replay;
+	return true;
+}
+
+void StopInputReplay()
+{
+	InputReplay* replay = g_inputReplay;
+	if (replay == nullptr)
+		return;
+
+	if (replay->mode == INPUT_REPLAY_MODE::RECORDING)
+	{
+		replay->header.fixedStepCount = replay->stepClock->GetFixedStepCount();
+		memcpy(replay->bytes.data(), &replay->header, sizeof(replay->header));
+
+		if (!WriteBinaryFile(replay->path.c_str(), replay->bytes.data(), replay->bytes.size()))
+			ReportReplayError(*replay, "Couldn't write replay " + replay->path);
+	}
+	else if (replay->mode == INPUT_REPLAY_MODE::PLAYING)
+	{
+		ReportPlayback(*replay);
+	}
+
+	replay->mode = INPUT_REPLAY_MODE::FINISHED;
+}
+
+void InputReplayBeginFrame()
+{
+	InputReplay& replay = *g_inputReplay;
+
+	uint64_t currentHPC = GetPerformanceCounter();
+	uint64_t wallElapsed = currentHPC - replay.lastFrameHPC;
+	replay.lastFrameHPC = currentHPC;
+
+	if (replay.mode == INPUT_REPLAY_MODE::RECORDING)
+	{
+		ClockSystemBeginFrame(wallElapsed);
+		replay.input->BeginFrame();
+		WriteFrame(replay, wallElapsed);
+		return;
+	}
+
+	ASSERT_OR_DIE(replay.mode == INPUT_REPLAY_MODE::PLAYING, "No replay running");
+
+	//profile the frame that just finished
+	if (replay.frameIndex > 0)
+	{
+		unsigned int fixedSteps = replay.stepClock->GetFixedStepCount();
+		replay.frameMs.push_back((float) (PerformanceCounterToSeconds(wallElapsed) * 1000.0));
+		replay.frameSteps.push_back(fixedSteps - replay.lastFixedStepCount);
+		replay.lastFixedStepCount = fixedSteps;
+	}
+
+	uint64_t elapsed = 0;
+	bool hasFrame = replay.frameIndex < replay.header.frameCount;
+	replay.input->BeginFrame(); //still pump messages, so the window stays responsive
+	if (hasFrame && !ReadFrame(replay, &elapsed))
+	{
+		ReportReplayError(replay, "Replay " + replay.path + " is cut short");
+		hasFrame = false;
+	}
+
+	if (!hasFrame)
+	{
+		//back to live input, with nothing left held down
+		StopInputReplay();
+		for (int keyCode = 0; keyCode < InputSystem::NUM_KEYS; ++keyCode)
+			replay.input->SetKeyState(keyCode, KeyButtonState());
+		for (int button = 0; button < InputSystem::NUM_MOUSE_BUTTONS; ++button)
+			replay.input->SetMouseButtonState(button, KeyButtonState());
+		ClockSystemBeginFrame();
+		return;
+	}
+
+	ClockSystemBeginFrame(elapsed);
+	replay.frameIndex++;
+}
+
+INPUT_REPLAY_MODE GetInputReplayMode()
+{
+	return g_inputReplay != nullptr ? g_inputReplay->mode : INPUT_REPLAY_MODE::OFF;
+}
+
+bool IsInputReplayActive()
+{
+	INPUT_REPLAY_MODE mode = GetInputReplayMode();
+	return mode == INPUT_REPLAY_MODE::RECORDING || mode == INPUT_REPLAY_MODE::PLAYING;
+}
+
+bool IsInputReplayHeadless()
+{
+	return g_inputReplay != nullptr && g_inputReplay->headless;
+}
+
+bool HasInputReplayFailed()
+{
+	return g_inputReplay != nullptr && g_inputReplay->hasFailed;
+}
+
+void InputReplayShutdown()
+{
+	StopInputReplay();
+	delete g_inputReplay;
+	g_inputReplay = nullptr;
+}
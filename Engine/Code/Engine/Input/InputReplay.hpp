@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+
+class InputSystem;
+class Clock;
+
+// Records a session's input to a compact binary file, or plays one back in place of live input.
+// A recording holds the random seed, the simulation's fixed step rate and every frame's time,
+// keys, mouse buttons and mouse movement. Playback advances the clocks by the recorded frame
+// times, so the simulation takes the same fixed steps on the same input and the session
+// plays out the same way, whatever the frames cost this time around.
+//
+// Start either one before the first frame: a replay only matches from the same starting state
+// (same config, same data). Dev console typing and controllers aren't recorded.
+//
+// Playback keeps a frame time profile and writes it next to the file when it finishes
+// (<path>.frametimes.txt), along with whether the fixed step count still matches the recording.
+// Headless playback is for runs nobody watches: the app skips rendering and quits at the end.
+// Errors there are logged instead of raising a dialog, and the app exits with a non-zero code.
+enum class INPUT_REPLAY_MODE
+{
+	OFF,
+	RECORDING,
+	PLAYING,
+	FINISHED,
+};
+
+// stepClock is the clock the simulation takes its fixed steps on
+bool StartInputRecording(const std::string& path, InputSystem* input, Clock* stepClock);
+bool StartInputPlayback(const std::string& path, InputSystem* input, Clock* stepClock, bool headless = false);
+void StopInputReplay(); // writes a recording out, reports a playback
+
+// in place of ClockSystemBeginFrame and InputSystem::BeginFrame while a replay is active
+void InputReplayBeginFrame();
+
+INPUT_REPLAY_MODE GetInputReplayMode();
+bool IsInputReplayActive(); // recording or playing
+bool IsInputReplayHeadless();
+bool HasInputReplayFailed(); // a headless replay couldn't load, read or write its files
+
+void InputReplayShutdown();
@@ -168,6 +168,12 @@ Vector2 InputSystem::GetMousePosition() const
 	return m_positionThisFrame;
 }
 
+void InputSystem::SetMouseFrame(const Vector2& position, const Vector2& delta)
+{
+	m_positionThisFrame = position;
+	m_positionLastFrame = position - delta;
+}
+
 void InputSystem::SetMousePosition(Vector2 clientPos)
 {
 	HWND hwnd = (HWND) Window::GetInstance()->GetHandle();
@@ -163,6 +163,13 @@ public:
 	//only DevConsole should call this directly...
 	void UpdateKeyboard();
 
+	//replays (InputReplay.hpp) read this frame's state and overwrite it with a recorded one
+	inline const KeyButtonState& GetKeyState(int keyCode) const { return m_keyStates[keyCode]; }
+	inline const KeyButtonState& GetMouseButtonState(int button) const { return m_mouseButtonStates[button]; }
+	inline void SetKeyState(int keyCode, const KeyButtonState& state) { m_keyStates[keyCode] = state; }
+	inline void SetMouseButtonState(int button, const KeyButtonState& state) { m_mouseButtonStates[button] = state; }
+	void SetMouseFrame(const Vector2& position, const Vector2& delta);
+
 public:
 	static const int NUM_KEYS = 256;
 	static const int NUM_CONTROLLERS = 4;
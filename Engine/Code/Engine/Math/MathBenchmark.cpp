@@ -0,0 +1,314 @@
+#include "Engine/Math/MathBenchmark.hpp"
+#include "Engine/Math/MatrixSIMD.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Engine/Math/NoiseSIMD.hpp"
+#include "Engine/Math/Vector4.hpp"
+#include "Engine/ThirdParty/SquirrelNoise/SmoothNoise.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/Time.hpp"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+constexpr float SIMD_MATRIX_TOLERANCE = 0.0001f; //relative, values are clamped to 1 first
+
+static float GetRelativeError(const float* a, const float* b, int count)
+{
+	float worst = 0.f;
+	for (int i = 0; i < count; i++)
+	{
+		float magnitude = fabsf(a[i]) > 1.f ? fabsf(a[i]) : 1.f;
+		float error = fabsf(a[i] - b[i]) / magnitude;
+		if (error > worst)
+			worst = error;
+	}
+
+	return worst;
+}
+
+// Rotation, non uniform scale and translation, so every inverse is well conditioned
+static Matrix44 MakeRandomTransform(bool orthonormal)
+{
+	const float pi = MathUtils::PI;
+	Matrix44 result = Matrix44::MakeFromEuler(Vector3(GetRandomFloatInRange(-pi, pi), GetRandomFloatInRange(-pi, pi), GetRandomFloatInRange(-pi, pi)));
+	if (!orthonormal)
+		result.AppendScalar(Matrix44::MakeScale(GetRandomFloatInRange(0.5f, 2.f), GetRandomFloatInRange(0.5f, 2.f), GetRandomFloatInRange(0.5f, 2.f)));
+
+	result.SetTranslation(RandomPointInCube(100.f));
+	return result;
+}
+
+template <typename FUNC>
+static double TimeSeconds(FUNC func)
+{
+	uint64_t start = GetPerformanceCounter();
+	func();
+	return PerformanceCounterToSeconds(GetPerformanceCounter() - start);
+}
+
+static void PrintMatrixResult(const char* name, float error, double scalarTime, double simdTime, int count)
+{
+	ConsolePrintf("  %-16s %s  max error %.2e  scalar %7.2f ns  simd %7.2f ns  (%.2fx)", name, error <= SIMD_MATRIX_TOLERANCE ? "ok  " : "FAIL",
+		error, scalarTime * 1000000000.0 / count, simdTime * 1000000000.0 / count, scalarTime / simdTime);
+}
+
+void RegisterMathBenchmarkCommands()
+{
+	CommandRegister("bench_matrix", BenchmarkMatrix, "Checks the SIMD Matrix44 kernels against the scalar code and times both. Option: matrix count");
+	CommandRegister("bench_random", BenchmarkRandom, "Times rand() against RandomNumberGenerator, single draws and bulk fills. Option: number count");
+	CommandRegister("bench_noise", BenchmarkNoise, "Checks the SIMD noise grid fills are bit identical to SquirrelNoise and times them. Option: grid size");
+	CommandRegister("bench_noise_types", BenchmarkNoiseTypes, "Times fractal, Perlin and simplex noise in 2D/3D/4D and prints their value statistics. Option: sample count");
+}
+
+void BenchmarkMatrix(Command& cmd)
+{
+	int count = 10000;
+	cmd.GetNextInt(&count);
+	count = MaxInt(count, 1);
+
+	std::vector<Matrix44> a(count);
+	std::vector<Matrix44> b(count);
+	std::vector<Matrix44> rigid(count);
+	std::vector<Vector3> points(count);
+	std::vector<Matrix44> scalarResults(count);
+	std::vector<Matrix44> simdResults(count);
+	std::vector<Vector3> scalarPoints(count);
+	std::vector<Vector3> simdPoints(count);
+
+	for (int i = 0; i < count; i++)
+	{
+		a[i] = MakeRandomTransform(false);
+		b[i] = MakeRandomTransform(false);
+		rigid[i] = MakeRandomTransform(true);
+		points[i] = RandomPointInCube(100.f);
+	}
+
+	ConsolePrintf("bench_matrix: %d matrices, tolerance %.0e", count, SIMD_MATRIX_TOLERANCE);
+
+	//multiply
+	double scalarTime = TimeSeconds([&]() {
+		for (int i = 0; i < count; i++)
+		{
+			scalarResults[i] = a[i];
+			scalarResults[i].AppendScalar(b[i]);
+		}
+	});
+	double simdTime = TimeSeconds([&]() { MultiplyMatrices(a.data(), b.data(), simdResults.data(), (uint) count); });
+	PrintMatrixResult("multiply", GetRelativeError(&scalarResults[0].Ix, &simdResults[0].Ix, count * 16), scalarTime, simdTime, count);
+
+	//general inverse
+	scalarTime = TimeSeconds([&]() {
+		for (int i = 0; i < count; i++)
+			scalarResults[i] = Matrix44::MakeInverseScalar(a[i]);
+	});
+	simdTime = TimeSeconds([&]() {
+		for (int i = 0; i < count; i++)
+			MatrixInverseSIMD(&simdResults[i], a[i]);
+	});
+	PrintMatrixResult("inverse", GetRelativeError(&scalarResults[0].Ix, &simdResults[0].Ix, count * 16), scalarTime, simdTime, count);
+
+	//orthonormal inverse
+	scalarTime = TimeSeconds([&]() {
+		for (int i = 0; i < count; i++)
+			scalarResults[i] = Matrix44::MakeInverseFastScalar(rigid[i]);
+	});
+	simdTime = TimeSeconds([&]() {
+		for (int i = 0; i < count; i++)
+			MatrixInverseOrthonormalSIMD(&simdResults[i], rigid[i]);
+	});
+	PrintMatrixResult("inverse fast", GetRelativeError(&scalarResults[0].Ix, &simdResults[0].Ix, count * 16), scalarTime, simdTime, count);
+
+	//points through one matrix
+	const Matrix44& mat = a[0];
+	scalarTime = TimeSeconds([&]() {
+		for (int i = 0; i < count; i++)
+		{
+			const Vector3& p = points[i];
+			scalarPoints[i] = Vector3((p.x * mat.Ix) + (p.y * mat.Jx) + (p.z * mat.Kx) + mat.Tx,
+				(p.x * mat.Iy) + (p.y * mat.Jy) + (p.z * mat.Ky) + mat.Ty,
+				(p.x * mat.Iz) + (p.y * mat.Jz) + (p.z * mat.Kz) + mat.Tz);
+		}
+	});
+	simdTime = TimeSeconds([&]() { TransformPositions(mat, points.data(), simdPoints.data(), (uint) count); });
+	PrintMatrixResult("transform points", GetRelativeError(&scalarPoints[0].x, &simdPoints[0].x, count * 3), scalarTime, simdTime, count);
+}
+
+void BenchmarkRandom(Command& cmd)
+{
+	int count = 1000000;
+	cmd.GetNextInt(&count);
+	count = MaxInt(count, 1);
+
+	std::vector<float> floats(count);
+	std::vector<Vector3> points(count);
+	RandomNumberGenerator random(GetRandomSeed());
+
+	double randTime = TimeSeconds([&]() {
+		for (int i = 0; i < count; i++)
+			floats[i] = -1.f + ((float) rand() / ((float) RAND_MAX / 2.f));
+	});
+	double singleTime = TimeSeconds([&]() {
+		for (int i = 0; i < count; i++)
+			floats[i] = random.GetRandomFloatInRange(-1.f, 1.f);
+	});
+	double threadTime = TimeSeconds([&]() {
+		for (int i = 0; i < count; i++)
+			floats[i] = GetRandomFloatInRange(-1.f, 1.f);
+	});
+	double bulkTime = TimeSeconds([&]() { random.FillRandomFloatsInRange(floats.data(), (uint) count, -1.f, 1.f); });
+	double sphereTime = TimeSeconds([&]() { random.FillRandomPointsOnSphere(points.data(), (uint) count); });
+
+	//sanity check the distribution, the mean of uniform [-1,1) should sit near 0
+	double sum = 0.0;
+	for (int i = 0; i < count; i++)
+		sum += floats[i];
+
+	double toNs = 1000000000.0 / count;
+	ConsolePrintf("bench_random: %d numbers, seed %u", count, GetRandomSeed());
+	ConsolePrintf("  rand()                     %6.2f ns", randTime * toNs);
+	ConsolePrintf("  RandomNumberGenerator      %6.2f ns (%.2fx rand)", singleTime * toNs, randTime / singleTime);
+	ConsolePrintf("  GetRandomFloatInRange      %6.2f ns (thread generator)", threadTime * toNs);
+	ConsolePrintf("  FillRandomFloatsInRange    %6.2f ns (%.2fx rand)", bulkTime * toNs, randTime / bulkTime);
+	ConsolePrintf("  FillRandomPointsOnSphere   %6.2f ns", sphereTime * toNs);
+	ConsolePrintf("  bulk mean %.5f", sum / count);
+}
+
+static int CountMismatches(const float* a, const float* b, int count)
+{
+	int mismatches = 0;
+	for (int i = 0; i < count; i++)
+	{
+		if (memcmp(&a[i], &b[i], sizeof(float)) != 0)
+			mismatches++;
+	}
+
+	return mismatches;
+}
+
+void BenchmarkNoise(Command& cmd)
+{
+	int size = 256;
+	cmd.GetNextInt(&size);
+	size = MaxInt(size, 1);
+
+	const int count = size * size;
+	const Vector2 origin = Vector2(-37.3f, 12.9f); //negative and positive cells both get covered
+	const Vector2 step = Vector2(0.37f, 0.41f);
+	const float scale = 20.f;
+	const uint octaves = 4;
+	const uint seed = GetRandomSeed();
+
+	std::vector<float> scalarResults(count);
+	std::vector<float> simdResults(count);
+	eNoiseSIMDLevel previousLevel = GetNoiseSIMDLevel();
+	const char* levelNames[] = { "scalar", "sse2", "avx2" };
+
+	ConsolePrintf("bench_noise: %dx%d grid, %u octaves, best level %s", size, size, octaves, levelNames[previousLevel]);
+
+	for (int pass = 0; pass < 2; pass++)
+	{
+		bool isPerlin = pass == 0;
+		auto fill = [&](float* out) {
+			if (isPerlin)
+				Fill2dPerlinNoise(out, size, size, origin, step, scale, octaves, 0.5f, 2.f, true, seed);
+			else
+				Fill2dFractalNoise(out, size, size, origin, step, scale, octaves, 0.5f, 2.f, true, seed);
+		};
+
+		SetNoiseSIMDLevel(NOISE_SIMD_NONE);
+		double scalarTime = TimeSeconds([&]() { fill(scalarResults.data()); });
+
+		for (int level = NOISE_SIMD_SSE2; level <= NOISE_SIMD_AVX2; level++)
+		{
+			SetNoiseSIMDLevel((eNoiseSIMDLevel) level);
+			if (GetNoiseSIMDLevel() != level)
+				continue;
+
+			memset(simdResults.data(), 0, count * sizeof(float));
+			double simdTime = TimeSeconds([&]() { fill(simdResults.data()); });
+			int mismatches = CountMismatches(scalarResults.data(), simdResults.data(), count);
+
+			ConsolePrintf("  %-7s %s %s  %d mismatches  scalar %6.1f Msamples/s  simd %6.1f Msamples/s  (%.2fx)", isPerlin ? "perlin" : "fractal", levelNames[level],
+				mismatches == 0 ? "ok  " : "FAIL", mismatches, count / scalarTime / 1000000.0, count / simdTime / 1000000.0, scalarTime / simdTime);
+		}
+	}
+
+	SetNoiseSIMDLevel(previousLevel);
+}
+
+struct noise_type_t
+{
+	const char* name;
+	float (*function)(const Vector4& pos, unsigned int seed); // one octave, not renormalized
+};
+
+static const noise_type_t NOISE_TYPES[] =
+{
+	{ "2d fractal", [](const Vector4& pos, unsigned int seed) { return Compute2dFractalNoise(pos.x, pos.y, 1.f, 1, 0.5f, 2.f, false, seed); } },
+	{ "2d perlin", [](const Vector4& pos, unsigned int seed) { return Compute2dPerlinNoise(pos.x, pos.y, 1.f, 1, 0.5f, 2.f, false, seed); } },
+	{ "2d simplex", [](const Vector4& pos, unsigned int seed) { return Compute2dSimplexNoise(pos.x, pos.y, 1.f, 1, 0.5f, 2.f, false, seed); } },
+	{ "3d fractal", [](const Vector4& pos, unsigned int seed) { return Compute3dFractalNoise(pos.x, pos.y, pos.z, 1.f, 1, 0.5f, 2.f, false, seed); } },
+	{ "3d perlin", [](const Vector4& pos, unsigned int seed) { return Compute3dPerlinNoise(pos.x, pos.y, pos.z, 1.f, 1, 0.5f, 2.f, false, seed); } },
+	{ "3d simplex", [](const Vector4& pos, unsigned int seed) { return Compute3dSimplexNoise(pos.x, pos.y, pos.z, 1.f, 1, 0.5f, 2.f, false, seed); } },
+	{ "4d perlin", [](const Vector4& pos, unsigned int seed) { return Compute4dPerlinNoise(pos.x, pos.y, pos.z, pos.w, 1.f, 1, 0.5f, 2.f, false, seed); } },
+	{ "4d simplex", [](const Vector4& pos, unsigned int seed) { return Compute4dSimplexNoise(pos.x, pos.y, pos.z, pos.w, 1.f, 1, 0.5f, 2.f, false, seed); } },
+};
+
+void BenchmarkNoiseTypes(Command& cmd)
+{
+	int count = 200000;
+	cmd.GetNextInt(&count);
+	count = MaxInt(count, 1);
+
+	const float delta = 0.05f; //for the axial bias, much smaller than a noise cell
+	const unsigned int seed = GetRandomSeed();
+	RandomNumberGenerator random(seed);
+	std::vector<Vector4> positions(count);
+	for (int i = 0; i < count; i++)
+		positions[i] = Vector4(random.RandomPointInCube(100.f), random.GetRandomFloatInRange(-100.f, 100.f));
+
+	std::vector<float> values(count);
+	ConsolePrintf("bench_noise_types: %d samples, 1 octave, seed %u", count, seed);
+	ConsolePrintf("  %-11s %8s %7s %7s %7s %7s %6s", "", "ns", "min", "max", "mean", "stddev", "axial");
+
+	for (const noise_type_t& type : NOISE_TYPES)
+	{
+		double time = TimeSeconds([&]() {
+			for (int i = 0; i < count; i++)
+				values[i] = type.function(positions[i], seed);
+		});
+
+		float minValue = values[0];
+		float maxValue = values[0];
+		double sum = 0.0;
+		double sumSquared = 0.0;
+		for (int i = 0; i < count; i++)
+		{
+			minValue = MinFloat(minValue, values[i]);
+			maxValue = MaxFloat(maxValue, values[i]);
+			sum += values[i];
+			sumSquared += values[i] * values[i];
+		}
+
+		double mean = sum / count;
+		double variance = (sumSquared / count) - (mean * mean);
+		double stddev = variance > 0.0 ? sqrt(variance) : 0.0;
+
+		//how much faster the noise changes along an axis than along a diagonal; 1 is isotropic,
+		//grid artifacts show up as values away from 1
+		const float diagonal = delta * 0.70710678f;
+		double axisChange = 0.0;
+		double diagonalChange = 0.0;
+		for (int i = 0; i < count; i++)
+		{
+			Vector4 alongAxis = positions[i] + Vector4(delta, 0.f, 0.f, 0.f);
+			Vector4 alongDiagonal = positions[i] + Vector4(diagonal, diagonal, 0.f, 0.f);
+			axisChange += fabsf(type.function(alongAxis, seed) - values[i]);
+			diagonalChange += fabsf(type.function(alongDiagonal, seed) - values[i]);
+		}
+
+		ConsolePrintf("  %-11s %8.1f %7.3f %7.3f %7.3f %7.3f %6.3f", type.name, time * 1000000000.0 / count, minValue, maxValue, mean, stddev, axisChange / diagonalChange);
+	}
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "Engine/Core/Command.hpp"
+
+// Dev console checks and microbenchmarks for the fast math paths against their plain versions.
+void RegisterMathBenchmarkCommands();
+
+void BenchmarkMatrix(Command& cmd);
+void BenchmarkRandom(Command& cmd);
+void BenchmarkNoise(Command& cmd);
+void BenchmarkNoiseTypes(Command& cmd);
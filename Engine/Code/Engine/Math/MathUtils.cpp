@@ -5,70 +5,67 @@
 #include "Engine/Math/AABB2.hpp"
 #include "Engine/Math/Disc2.hpp"
 #include "Engine/Math/Matrix44.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
 #include <math.h> 
-#include <stdlib.h>
 #include <time.h> 
+#include <intrin.h>
 
 const float MathUtils::PI = 3.14159265359f;
 const float MathUtils::EPSILON = 0.001f;
 
 void InitRandomSeed()
 {
-	unsigned int temp = (unsigned int) time(NULL);
-	srand(temp);
+	SetRandomSeed((unsigned int) time(NULL));
 }
 
 int GetRandomIntLessThan(int maxExclusive)
 {
-	return rand() % maxExclusive;
+	return GetThreadRandom().GetRandomIntLessThan(maxExclusive);
 }
 
 int GetRandomIntInRange(int minInclusive, int maxInclusive)
 {
-	int range = (maxInclusive - minInclusive) + 1;
-	return minInclusive + GetRandomIntLessThan(range);
+	return GetThreadRandom().GetRandomIntInRange(minInclusive, maxInclusive);
 }
 
 float GetRandomFloatZeroToOne()
 {
-	return (float) rand() / (float) RAND_MAX;
+	return GetThreadRandom().GetRandomFloatZeroToOne();
 }
 
 float GetRandomFloatInRange(float min, float max)
 {
-	return min + ((float) rand() / ((float) RAND_MAX / (max - min)));
+	return GetThreadRandom().GetRandomFloatInRange(min, max);
 }
 
 bool CheckRandomChance(float chanceForSuccess)
 {
-	float clampedChance = ClampFloatZeroToOne(chanceForSuccess);
-	if (clampedChance == 1)
-		return true;
-
-	return GetRandomFloatInRange(0, 1) < clampedChance;
+	return GetThreadRandom().CheckRandomChance(chanceForSuccess);
 }
 
 Vector3 RandomPointOnSphere(float radius)
 {
-	Vector3 result = Vector3::zero;
-	while (result.NormalizeAndGetLength() < 0.0001f)
-	{
-		result.x = GetRandomFloatInRange(-1.f, 1.f);
-		result.y = GetRandomFloatInRange(-1.f, 1.f);
-		result.z = GetRandomFloatInRange(-1.f, 1.f);
-	}
-
-	return result * radius;
+	return GetThreadRandom().RandomPointOnSphere(radius);
 }
 
 Vector3 RandomPointInCube(float extend)
 {
-	Vector3 result = Vector3::zero;
-	result.x = GetRandomFloatInRange(-1.f, 1.f);
-	result.y = GetRandomFloatInRange(-1.f, 1.f);
-	result.z = GetRandomFloatInRange(-1.f, 1.f);
+	return GetThreadRandom().RandomPointInCube(extend);
+}
+
+void FillRandomFloatsInRange(float* out, unsigned int count, float min, float max)
+{
+	GetThreadRandom().FillRandomFloatsInRange(out, count, min, max);
+}
 
-	return result * extend;
+void FillRandomPointsOnSphere(Vector3* out, unsigned int count, float radius)
+{
+	GetThreadRandom().FillRandomPointsOnSphere(out, count, radius);
+}
+
+void FillRandomPointsInCube(Vector3* out, unsigned int count, float extend)
+{
+	GetThreadRandom().FillRandomPointsInCube(out, count, extend);
 }
 
 float GetDistance(const Vector2 & a, const Vector2 & b)
@@ -451,3 +448,27 @@ float BetterMod(float a, float b)
 {
 	return static_cast<float>(fmod((fmod(a, b) + b), b));
 }
+
+//------------------------------------------------------------------------
+static bool CheckAVX2Support()
+{
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return false;
+
+	//the OS has to save the ymm registers too, not just the CPU support them
+	__cpuid(info, 1);
+	bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+	if (!osSavesYmm)
+		return false;
+
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+}
+
+bool IsAVX2Supported()
+{
+	static const bool supported = CheckAVX2Support();
+	return supported;
+}
@@ -14,7 +14,9 @@ public:
 	static const float EPSILON;
 };
 
-void InitRandomSeed();
+void InitRandomSeed(); // seeds from the clock
+void SetRandomSeed(unsigned int seed); // deterministic runs (replays), see RandomNumberGenerator.hpp
+unsigned int GetRandomSeed();
 int GetRandomIntLessThan(int maxExclusive);
 int GetRandomIntInRange(int minInclusive, int maxInclusive);
 float GetRandomFloatZeroToOne();
@@ -22,6 +24,9 @@ float GetRandomFloatInRange(float min, float max);
 bool CheckRandomChance(float chanceForSuccess);
 Vector3 RandomPointOnSphere(float radius = 1.f);
 Vector3 RandomPointInCube(float extend = 1.f);
+void FillRandomFloatsInRange(float* out, unsigned int count, float min, float max);
+void FillRandomPointsOnSphere(Vector3* out, unsigned int count, float radius = 1.f);
+void FillRandomPointsInCube(Vector3* out, unsigned int count, float extend = 1.f);
 
 float GetDistance( const Vector2& a, const Vector2& b );
 float GetDistance( const Vector3& a, const Vector3& b );
@@ -102,3 +107,6 @@ bool Quadratic(Vector2* out, float a, float b, float c);
 // Hacky "close enough" compares for floats, to test actual vs. expected outcomes on float ops
 bool IsMostlyEqual(float a, float b, float epsilon = 0.001f);
 float BetterMod(float a, float b);
+
+// CPU and OS both support AVX2 (the OS has to save the ymm registers too), checked once
+bool IsAVX2Supported();
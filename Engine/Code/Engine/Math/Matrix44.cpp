@@ -1,4 +1,7 @@
+#include "Game/EngineBuildPreferences.hpp"
 #include "Engine/Math/Matrix44.hpp"
+#include "Engine/Math/MatrixSIMD.hpp"
+#include "Engine/Math/Quaternion.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Debug/DebugRender.hpp"
@@ -102,6 +105,40 @@ Vector2 Matrix44::TransformDisplacement2D(const Vector2 & displacement2D)
 	return Vector2((displacement2D.x * Ix) + (displacement2D.y * Jx), (displacement2D.x * Iy) + (displacement2D.y * Jy));
 }
 
+Vector3 Matrix44::TransformPosition(const Vector3& position) const
+{
+#if !defined(ENGINE_DISABLE_SIMD)
+	return TransformPositionSIMD(*this, position);
+#else
+	return Vector3((position.x * Ix) + (position.y * Jx) + (position.z * Kx) + Tx,
+		(position.x * Iy) + (position.y * Jy) + (position.z * Ky) + Ty,
+		(position.x * Iz) + (position.y * Jz) + (position.z * Kz) + Tz);
+#endif
+}
+
+Vector3 Matrix44::TransformDirection(const Vector3& direction) const
+{
+#if !defined(ENGINE_DISABLE_SIMD)
+	return TransformDirectionSIMD(*this, direction);
+#else
+	return Vector3((direction.x * Ix) + (direction.y * Jx) + (direction.z * Kx),
+		(direction.x * Iy) + (direction.y * Jy) + (direction.z * Ky),
+		(direction.x * Iz) + (direction.y * Jz) + (direction.z * Kz));
+#endif
+}
+
+Vector4 Matrix44::Transform(const Vector4& vec) const
+{
+#if !defined(ENGINE_DISABLE_SIMD)
+	return TransformVectorSIMD(*this, vec);
+#else
+	return Vector4((vec.x * Ix) + (vec.y * Jx) + (vec.z * Kx) + (vec.w * Tx),
+		(vec.x * Iy) + (vec.y * Jy) + (vec.z * Ky) + (vec.w * Ty),
+		(vec.x * Iz) + (vec.y * Jz) + (vec.z * Kz) + (vec.w * Tz),
+		(vec.x * Iw) + (vec.y * Jw) + (vec.z * Kw) + (vec.w * Tw));
+#endif
+}
+
 void Matrix44::SetIdentity()
 {
 	Ix = 1;
@@ -146,6 +183,15 @@ void Matrix44::SetValues(const float * sixteenValuesBasisMajor)
 }
 
 void Matrix44::Append(const Matrix44 & matrixToAppend)
+{
+#if !defined(ENGINE_DISABLE_SIMD)
+	MatrixMultiplySIMD(this, *this, matrixToAppend);
+#else
+	AppendScalar(matrixToAppend);
+#endif
+}
+
+void Matrix44::AppendScalar(const Matrix44 & matrixToAppend)
 {	
 	float oldIx = Ix;
 	float oldIy = Iy;
@@ -397,6 +443,28 @@ Matrix44 Matrix44::LookAt(const Vector3& position, const Vector3& target, const
 }
 
 Matrix44 Matrix44::MakeInverseFast(const Matrix44 & mat)
+{
+#if !defined(ENGINE_DISABLE_SIMD)
+	Matrix44 result;
+	MatrixInverseOrthonormalSIMD(&result, mat);
+	return result;
+#else
+	return MakeInverseFastScalar(mat);
+#endif
+}
+
+Matrix44 Matrix44::MakeInverse(const Matrix44& mat)
+{
+#if !defined(ENGINE_DISABLE_SIMD)
+	Matrix44 result;
+	MatrixInverseSIMD(&result, mat);
+	return result;
+#else
+	return MakeInverseScalar(mat);
+#endif
+}
+
+Matrix44 Matrix44::MakeInverseFastScalar(const Matrix44 & mat)
 {
 	float transposeData[16] =
 	{	mat.Ix,	mat.Jx,	mat.Kx, 0,
@@ -407,11 +475,11 @@ Matrix44 Matrix44::MakeInverseFast(const Matrix44 & mat)
 	Matrix44 rotationalTranspose = Matrix44(transposeData);
 	Matrix44 translation = MakeTranslation(Vector3(-mat.Tx, -mat.Ty, -mat.Tz));
 
-	rotationalTranspose.Append(translation);
+	rotationalTranspose.AppendScalar(translation);
 	return rotationalTranspose;
 }
 
-Matrix44 Matrix44::MakeInverse(const Matrix44& mat)
+Matrix44 Matrix44::MakeInverseScalar(const Matrix44& mat)
 {
 	float inv[16];
 	float det;
@@ -545,38 +613,12 @@ Matrix44 Matrix44::MakeInverse(const Matrix44& mat)
 
 Matrix44 Matrix44::TurnToward(const Matrix44& current, const Matrix44& target, float maxTurnRadians)
 {
-	Matrix44 ci = Matrix44::MakeInverse(current); 
-	Matrix44 r = target;
-
-	r.Append(ci);
-
-	// trace is 1 + 2 cos(theta) == sum of diagonal
-	float trace = r.GetTrace3(); 
-
-	float inner = (trace - 1.0f) * .5f; 
-	trace = ClampFloat(inner, -1.0f, 1.0f); 
-	float theta = acos(trace - 1.0f); 
-
-	float t = MinFloat(maxTurnRadians / theta, 1.0f);
-	
-	TODO("find out why theta is sometimes nan");
-	if (isnan(theta) == 1)
-	{
-// 		DebugLogf("trace: " + std::to_string(trace), Rgba::red, 10);
-// 		DebugLogf("theta: " + std::to_string(theta), Rgba::red, 10);
-// 		DebugLogf("t: " + std::to_string(t), Rgba::red, 10);
-
-		t = 0.1f;
-	}
-
-// 	DebugLogf("trace: " + std::to_string(trace), Rgba::white, 0);
-// 	DebugLogf("theta: " + std::to_string(theta), Rgba::white, 0);
-// 	DebugLogf("t: " + std::to_string(t), Rgba::white, 0);
-
-	Matrix44 ret = LerpTransform(current, target, t); 
-	ret.SetTranslation(current.GetPosition()); 
+	//quaternion slerp, no inverse or trace (the old trace version could produce a nan angle)
+	Quaternion rotation = RotateTowards(Quaternion::MakeFromMatrix(current), Quaternion::MakeFromMatrix(target), maxTurnRadians);
 
-	return ret; 
+	Matrix44 ret = rotation.GetMatrix();
+	ret.SetTranslation(current.GetPosition());
+	return ret;
 }
 
 float Matrix44::GetTrace3() const
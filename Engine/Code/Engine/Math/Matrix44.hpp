@@ -1,6 +1,7 @@
 #pragma once
 #include "Engine/Math/Vector2.hpp"
 #include "Engine/Math/Vector3.hpp"
+#include "Engine/Math/Vector4.hpp"
 
 class Matrix44
 {
@@ -14,11 +15,15 @@ public:
 	// Accessors
 	Vector2 TransformPosition2D(const Vector2& position2D); // Written assuming z=0, w=1
 	Vector2 TransformDisplacement2D(const Vector2& displacement2D); // Written assuming z=0, w=0
+	Vector3 TransformPosition(const Vector3& position) const; // w=1
+	Vector3 TransformDirection(const Vector3& direction) const; // w=0
+	Vector4 Transform(const Vector4& vec) const;
 
 	// Mutators
 	void SetIdentity();
 	void SetValues(const float* sixteenValuesBasisMajor); // float[16] array in order Ix, Iy...
 	void Append(const Matrix44& matrixToAppend); // a.k.a. Concatenate (right-multiply)
+	void AppendScalar(const Matrix44& matrixToAppend); // reference for the SIMD path
 	void RotateDegrees2D(float rotationDegreesAboutZ); // 
 	void Translate2D(const Vector2& translation);
 	void Translate(const Vector3& translation);
@@ -49,6 +54,8 @@ public:
 	static Matrix44 LookAt(const Vector3& position, const Vector3& target, const Vector3& up = Vector3::up);
 	static Matrix44 MakeInverseFast(const Matrix44& mat);
 	static Matrix44 MakeInverse(const Matrix44& mat);
+	static Matrix44 MakeInverseFastScalar(const Matrix44& mat); // reference for the SIMD path
+	static Matrix44 MakeInverseScalar(const Matrix44& mat); // reference for the SIMD path
 	static Matrix44 TurnToward(const Matrix44& current, const Matrix44& target, float maxTurnRadians);
 
 	// Helper
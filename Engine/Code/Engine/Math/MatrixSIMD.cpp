@@ -0,0 +1,226 @@
+#include "Engine/Math/MatrixSIMD.hpp"
+#include <xmmintrin.h>
+
+#define SHUFFLE_MASK(x, y, z, w) ((x) | ((y) << 2) | ((z) << 4) | ((w) << 6))
+#define SWIZZLE(vec, x, y, z, w) _mm_shuffle_ps(vec, vec, SHUFFLE_MASK(x, y, z, w))
+#define SHUFFLE(vec1, vec2, x, y, z, w) _mm_shuffle_ps(vec1, vec2, SHUFFLE_MASK(x, y, z, w))
+
+static inline __m128 LoadColumn(const Matrix44& mat, int column)
+{
+	return _mm_loadu_ps(&mat.Ix + column * 4);
+}
+
+static inline void StoreColumn(Matrix44* mat, int column, __m128 value)
+{
+	_mm_storeu_ps(&mat->Ix + column * 4, value);
+}
+
+// x*I + y*J + z*K + w*T, summed in the same order as the scalar code
+static inline __m128 LinearCombine(__m128 vec, __m128 col0, __m128 col1, __m128 col2, __m128 col3)
+{
+	__m128 result = _mm_mul_ps(SWIZZLE(vec, 0, 0, 0, 0), col0);
+	result = _mm_add_ps(result, _mm_mul_ps(SWIZZLE(vec, 1, 1, 1, 1), col1));
+	result = _mm_add_ps(result, _mm_mul_ps(SWIZZLE(vec, 2, 2, 2, 2), col2));
+	result = _mm_add_ps(result, _mm_mul_ps(SWIZZLE(vec, 3, 3, 3, 3), col3));
+	return result;
+}
+
+static inline __m128 LoadVector3(const Vector3& vec, float w)
+{
+	return _mm_setr_ps(vec.x, vec.y, vec.z, w);
+}
+
+static inline void StoreVector3(Vector3* out, __m128 value)
+{
+	_mm_storel_pi((__m64*) &out->x, value);
+	_mm_store_ss(&out->z, _mm_movehl_ps(value, value));
+}
+
+//------------------------------------------------------------------------
+// 2x2 helpers for the block inverse. A __m128 holds a 2x2 block as (m00, m01, m10, m11).
+static inline __m128 Mat2Mul(__m128 a, __m128 b)
+{
+	return _mm_add_ps(_mm_mul_ps(a, SWIZZLE(b, 0, 3, 0, 3)), _mm_mul_ps(SWIZZLE(a, 1, 0, 3, 2), SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+// adjugate(a) * b
+static inline __m128 Mat2AdjMul(__m128 a, __m128 b)
+{
+	return _mm_sub_ps(_mm_mul_ps(SWIZZLE(a, 3, 3, 0, 0), b), _mm_mul_ps(SWIZZLE(a, 1, 1, 2, 2), SWIZZLE(b, 2, 3, 0, 1)));
+}
+
+// a * adjugate(b)
+static inline __m128 Mat2MulAdj(__m128 a, __m128 b)
+{
+	return _mm_sub_ps(_mm_mul_ps(a, SWIZZLE(b, 3, 0, 3, 0)), _mm_mul_ps(SWIZZLE(a, 1, 0, 3, 2), SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+//------------------------------------------------------------------------
+void MatrixMultiplySIMD(Matrix44* out, const Matrix44& a, const Matrix44& b)
+{
+	__m128 col0 = LoadColumn(a, 0);
+	__m128 col1 = LoadColumn(a, 1);
+	__m128 col2 = LoadColumn(a, 2);
+	__m128 col3 = LoadColumn(a, 3);
+
+	//read each column of b right before overwriting the same column of out, so out can be b
+	for (int column = 0; column < 4; column++)
+		StoreColumn(out, column, LinearCombine(LoadColumn(b, column), col0, col1, col2, col3));
+}
+
+// Block matrix inverse, M = | A B |
+//                           | C D | with 2x2 blocks.
+// The layout is column major, but inverse(transpose(M)) == transpose(inverse(M)),
+// so working on the columns as if they were rows gives the columns of the inverse.
+void MatrixInverseSIMD(Matrix44* out, const Matrix44& mat)
+{
+	__m128 col0 = LoadColumn(mat, 0);
+	__m128 col1 = LoadColumn(mat, 1);
+	__m128 col2 = LoadColumn(mat, 2);
+	__m128 col3 = LoadColumn(mat, 3);
+
+	__m128 A = _mm_movelh_ps(col0, col1);
+	__m128 B = _mm_movehl_ps(col1, col0);
+	__m128 C = _mm_movelh_ps(col2, col3);
+	__m128 D = _mm_movehl_ps(col3, col2);
+
+	//determinants of the blocks as (|A|, |B|, |C|, |D|)
+	__m128 detSub = _mm_sub_ps(
+		_mm_mul_ps(SHUFFLE(col0, col2, 0, 2, 0, 2), SHUFFLE(col1, col3, 1, 3, 1, 3)),
+		_mm_mul_ps(SHUFFLE(col0, col2, 1, 3, 1, 3), SHUFFLE(col1, col3, 0, 2, 0, 2)));
+	__m128 detA = SWIZZLE(detSub, 0, 0, 0, 0);
+	__m128 detB = SWIZZLE(detSub, 1, 1, 1, 1);
+	__m128 detC = SWIZZLE(detSub, 2, 2, 2, 2);
+	__m128 detD = SWIZZLE(detSub, 3, 3, 3, 3);
+
+	__m128 adjDC = Mat2AdjMul(D, C);
+	__m128 adjAB = Mat2AdjMul(A, B);
+
+	//inverse = 1/|M| * | X Y |, these are the adjugates of X, Y, Z and W
+	//                  | Z W |
+	__m128 X = _mm_sub_ps(_mm_mul_ps(detD, A), Mat2Mul(B, adjDC));
+	__m128 W = _mm_sub_ps(_mm_mul_ps(detA, D), Mat2Mul(C, adjAB));
+	__m128 Y = _mm_sub_ps(_mm_mul_ps(detB, C), Mat2MulAdj(D, adjAB));
+	__m128 Z = _mm_sub_ps(_mm_mul_ps(detC, B), Mat2MulAdj(A, adjDC));
+
+	//|M| = |A||D| + |B||C| - trace(adj(A)B * adj(D)C)
+	__m128 trace = _mm_mul_ps(adjAB, SWIZZLE(adjDC, 0, 2, 1, 3));
+	trace = _mm_add_ps(trace, SWIZZLE(trace, 1, 0, 3, 2));
+	trace = _mm_add_ps(trace, SWIZZLE(trace, 2, 3, 0, 1));
+	__m128 detM = _mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC));
+	detM = _mm_sub_ps(detM, trace);
+
+	//same as the scalar version, a singular matrix gives identity
+	if (_mm_cvtss_f32(detM) == 0.f)
+	{
+		*out = Matrix44::identity;
+		return;
+	}
+
+	__m128 reciprocalDet = _mm_div_ps(_mm_setr_ps(1.f, -1.f, -1.f, 1.f), detM);
+	X = _mm_mul_ps(X, reciprocalDet);
+	Y = _mm_mul_ps(Y, reciprocalDet);
+	Z = _mm_mul_ps(Z, reciprocalDet);
+	W = _mm_mul_ps(W, reciprocalDet);
+
+	//adjugate shuffle and the block to column shuffle in one go
+	StoreColumn(out, 0, SHUFFLE(X, Y, 3, 1, 3, 1));
+	StoreColumn(out, 1, SHUFFLE(X, Y, 2, 0, 2, 0));
+	StoreColumn(out, 2, SHUFFLE(Z, W, 3, 1, 3, 1));
+	StoreColumn(out, 3, SHUFFLE(Z, W, 2, 0, 2, 0));
+}
+
+// Transposed rotation, translation = -(R^T * T)
+void MatrixInverseOrthonormalSIMD(Matrix44* out, const Matrix44& mat)
+{
+	__m128 col0 = LoadColumn(mat, 0);
+	__m128 col1 = LoadColumn(mat, 1);
+	__m128 col2 = LoadColumn(mat, 2);
+	__m128 col3 = _mm_setr_ps(0.f, 0.f, 0.f, 1.f);
+	__m128 translation = LoadColumn(mat, 3);
+
+	//after the transpose col3 holds the old w row, which is dropped for (0, 0, 0, 1)
+	_MM_TRANSPOSE4_PS(col0, col1, col2, col3);
+	col3 = _mm_setr_ps(0.f, 0.f, 0.f, 1.f);
+
+	__m128 newTranslation = _mm_mul_ps(SWIZZLE(translation, 0, 0, 0, 0), col0);
+	newTranslation = _mm_add_ps(newTranslation, _mm_mul_ps(SWIZZLE(translation, 1, 1, 1, 1), col1));
+	newTranslation = _mm_add_ps(newTranslation, _mm_mul_ps(SWIZZLE(translation, 2, 2, 2, 2), col2));
+	newTranslation = _mm_sub_ps(col3, newTranslation);
+
+	StoreColumn(out, 0, col0);
+	StoreColumn(out, 1, col1);
+	StoreColumn(out, 2, col2);
+	StoreColumn(out, 3, newTranslation);
+}
+
+Vector4 TransformVectorSIMD(const Matrix44& mat, const Vector4& vec)
+{
+	Vector4 result;
+	_mm_storeu_ps(&result.x, LinearCombine(_mm_loadu_ps(&vec.x), LoadColumn(mat, 0), LoadColumn(mat, 1), LoadColumn(mat, 2), LoadColumn(mat, 3)));
+	return result;
+}
+
+Vector3 TransformPositionSIMD(const Matrix44& mat, const Vector3& position)
+{
+	Vector3 result;
+	StoreVector3(&result, LinearCombine(LoadVector3(position, 1.f), LoadColumn(mat, 0), LoadColumn(mat, 1), LoadColumn(mat, 2), LoadColumn(mat, 3)));
+	return result;
+}
+
+Vector3 TransformDirectionSIMD(const Matrix44& mat, const Vector3& direction)
+{
+	Vector3 result;
+	StoreVector3(&result, LinearCombine(LoadVector3(direction, 0.f), LoadColumn(mat, 0), LoadColumn(mat, 1), LoadColumn(mat, 2), LoadColumn(mat, 3)));
+	return result;
+}
+
+//------------------------------------------------------------------------
+void TransformPositions(const Matrix44& mat, const Vector3* positions, Vector3* out, uint count)
+{
+	__m128 col0 = LoadColumn(mat, 0);
+	__m128 col1 = LoadColumn(mat, 1);
+	__m128 col2 = LoadColumn(mat, 2);
+	__m128 col3 = LoadColumn(mat, 3);
+
+	for (uint i = 0; i < count; i++)
+	{
+		__m128 result = _mm_mul_ps(_mm_set1_ps(positions[i].x), col0);
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(positions[i].y), col1));
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(positions[i].z), col2));
+		result = _mm_add_ps(result, col3);
+		StoreVector3(&out[i], result);
+	}
+}
+
+void TransformDirections(const Matrix44& mat, const Vector3* directions, Vector3* out, uint count)
+{
+	__m128 col0 = LoadColumn(mat, 0);
+	__m128 col1 = LoadColumn(mat, 1);
+	__m128 col2 = LoadColumn(mat, 2);
+
+	for (uint i = 0; i < count; i++)
+	{
+		__m128 result = _mm_mul_ps(_mm_set1_ps(directions[i].x), col0);
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(directions[i].y), col1));
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(directions[i].z), col2));
+		StoreVector3(&out[i], result);
+	}
+}
+
+void TransformVectors(const Matrix44& mat, const Vector4* vectors, Vector4* out, uint count)
+{
+	__m128 col0 = LoadColumn(mat, 0);
+	__m128 col1 = LoadColumn(mat, 1);
+	__m128 col2 = LoadColumn(mat, 2);
+	__m128 col3 = LoadColumn(mat, 3);
+
+	for (uint i = 0; i < count; i++)
+		_mm_storeu_ps(&out[i].x, LinearCombine(_mm_loadu_ps(&vectors[i].x), col0, col1, col2, col3));
+}
+
+void MultiplyMatrices(const Matrix44* a, const Matrix44* b, Matrix44* out, uint count)
+{
+	for (uint i = 0; i < count; i++)
+		MatrixMultiplySIMD(&out[i], a[i], b[i]);
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Math/Matrix44.hpp"
+#include "Engine/Math/Vector4.hpp"
+
+// SSE kernels for Matrix44. A Matrix44 is four basis columns (I, J, K, T) of four
+// floats back to back, so each column loads straight into one register.
+// Results match the scalar Matrix44 code within float rounding. Outputs may alias inputs.
+void MatrixMultiplySIMD(Matrix44* out, const Matrix44& a, const Matrix44& b); // out = a.Append(b)
+void MatrixInverseSIMD(Matrix44* out, const Matrix44& mat);
+void MatrixInverseOrthonormalSIMD(Matrix44* out, const Matrix44& mat); // rotation + translation only
+
+Vector4 TransformVectorSIMD(const Matrix44& mat, const Vector4& vec);
+Vector3 TransformPositionSIMD(const Matrix44& mat, const Vector3& position); // w=1
+Vector3 TransformDirectionSIMD(const Matrix44& mat, const Vector3& direction); // w=0
+
+//------------------------------------------------------------------------
+// Batches: the matrix stays in registers across the whole array.
+// 16 byte aligned arrays are fastest but not required.
+void TransformPositions(const Matrix44& mat, const Vector3* positions, Vector3* out, uint count);
+void TransformDirections(const Matrix44& mat, const Vector3* directions, Vector3* out, uint count);
+void TransformVectors(const Matrix44& mat, const Vector4* vectors, Vector4* out, uint count);
+void MultiplyMatrices(const Matrix44* a, const Matrix44* b, Matrix44* out, uint count); // out[i] = a[i].Append(b[i])
@@ -0,0 +1,454 @@
+#include "Engine/Math/NoiseSIMD.hpp"
+#include "Engine/ThirdParty/SquirrelNoise/RawNoise.hpp"
+#include "Engine/ThirdParty/SquirrelNoise/SmoothNoise.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include <emmintrin.h>
+#include <immintrin.h>
+#include <intrin.h>
+
+// Constants from RawNoise.cpp / SmoothNoise.cpp, the results have to match them bit for bit
+constexpr unsigned int BIT_NOISE1 = 0xD2A80A23;
+constexpr unsigned int BIT_NOISE2 = 0xA884F197;
+constexpr unsigned int BIT_NOISE3 = 0x1B56C4E9;
+constexpr int PRIME_NUMBER = 198491317;
+constexpr double ONE_OVER_MAX_UINT = (1.0 / (double) 0xFFFFFFFF);
+constexpr float OCTAVE_OFFSET = 0.636764989593174f;
+
+// Compute2dPerlinNoise's gradient table split into x and y
+alignas(32) static const float GRADIENTS_X[8] = { +0.923879533f, +0.382683432f, -0.382683432f, -0.923879533f, -0.923879533f, -0.382683432f, +0.382683432f, +0.923879533f };
+alignas(32) static const float GRADIENTS_Y[8] = { +0.382683432f, +0.923879533f, +0.923879533f, +0.382683432f, -0.382683432f, -0.923879533f, -0.923879533f, -0.382683432f };
+
+//------------------------------------------------------------------------
+// Lane sets: the noise code below is written once against these and instantiated for each.
+// SSE2 has no 32 bit multiply, floor or unsigned convert, so those are built out of what it has.
+struct SSE2Lanes
+{
+	typedef __m128 Floats;
+	typedef __m128i Ints;
+	static constexpr int WIDTH = 4;
+
+	static inline Floats Set(float value) { return _mm_set1_ps(value); }
+	static inline Ints SetInt(unsigned int value) { return _mm_set1_epi32((int) value); }
+	static inline Ints Ramp() { return _mm_setr_epi32(0, 1, 2, 3); }
+	static inline Ints LoadInts(const int* in) { return _mm_loadu_si128((const __m128i*) in); }
+	static inline void Store(float* out, Floats value) { _mm_storeu_ps(out, value); }
+	static inline void StoreInts(unsigned int* out, Ints value) { _mm_storeu_si128((__m128i*) out, value); }
+
+	static inline Floats Add(Floats a, Floats b) { return _mm_add_ps(a, b); }
+	static inline Floats Sub(Floats a, Floats b) { return _mm_sub_ps(a, b); }
+	static inline Floats Mul(Floats a, Floats b) { return _mm_mul_ps(a, b); }
+	static inline Floats Div(Floats a, Floats b) { return _mm_div_ps(a, b); }
+	static inline Ints Add(Ints a, Ints b) { return _mm_add_epi32(a, b); }
+	static inline Ints Xor(Ints a, Ints b) { return _mm_xor_si128(a, b); }
+	static inline Ints And(Ints a, Ints b) { return _mm_and_si128(a, b); }
+	template <int BITS> static inline Ints ShiftRight(Ints a) { return _mm_srli_epi32(a, BITS); }
+	static inline Floats ToFloat(Ints a) { return _mm_cvtepi32_ps(a); }
+
+	static inline Ints Mul(Ints a, Ints b)
+	{
+		//low 32 bits of lanes 0,2 and 1,3 separately, then interleave
+		__m128i even = _mm_mul_epu32(a, b);
+		__m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+		return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+	}
+
+	// floorf, including floorf(-0) == -0. Only valid inside int range, same as the (int) cast after it
+	static inline Floats Floor(Floats a)
+	{
+		__m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
+		__m128 correction = _mm_and_ps(_mm_cmpgt_ps(truncated, a), _mm_set1_ps(1.f));
+		__m128 signBit = _mm_and_ps(a, _mm_set1_ps(-0.f));
+		return _mm_or_ps(_mm_sub_ps(truncated, correction), signBit);
+	}
+
+	static inline Ints ToInt(Floats a) { return _mm_cvttps_epi32(a); }
+
+	// (float) (ONE_OVER_MAX_UINT * (double) value), through doubles like the scalar code
+	static inline Floats ZeroToOne(Ints value)
+	{
+		__m128i biased = _mm_xor_si128(value, _mm_set1_epi32((int) 0x80000000));
+		__m128d low = _mm_add_pd(_mm_cvtepi32_pd(biased), _mm_set1_pd(2147483648.0));
+		__m128d high = _mm_add_pd(_mm_cvtepi32_pd(_mm_shuffle_epi32(biased, _MM_SHUFFLE(1, 0, 3, 2))), _mm_set1_pd(2147483648.0));
+		low = _mm_mul_pd(low, _mm_set1_pd(ONE_OVER_MAX_UINT));
+		high = _mm_mul_pd(high, _mm_set1_pd(ONE_OVER_MAX_UINT));
+		return _mm_movelh_ps(_mm_cvtpd_ps(low), _mm_cvtpd_ps(high));
+	}
+
+	static inline Floats LookUp8(const float* table, Ints index)
+	{
+		alignas(16) int lanes[4];
+		_mm_store_si128((__m128i*) lanes, index);
+		return _mm_setr_ps(table[lanes[0]], table[lanes[1]], table[lanes[2]], table[lanes[3]]);
+	}
+
+	static inline void Finish() {}
+};
+
+struct AVX2Lanes
+{
+	typedef __m256 Floats;
+	typedef __m256i Ints;
+	static constexpr int WIDTH = 8;
+
+	static inline Floats Set(float value) { return _mm256_set1_ps(value); }
+	static inline Ints SetInt(unsigned int value) { return _mm256_set1_epi32((int) value); }
+	static inline Ints Ramp() { return _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7); }
+	static inline Ints LoadInts(const int* in) { return _mm256_loadu_si256((const __m256i*) in); }
+	static inline void Store(float* out, Floats value) { _mm256_storeu_ps(out, value); }
+	static inline void StoreInts(unsigned int* out, Ints value) { _mm256_storeu_si256((__m256i*) out, value); }
+
+	static inline Floats Add(Floats a, Floats b) { return _mm256_add_ps(a, b); }
+	static inline Floats Sub(Floats a, Floats b) { return _mm256_sub_ps(a, b); }
+	static inline Floats Mul(Floats a, Floats b) { return _mm256_mul_ps(a, b); }
+	static inline Floats Div(Floats a, Floats b) { return _mm256_div_ps(a, b); }
+	static inline Ints Add(Ints a, Ints b) { return _mm256_add_epi32(a, b); }
+	static inline Ints Mul(Ints a, Ints b) { return _mm256_mullo_epi32(a, b); }
+	static inline Ints Xor(Ints a, Ints b) { return _mm256_xor_si256(a, b); }
+	static inline Ints And(Ints a, Ints b) { return _mm256_and_si256(a, b); }
+	template <int BITS> static inline Ints ShiftRight(Ints a) { return _mm256_srli_epi32(a, BITS); }
+	static inline Floats ToFloat(Ints a) { return _mm256_cvtepi32_ps(a); }
+	static inline Floats Floor(Floats a) { return _mm256_floor_ps(a); }
+	static inline Ints ToInt(Floats a) { return _mm256_cvttps_epi32(a); }
+
+	static inline Floats ZeroToOne(Ints value)
+	{
+		__m256i biased = _mm256_xor_si256(value, _mm256_set1_epi32((int) 0x80000000));
+		__m256d low = _mm256_add_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(biased)), _mm256_set1_pd(2147483648.0));
+		__m256d high = _mm256_add_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(biased, 1)), _mm256_set1_pd(2147483648.0));
+		low = _mm256_mul_pd(low, _mm256_set1_pd(ONE_OVER_MAX_UINT));
+		high = _mm256_mul_pd(high, _mm256_set1_pd(ONE_OVER_MAX_UINT));
+		return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(low)), _mm256_cvtpd_ps(high), 1);
+	}
+
+	// the whole 8 entry table fits one register
+	static inline Floats LookUp8(const float* table, Ints index) { return _mm256_permutevar8x32_ps(_mm256_load_ps(table), index); }
+
+	// avoid the AVX to SSE transition penalty in whatever runs next
+	static inline void Finish() { _mm256_zeroupper(); }
+};
+
+//------------------------------------------------------------------------
+template <typename LANES>
+static inline typename LANES::Ints Get1dNoiseLanes(typename LANES::Ints index, unsigned int seed)
+{
+	typename LANES::Ints mangledBits = LANES::Mul(index, LANES::SetInt(BIT_NOISE1));
+	mangledBits = LANES::Add(mangledBits, LANES::SetInt(seed));
+	mangledBits = LANES::Xor(mangledBits, LANES::template ShiftRight<7>(mangledBits));
+	mangledBits = LANES::Add(mangledBits, LANES::SetInt(BIT_NOISE2));
+	mangledBits = LANES::Xor(mangledBits, LANES::template ShiftRight<8>(mangledBits));
+	mangledBits = LANES::Mul(mangledBits, LANES::SetInt(BIT_NOISE3));
+	mangledBits = LANES::Xor(mangledBits, LANES::template ShiftRight<11>(mangledBits));
+	return mangledBits;
+}
+
+template <typename LANES>
+static inline typename LANES::Ints Get2dNoiseLanes(typename LANES::Ints indexX, typename LANES::Ints indexY, unsigned int seed)
+{
+	return Get1dNoiseLanes<LANES>(LANES::Add(indexX, LANES::Mul(LANES::SetInt(PRIME_NUMBER), indexY)), seed);
+}
+
+// same expression order as MathUtils SmoothStep3 / SmoothStart3 / SmoothStop3
+template <typename LANES>
+static inline typename LANES::Floats SmoothStep3Lanes(typename LANES::Floats t)
+{
+	typedef typename LANES::Floats Floats;
+	Floats one = LANES::Set(1.f);
+	Floats oneMinusT = LANES::Sub(one, t);
+	Floats start = LANES::Mul(LANES::Mul(t, t), t);
+	Floats stop = LANES::Sub(one, LANES::Mul(LANES::Mul(oneMinusT, oneMinusT), oneMinusT));
+	return LANES::Add(LANES::Mul(oneMinusT, start), LANES::Mul(t, stop));
+}
+
+template <typename LANES>
+static inline typename LANES::Floats RenormalizeLanes(typename LANES::Floats totalNoise, float totalAmplitude)
+{
+	totalNoise = LANES::Div(totalNoise, LANES::Set(totalAmplitude));
+	totalNoise = LANES::Add(LANES::Mul(totalNoise, LANES::Set(0.5f)), LANES::Set(0.5f));
+	totalNoise = SmoothStep3Lanes<LANES>(totalNoise);
+	return LANES::Sub(LANES::Mul(totalNoise, LANES::Set(2.f)), LANES::Set(1.f));
+}
+
+//------------------------------------------------------------------------
+// One row of Compute2dFractalNoise / Compute2dPerlinNoise, WIDTH samples at a time.
+// Amplitudes are the same for every lane so they stay scalar.
+template <typename LANES>
+static void Fill2dFractalNoiseRow(float* out, int width, float posY, const Vector2& origin, const Vector2& step, float scale,
+	unsigned int numOctaves, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed)
+{
+	typedef typename LANES::Floats Floats;
+	typedef typename LANES::Ints Ints;
+
+	const float invScale = (1.f / scale);
+	const Floats one = LANES::Set(1.f);
+
+	int x = 0;
+	for (; x + LANES::WIDTH <= width; x += LANES::WIDTH)
+	{
+		Floats posX = LANES::Add(LANES::Set(origin.x), LANES::Mul(LANES::ToFloat(LANES::Add(LANES::SetInt(x), LANES::Ramp())), LANES::Set(step.x)));
+		Floats currentX = LANES::Mul(posX, LANES::Set(invScale));
+		Floats currentY = LANES::Set(posY * invScale);
+		Floats totalNoise = LANES::Set(0.f);
+		float totalAmplitude = 0.f;
+		float currentAmplitude = 1.f;
+		unsigned int octaveSeed = seed;
+
+		for (unsigned int octaveNum = 0; octaveNum < numOctaves; ++octaveNum)
+		{
+			Floats cellMinsX = LANES::Floor(currentX);
+			Floats cellMinsY = LANES::Floor(currentY);
+			Ints indexWestX = LANES::ToInt(cellMinsX);
+			Ints indexSouthY = LANES::ToInt(cellMinsY);
+			Ints indexEastX = LANES::Add(indexWestX, LANES::SetInt(1));
+			Ints indexNorthY = LANES::Add(indexSouthY, LANES::SetInt(1));
+			Floats valueSouthWest = LANES::ZeroToOne(Get2dNoiseLanes<LANES>(indexWestX, indexSouthY, octaveSeed));
+			Floats valueSouthEast = LANES::ZeroToOne(Get2dNoiseLanes<LANES>(indexEastX, indexSouthY, octaveSeed));
+			Floats valueNorthWest = LANES::ZeroToOne(Get2dNoiseLanes<LANES>(indexWestX, indexNorthY, octaveSeed));
+			Floats valueNorthEast = LANES::ZeroToOne(Get2dNoiseLanes<LANES>(indexEastX, indexNorthY, octaveSeed));
+
+			Floats weightEast = SmoothStep3Lanes<LANES>(LANES::Sub(currentX, cellMinsX));
+			Floats weightNorth = SmoothStep3Lanes<LANES>(LANES::Sub(currentY, cellMinsY));
+			Floats weightWest = LANES::Sub(one, weightEast);
+			Floats weightSouth = LANES::Sub(one, weightNorth);
+
+			Floats blendSouth = LANES::Add(LANES::Mul(weightEast, valueSouthEast), LANES::Mul(weightWest, valueSouthWest));
+			Floats blendNorth = LANES::Add(LANES::Mul(weightEast, valueNorthEast), LANES::Mul(weightWest, valueNorthWest));
+			Floats blendTotal = LANES::Add(LANES::Mul(weightSouth, blendSouth), LANES::Mul(weightNorth, blendNorth));
+			Floats noiseThisOctave = LANES::Mul(LANES::Set(2.f), LANES::Sub(blendTotal, LANES::Set(0.5f)));
+
+			totalNoise = LANES::Add(totalNoise, LANES::Mul(noiseThisOctave, LANES::Set(currentAmplitude)));
+			totalAmplitude += currentAmplitude;
+			currentAmplitude *= octavePersistence;
+			currentX = LANES::Add(LANES::Mul(currentX, LANES::Set(octaveScale)), LANES::Set(OCTAVE_OFFSET));
+			currentY = LANES::Add(LANES::Mul(currentY, LANES::Set(octaveScale)), LANES::Set(OCTAVE_OFFSET));
+			++octaveSeed;
+		}
+
+		if (renormalize && totalAmplitude > 0.f)
+			totalNoise = RenormalizeLanes<LANES>(totalNoise, totalAmplitude);
+
+		LANES::Store(out + x, totalNoise);
+	}
+
+	//leftovers narrower than a register
+	for (; x < width; x++)
+		out[x] = Compute2dFractalNoise(origin.x + ((float) x * step.x), posY, scale, numOctaves, octavePersistence, octaveScale, renormalize, seed);
+}
+
+template <typename LANES>
+static void Fill2dPerlinNoiseRow(float* out, int width, float posY, const Vector2& origin, const Vector2& step, float scale,
+	unsigned int numOctaves, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed)
+{
+	typedef typename LANES::Floats Floats;
+	typedef typename LANES::Ints Ints;
+
+	const float invScale = (1.f / scale);
+	const Floats one = LANES::Set(1.f);
+	const Ints gradientMask = LANES::SetInt(0x00000007);
+
+	int x = 0;
+	for (; x + LANES::WIDTH <= width; x += LANES::WIDTH)
+	{
+		Floats posX = LANES::Add(LANES::Set(origin.x), LANES::Mul(LANES::ToFloat(LANES::Add(LANES::SetInt(x), LANES::Ramp())), LANES::Set(step.x)));
+		Floats currentX = LANES::Mul(posX, LANES::Set(invScale));
+		Floats currentY = LANES::Set(posY * invScale);
+		Floats totalNoise = LANES::Set(0.f);
+		float totalAmplitude = 0.f;
+		float currentAmplitude = 1.f;
+		unsigned int octaveSeed = seed;
+
+		for (unsigned int octaveNum = 0; octaveNum < numOctaves; ++octaveNum)
+		{
+			Floats cellMinsX = LANES::Floor(currentX);
+			Floats cellMinsY = LANES::Floor(currentY);
+			Floats cellMaxsX = LANES::Add(cellMinsX, one);
+			Floats cellMaxsY = LANES::Add(cellMinsY, one);
+			Ints indexWestX = LANES::ToInt(cellMinsX);
+			Ints indexSouthY = LANES::ToInt(cellMinsY);
+			Ints indexEastX = LANES::Add(indexWestX, LANES::SetInt(1));
+			Ints indexNorthY = LANES::Add(indexSouthY, LANES::SetInt(1));
+
+			Ints noiseSW = LANES::And(Get2dNoiseLanes<LANES>(indexWestX, indexSouthY, octaveSeed), gradientMask);
+			Ints noiseSE = LANES::And(Get2dNoiseLanes<LANES>(indexEastX, indexSouthY, octaveSeed), gradientMask);
+			Ints noiseNW = LANES::And(Get2dNoiseLanes<LANES>(indexWestX, indexNorthY, octaveSeed), gradientMask);
+			Ints noiseNE = LANES::And(Get2dNoiseLanes<LANES>(indexEastX, indexNorthY, octaveSeed), gradientMask);
+
+			Floats displacementWest = LANES::Sub(currentX, cellMinsX);
+			Floats displacementEast = LANES::Sub(currentX, cellMaxsX);
+			Floats displacementSouth = LANES::Sub(currentY, cellMinsY);
+			Floats displacementNorth = LANES::Sub(currentY, cellMaxsY);
+
+			Floats dotSouthWest = LANES::Add(LANES::Mul(LANES::LookUp8(GRADIENTS_X, noiseSW), displacementWest), LANES::Mul(LANES::LookUp8(GRADIENTS_Y, noiseSW), displacementSouth));
+			Floats dotSouthEast = LANES::Add(LANES::Mul(LANES::LookUp8(GRADIENTS_X, noiseSE), displacementEast), LANES::Mul(LANES::LookUp8(GRADIENTS_Y, noiseSE), displacementSouth));
+			Floats dotNorthWest = LANES::Add(LANES::Mul(LANES::LookUp8(GRADIENTS_X, noiseNW), displacementWest), LANES::Mul(LANES::LookUp8(GRADIENTS_Y, noiseNW), displacementNorth));
+			Floats dotNorthEast = LANES::Add(LANES::Mul(LANES::LookUp8(GRADIENTS_X, noiseNE), displacementEast), LANES::Mul(LANES::LookUp8(GRADIENTS_Y, noiseNE), displacementNorth));
+
+			Floats weightEast = SmoothStep3Lanes<LANES>(displacementWest);
+			Floats weightNorth = SmoothStep3Lanes<LANES>(displacementSouth);
+			Floats weightWest = LANES::Sub(one, weightEast);
+			Floats weightSouth = LANES::Sub(one, weightNorth);
+
+			Floats blendSouth = LANES::Add(LANES::Mul(weightEast, dotSouthEast), LANES::Mul(weightWest, dotSouthWest));
+			Floats blendNorth = LANES::Add(LANES::Mul(weightEast, dotNorthEast), LANES::Mul(weightWest, dotNorthWest));
+			Floats blendTotal = LANES::Add(LANES::Mul(weightSouth, blendSouth), LANES::Mul(weightNorth, blendNorth));
+			Floats noiseThisOctave = LANES::Mul(blendTotal, LANES::Set(1.f / 0.662578106f));
+
+			totalNoise = LANES::Add(totalNoise, LANES::Mul(noiseThisOctave, LANES::Set(currentAmplitude)));
+			totalAmplitude += currentAmplitude;
+			currentAmplitude *= octavePersistence;
+			currentX = LANES::Add(LANES::Mul(currentX, LANES::Set(octaveScale)), LANES::Set(OCTAVE_OFFSET));
+			currentY = LANES::Add(LANES::Mul(currentY, LANES::Set(octaveScale)), LANES::Set(OCTAVE_OFFSET));
+			++octaveSeed;
+		}
+
+		if (renormalize && totalAmplitude > 0.f)
+			totalNoise = RenormalizeLanes<LANES>(totalNoise, totalAmplitude);
+
+		LANES::Store(out + x, totalNoise);
+	}
+
+	for (; x < width; x++)
+		out[x] = Compute2dPerlinNoise(origin.x + ((float) x * step.x), posY, scale, numOctaves, octavePersistence, octaveScale, renormalize, seed);
+}
+
+//------------------------------------------------------------------------
+template <typename LANES>
+static void Get1dNoiseUintsLanes(const int* indices, unsigned int* out, uint count, unsigned int seed)
+{
+	uint i = 0;
+	for (; i + LANES::WIDTH <= count; i += LANES::WIDTH)
+		LANES::StoreInts(out + i, Get1dNoiseLanes<LANES>(LANES::LoadInts(indices + i), seed));
+
+	for (; i < count; i++)
+		out[i] = Get1dNoiseUint(indices[i], seed);
+
+	LANES::Finish();
+}
+
+template <typename LANES>
+static void Get2dNoiseUintsLanes(const int* indicesX, const int* indicesY, unsigned int* out, uint count, unsigned int seed)
+{
+	uint i = 0;
+	for (; i + LANES::WIDTH <= count; i += LANES::WIDTH)
+		LANES::StoreInts(out + i, Get2dNoiseLanes<LANES>(LANES::LoadInts(indicesX + i), LANES::LoadInts(indicesY + i), seed));
+
+	for (; i < count; i++)
+		out[i] = Get2dNoiseUint(indicesX[i], indicesY[i], seed);
+
+	LANES::Finish();
+}
+
+template <typename LANES>
+static void Fill2dFractalNoiseLanes(float* out, int width, int height, const Vector2& origin, const Vector2& step, float scale,
+	unsigned int numOctaves, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed)
+{
+	for (int y = 0; y < height; y++)
+		Fill2dFractalNoiseRow<LANES>(out + (y * width), width, origin.y + ((float) y * step.y), origin, step, scale, numOctaves, octavePersistence, octaveScale, renormalize, seed);
+
+	LANES::Finish();
+}
+
+template <typename LANES>
+static void Fill2dPerlinNoiseLanes(float* out, int width, int height, const Vector2& origin, const Vector2& step, float scale,
+	unsigned int numOctaves, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed)
+{
+	for (int y = 0; y < height; y++)
+		Fill2dPerlinNoiseRow<LANES>(out + (y * width), width, origin.y + ((float) y * step.y), origin, step, scale, numOctaves, octavePersistence, octaveScale, renormalize, seed);
+
+	LANES::Finish();
+}
+
+//------------------------------------------------------------------------
+static eNoiseSIMDLevel GetSupportedNoiseSIMDLevel()
+{
+	static const eNoiseSIMDLevel supported = IsAVX2Supported() ? NOISE_SIMD_AVX2 : NOISE_SIMD_SSE2;
+	return supported;
+}
+
+static eNoiseSIMDLevel g_noiseSIMDLevel = GetSupportedNoiseSIMDLevel();
+
+eNoiseSIMDLevel GetNoiseSIMDLevel()
+{
+	return g_noiseSIMDLevel;
+}
+
+void SetNoiseSIMDLevel(eNoiseSIMDLevel level)
+{
+	g_noiseSIMDLevel = level < GetSupportedNoiseSIMDLevel() ? level : GetSupportedNoiseSIMDLevel();
+}
+
+//------------------------------------------------------------------------
+void Get1dNoiseUints(const int* indices, unsigned int* out, uint count, unsigned int seed)
+{
+	switch (g_noiseSIMDLevel)
+	{
+	case NOISE_SIMD_AVX2:
+		Get1dNoiseUintsLanes<AVX2Lanes>(indices, out, count, seed);
+		break;
+	case NOISE_SIMD_SSE2:
+		Get1dNoiseUintsLanes<SSE2Lanes>(indices, out, count, seed);
+		break;
+	default:
+		for (uint i = 0; i < count; i++)
+			out[i] = Get1dNoiseUint(indices[i], seed);
+		break;
+	}
+}
+
+void Get2dNoiseUints(const int* indicesX, const int* indicesY, unsigned int* out, uint count, unsigned int seed)
+{
+	switch (g_noiseSIMDLevel)
+	{
+	case NOISE_SIMD_AVX2:
+		Get2dNoiseUintsLanes<AVX2Lanes>(indicesX, indicesY, out, count, seed);
+		break;
+	case NOISE_SIMD_SSE2:
+		Get2dNoiseUintsLanes<SSE2Lanes>(indicesX, indicesY, out, count, seed);
+		break;
+	default:
+		for (uint i = 0; i < count; i++)
+			out[i] = Get2dNoiseUint(indicesX[i], indicesY[i], seed);
+		break;
+	}
+}
+
+void Fill2dFractalNoise(float* out, int width, int height, const Vector2& origin, const Vector2& step, float scale, unsigned int numOctaves,
+	float octavePersistence, float octaveScale, bool renormalize, unsigned int seed)
+{
+	switch (g_noiseSIMDLevel)
+	{
+	case NOISE_SIMD_AVX2:
+		Fill2dFractalNoiseLanes<AVX2Lanes>(out, width, height, origin, step, scale, numOctaves, octavePersistence, octaveScale, renormalize, seed);
+		break;
+	case NOISE_SIMD_SSE2:
+		Fill2dFractalNoiseLanes<SSE2Lanes>(out, width, height, origin, step, scale, numOctaves, octavePersistence, octaveScale, renormalize, seed);
+		break;
+	default:
+		for (int y = 0; y < height; y++)
+		{
+			for (int x = 0; x < width; x++)
+				out[(y * width) + x] = Compute2dFractalNoise(origin.x + ((float) x * step.x), origin.y + ((float) y * step.y), scale, numOctaves, octavePersistence, octaveScale, renormalize, seed);
+		}
+		break;
+	}
+}
+
+void Fill2dPerlinNoise(float* out, int width, int height, const Vector2& origin, const Vector2& step, float scale, unsigned int numOctaves,
+	float octavePersistence, float octaveScale, bool renormalize, unsigned int seed)
+{
+	switch (g_noiseSIMDLevel)
+	{
+	case NOISE_SIMD_AVX2:
+		Fill2dPerlinNoiseLanes<AVX2Lanes>(out, width, height, origin, step, scale, numOctaves, octavePersistence, octaveScale, renormalize, seed);
+		break;
+	case NOISE_SIMD_SSE2:
+		Fill2dPerlinNoiseLanes<SSE2Lanes>(out, width, height, origin, step, scale, numOctaves, octavePersistence, octaveScale, renormalize, seed);
+		break;
+	default:
+		for (int y = 0; y < height; y++)
+		{
+			for (int x = 0; x < width; x++)
+				out[(y * width) + x] = Compute2dPerlinNoise(origin.x + ((float) x * step.x), origin.y + ((float) y * step.y), scale, numOctaves, octavePersistence, octaveScale, renormalize, seed);
+		}
+		break;
+	}
+}
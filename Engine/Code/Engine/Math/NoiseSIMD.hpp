@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Math/Vector2.hpp"
+
+// Wide versions of the SquirrelNoise functions: 8 lanes with AVX2 when the CPU has it,
+// 4 lanes with SSE2 otherwise. Every result is bit identical to the scalar function for
+// the same inputs, so the two can be mixed freely (e.g. a chunk filled here, a point
+// queried with Compute2dPerlinNoise later).
+
+//------------------------------------------------------------------------
+// Raw hashes, out[i] = Get1dNoiseUint(indices[i], seed) etc.
+void Get1dNoiseUints(const int* indices, unsigned int* out, uint count, unsigned int seed = 0);
+void Get2dNoiseUints(const int* indicesX, const int* indicesY, unsigned int* out, uint count, unsigned int seed = 0);
+
+//------------------------------------------------------------------------
+// Grid fills, row major: out[(y * width) + x] is the noise at
+// (origin.x + (x * step.x), origin.y + (y * step.y)).
+// out needs width * height floats. Parameters match Compute2dFractalNoise / Compute2dPerlinNoise.
+void Fill2dFractalNoise(float* out, int width, int height, const Vector2& origin, const Vector2& step, float scale = 1.f, unsigned int numOctaves = 1,
+	float octavePersistence = 0.5f, float octaveScale = 2.f, bool renormalize = true, unsigned int seed = 0);
+void Fill2dPerlinNoise(float* out, int width, int height, const Vector2& origin, const Vector2& step, float scale = 1.f, unsigned int numOctaves = 1,
+	float octavePersistence = 0.5f, float octaveScale = 2.f, bool renormalize = true, unsigned int seed = 0);
+
+//------------------------------------------------------------------------
+enum eNoiseSIMDLevel
+{
+	NOISE_SIMD_NONE, // scalar SquirrelNoise calls
+	NOISE_SIMD_SSE2,
+	NOISE_SIMD_AVX2,
+};
+
+eNoiseSIMDLevel GetNoiseSIMDLevel();
+void SetNoiseSIMDLevel(eNoiseSIMDLevel level); // clamped to what the CPU supports, for benchmarking
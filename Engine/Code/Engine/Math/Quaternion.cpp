@@ -0,0 +1,267 @@
+#include "Engine/Math/Quaternion.hpp"
+#include "Engine/Math/Matrix44.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include <math.h>
+
+const Quaternion Quaternion::identity = Quaternion();
+
+Quaternion::Quaternion(const Quaternion& copyFrom)
+	: x(copyFrom.x)
+	, y(copyFrom.y)
+	, z(copyFrom.z)
+	, w(copyFrom.w)
+{
+}
+
+Quaternion::Quaternion(float initialX, float initialY, float initialZ, float initialW)
+	: x(initialX)
+	, y(initialY)
+	, z(initialZ)
+	, w(initialW)
+{
+}
+
+const Quaternion Quaternion::operator*(const Quaternion& rotationToAppend) const
+{
+	const Quaternion& b = rotationToAppend;
+	return Quaternion((w * b.x) + (x * b.w) + (y * b.z) - (z * b.y),
+		(w * b.y) - (x * b.z) + (y * b.w) + (z * b.x),
+		(w * b.z) + (x * b.y) - (y * b.x) + (z * b.w),
+		(w * b.w) - (x * b.x) - (y * b.y) - (z * b.z));
+}
+
+void Quaternion::operator*=(const Quaternion& rotationToAppend)
+{
+	*this = *this * rotationToAppend;
+}
+
+void Quaternion::operator=(const Quaternion& copyFrom)
+{
+	x = copyFrom.x;
+	y = copyFrom.y;
+	z = copyFrom.z;
+	w = copyFrom.w;
+}
+
+bool Quaternion::operator==(const Quaternion& compare) const
+{
+	return x == compare.x && y == compare.y && z == compare.z && w == compare.w;
+}
+
+bool Quaternion::operator!=(const Quaternion& compare) const
+{
+	return !(*this == compare);
+}
+
+Vector3 Quaternion::Rotate(const Vector3& vec) const
+{
+	//v + w*t + u x t, with u = (x, y, z) and t = 2 * u x v
+	Vector3 u = Vector3(x, y, z);
+	Vector3 t = CrossProduct(u, vec) * 2.f;
+	return vec + (t * w) + CrossProduct(u, t);
+}
+
+Quaternion Quaternion::GetInverse() const
+{
+	return Quaternion(-x, -y, -z, w);
+}
+
+Quaternion Quaternion::GetNormalized() const
+{
+	Quaternion result = *this;
+	result.Normalize();
+	return result;
+}
+
+void Quaternion::Normalize()
+{
+	float lengthSquared = (x * x) + (y * y) + (z * z) + (w * w);
+	if (lengthSquared == 0.f)
+	{
+		*this = identity;
+		return;
+	}
+
+	float inverseLength = 1.f / sqrtf(lengthSquared);
+	x *= inverseLength;
+	y *= inverseLength;
+	z *= inverseLength;
+	w *= inverseLength;
+}
+
+Matrix44 Quaternion::GetMatrix() const
+{
+	return Matrix44(GetRight(), GetUp(), GetForward());
+}
+
+Vector3 Quaternion::GetEuler() const
+{
+	//same decomposition as Matrix44::GetEuler, only building the matrix entries it reads
+	float Ix = 1.f - 2.f * ((y * y) + (z * z));
+	float Iy = 2.f * ((x * y) + (w * z));
+	float Jy = 1.f - 2.f * ((x * x) + (z * z));
+	float Kx = 2.f * ((x * z) + (w * y));
+	float Ky = 2.f * ((y * z) - (w * x));
+	float Kz = 1.f - 2.f * ((x * x) + (y * y));
+
+	float xRad = asinf(-ClampFloat(Ky, -1.0f, 1.0f));
+	float yRad;
+	float zRad;
+
+	if (!IsMostlyEqual(cosf(xRad), 0.0f))
+	{
+		yRad = atan2f(Kx, Kz);
+		zRad = atan2f(Iy, Jy);
+	}
+	else
+	{
+		zRad = 0.f;
+		yRad = atan2f(-Kx, Ix);
+	}
+
+	return Vector3(xRad, yRad, zRad);
+}
+
+Vector3 Quaternion::GetRight() const
+{
+	return Vector3(1.f - 2.f * ((y * y) + (z * z)), 2.f * ((x * y) + (w * z)), 2.f * ((x * z) - (w * y)));
+}
+
+Vector3 Quaternion::GetUp() const
+{
+	return Vector3(2.f * ((x * y) - (w * z)), 1.f - 2.f * ((x * x) + (z * z)), 2.f * ((y * z) + (w * x)));
+}
+
+Vector3 Quaternion::GetForward() const
+{
+	return Vector3(2.f * ((x * z) + (w * y)), 2.f * ((y * z) - (w * x)), 1.f - 2.f * ((x * x) + (y * y)));
+}
+
+Quaternion Quaternion::MakeFromAxisAngle(const Vector3& axis, float radians)
+{
+	Vector3 unitAxis = axis.GetNormalized();
+	float halfAngle = radians * 0.5f;
+	float s = sinf(halfAngle);
+
+	return Quaternion(unitAxis.x * s, unitAxis.y * s, unitAxis.z * s, cosf(halfAngle));
+}
+
+Quaternion Quaternion::MakeFromEuler(const Vector3& eulerRotation)
+{
+	//MakeFromEuler builds yaw * pitch * roll
+	float cx = cosf(eulerRotation.x * 0.5f);
+	float sx = sinf(eulerRotation.x * 0.5f);
+	float cy = cosf(eulerRotation.y * 0.5f);
+	float sy = sinf(eulerRotation.y * 0.5f);
+	float cz = cosf(eulerRotation.z * 0.5f);
+	float sz = sinf(eulerRotation.z * 0.5f);
+
+	Quaternion pitch = Quaternion(sx, 0.f, 0.f, cx);
+	Quaternion yaw = Quaternion(0.f, sy, 0.f, cy);
+	Quaternion roll = Quaternion(0.f, 0.f, sz, cz);
+
+	return yaw * pitch * roll;
+}
+
+Quaternion Quaternion::MakeFromBasis(const Vector3& right, const Vector3& up, const Vector3& forward)
+{
+	//Shepperd's method, picking the largest diagonal term keeps the sqrt well away from zero
+	float trace = right.x + up.y + forward.z;
+	Quaternion result;
+
+	if (trace > 0.f)
+	{
+		float s = 0.5f / sqrtf(trace + 1.f);
+		result = Quaternion((up.z - forward.y) * s, (forward.x - right.z) * s, (right.y - up.x) * s, 0.25f / s);
+	}
+	else if (right.x > up.y && right.x > forward.z)
+	{
+		float s = 2.f * sqrtf(1.f + right.x - up.y - forward.z);
+		result = Quaternion(0.25f * s, (up.x + right.y) / s, (forward.x + right.z) / s, (up.z - forward.y) / s);
+	}
+	else if (up.y > forward.z)
+	{
+		float s = 2.f * sqrtf(1.f + up.y - right.x - forward.z);
+		result = Quaternion((up.x + right.y) / s, 0.25f * s, (forward.y + up.z) / s, (forward.x - right.z) / s);
+	}
+	else
+	{
+		float s = 2.f * sqrtf(1.f + forward.z - right.x - up.y);
+		result = Quaternion((forward.x + right.z) / s, (forward.y + up.z) / s, 0.25f * s, (right.y - up.x) / s);
+	}
+
+	result.Normalize();
+	return result;
+}
+
+Quaternion Quaternion::MakeFromMatrix(const Matrix44& mat)
+{
+	return MakeFromBasis(mat.GetRight().GetNormalized(), mat.GetUp().GetNormalized(), mat.GetForward().GetNormalized());
+}
+
+Quaternion Quaternion::LookRotation(const Vector3& forward, const Vector3& up)
+{
+	//same basis as Matrix44::LookAt
+	Vector3 unitForward = forward.GetNormalized();
+	Vector3 right = CrossProduct(up, unitForward);
+	right.NormalizeAndGetLength();
+	Vector3 unitUp = CrossProduct(unitForward, right);
+
+	return MakeFromBasis(right, unitUp, unitForward);
+}
+
+//------------------------------------------------------------------------
+float DotProduct(const Quaternion& a, const Quaternion& b)
+{
+	return (a.x * b.x) + (a.y * b.y) + (a.z * b.z) + (a.w * b.w);
+}
+
+float GetAngleBetween(const Quaternion& a, const Quaternion& b)
+{
+	//q and -q are the same rotation
+	float dot = fabsf(DotProduct(a, b));
+	return 2.f * acosf(MinFloat(dot, 1.f));
+}
+
+Quaternion Slerp(const Quaternion& a, const Quaternion& b, float t)
+{
+	Quaternion end = b;
+	float dot = DotProduct(a, b);
+	if (dot < 0.f)
+	{
+		end = Quaternion(-b.x, -b.y, -b.z, -b.w);
+		dot = -dot;
+	}
+
+	float weightA;
+	float weightB;
+	if (dot > 0.9995f)
+	{
+		//nearly the same rotation, sin(theta) is too small to divide by so lerp instead
+		weightA = 1.f - t;
+		weightB = t;
+	}
+	else
+	{
+		float theta = acosf(dot);
+		float inverseSinTheta = 1.f / sinf(theta);
+		weightA = sinf((1.f - t) * theta) * inverseSinTheta;
+		weightB = sinf(t * theta) * inverseSinTheta;
+	}
+
+	Quaternion result = Quaternion((a.x * weightA) + (end.x * weightB),
+		(a.y * weightA) + (end.y * weightB),
+		(a.z * weightA) + (end.z * weightB),
+		(a.w * weightA) + (end.w * weightB));
+	result.Normalize();
+	return result;
+}
+
+Quaternion RotateTowards(const Quaternion& current, const Quaternion& target, float maxTurnRadians)
+{
+	float angle = GetAngleBetween(current, target);
+	if (angle <= maxTurnRadians)
+		return target;
+
+	return Slerp(current, target, maxTurnRadians / angle);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Engine/Math/Vector3.hpp"
+
+class Matrix44;
+
+// Unit quaternion rotation, same conventions as Matrix44 (column vectors, right-multiply
+// to concatenate): a * b rotates by b first, then by a.
+// Euler angles are radians and match Matrix44::MakeFromEuler / GetEuler.
+class Quaternion
+{
+public:
+	~Quaternion() {}
+	Quaternion() {} // identity
+	Quaternion(const Quaternion& copyFrom);
+	explicit Quaternion(float initialX, float initialY, float initialZ, float initialW);
+
+	// Operators
+	const Quaternion operator*(const Quaternion& rotationToAppend) const;	// concatenate
+	void operator*=(const Quaternion& rotationToAppend);
+	void operator=(const Quaternion& copyFrom);
+	bool operator==(const Quaternion& compare) const;
+	bool operator!=(const Quaternion& compare) const;
+
+	Vector3 Rotate(const Vector3& vec) const;
+	Quaternion GetInverse() const; // conjugate, assumes unit length
+	Quaternion GetNormalized() const;
+	void Normalize();
+
+	Matrix44 GetMatrix() const;
+	Vector3 GetEuler() const;
+	Vector3 GetRight() const;
+	Vector3 GetUp() const;
+	Vector3 GetForward() const;
+
+	// Producers
+	static Quaternion MakeFromAxisAngle(const Vector3& axis, float radians);
+	static Quaternion MakeFromEuler(const Vector3& eulerRotation);
+	static Quaternion MakeFromBasis(const Vector3& right, const Vector3& up, const Vector3& forward); // orthonormal basis
+	static Quaternion MakeFromMatrix(const Matrix44& mat); // ignores translation and scale
+	static Quaternion LookRotation(const Vector3& forward, const Vector3& up = Vector3::up);
+
+public:
+	float x = 0.f;
+	float y = 0.f;
+	float z = 0.f;
+	float w = 1.f;
+
+	static const Quaternion identity;
+};
+
+float DotProduct(const Quaternion& a, const Quaternion& b);
+float GetAngleBetween(const Quaternion& a, const Quaternion& b); // radians, always the short way round
+Quaternion Slerp(const Quaternion& a, const Quaternion& b, float t);
+Quaternion RotateTowards(const Quaternion& current, const Quaternion& target, float maxTurnRadians);
@@ -0,0 +1,123 @@
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/ThirdParty/SquirrelNoise/RawNoise.hpp"
+#include <math.h>
+#include <stdint.h>
+#include <atomic>
+
+static unsigned int g_baseSeed = 0;
+static std::atomic<int> g_seededThreadCount(0);
+
+static thread_local RandomNumberGenerator t_threadRandom;
+static thread_local bool t_isThreadRandomSeeded = false;
+
+void RandomNumberGenerator::SetSeed(unsigned int seed)
+{
+	m_seed = seed;
+	for (int i = 0; i < 4; i++)
+		m_state[i] = Get1dNoiseUint(i, seed);
+
+	//xoshiro never leaves the all zero state
+	if ((m_state[0] | m_state[1] | m_state[2] | m_state[3]) == 0)
+		m_state[0] = 1;
+}
+
+int RandomNumberGenerator::GetRandomIntLessThan(int maxExclusive)
+{
+	//multiply-shift instead of %, no modulo bias and no divide
+	return (int) (((uint64_t) GetRandomUint() * (uint64_t) maxExclusive) >> 32);
+}
+
+int RandomNumberGenerator::GetRandomIntInRange(int minInclusive, int maxInclusive)
+{
+	int range = (maxInclusive - minInclusive) + 1;
+	return minInclusive + GetRandomIntLessThan(range);
+}
+
+float RandomNumberGenerator::GetRandomFloatZeroToOne()
+{
+	//top 24 bits, exactly what a float mantissa holds
+	return (float) (GetRandomUint() >> 8) * (1.f / 16777216.f);
+}
+
+float RandomNumberGenerator::GetRandomFloatInRange(float min, float max)
+{
+	return min + ((max - min) * GetRandomFloatZeroToOne());
+}
+
+bool RandomNumberGenerator::CheckRandomChance(float chanceForSuccess)
+{
+	float clampedChance = ClampFloatZeroToOne(chanceForSuccess);
+	if (clampedChance == 1)
+		return true;
+
+	return GetRandomFloatZeroToOne() < clampedChance;
+}
+
+Vector3 RandomNumberGenerator::RandomPointOnSphere(float radius)
+{
+	//uniform height and angle around the axis is uniform over the sphere (Archimedes)
+	float z = GetRandomFloatInRange(-1.f, 1.f);
+	float radians = GetRandomFloatInRange(0.f, 2.f * MathUtils::PI);
+	float ringRadius = sqrtf(MaxFloat(0.f, 1.f - (z * z)));
+
+	return Vector3(ringRadius * cosf(radians), ringRadius * sinf(radians), z) * radius;
+}
+
+Vector3 RandomNumberGenerator::RandomPointInCube(float extend)
+{
+	float x = GetRandomFloatInRange(-1.f, 1.f);
+	float y = GetRandomFloatInRange(-1.f, 1.f);
+	float z = GetRandomFloatInRange(-1.f, 1.f);
+
+	return Vector3(x * extend, y * extend, z * extend);
+}
+
+void RandomNumberGenerator::FillRandomFloatsInRange(float* out, unsigned int count, float min, float max)
+{
+	float scale = (max - min) * (1.f / 16777216.f);
+	for (unsigned int i = 0; i < count; i++)
+		out[i] = min + ((float) (GetRandomUint() >> 8) * scale);
+}
+
+void RandomNumberGenerator::FillRandomPointsOnSphere(Vector3* out, unsigned int count, float radius)
+{
+	for (unsigned int i = 0; i < count; i++)
+		out[i] = RandomPointOnSphere(radius);
+}
+
+void RandomNumberGenerator::FillRandomPointsInCube(Vector3* out, unsigned int count, float extend)
+{
+	float scale = 2.f * extend * (1.f / 16777216.f);
+	for (unsigned int i = 0; i < count; i++)
+	{
+		out[i].x = ((float) (GetRandomUint() >> 8) * scale) - extend;
+		out[i].y = ((float) (GetRandomUint() >> 8) * scale) - extend;
+		out[i].z = ((float) (GetRandomUint() >> 8) * scale) - extend;
+	}
+}
+
+//------------------------------------------------------------------------
+RandomNumberGenerator& GetThreadRandom()
+{
+	if (!t_isThreadRandomSeeded)
+	{
+		//first use on this thread, derive a seed from the base one
+		t_threadRandom.SetSeed(Get1dNoiseUint(g_seededThreadCount++, g_baseSeed));
+		t_isThreadRandomSeeded = true;
+	}
+
+	return t_threadRandom;
+}
+
+void SetRandomSeed(unsigned int seed)
+{
+	g_baseSeed = seed;
+	t_threadRandom.SetSeed(seed);
+	t_isThreadRandomSeeded = true;
+}
+
+unsigned int GetRandomSeed()
+{
+	return g_baseSeed;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Engine/Math/Vector3.hpp"
+
+// xoshiro128** generator: four words of state, a handful of shifts and a multiply per
+// number, passes BigCrush. Seeding runs the seed through SquirrelNoise so nearby seeds
+// (0, 1, 2...) still give unrelated sequences.
+// Not thread safe on its own; each thread gets one from GetThreadRandom(), or own one.
+class RandomNumberGenerator
+{
+public:
+	RandomNumberGenerator() { SetSeed(0); }
+	explicit RandomNumberGenerator(unsigned int seed) { SetSeed(seed); }
+
+	void SetSeed(unsigned int seed);
+	inline unsigned int GetSeed() const { return m_seed; }
+
+	inline unsigned int GetRandomUint()
+	{
+		unsigned int result = RotateLeft(m_state[1] * 5, 7) * 9;
+		unsigned int t = m_state[1] << 9;
+
+		m_state[2] ^= m_state[0];
+		m_state[3] ^= m_state[1];
+		m_state[1] ^= m_state[2];
+		m_state[0] ^= m_state[3];
+		m_state[2] ^= t;
+		m_state[3] = RotateLeft(m_state[3], 11);
+
+		return result;
+	}
+
+	// Same API as the MathUtils functions
+	int GetRandomIntLessThan(int maxExclusive);
+	int GetRandomIntInRange(int minInclusive, int maxInclusive);
+	float GetRandomFloatZeroToOne(); // [0,1)
+	float GetRandomFloatInRange(float min, float max);
+	bool CheckRandomChance(float chanceForSuccess);
+	Vector3 RandomPointOnSphere(float radius = 1.f);
+	Vector3 RandomPointInCube(float extend = 1.f);
+
+	// Bulk fills
+	void FillRandomFloatsInRange(float* out, unsigned int count, float min, float max);
+	void FillRandomPointsOnSphere(Vector3* out, unsigned int count, float radius = 1.f);
+	void FillRandomPointsInCube(Vector3* out, unsigned int count, float extend = 1.f);
+
+private:
+	static inline unsigned int RotateLeft(unsigned int x, int k)
+	{
+		return (x << k) | (x >> (32 - k));
+	}
+
+private:
+	unsigned int m_state[4];
+	unsigned int m_seed = 0;
+};
+
+//------------------------------------------------------------------------
+// Per-thread generator behind the MathUtils random functions.
+// SetRandomSeed seeds the calling thread and becomes the base seed for threads that
+// haven't drawn a number yet. Work that has to replay exactly on any thread should
+// seed GetThreadRandom() itself, or carry its own RandomNumberGenerator.
+RandomNumberGenerator& GetThreadRandom();
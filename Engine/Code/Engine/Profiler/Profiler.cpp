@@ -4,21 +4,39 @@
 #include "Engine/Core/DevConsole.hpp"
 #include "Engine/Profiler/ProfilerReport.hpp"
 #include "Engine/Profiler/ProfilerView.hpp"
+#include "Engine/File/File.hpp"
+#include "Engine/Core/MemoryTracker.hpp"
 
 static Profiler* g_profiler = nullptr; 
 
+//counter names live outside the profiler so call sites can register before startup
+static char g_counterNames[PROFILE_MAX_COUNTERS][PROFILE_MAX_COUNTER_NAME_LENGTH];
+static int g_counterCount = 0;
+
 Profiler::~Profiler()
 {
+	if (m_hitchWriter.joinable())
+		m_hitchWriter.join();
+
 	m_measurementPool.Clear();
 }
 
 Profiler::Profiler()
 {
 	for (int i = 0; i < PROFILE_MAX_HISTORY_LENGTH; i++)
+	{
 		m_frameHistory[i] = nullptr;
+		m_counterHistory[i].Reset();
+	}
+
+	m_frameCounters.Reset();
+	m_prevFrameCounters.Reset();
+
+	m_hitchThresholdSeconds = g_gameConfigBlackboard.GetValue("profilerHitchThresholdMs", 0.f) / 1000.0;
 
 	CommandRegister("profiler_pause", Profiler::ProfilePause, "Pause profiler");
 	CommandRegister("profiler_resume", Profiler::ProfileResume, "Resume profiler");
+	CommandRegister("profiler_hitch", Profiler::ProfileHitchThreshold, "Set hitch capture threshold in ms (0 to disable)");
 }
 
 void Profiler::ProfilePush(const char* tag)
@@ -60,7 +78,14 @@ void Profiler::MarkFrame()
 			SaveReportFromFrame(m_prevFrame);
 		}
 
+		if (MemoryTrackerIsEnabled())
+		{
+			CounterAdd(ProfilerGetCounterIndex("allocations"), MemoryTrackerGetFrameAllocationCount());
+			CounterAdd(ProfilerGetCounterIndex("allocated bytes"), MemoryTrackerGetFrameAllocationBytes());
+		}
+
 		m_prevFrame = m_activeNode;
+		m_prevFrameCounters = m_frameCounters;
 		ProfilePop(); //pop "frame"
 
 		ASSERT_OR_DIE(m_activeNode == nullptr, "Someone forgot to pop");
@@ -71,6 +96,8 @@ void Profiler::MarkFrame()
 	else
 		m_isPaused = false;
 
+	m_frameCounters.Reset();
+	MemoryTrackerMarkFrame();
 	ProfilePush("frame"); 
 }
 
@@ -147,9 +174,130 @@ void Profiler::SaveReportFromFrame(profile_measurement_t* node)
 		DestroyMeasurementTreeRecursive(m_frameHistory[index]);
 
 	m_frameHistory[index] = node;
+	m_counterHistory[index] = m_prevFrameCounters;
 	m_frameCount++;
+
+	CheckForHitch(node);
+}
+
+void Profiler::CheckForHitch(profile_measurement_t* frame)
+{
+	//waiting for the frames after a hitch before writing it out
+	if (m_hitchFrameIndex >= 0)
+	{
+		m_hitchFramesToWait--;
+		if (m_hitchFramesToWait <= 0)
+			WriteHitchCapture();
+		return;
+	}
+
+	if (m_hitchThresholdSeconds <= 0.0)
+		return;
+
+	if (PerformanceCounterToSeconds(frame->GetElapsedTime()) > m_hitchThresholdSeconds)
+	{
+		m_hitchFrameIndex = m_frameCount - 1;
+		m_hitchFramesToWait = PROFILE_HITCH_SURROUNDING_FRAMES;
+		if (m_hitchFramesToWait <= 0)
+			WriteHitchCapture();
+	}
+}
+
+void Profiler::WriteHitchCapture()
+{
+	//serialize on this thread while the trees are still guaranteed to be in the history
+	std::string data = Stringf("Hitch threshold: %.2f ms\n", m_hitchThresholdSeconds * 1000.0);
+
+	int firstFrame = m_hitchFrameIndex - PROFILE_HITCH_SURROUNDING_FRAMES;
+	if (firstFrame < 0)
+		firstFrame = 0;
+
+	for (int frameIndex = firstFrame; frameIndex < m_frameCount; frameIndex++)
+	{
+		profile_measurement_t* frame = m_frameHistory[frameIndex % PROFILE_MAX_HISTORY_LENGTH];
+		if (frame == nullptr)
+			continue;
+
+		data += Stringf("\n==== frame %d: %.3f ms%s ====\n", frameIndex, PerformanceCounterToSeconds(frame->GetElapsedTime()) * 1000.0, 
+			frameIndex == m_hitchFrameIndex ? " [HITCH]" : "");
+		data += MeasurementTreeToString(frame, frame->m_start_hpc);
+		data += CountersToString(m_counterHistory[frameIndex % PROFILE_MAX_HISTORY_LENGTH]);
+	}
+
+	std::string filename = Stringf("Profiler_Hitch_%s_frame%d", GetFormatedDateTime().c_str(), m_hitchFrameIndex);
+	m_hitchFrameIndex = -1;
+
+	//disk write happens in the background so the capture doesn't cause another hitch
+	if (m_hitchWriter.joinable())
+		m_hitchWriter.join();
+
+	m_hitchWriter = std::thread([filename, data]()
+	{
+		WriteStringToFile(filename.c_str(), data);
+	});
+}
+
+std::string Profiler::MeasurementTreeToString(profile_measurement_t* node, uint64_t frameStartHPC, int depth)
+{
+	if (node == nullptr)
+		return "";
+
+	std::string result = Stringf("%*s%-*s start: %8.3f ms  total: %8.3f ms\n", depth * 2, "", 64 - depth * 2, node->m_id,
+		PerformanceCounterToSeconds(node->m_start_hpc - frameStartHPC) * 1000.0, PerformanceCounterToSeconds(node->GetElapsedTime()) * 1000.0);
+
+	for (profile_measurement_t* child = node->m_children; child != nullptr; child = child->next)
+		result += MeasurementTreeToString(child, frameStartHPC, depth + 1);
+
+	return result;
+}
+
+
+void Profiler::CounterAdd(int counterIndex, int64_t amount)
+{
+	if (m_isPaused || counterIndex < 0)
+		return;
+
+	m_frameCounters.m_values[counterIndex] += amount;
+}
+
+profile_counters_t* Profiler::ProfileGetPreviousFrameCounters(uint skipCount)
+{
+	profile_measurement_t* frame = ProfileGetPreviousFrame(skipCount);
+	if (frame == nullptr)
+		return nullptr;
+
+	int index = m_frameCount % PROFILE_MAX_HISTORY_LENGTH;
+
+	index -= skipCount + 1;
+	if (index < 0)
+		index = PROFILE_MAX_HISTORY_LENGTH + index;
+
+	return &m_counterHistory[index];
+}
+
+int64_t Profiler::GetWorstCounterValueInHistory(int counterIndex)
+{
+	int64_t worst = 0;
+
+	for (int i = 0; i < PROFILE_MAX_HISTORY_LENGTH; i++)
+	{
+		if (m_frameHistory[i] != nullptr && m_counterHistory[i].m_values[counterIndex] > worst)
+			worst = m_counterHistory[i].m_values[counterIndex];
+	}
+
+	return worst;
 }
 
+std::string Profiler::CountersToString(const profile_counters_t& counters)
+{
+	std::string result = "";
+	for (int i = 0; i < g_counterCount; i++)
+	{
+		result += Stringf("%-*s %lld\n", PROFILE_MAX_COUNTER_NAME_LENGTH, g_counterNames[i], counters.m_values[i]);
+	}
+
+	return result;
+}
 
 Profiler* Profiler::GetInstance()
 {
@@ -172,6 +320,25 @@ void Profiler::ProfileResume(Command& cmd)
 #endif
 }
 
+void Profiler::ProfileHitchThreshold(Command& cmd)
+{
+	UNUSED(cmd);
+#if !defined(ENGINE_DISABLE_PROFILING) 
+	int thresholdMs = 0;
+	if (!cmd.GetNextInt(&thresholdMs) || thresholdMs < 0)
+	{
+		ConsoleErrorf("Usage: profiler_hitch <threshold ms>, 0 disables capture");
+		return;
+	}
+
+	g_profiler->m_hitchThresholdSeconds = thresholdMs / 1000.0;
+	if (thresholdMs == 0)
+		ConsolePrintf("Hitch capture disabled");
+	else
+		ConsolePrintf("Hitch capture threshold set to %d ms", thresholdMs);
+#endif
+}
+
 void ProfilingSystemStartup()
 {
 #if !defined(ENGINE_DISABLE_PROFILING) 
@@ -225,3 +392,55 @@ void ProfilerResume()
 	g_profiler->m_pauseInitiated = false;
 #endif
 }
+
+
+const char* ProfilerGetActiveTag()
+{
+#if !defined(ENGINE_DISABLE_PROFILING) 
+	if (g_profiler != nullptr && g_profiler->m_activeNode != nullptr)
+		return g_profiler->m_activeNode->m_id;
+#endif
+	return nullptr;
+}
+
+int ProfilerGetCounterIndex(const char* id)
+{
+	for (int i = 0; i < g_counterCount; i++)
+	{
+		if (strcmp(g_counterNames[i], id) == 0)
+			return i;
+	}
+
+	if (g_counterCount >= PROFILE_MAX_COUNTERS)
+	{
+		ASSERT_RECOVERABLE(false, "Ran out of profiler counters, raise PROFILE_MAX_COUNTERS");
+		return -1;
+	}
+
+	strncpy_s(g_counterNames[g_counterCount], id, PROFILE_MAX_COUNTER_NAME_LENGTH - 1);
+	return g_counterCount++;
+}
+
+int ProfilerGetCounterCount()
+{
+	return g_counterCount;
+}
+
+const char* ProfilerGetCounterName(int counterIndex)
+{
+	if (counterIndex < 0 || counterIndex >= g_counterCount)
+		return "";
+
+	return g_counterNames[counterIndex];
+}
+
+void ProfilerCounterAdd(int counterIndex, int64_t amount)
+{
+#if !defined(ENGINE_DISABLE_PROFILING) 
+	if (g_profiler != nullptr)
+		g_profiler->CounterAdd(counterIndex, amount);
+#else
+	UNUSED(counterIndex);
+	UNUSED(amount);
+#endif
+}
\ No newline at end of file
@@ -6,8 +6,13 @@
 #include "Engine/Core/PageAllocator.hpp"
 #include "Engine/Core/Command.hpp"
 #include <stdint.h>
+#include <string.h>
+#include <thread>
 
 #define PROFILE_MAX_HISTORY_LENGTH 256
+#define PROFILE_HITCH_SURROUNDING_FRAMES 3
+#define PROFILE_MAX_COUNTERS 32
+#define PROFILE_MAX_COUNTER_NAME_LENGTH 32
 
 struct profile_measurement_t 
 {
@@ -42,6 +47,14 @@ struct profile_measurement_t
 	profile_measurement_t* next = nullptr; 
 };
 
+//per frame counts (draws, triangles...) recorded next to the measurement tree of the same frame
+struct profile_counters_t
+{
+	int64_t m_values[PROFILE_MAX_COUNTERS];
+
+	void Reset() { memset(m_values, 0, sizeof(m_values)); }
+};
+
 class Profiler
 {
 public:
@@ -57,9 +70,21 @@ public:
 	void DestroyMeasurementTreeRecursive(profile_measurement_t* node);
 	void SaveReportFromFrame(profile_measurement_t* node);
 
+	//hitch capture
+	void CheckForHitch(profile_measurement_t* frame);
+	void WriteHitchCapture();
+	static std::string MeasurementTreeToString(profile_measurement_t* node, uint64_t frameStartHPC, int depth = 0);
+
+	//counters
+	void CounterAdd(int counterIndex, int64_t amount);
+	profile_counters_t* ProfileGetPreviousFrameCounters(uint skipCount = 0);
+	int64_t GetWorstCounterValueInHistory(int counterIndex);
+	static std::string CountersToString(const profile_counters_t& counters);
+
 	static Profiler* GetInstance();
 	static void ProfilePause(Command& cmd);
 	static void ProfileResume(Command& cmd);
+	static void ProfileHitchThreshold(Command& cmd);
 
 public:
 	profile_measurement_t* m_activeNode = nullptr; 
@@ -72,7 +97,16 @@ public:
 	int m_startIndex = 0;
 	int m_endIndex = 0;
 
-	TPageAllocator<profile_measurement_t> m_measurementPool;
+	TPageAllocator<profile_measurement_t, 1024> m_measurementPool; //a frame can hold hundreds of measurements
+
+	profile_counters_t m_frameCounters; //frame in progress
+	profile_counters_t m_prevFrameCounters; //matches m_prevFrame
+	profile_counters_t m_counterHistory[PROFILE_MAX_HISTORY_LENGTH]; //matches m_frameHistory
+
+	double m_hitchThresholdSeconds = 0.0; //0 disables hitch capture
+	int m_hitchFrameIndex = -1; //frame count of the pending hitch, -1 if none
+	int m_hitchFramesToWait = 0;
+	std::thread m_hitchWriter;
 };
 
 void ProfilingSystemStartup();
@@ -83,10 +117,24 @@ void ProfilerMarkFrame();
 void ProfilerPause();
 void ProfilerResume(); 
 
+const char* ProfilerGetActiveTag(); //nullptr outside of any scope
+
+int ProfilerGetCounterIndex(const char* id);
+int ProfilerGetCounterCount();
+const char* ProfilerGetCounterName(int counterIndex);
+void ProfilerCounterAdd(int counterIndex, int64_t amount);
+
 //////////////////////////////////////////////////////////////////////////
 #define PROFILE_SCOPE(tag) ProfileScoped __timer_ ##__LINE__ ## (tag)
 #define PROFILE_SCOPE_FUNCTION()  ProfileScoped __timer_ ##__LINE__ ## (__FUNCTION__)
 
+//counter index is looked up once per call site
+#if !defined(ENGINE_DISABLE_PROFILING)
+#define PROFILE_COUNTER_ADD(id, amount) do { static int __counter_index = ProfilerGetCounterIndex(id); ProfilerCounterAdd(__counter_index, (int64_t) (amount)); } while (0)
+#else
+#define PROFILE_COUNTER_ADD(id, amount) do {} while (0)
+#endif
+
 class ProfileScoped
 {
 public:
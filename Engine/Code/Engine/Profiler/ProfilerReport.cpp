@@ -139,4 +139,8 @@ void ProfilerReport::ProfilerReportToConsole(Command& cmd)
 		g_profilerReport->GenerateReportTreeFromFrame(Profiler::GetInstance()->ProfileGetPreviousFrame());
 		ConsolePrintf(ProfilerView::GetInstance()->ProfileEntryToStringIndented(g_profilerReport->m_root).c_str());
 	}
+
+	profile_counters_t* counters = Profiler::GetInstance()->ProfileGetPreviousFrameCounters();
+	if (counters != nullptr)
+		ConsolePrintf(Profiler::CountersToString(*counters).c_str());
 }
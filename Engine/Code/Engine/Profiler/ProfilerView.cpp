@@ -20,6 +20,9 @@ constexpr uint GRAPH_WIDTH = 800;
 constexpr uint GRAPH_HEIGHT = 200;
 static Vector2 GRAPH_BOT_LEFT = Vector2(700, 750);
 
+constexpr uint COUNTER_GRAPH_HEIGHT = 150;
+static Vector2 COUNTER_GRAPH_BOT_LEFT = Vector2(700, 570);
+
 ProfilerView::~ProfilerView()
 {
 }
@@ -27,6 +30,7 @@ ProfilerView::~ProfilerView()
 ProfilerView::ProfilerView()
 {
 	m_graphBounds = AABB2(GRAPH_BOT_LEFT, Vector2(GRAPH_BOT_LEFT.x + GRAPH_WIDTH, GRAPH_BOT_LEFT.y + GRAPH_HEIGHT));
+	m_counterGraphBounds = AABB2(COUNTER_GRAPH_BOT_LEFT, Vector2(COUNTER_GRAPH_BOT_LEFT.x + GRAPH_WIDTH, COUNTER_GRAPH_BOT_LEFT.y + COUNTER_GRAPH_HEIGHT));
 	m_graphHitBounds = AABB2(GRAPH_BOT_LEFT.x, Window::GetHeight() - GRAPH_BOT_LEFT.y - GRAPH_HEIGHT, GRAPH_BOT_LEFT.x + GRAPH_WIDTH, Window::GetHeight() - GRAPH_BOT_LEFT.y);
 
 	CommandRegister("profiler", ProfilerView::ProfilerViewToggle, "Toggle ProfilerView");
@@ -67,6 +71,12 @@ void ProfilerView::StartUp()
 	t->m_height = 18.f;
 	m_fpsAndFrameTimeText = t;
 	m_canvas->m_canvasGroups[1]->m_elements.push_back(t);
+
+	t = new TextUI(m_canvas);
+	t->SetBounds(AABB2(0.75f, 0.1f, 1.f, 0.5f));
+	t->m_height = 14.f;
+	m_countersText = t;
+	m_canvas->m_canvasGroups[1]->m_elements.push_back(t);
 }
 
 void ProfilerView::Update()
@@ -115,8 +125,15 @@ void ProfilerView::Update()
 		else
 			modeText.append("\nM - MOUSE DISABLE");
 
+		modeText.append(Stringf("\nC - COUNTER GRAPH: %s", ProfilerGetCounterName(m_counterSelected)));
+
 		m_viewModeText->SetText(modeText);
 
+		//Counters
+		profile_counters_t* counters = profiler->ProfileGetPreviousFrameCounters(frameToUse);
+		if (counters != nullptr)
+			m_countersText->SetText("COUNTERS\n" + Profiler::CountersToString(*counters));
+
 		//FPS
 		//root is not actual root...we need to get a level down for real info
 		m_fpsAndFrameTimeText->SetText(Stringf("FPS: %.0f\nLAST FRAME TIME: %s", std::trunc(1.0 / report->GetTotalFrameTime()), TimePerfCountToString(report->m_frameRoot->m_totalHPC).c_str()));
@@ -192,11 +209,77 @@ void ProfilerView::Render()
 
 		mb.End();
 
+		RenderCounterGraph();
+
 		r->EnableDepth(COMPARE_LESS, true);
 	}
 
 }
 
+void ProfilerView::RenderCounterGraph()
+{
+	Renderer* r = Renderer::GetInstance();
+	Profiler* profiler = Profiler::GetInstance();
+
+	if (m_counterSelected >= ProfilerGetCounterCount())
+		return;
+
+	r->DrawAABB(m_counterGraphBounds, Rgba(120, 120, 150, 255));
+
+	int64_t worstValue = profiler->GetWorstCounterValueInHistory(m_counterSelected);
+	if (worstValue <= 0)
+		return;
+
+	std::vector<VertexPCU> vertexs;
+	vertexs.reserve(PROFILE_MAX_HISTORY_LENGTH * 6);
+
+	int indexLeft = 0;
+	float blockWidth = (float) GRAPH_WIDTH / (PROFILE_MAX_HISTORY_LENGTH - 1);
+	for (int i = PROFILE_MAX_HISTORY_LENGTH - 1; i > 0; i--)
+	{
+		profile_counters_t* leftCounters = profiler->ProfileGetPreviousFrameCounters(i);
+		profile_counters_t* rightCounters = profiler->ProfileGetPreviousFrameCounters(i - 1);
+
+		//no data
+		if (leftCounters == nullptr || rightCounters == nullptr)
+			break;
+
+		float left = COUNTER_GRAPH_BOT_LEFT.x + (indexLeft * blockWidth);
+		float right = COUNTER_GRAPH_BOT_LEFT.x + ((indexLeft + 1) * blockWidth);
+		float bot = COUNTER_GRAPH_BOT_LEFT.y;
+		float tl_y = RangeMapFloat((float) leftCounters->m_values[m_counterSelected], 0, (float) worstValue, bot, bot + COUNTER_GRAPH_HEIGHT);
+		float tr_y = RangeMapFloat((float) rightCounters->m_values[m_counterSelected], 0, (float) worstValue, bot, bot + COUNTER_GRAPH_HEIGHT);
+
+		Rgba colorToUse = (m_frameSelected + 1 != i) ? Rgba::cyan : Rgba::red;
+
+		vertexs.push_back(VertexPCU(Vector2(left, bot), colorToUse, Vector2(0, 1)));
+		vertexs.push_back(VertexPCU(Vector2(right, bot), colorToUse, Vector2(1, 1)));
+		vertexs.push_back(VertexPCU(Vector2(left, tl_y), colorToUse, Vector2(0, 0)));
+
+		vertexs.push_back(VertexPCU(Vector2(left, tl_y), colorToUse, Vector2(0, 0)));
+		vertexs.push_back(VertexPCU(Vector2(right, bot), colorToUse, Vector2(1, 1)));
+		vertexs.push_back(VertexPCU(Vector2(right, tr_y), colorToUse, Vector2(1, 0)));
+
+		indexLeft++;
+	}
+
+	if (vertexs.empty())
+		return;
+
+	r->BindSampler(0, nullptr);
+	r->BindTexture(0, nullptr);
+	r->DrawMeshImmediate(vertexs.data(), (int) vertexs.size(), eDrawPrimitive::TRIANGLES);
+}
+
+void ProfilerView::CycleSelectedCounter()
+{
+	int counterCount = ProfilerGetCounterCount();
+	if (counterCount == 0)
+		return;
+
+	m_counterSelected = (m_counterSelected + 1) % counterCount;
+}
+
 void ProfilerView::OnMouseDown(MOUSE_CODE button, const Vector2& mousePos)
 {
 	//if within graph bounds
@@ -17,6 +17,8 @@ public:
 	void StartUp();
 	void Update();
 	void Render();
+	void RenderCounterGraph();
+	void CycleSelectedCounter();
 
 	inline bool IsOpen() { return m_isActive; };
 
@@ -43,11 +45,14 @@ public:
 	TextUI* m_fpsAndFrameTimeText = nullptr;
 	TextUI* m_frameReportText = nullptr;
 	TextUI* m_viewModeText = nullptr;
+	TextUI* m_countersText = nullptr;
 
 	AABB2 m_graphBounds;
 	AABB2 m_graphHitBounds;
+	AABB2 m_counterGraphBounds;
 
 	int m_frameSelected = -1; //-1 marks not selected
+	int m_counterSelected = 0; //counter shown in the counter graph
 
 private:
 	bool m_isActive = false;
@@ -10,11 +10,29 @@ BitmapFont::BitmapFont(const std::string& fontName, const SpriteSheet& glyphShee
 
 }
 
+void BitmapFont::SetSDFAtlas(const sdf_atlas_t& atlas, const Texture* atlasTexture)
+{
+	m_sdfTexture = atlasTexture;
+	for (int glyph = 0; glyph < SDF_GLYPH_COUNT; glyph++)
+		m_sdfGlyphs[glyph] = atlas.glyphs[glyph];
+}
+
 AABB2 BitmapFont::GetUVsForGlyph(int glyphUnicode) const
 {
+	if (IsSDF())
+		return m_sdfGlyphs[(unsigned char) glyphUnicode].uvs;
+
 	return m_spriteSheet.GetTexCoordsForSpriteIndex(glyphUnicode);
 }
 
+AABB2 BitmapFont::GetGlyphBox(int glyphUnicode) const
+{
+	if (IsSDF())
+		return m_sdfGlyphs[(unsigned char) glyphUnicode].box; //zero sized for blank glyphs
+
+	return AABB2(0.f, 0.f, 1.f, 1.f);
+}
+
 float BitmapFont::GetGlyphAspect(int glyphUnicode) const
 {
 	UNUSED(glyphUnicode);
@@ -2,6 +2,7 @@
 
 #include "Engine/Math/AABB2.hpp"
 #include "Engine/Renderer/SpriteSheet.hpp"
+#include "Engine/Renderer/SDFFont.hpp"
 #include <string>
 
 class BitmapFont
@@ -12,12 +13,18 @@ public:
 	AABB2 GetUVsForGlyph(int glyphUnicode) const; // pass A or 65 for A, etc.
 	float GetGlyphAspect(int glyphUnicode) const; // will change later
 	float GetStringWidth(const std::string& asciiText, float cellHeight, float aspectScale) const;
+	AABB2 GetGlyphBox(int glyphUnicode) const; // quad in its cell, 0 to 1 from the cell's bottom left
+	inline const Texture& GetTexture() const { return m_sdfTexture != nullptr ? *m_sdfTexture : m_spriteSheet.GetTexture(); }
+	inline bool IsSDF() const { return m_sdfTexture != nullptr; } // drawn through the sdf text shader, crisp at any size
 
 private:
 	explicit BitmapFont(const std::string& fontName, const SpriteSheet& glyphSheet, float baseAspect); // constructed by Renderer
+	void SetSDFAtlas(const sdf_atlas_t& atlas, const Texture* atlasTexture);
 
 private:
 	const std::string m_fontName;
 	const SpriteSheet& m_spriteSheet; // used internally; assumed to be a 16x16 glyph sheet
 	float m_baseAspect = 1.0f; // used as the base aspect ratio for all glyphs
+	const Texture* m_sdfTexture = nullptr; // glyph sheet is used when there's no atlas
+	sdf_glyph_t m_sdfGlyphs[SDF_GLYPH_COUNT];
 };
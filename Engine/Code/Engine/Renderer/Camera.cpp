@@ -78,9 +78,9 @@ void Camera::LookAt(const Vector3& position, const Vector3& target, const Vector
 {
 	camera_state_t* buff = m_cameraBuffer->as<camera_state_t>();
 
-	Matrix44 cameraMatrix = Matrix44::LookAt(position, target, up);
-	m_transform.SetLocalMatrix(cameraMatrix);;
-	buff->view = Matrix44::MakeInverseFast(cameraMatrix);
+	m_transform.SetLocalPosition(position);
+	m_transform.SetLocalRotation(Quaternion::LookRotation(target - position, up));
+	buff->view = Matrix44::MakeInverseFast(m_transform.GetLocalMatrix());
 }
 
 void Camera::SetLocalMatrix(const Matrix44& mat)
@@ -107,6 +107,22 @@ void Camera::TranslateLocal(const Vector3& offset)
 	buff->view = Matrix44::MakeInverseFast(m_transform.GetLocalMatrix());
 }
 
+void Camera::SetLocalRotation(const Quaternion& rotation)
+{
+	camera_state_t* buff = m_cameraBuffer->as<camera_state_t>();
+
+	m_transform.SetLocalRotation(rotation);
+	buff->view = Matrix44::MakeInverseFast(m_transform.GetLocalMatrix());
+}
+
+void Camera::RotateLocal(const Quaternion& rotation)
+{
+	camera_state_t* buff = m_cameraBuffer->as<camera_state_t>();
+
+	m_transform.RotateLocal(rotation);
+	buff->view = Matrix44::MakeInverseFast(m_transform.GetLocalMatrix());
+}
+
 void Camera::SetLocalRotationEuler(const Vector3& euler)
 {
 	camera_state_t* buff = m_cameraBuffer->as<camera_state_t>();
@@ -49,6 +49,8 @@ public:
 	void SetLocalMatrix(const Matrix44& mat); 
 	void SetLocalPosition(const Vector3& pos); 
 	void TranslateLocal(const Vector3& offset); 
+	void SetLocalRotation(const Quaternion& rotation);
+	void RotateLocal(const Quaternion& rotation);
 	void SetLocalRotationEuler(const Vector3& euler); 
 	void RotateLocalByEuler(const Vector3& euler); 
 
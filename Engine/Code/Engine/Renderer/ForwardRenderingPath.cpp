@@ -53,7 +53,8 @@ void ForwardRenderingPath::RenderSceneForCamera(Camera* cam, RenderScene* scene)
 		m_renderer->ClearDepth(1.0f); 
 	}
 
-	std::vector<DrawCall> drawCalls; 
+	DrawCallList drawCalls; 
+	drawCalls.reserve(scene->m_renderables.size());
 
 	for each (Renderable* renderable in scene->m_renderables) 
 	{
@@ -78,6 +79,9 @@ void ForwardRenderingPath::RenderSceneForCamera(Camera* cam, RenderScene* scene)
 		drawCalls.push_back(dc); 
 	}
 
+	//no culling yet, everything in the scene is submitted
+	PROFILE_COUNTER_ADD("renderables submitted", drawCalls.size());
+
 	SortDrawsBySortOrder(drawCalls);
 
 	//draw skybox before everything
@@ -146,7 +150,7 @@ void ForwardRenderingPath::RenderShadowCastingObjectsForLight(Light* light, Rend
 	}
 }
 
-void ForwardRenderingPath::SortDrawsBySortOrder(std::vector<DrawCall>& drawCalls)
+void ForwardRenderingPath::SortDrawsBySortOrder(DrawCallList& drawCalls)
 {
 	std::sort(drawCalls.begin(), drawCalls.end(), [](const DrawCall& a, const DrawCall& b) -> bool
 	{
@@ -2,6 +2,7 @@
 
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Core/Transform.hpp"
+#include "Engine/Core/LinearAllocator.hpp"
 
 class RenderScene;
 class Camera;
@@ -27,6 +28,9 @@ public:
 	uint m_queue; //Alpha/Opaque
 };
 
+//rebuilt every frame, so it lives in frame memory
+typedef std::vector<DrawCall, TFrameAllocatorAdapter<DrawCall>> DrawCallList;
+
 class ForwardRenderingPath
 {
 public:
@@ -37,7 +41,7 @@ public:
 	void RenderSceneForCamera(Camera* cam, RenderScene* scene);
 	void RenderShadowCastingObjectsForLight(Light* light, RenderScene*scene);
 
-	void SortDrawsBySortOrder(std::vector<DrawCall>& drawCalls);
+	void SortDrawsBySortOrder(DrawCallList& drawCalls);
 
 public:
 	static Transform* s_lightFocalPoint;
@@ -15,7 +15,15 @@ void Mesh::SetIndices(uint count, const uint* indices)
 	m_ibo.m_indexStride = sizeof(uint);
 }
 
+void Mesh::SetVertices(const VertexLayout* layout, uint count, const void* vertices)
+{
+	m_vbo.CopyToGPU(count * layout->m_stride, vertices);
+	m_layout = layout;
+	m_vbo.m_vertexCount = count;
+	m_vbo.m_vertexStride = layout->m_stride;
+}
+
 void Mesh::SetDrawInstruction(eDrawPrimitive type, bool useIndices, uint start_index, uint elem_count)
 {
-	m_drawCall = draw_instruction_t(type, useIndices, start_index, elem_count);
+	m_drawCall = draw_instruction_t(type, start_index, elem_count, useIndices);
 }
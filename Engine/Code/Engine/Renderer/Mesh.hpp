@@ -45,6 +45,16 @@ public:
 		// s_layout defined that is a VertexLayout;
 	}
 
+	// packed vertices already in layout, straight from a file
+	void SetVertices(const VertexLayout* layout, uint count, const void* vertices);
+
+	// overwrite count vertices starting at firstVertex, layout and count stay the same
+	template <typename VERTEX_TYPE>
+	void UpdateVertices(uint firstVertex, uint count, const VERTEX_TYPE* vertices)
+	{
+		m_vbo.UpdateRangeFromCPU(firstVertex * sizeof(VERTEX_TYPE), count * sizeof(VERTEX_TYPE), vertices);
+	}
+
 	template <typename VERTEX_TYPE>
 	void FromBuilderForType(const MeshBuilder& mb) 
 	{
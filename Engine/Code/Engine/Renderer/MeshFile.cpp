@@ -0,0 +1,180 @@
+#include "Engine/Renderer/MeshFile.hpp"
+#include "Engine/Renderer/ObjImport.hpp"
+#include "Engine/Core/Command.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Core/WorkerThreadPool.hpp"
+#include "Engine/File/File.hpp"
+#include "Engine/Profiler/Profiler.hpp"
+#include <string.h>
+
+// File layout (little endian):
+//   header    MeshFileHeader below
+//   vertices  vertexCount * vertexStride bytes, the vertex struct as is
+//   indices   indexCount uint32
+
+static const char MESH_FILE_MAGIC[4] = { 'T', 'W', 'M', 'S' };
+static const unsigned short MESH_FILE_VERSION = 1;
+
+struct MeshFileHeader
+{
+	char magic[4];
+	unsigned short version;
+	unsigned short layout; // eMeshFileLayout
+	unsigned int vertexStride; // checked against the layout, catches a vertex struct that changed since
+	unsigned int vertexCount;
+	unsigned int indexCount;
+	unsigned int primitive;
+	unsigned int usingIndices;
+	unsigned int startIndex;
+	unsigned int elemCount;
+	unsigned int reserved;
+	uint64_t sourceSize;
+	int64_t sourceModifiedTime;
+};
+static_assert(sizeof(MeshFileHeader) == 56, "MeshFileHeader is written as is, keep it free of padding");
+
+static const VertexLayout* GetMeshFileLayout(unsigned short layout)
+{
+	switch (layout)
+	{
+	case MESH_FILE_LAYOUT_PCU: return &VertexPCU::s_layout;
+	case MESH_FILE_LAYOUT_LIT: return &VertexLit::s_layout;
+	default: return nullptr;
+	}
+}
+
+static bool GetMeshFileLayoutID(const VertexLayout* layout, unsigned short* out_layout)
+{
+	for (unsigned short id = 0; id < NUM_MESH_FILE_LAYOUTS; id++)
+	{
+		if (GetMeshFileLayout(id) == layout)
+		{
+			*out_layout = id;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool SaveMeshFile(const std::string& path, const VertexLayout* layout, const void* vertices, uint vertexCount, const uint* indices, uint indexCount, const draw_instruction_t& draw, const std::string& sourcePath)
+{
+	MeshFileHeader header;
+	memset(&header, 0, sizeof(header));
+	if (!GetMeshFileLayoutID(layout, &header.layout))
+	{
+		ERROR_RECOVERABLE("Mesh files don't support this vertex layout: " + path);
+		return false;
+	}
+
+	memcpy(header.magic, MESH_FILE_MAGIC, sizeof(MESH_FILE_MAGIC));
+	header.version = MESH_FILE_VERSION;
+	header.vertexStride = layout->m_stride;
+	header.vertexCount = vertexCount;
+	header.indexCount = indexCount;
+	header.primitive = (unsigned int) draw.m_primitiveType;
+	header.usingIndices = draw.m_usingIndices ? 1 : 0;
+	header.startIndex = draw.m_startIndex;
+	header.elemCount = draw.m_elemCount;
+	if (!sourcePath.empty() && !GetFileStamp(sourcePath.c_str(), &header.sourceSize, &header.sourceModifiedTime))
+		return false; //nothing was cooked, and a file stamped 0/0 would never go stale
+
+	size_t vertexBytes = (size_t) vertexCount * layout->m_stride;
+	size_t indexBytes = (size_t) indexCount * sizeof(uint);
+	std::vector<unsigned char> bytes(sizeof(header) + vertexBytes + indexBytes);
+	memcpy(bytes.data(), &header, sizeof(header));
+	if (vertexBytes > 0)
+		memcpy(bytes.data() + sizeof(header), vertices, vertexBytes);
+	if (indexBytes > 0)
+		memcpy(bytes.data() + sizeof(header) + vertexBytes, indices, indexBytes);
+
+	return WriteBinaryFile(path.c_str(), bytes.data(), bytes.size());
+}
+
+bool LoadMeshFile(Mesh* out, const std::string& path, const std::string& sourcePath)
+{
+	PROFILE_SCOPE_FUNCTION();
+
+	MappedFile file;
+	if (!file.Open(path.c_str()) || file.GetSize() < sizeof(MeshFileHeader))
+		return false;
+
+	MeshFileHeader header;
+	memcpy(&header, file.GetData(), sizeof(header));
+	const VertexLayout* layout = GetMeshFileLayout(header.layout);
+	if (memcmp(header.magic, MESH_FILE_MAGIC, sizeof(MESH_FILE_MAGIC)) != 0
+		|| header.version != MESH_FILE_VERSION
+		|| layout == nullptr
+		|| header.vertexStride != layout->m_stride)
+	{
+		return false;
+	}
+
+	size_t vertexBytes = (size_t) header.vertexCount * header.vertexStride;
+	size_t indexBytes = (size_t) header.indexCount * sizeof(uint);
+	if (file.GetSize() != sizeof(header) + vertexBytes + indexBytes)
+		return false;
+
+	//the draw goes straight into m_drawCall, it has to stay inside what gets uploaded
+	uint64_t drawEnd = (uint64_t) header.startIndex + header.elemCount;
+	uint drawnCount = header.usingIndices != 0 ? header.indexCount : header.vertexCount;
+	if (header.primitive > (unsigned int) QUADS || drawEnd > drawnCount)
+		return false;
+
+	//cooked from an older source
+	uint64_t sourceSize = 0;
+	int64_t sourceModifiedTime = 0;
+	if (!sourcePath.empty() && GetFileStamp(sourcePath.c_str(), &sourceSize, &sourceModifiedTime)
+		&& (sourceSize != header.sourceSize || sourceModifiedTime != header.sourceModifiedTime))
+	{
+		return false;
+	}
+
+	const unsigned char* vertices = file.GetData() + sizeof(header);
+	out->SetVertices(layout, header.vertexCount, vertices);
+	out->SetIndices(header.indexCount, (const uint*) (vertices + vertexBytes));
+	out->m_drawCall = draw_instruction_t((eDrawPrimitive) header.primitive, header.startIndex, header.elemCount, header.usingIndices != 0);
+	return true;
+}
+
+//------------------------------------------------------------------------
+void RegisterMeshFileCommands()
+{
+	CommandRegister("mesh_cook", CookMeshFile, "Imports an OBJ and writes its <path>.mesh, which CreateOrGetMesh loads instead. Option: path");
+}
+
+void CookMeshFile(Command& cmd)
+{
+	std::string path = cmd.GetNextString();
+	if (path.empty() || !FileExists(path.c_str()))
+	{
+		ConsoleErrorf("mesh_cook needs the path of an OBJ file");
+		return;
+	}
+
+	uint64_t start = GetPerformanceCounter();
+	MeshBuilder mb;
+	bool isImported = ImportObjFile(&mb, path, GetWorkerThreads());
+	double importSeconds = PerformanceCounterToSeconds(GetPerformanceCounter() - start);
+	if (!isImported)
+	{
+		ConsoleErrorf("Couldn't import %s, nothing was written", path.c_str());
+		return;
+	}
+
+	std::string meshPath = GetMeshFilePath(path);
+	if (!SaveMeshFileFromBuilder<VertexLit>(meshPath, mb, path))
+	{
+		ConsoleErrorf("Couldn't write %s", meshPath.c_str());
+		return;
+	}
+
+	//time the load the game will do from now on
+	start = GetPerformanceCounter();
+	Mesh mesh;
+	bool loaded = LoadMeshFile(&mesh, meshPath, path);
+	double loadSeconds = PerformanceCounterToSeconds(GetPerformanceCounter() - start);
+
+	ConsolePrintf("Wrote %s: %u vertices, %u indices. OBJ import %.2f ms, mesh load %.2f ms%s",
+		meshPath.c_str(), (uint) mb.m_vertices.size(), (uint) mb.m_indices.size(), importSeconds * 1000.0, loadSeconds * 1000.0, loaded ? "" : " (FAILED)");
+}
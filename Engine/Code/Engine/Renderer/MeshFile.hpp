@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Renderer/Mesh.hpp"
+#include <string>
+#include <vector>
+
+class Command;
+
+// Which vertex struct a mesh file holds, so its blob can go to the GPU as is
+enum eMeshFileLayout : unsigned short
+{
+	MESH_FILE_LAYOUT_PCU,
+	MESH_FILE_LAYOUT_LIT,
+	NUM_MESH_FILE_LAYOUTS
+};
+
+// Cooked mesh: header, then the packed vertices, then the uint indices. Loading maps the file
+// and uploads both blobs directly, nothing is parsed or converted.
+// sourcePath is the file it was cooked from: its size and write time are kept, and a load
+// after the source changed fails so the caller cooks it again. Missing sources are not checked.
+inline std::string GetMeshFilePath(const std::string& sourcePath) { return sourcePath + ".mesh"; } // cooked next to the source
+bool SaveMeshFile(const std::string& path, const VertexLayout* layout, const void* vertices, uint vertexCount, const uint* indices, uint indexCount, const draw_instruction_t& draw, const std::string& sourcePath = "");
+bool LoadMeshFile(Mesh* out, const std::string& path, const std::string& sourcePath = "");
+
+template <typename VERTEX_TYPE>
+bool SaveMeshFileFromBuilder(const std::string& path, const MeshBuilder& mb, const std::string& sourcePath = "")
+{
+	std::vector<VERTEX_TYPE> vertices;
+	vertices.reserve(mb.m_vertices.size());
+	for each (const Vertex_builder& vertex in mb.m_vertices)
+		vertices.push_back(VERTEX_TYPE(vertex));
+
+	return SaveMeshFile(path, &VERTEX_TYPE::s_layout, vertices.data(), (uint) vertices.size(), mb.m_indices.data(), (uint) mb.m_indices.size(), mb.m_draw, sourcePath);
+}
+
+// mesh_cook writes <path>.mesh for an OBJ ahead of time, the same file CreateOrGetMesh writes on first load
+void RegisterMeshFileCommands();
+
+void CookMeshFile(Command& cmd);
@@ -0,0 +1,145 @@
+#include "Engine/Renderer/ObjBenchmark.hpp"
+#include "Engine/Renderer/ObjImport.hpp"
+#include "Engine/Renderer/MeshBuilder.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Core/WorkerThreadPool.hpp"
+#include "Engine/File/File.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+static const char* BENCH_OBJ_PATH = "Data/Models/bench_obj.obj";
+
+//------------------------------------------------------------------------
+// A rippled grid of quads, each corner v/vt/vn, written like the exporter of the models in Data
+// (two spaces after v, which AddFromObjFile counts on). %g on the uvs and normals puts exponents in.
+static bool WriteBenchObjFile(const char* path, int quadsPerSide)
+{
+	int side = quadsPerSide + 1;
+	std::string text;
+	text.reserve((size_t) side * side * 100 + (size_t) quadsPerSide * quadsPerSide * 60);
+	text += "# bench_obj grid\n";
+
+	char line[256];
+	for (int y = 0; y < side; y++)
+	{
+		for (int x = 0; x < side; x++)
+		{
+			float height = 0.25f * sinf((float) x * 0.37f) * cosf((float) y * 0.23f);
+			snprintf(line, sizeof(line), "v  %.6f %.6f %.6f\n", (float) x * 0.1f, height, (float) y * -0.1f);
+			text += line;
+		}
+	}
+
+	for (int y = 0; y < side; y++)
+	{
+		for (int x = 0; x < side; x++)
+		{
+			snprintf(line, sizeof(line), "vt %g %g 0.0000\n", (float) x / (float) quadsPerSide, (float) y / (float) quadsPerSide);
+			text += line;
+		}
+	}
+
+	for (int y = 0; y < side; y++)
+	{
+		for (int x = 0; x < side; x++)
+		{
+			float slopeX = 0.0925f * cosf((float) x * 0.37f) * cosf((float) y * 0.23f);
+			float slopeY = -0.0575f * sinf((float) x * 0.37f) * sinf((float) y * 0.23f);
+			float length = sqrtf((slopeX * slopeX) + 1.f + (slopeY * slopeY));
+			snprintf(line, sizeof(line), "vn %g %g %g\n", -slopeX / length, 1.f / length, slopeY / length);
+			text += line;
+		}
+	}
+
+	text += "g grid\n";
+	for (int y = 0; y < quadsPerSide; y++)
+	{
+		for (int x = 0; x < quadsPerSide; x++)
+		{
+			int a = (y * side) + x + 1;
+			int b = a + 1;
+			int c = a + side + 1;
+			int d = a + side;
+			snprintf(line, sizeof(line), "f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d \n", a, a, a, b, b, b, c, c, c, d, d, d);
+			text += line;
+		}
+	}
+
+	return WriteBinaryFile(path, text.data(), text.size());
+}
+
+// Same triangles corner for corner, whatever the vertices are shared as
+static bool AreObjMeshesEqual(const MeshBuilder& expected, const MeshBuilder& imported)
+{
+	if (expected.m_indices.size() != imported.m_indices.size())
+		return false;
+
+	for (size_t i = 0; i < expected.m_indices.size(); i++)
+	{
+		const Vertex_builder& a = expected.m_vertices[expected.m_indices[i]];
+		const Vertex_builder& b = imported.m_vertices[imported.m_indices[i]];
+		bool isSame = memcmp(&a.position, &b.position, sizeof(Vector3)) == 0
+			&& memcmp(&a.normal, &b.normal, sizeof(Vector3)) == 0
+			&& memcmp(&a.color, &b.color, sizeof(Rgba)) == 0
+			&& memcmp(&a.UV, &b.UV, sizeof(Vector2)) == 0
+			&& memcmp(&a.tangent, &b.tangent, sizeof(Vector4)) == 0;
+		if (!isSame)
+			return false;
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------
+void RegisterObjBenchmarkCommands()
+{
+	CommandRegister("bench_obj", BenchmarkObjImport, "Writes a grid OBJ and times importing it with AddFromObjFile against ImportObjFile on 1 thread and on the worker pool. Option: triangle count");
+}
+
+void BenchmarkObjImport(Command& cmd)
+{
+	int triangleCount = 1000000;
+	cmd.GetNextInt(&triangleCount);
+	triangleCount = MaxInt(triangleCount, 2);
+
+	int quadsPerSide = MaxInt((int) sqrtf((float) triangleCount * 0.5f), 1);
+	if (!WriteBenchObjFile(BENCH_OBJ_PATH, quadsPerSide))
+	{
+		ConsoleErrorf("bench_obj couldn't write %s", BENCH_OBJ_PATH);
+		return;
+	}
+
+	uint64_t fileSize = 0;
+	int64_t modifiedTime = 0;
+	GetFileStamp(BENCH_OBJ_PATH, &fileSize, &modifiedTime);
+	ConsolePrintf("bench_obj: %d triangles (%d x %d quads), %.1f MB", quadsPerSide * quadsPerSide * 2, quadsPerSide, quadsPerSide, (double) fileSize / (1024.0 * 1024.0));
+
+	uint64_t start = GetPerformanceCounter();
+	MeshBuilder expected;
+	expected.AddFromObjFile(BENCH_OBJ_PATH);
+	double builderSeconds = PerformanceCounterToSeconds(GetPerformanceCounter() - start);
+	ConsolePrintf("  AddFromObjFile  %8.2f ms  %u vertices", builderSeconds * 1000.0, (uint) expected.m_vertices.size());
+
+	WorkerThreadPool* workers = GetWorkerThreads();
+	uint threadCounts[2] = { 1, workers != nullptr ? workers->GetThreadCount() + 1 : 1 };
+	for (uint run = 0; run < 2; run++)
+	{
+		if (run > 0 && threadCounts[run] == 1)
+			break;
+
+		start = GetPerformanceCounter();
+		MeshBuilder imported;
+		bool isImported = ImportObjFile(&imported, BENCH_OBJ_PATH, run > 0 ? workers : nullptr);
+		double importSeconds = PerformanceCounterToSeconds(GetPerformanceCounter() - start);
+
+		bool matches = isImported && AreObjMeshesEqual(expected, imported);
+		ConsolePrintf("  ImportObjFile %2u thread%s %8.2f ms  %u vertices (%.2fx)  matches AddFromObjFile: %s", threadCounts[run], threadCounts[run] > 1 ? "s" : " ",
+			importSeconds * 1000.0, (uint) imported.m_vertices.size(), builderSeconds / importSeconds, matches ? "ok" : "FAIL");
+	}
+
+	remove(BENCH_OBJ_PATH);
+}
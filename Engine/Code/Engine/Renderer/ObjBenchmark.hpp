@@ -0,0 +1,9 @@
+#pragma once
+
+#include "Engine/Core/Command.hpp"
+
+// Dev console benchmark for first time mesh imports: MeshBuilder::AddFromObjFile against
+// ImportObjFile on one thread and on the worker pool, on a generated OBJ.
+void RegisterObjBenchmarkCommands();
+
+void BenchmarkObjImport(Command& cmd);
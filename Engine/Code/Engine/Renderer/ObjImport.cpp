@@ -0,0 +1,452 @@
+#include "Engine/Renderer/ObjImport.hpp"
+#include "Engine/Renderer/MeshBuilder.hpp"
+#include "Engine/Core/WorkerThreadPool.hpp"
+#include "Engine/File/File.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Profiler/Profiler.hpp"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+constexpr size_t OBJ_MIN_CHUNK_BYTES = 256 * 1024; // smaller files aren't worth a job per chunk
+constexpr uint OBJ_CHUNKS_PER_THREAD = 4; // lines aren't the same length everywhere, spare chunks even it out
+constexpr uint OBJ_VERTICES_PER_JOB = 16 * 1024;
+constexpr int OBJ_MAX_NUMBER_LENGTH = 64;
+constexpr int OBJ_MAX_FAST_DIGITS = 19; // fits a uint64 mantissa
+
+// Indices as written, 1 based, 0 when the corner leaves it out
+struct obj_corner_t
+{
+	int position;
+	int uv;
+	int normal;
+};
+
+// One line aligned piece of the file and everything parsed from it, in file order
+struct obj_chunk_t
+{
+	const char* begin = nullptr;
+	const char* end = nullptr;
+	std::vector<Vector3> positions;
+	std::vector<Vector3> normals;
+	std::vector<Vector2> uvs;
+	std::vector<obj_corner_t> corners;
+	std::vector<uint> faceSizes; // corners in each face
+};
+
+static const double OBJ_POWERS_OF_TEN[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static inline bool IsObjBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+static inline bool IsObjDigit(char c) { return c >= '0' && c <= '9'; }
+
+//------------------------------------------------------------------------
+// Same value as atof, which AddFromObjFile uses. Up to 19 significant digits and a power of ten
+// up to 22 are exact as doubles, so one multiply or divide rounds the way atof does (Clinger's
+// fast path). Anything else, like long mantissas, inf or nan, goes to strtod on a copy.
+static const char* ParseObjFloat(const char* cursor, const char* end, float* out_value)
+{
+	while (cursor < end && IsObjBlank(*cursor))
+		cursor++;
+	const char* start = cursor;
+
+	bool isNegative = false;
+	if (cursor < end && (*cursor == '-' || *cursor == '+'))
+	{
+		isNegative = *cursor == '-';
+		cursor++;
+	}
+
+	uint64_t mantissa = 0;
+	int digitCount = 0; // significant ones, from the first non zero
+	int exponent = 0;
+	bool hasDigits = false;
+	for (; cursor < end && IsObjDigit(*cursor); cursor++)
+	{
+		hasDigits = true;
+		if (mantissa != 0 || *cursor != '0')
+			digitCount++;
+		if (digitCount <= OBJ_MAX_FAST_DIGITS)
+			mantissa = (mantissa * 10) + (*cursor - '0');
+	}
+
+	if (cursor < end && *cursor == '.')
+	{
+		for (cursor++; cursor < end && IsObjDigit(*cursor); cursor++)
+		{
+			hasDigits = true;
+			if (mantissa != 0 || *cursor != '0')
+				digitCount++;
+			if (digitCount <= OBJ_MAX_FAST_DIGITS)
+			{
+				mantissa = (mantissa * 10) + (*cursor - '0');
+				exponent--;
+			}
+		}
+	}
+
+	if (hasDigits && cursor < end && (*cursor == 'e' || *cursor == 'E'))
+	{
+		const char* exponentStart = cursor;
+		cursor++;
+		bool isExponentNegative = false;
+		if (cursor < end && (*cursor == '-' || *cursor == '+'))
+		{
+			isExponentNegative = *cursor == '-';
+			cursor++;
+		}
+
+		int written = 0;
+		bool hasExponentDigits = false;
+		for (; cursor < end && IsObjDigit(*cursor); cursor++)
+		{
+			hasExponentDigits = true;
+			if (written < 100000)
+				written = (written * 10) + (*cursor - '0');
+		}
+
+		if (hasExponentDigits)
+			exponent += isExponentNegative ? -written : written;
+		else
+			cursor = exponentStart; //just an 'e', not part of the number
+	}
+
+	bool isFast = hasDigits && digitCount <= OBJ_MAX_FAST_DIGITS && mantissa <= (1ull << 53) && exponent >= -22 && exponent <= 22;
+	if (isFast)
+	{
+		double value = (double) mantissa;
+		value = exponent < 0 ? value / OBJ_POWERS_OF_TEN[-exponent] : value * OBJ_POWERS_OF_TEN[exponent];
+		*out_value = (float) (isNegative ? -value : value);
+		return cursor;
+	}
+
+	//the file isn't null terminated, strtod gets its own copy of the token
+	const char* tokenEnd = hasDigits ? cursor : start;
+	while (tokenEnd < end && !IsObjBlank(*tokenEnd) && *tokenEnd != '\n' && (hasDigits || *tokenEnd != '/'))
+		tokenEnd++;
+	if (!hasDigits)
+		cursor = tokenEnd;
+
+	char number[OBJ_MAX_NUMBER_LENGTH];
+	size_t length = MinInt((int) (tokenEnd - start), OBJ_MAX_NUMBER_LENGTH - 1);
+	memcpy(number, start, length);
+	number[length] = '\0';
+	*out_value = (float) strtod(number, nullptr);
+	return cursor;
+}
+
+static const char* ParseObjIndex(const char* cursor, const char* end, int* out_index)
+{
+	bool isNegative = false;
+	if (cursor < end && *cursor == '-')
+	{
+		isNegative = true;
+		cursor++;
+	}
+
+	int value = 0;
+	for (; cursor < end && IsObjDigit(*cursor); cursor++)
+	{
+		if (value < 100000000)
+			value = (value * 10) + (*cursor - '0');
+	}
+
+	*out_index = isNegative ? -value : value;
+	return cursor;
+}
+
+static const char* ParseObjFace(obj_chunk_t* chunk, const char* cursor, const char* end)
+{
+	uint cornerCount = 0;
+	for (;;)
+	{
+		while (cursor < end && IsObjBlank(*cursor))
+			cursor++;
+		if (cursor >= end || *cursor == '\n' || *cursor == '#')
+			break;
+
+		//v, v/vt, v//vn or v/vt/vn
+		obj_corner_t corner = { 0, 0, 0 };
+		cursor = ParseObjIndex(cursor, end, &corner.position);
+		if (cursor < end && *cursor == '/')
+		{
+			cursor++;
+			if (cursor < end && *cursor != '/')
+				cursor = ParseObjIndex(cursor, end, &corner.uv);
+			if (cursor < end && *cursor == '/')
+				cursor = ParseObjIndex(cursor + 1, end, &corner.normal);
+		}
+
+		//whatever else is in the token
+		while (cursor < end && !IsObjBlank(*cursor) && *cursor != '\n')
+			cursor++;
+
+		chunk->corners.push_back(corner);
+		cornerCount++;
+	}
+
+	chunk->faceSizes.push_back(cornerCount);
+	return cursor;
+}
+
+static void ParseObjChunk(obj_chunk_t* chunk)
+{
+	const char* cursor = chunk->begin;
+	const char* end = chunk->end;
+	while (cursor < end)
+	{
+		while (cursor < end && IsObjBlank(*cursor))
+			cursor++;
+
+		size_t left = end - cursor;
+		if (left > 1 && cursor[0] == 'v' && IsObjBlank(cursor[1]))
+		{
+			Vector3 position;
+			cursor = ParseObjFloat(cursor + 1, end, &position.x);
+			cursor = ParseObjFloat(cursor, end, &position.y);
+			cursor = ParseObjFloat(cursor, end, &position.z);
+			position.x *= -1; //flip
+			chunk->positions.push_back(position);
+		}
+		else if (left > 2 && cursor[0] == 'v' && cursor[1] == 'n' && IsObjBlank(cursor[2]))
+		{
+			Vector3 normal;
+			cursor = ParseObjFloat(cursor + 2, end, &normal.x);
+			cursor = ParseObjFloat(cursor, end, &normal.y);
+			cursor = ParseObjFloat(cursor, end, &normal.z);
+			normal.x *= -1; //flip
+			chunk->normals.push_back(normal);
+		}
+		else if (left > 2 && cursor[0] == 'v' && cursor[1] == 't' && IsObjBlank(cursor[2]))
+		{
+			Vector2 uv;
+			cursor = ParseObjFloat(cursor + 2, end, &uv.x);
+			cursor = ParseObjFloat(cursor, end, &uv.y);
+			chunk->uvs.push_back(uv);
+		}
+		else if (left > 1 && cursor[0] == 'f' && IsObjBlank(cursor[1]))
+		{
+			cursor = ParseObjFace(chunk, cursor + 1, end);
+		}
+
+		//rest of the line: comments, w components, anything not read
+		while (cursor < end && *cursor != '\n')
+			cursor++;
+		cursor++;
+	}
+}
+
+//------------------------------------------------------------------------
+// Corners with the same position, uv and normal indices, and so the same vertex, share one index
+class ObjWeldTable
+{
+public:
+	explicit ObjWeldTable(size_t cornerCount)
+	{
+		size_t capacity = 16;
+		while (capacity < cornerCount * 2)
+			capacity *= 2;
+		m_slots.assign(capacity, -1);
+		m_mask = capacity - 1;
+	}
+
+	uint Weld(const obj_corner_t& corner)
+	{
+		uint64_t hash = ((uint64_t) (uint) corner.position * 0x9E3779B97F4A7C15ull)
+			^ ((uint64_t) (uint) corner.uv * 0xC2B2AE3D27D4EB4Full)
+			^ ((uint64_t) (uint) corner.normal * 0x165667B19E3779F9ull);
+		hash ^= hash >> 29;
+
+		for (size_t slot = (size_t) hash & m_mask;; slot = (slot + 1) & m_mask)
+		{
+			int index = m_slots[slot];
+			if (index < 0)
+			{
+				uint added = (uint) m_corners.size();
+				m_slots[slot] = (int) added;
+				m_corners.push_back(corner);
+				return added;
+			}
+
+			const obj_corner_t& existing = m_corners[index];
+			if (existing.position == corner.position && existing.uv == corner.uv && existing.normal == corner.normal)
+				return (uint) index;
+		}
+	}
+
+public:
+	std::vector<obj_corner_t> m_corners; // one per vertex, in the order first seen
+
+private:
+	std::vector<int> m_slots;
+	size_t m_mask;
+};
+
+template <typename T>
+static void ConcatenateObjChunks(std::vector<T>* out, const std::vector<obj_chunk_t>& chunks, std::vector<T> obj_chunk_t::* member)
+{
+	size_t count = 0;
+	for each (const obj_chunk_t& chunk in chunks)
+		count += (chunk.*member).size();
+
+	out->reserve(count);
+	for each (const obj_chunk_t& chunk in chunks)
+		out->insert(out->end(), (chunk.*member).begin(), (chunk.*member).end());
+}
+
+bool ImportObjFile(MeshBuilder* out, const std::string& path, WorkerThreadPool* workers)
+{
+	PROFILE_SCOPE_FUNCTION();
+
+	MappedFile file;
+	if (!file.Open(path.c_str()))
+	{
+		ASSERT_RECOVERABLE(false, "Cannot find file at path " + path);
+		return false;
+	}
+
+	//line aligned chunks, a few per thread
+	const char* data = (const char*) file.GetData();
+	const char* dataEnd = data + file.GetSize();
+	uint threadCount = workers != nullptr ? workers->GetThreadCount() + 1 : 1;
+	size_t chunkBytes = file.GetSize() / (threadCount * OBJ_CHUNKS_PER_THREAD);
+	if (chunkBytes < OBJ_MIN_CHUNK_BYTES)
+		chunkBytes = OBJ_MIN_CHUNK_BYTES;
+
+	std::vector<obj_chunk_t> chunks;
+	for (const char* begin = data; begin < dataEnd;)
+	{
+		const char* end = (size_t) (dataEnd - begin) > chunkBytes ? begin + chunkBytes : dataEnd;
+		while (end < dataEnd && end[-1] != '\n')
+			end++;
+
+		chunks.push_back(obj_chunk_t());
+		chunks.back().begin = begin;
+		chunks.back().end = end;
+		begin = end;
+	}
+
+	if (workers != nullptr && chunks.size() > 1)
+		workers->ParallelFor((uint) chunks.size(), [&chunks](uint chunk) { ParseObjChunk(&chunks[chunk]); });
+	else
+		for (uint chunk = 0; chunk < (uint) chunks.size(); chunk++)
+			ParseObjChunk(&chunks[chunk]);
+
+	//indices count from the start of the file, so the chunks' lists join end to end
+	std::vector<Vector3> positions;
+	std::vector<Vector3> normals;
+	std::vector<Vector2> uvs;
+	ConcatenateObjChunks(&positions, chunks, &obj_chunk_t::positions);
+	ConcatenateObjChunks(&normals, chunks, &obj_chunk_t::normals);
+	ConcatenateObjChunks(&uvs, chunks, &obj_chunk_t::uvs);
+
+	size_t cornerCount = 0;
+	for each (const obj_chunk_t& chunk in chunks)
+		cornerCount += chunk.corners.size();
+
+	out->Begin(eDrawPrimitive::TRIANGLES, true);
+	out->SetColor(Rgba::white);
+	uint firstVertex = (uint) out->m_vertices.size();
+
+	//in file order: a corner without a uv or normal keeps the last one set, like the stamp does
+	ObjWeldTable weld(cornerCount);
+	out->m_indices.reserve(out->m_indices.size() + cornerCount + (cornerCount / 2));
+	obj_corner_t state = { 0, 0, 0 };
+	bool isValid = true;
+	for each (const obj_chunk_t& chunk in chunks)
+	{
+		const obj_corner_t* corner = chunk.corners.data();
+		for each (uint faceSize in chunk.faceSizes)
+		{
+			bool isFace = faceSize == 3 || faceSize == 4;
+			bool inRange = true;
+			uint face[4];
+			for (uint i = 0; i < faceSize; i++, corner++)
+			{
+				state.position = corner->position;
+				if (corner->uv != 0)
+					state.uv = corner->uv;
+				if (corner->normal != 0)
+					state.normal = corner->normal;
+
+				inRange = inRange && state.position >= 1 && state.position <= (int) positions.size()
+					&& state.uv >= 0 && state.uv <= (int) uvs.size()
+					&& state.normal >= 0 && state.normal <= (int) normals.size();
+				if (isFace && inRange)
+					face[i] = firstVertex + weld.Weld(state);
+			}
+
+			if (!inRange)
+			{
+				isValid = false;
+				continue;
+			}
+
+			if (faceSize == 4)
+			{
+				out->AddFace(face[0], face[1], face[2]);
+				out->AddFace(face[0], face[2], face[3]);
+			}
+			else if (faceSize == 3)
+			{
+				out->AddFace(face[0], face[1], face[2]);
+			}
+		}
+	}
+
+	//vertices from the welded corners, the stamp filling in what a corner never had
+	const std::vector<obj_corner_t>& vertexCorners = weld.m_corners;
+	Vertex_builder stamp = out->m_stamp;
+	out->m_vertices.resize(firstVertex + vertexCorners.size());
+	auto buildVertices = [&](uint job)
+	{
+		uint first = job * OBJ_VERTICES_PER_JOB;
+		uint last = (uint) MinInt((int) (first + OBJ_VERTICES_PER_JOB), (int) vertexCorners.size());
+		for (uint index = first; index < last; index++)
+		{
+			const obj_corner_t& corner = vertexCorners[index];
+			Vertex_builder& vertex = out->m_vertices[firstVertex + index];
+			vertex = stamp;
+			vertex.position = positions[corner.position - 1];
+			if (corner.uv != 0)
+				vertex.UV = uvs[corner.uv - 1];
+			if (corner.normal != 0)
+			{
+				//to be removed once put in MikT
+				Vector3 tangent;
+				vertex.normal = normals[corner.normal - 1];
+				out->GenerateArbitraryTangents(&tangent, nullptr, vertex.normal);
+				vertex.tangent = Vector4(tangent.x, tangent.y, tangent.z, 1);
+			}
+		}
+	};
+
+	uint jobCount = (uint) ((vertexCorners.size() + OBJ_VERTICES_PER_JOB - 1) / OBJ_VERTICES_PER_JOB);
+	if (workers != nullptr && jobCount > 1)
+		workers->ParallelFor(jobCount, buildVertices);
+	else
+		for (uint job = 0; job < jobCount; job++)
+			buildVertices(job);
+
+	//stamp left as AddFromObjFile leaves it
+	if (state.position >= 1 && state.position <= (int) positions.size())
+		out->m_stamp.position = positions[state.position - 1];
+	if (state.uv >= 1 && state.uv <= (int) uvs.size())
+		out->SetUV(uvs[state.uv - 1]);
+	if (state.normal >= 1 && state.normal <= (int) normals.size())
+	{
+		Vector3 tangent;
+		out->SetNormal(normals[state.normal - 1]);
+		out->GenerateArbitraryTangents(&tangent, nullptr, normals[state.normal - 1]);
+		out->SetTangent(Vector4(tangent.x, tangent.y, tangent.z, 1));
+	}
+
+	out->End();
+
+	if (!isValid)
+		ERROR_RECOVERABLE("Faces with indices out of range were skipped in " + path);
+	return isValid;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "Engine/Core/EngineCommon.hpp"
+#include <string>
+
+class MeshBuilder;
+class WorkerThreadPool;
+
+// MeshBuilder::AddFromObjFile's triangles, faster for big files: the file is mapped and parsed in
+// line aligned chunks on workers, then face corners with the same position, uv and normal are
+// welded into one vertex. Every triangle ends up with the same vertices AddFromObjFile gives it,
+// x flipped and tangents made the same way, only shared instead of pushed once per corner.
+// Triangles and quads become faces like before, other polygons are skipped.
+bool ImportObjFile(MeshBuilder* out, const std::string& path, WorkerThreadPool* workers = nullptr);
@@ -0,0 +1,425 @@
+#include "Engine/Renderer/ParticleArrays.hpp"
+#include "Engine/Renderer/VertexPCU.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Core/WorkerThreadPool.hpp"
+#include <immintrin.h>
+#include <stddef.h>
+#include <malloc.h>
+#include <string.h>
+
+constexpr uint PARTICLE_ARRAY_COUNT = 12;
+constexpr uint MIN_PARTICLE_CAPACITY = 64;
+
+// _mm256_permutevar8x32_ps indices that pack the lanes set in a movemask to the front
+struct CompactPermutes
+{
+	CompactPermutes()
+	{
+		for (int mask = 0; mask < 256; mask++)
+		{
+			int packed = 0;
+			for (int lane = 0; lane < 8; lane++)
+			{
+				if (mask & (1 << lane))
+					lanes[mask][packed++] = lane;
+			}
+			for (; packed < 8; packed++)
+				lanes[mask][packed] = 0;
+		}
+	}
+
+	alignas(32) int lanes[256][8];
+};
+
+static const CompactPermutes COMPACT_PERMUTES;
+
+// WriteBillboards stores position and color as one 16 byte write
+static_assert(offsetof(VertexPCU, m_color) == 12 && sizeof(Rgba) == 4 && offsetof(VertexPCU, m_UVs) == 16 && sizeof(VertexPCU) == 24,
+	"WriteBillboards expects VertexPCU packed as position, color, uvs");
+
+// MeshBuilder::AddPlane's vertex order: bottom right, bottom left, top right, top left
+static const float BILLBOARD_RIGHT[4] = { +1.f, -1.f, +1.f, -1.f };
+static const float BILLBOARD_UP[4] = { -1.f, -1.f, +1.f, +1.f };
+static const Vector2 BILLBOARD_UVS[4] = { Vector2(1.f, 0.f), Vector2(0.f, 0.f), Vector2(1.f, 1.f), Vector2(0.f, 1.f) };
+
+//------------------------------------------------------------------------
+// Both versions write every particle back to the slot it ends up in and advance the write
+// index by whether it survived, so the dead are dropped without a branch per particle.
+// Same operations in the same order, so the results are bit identical.
+static uint IntegrateScalar(ParticleArrays& p, uint begin, uint end, float dt, float time)
+{
+	uint write = begin;
+	for (uint read = begin; read < end; read++)
+	{
+		float velocityX = p.m_velocityX[read] + (p.m_forceX[read] * dt);
+		float velocityY = p.m_velocityY[read] + (p.m_forceY[read] * dt);
+		float velocityZ = p.m_velocityZ[read] + (p.m_forceZ[read] * dt);
+		float timeDead = p.m_timeDead[read];
+
+		p.m_positionX[write] = p.m_positionX[read] + (velocityX * dt);
+		p.m_positionY[write] = p.m_positionY[read] + (velocityY * dt);
+		p.m_positionZ[write] = p.m_positionZ[read] + (velocityZ * dt);
+		p.m_velocityX[write] = velocityX;
+		p.m_velocityY[write] = velocityY;
+		p.m_velocityZ[write] = velocityZ;
+		p.m_forceX[write] = 0.f;
+		p.m_forceY[write] = 0.f;
+		p.m_forceZ[write] = 0.f;
+		p.m_size[write] = p.m_size[read];
+		p.m_timeBorn[write] = p.m_timeBorn[read];
+		p.m_timeDead[write] = timeDead;
+
+		write += timeDead > time ? 1 : 0;
+	}
+	return write - begin;
+}
+
+// Loads a whole block before storing anything: write <= read, so the packed stores only
+// land on blocks already done or on this one, never past the range.
+static uint IntegrateAVX2(ParticleArrays& p, uint begin, uint end, float dt, float time)
+{
+	const __m256 dtLanes = _mm256_set1_ps(dt);
+	const __m256 timeLanes = _mm256_set1_ps(time);
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256i endLanes = _mm256_set1_epi32((int) end);
+	__m256i laneIndices = _mm256_add_epi32(_mm256_set1_epi32((int) begin), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+	const __m256i laneStep = _mm256_set1_epi32((int) ParticleArrays::PARTICLE_LANES);
+
+	uint write = begin;
+	for (uint read = begin; read < end; read += ParticleArrays::PARTICLE_LANES)
+	{
+		__m256 velocityX = _mm256_add_ps(_mm256_load_ps(p.m_velocityX + read), _mm256_mul_ps(_mm256_load_ps(p.m_forceX + read), dtLanes));
+		__m256 velocityY = _mm256_add_ps(_mm256_load_ps(p.m_velocityY + read), _mm256_mul_ps(_mm256_load_ps(p.m_forceY + read), dtLanes));
+		__m256 velocityZ = _mm256_add_ps(_mm256_load_ps(p.m_velocityZ + read), _mm256_mul_ps(_mm256_load_ps(p.m_forceZ + read), dtLanes));
+		__m256 positionX = _mm256_add_ps(_mm256_load_ps(p.m_positionX + read), _mm256_mul_ps(velocityX, dtLanes));
+		__m256 positionY = _mm256_add_ps(_mm256_load_ps(p.m_positionY + read), _mm256_mul_ps(velocityY, dtLanes));
+		__m256 positionZ = _mm256_add_ps(_mm256_load_ps(p.m_positionZ + read), _mm256_mul_ps(velocityZ, dtLanes));
+		__m256 size = _mm256_load_ps(p.m_size + read);
+		__m256 timeBorn = _mm256_load_ps(p.m_timeBorn + read);
+		__m256 timeDead = _mm256_load_ps(p.m_timeDead + read);
+
+		//lanes past the last particle count as dead
+		__m256 inRange = _mm256_castsi256_ps(_mm256_cmpgt_epi32(endLanes, laneIndices));
+		__m256 alive = _mm256_and_ps(_mm256_cmp_ps(timeDead, timeLanes, _CMP_GT_OQ), inRange);
+		int aliveMask = _mm256_movemask_ps(alive);
+		__m256i permute = _mm256_load_si256((const __m256i*) COMPACT_PERMUTES.lanes[aliveMask]);
+
+		_mm256_storeu_ps(p.m_positionX + write, _mm256_permutevar8x32_ps(positionX, permute));
+		_mm256_storeu_ps(p.m_positionY + write, _mm256_permutevar8x32_ps(positionY, permute));
+		_mm256_storeu_ps(p.m_positionZ + write, _mm256_permutevar8x32_ps(positionZ, permute));
+		_mm256_storeu_ps(p.m_velocityX + write, _mm256_permutevar8x32_ps(velocityX, permute));
+		_mm256_storeu_ps(p.m_velocityY + write, _mm256_permutevar8x32_ps(velocityY, permute));
+		_mm256_storeu_ps(p.m_velocityZ + write, _mm256_permutevar8x32_ps(velocityZ, permute));
+		_mm256_storeu_ps(p.m_forceX + write, zero);
+		_mm256_storeu_ps(p.m_forceY + write, zero);
+		_mm256_storeu_ps(p.m_forceZ + write, zero);
+		_mm256_storeu_ps(p.m_size + write, _mm256_permutevar8x32_ps(size, permute));
+		_mm256_storeu_ps(p.m_timeBorn + write, _mm256_permutevar8x32_ps(timeBorn, permute));
+		_mm256_storeu_ps(p.m_timeDead + write, _mm256_permutevar8x32_ps(timeDead, permute));
+
+		write += (uint) _mm_popcnt_u32((unsigned int) aliveMask);
+		laneIndices = _mm256_add_epi32(laneIndices, laneStep);
+	}
+
+	_mm256_zeroupper();
+	return write - begin;
+}
+
+//------------------------------------------------------------------------
+ParticleArrays::~ParticleArrays()
+{
+	_aligned_free(m_memory);
+	m_memory = nullptr;
+}
+
+uint ParticleArrays::Add(uint count)
+{
+	uint first = m_count;
+	if (m_count + count > m_capacity)
+	{
+		uint grown = m_capacity * 2;
+		grown = grown > m_count + count ? grown : m_count + count;
+		Reserve(grown > MIN_PARTICLE_CAPACITY ? grown : MIN_PARTICLE_CAPACITY);
+	}
+
+	m_count += count;
+	return first;
+}
+
+void ParticleArrays::Reserve(uint capacity)
+{
+	capacity = (capacity + PARTICLE_LANES - 1) & ~(PARTICLE_LANES - 1);
+	if (capacity <= m_capacity)
+		return;
+
+	float* memory = (float*) _aligned_malloc(capacity * PARTICLE_ARRAY_COUNT * sizeof(float), 32);
+	ASSERT_OR_DIE(memory != nullptr, "Out of memory for particles");
+
+	float** arrays[PARTICLE_ARRAY_COUNT] = { &m_positionX, &m_positionY, &m_positionZ, &m_velocityX, &m_velocityY, &m_velocityZ,
+		&m_forceX, &m_forceY, &m_forceZ, &m_size, &m_timeBorn, &m_timeDead };
+	for (uint i = 0; i < PARTICLE_ARRAY_COUNT; i++)
+	{
+		float* grown = memory + (i * capacity);
+		if (m_count > 0)
+			memcpy(grown, *arrays[i], m_count * sizeof(float));
+		*arrays[i] = grown;
+	}
+
+	_aligned_free(m_memory);
+	m_memory = memory;
+	m_capacity = capacity;
+}
+
+uint ParticleArrays::Integrate(float deltaSeconds, float time)
+{
+	uint count = m_count;
+	m_count = IntegrateRange(0, count, deltaSeconds, time);
+	return count - m_count;
+}
+
+uint ParticleArrays::IntegrateRange(uint begin, uint end, float deltaSeconds, float time)
+{
+	ASSERT_OR_DIE((begin % PARTICLE_LANES) == 0 && end <= m_count, "Particle range out of bounds or unaligned");
+
+	if (GetParticleSIMDLevel() == PARTICLE_SIMD_AVX2)
+		return IntegrateAVX2(*this, begin, end, deltaSeconds, time);
+	else
+		return IntegrateScalar(*this, begin, end, deltaSeconds, time);
+}
+
+void ParticleArrays::PackRanges(const particle_range_t* ranges, uint rangeCount)
+{
+	uint write = 0;
+	for (uint i = 0; i < rangeCount; i++)
+	{
+		const particle_range_t& range = ranges[i];
+		if (write != range.begin)
+			MoveParticles(write, range.begin, range.survivors);
+		write += range.survivors;
+	}
+	m_count = write;
+}
+
+void ParticleArrays::MoveParticles(uint to, uint from, uint count)
+{
+	//the arrays sit one after another in m_memory
+	for (uint i = 0; i < PARTICLE_ARRAY_COUNT; i++)
+	{
+		float* array = m_memory + (i * m_capacity);
+		memmove(array + to, array + from, count * sizeof(float));
+	}
+}
+
+void ParticleArrays::WriteBillboards(VertexPCU* out, const Vector3& right, const Vector3& up, const Rgba& color) const
+{
+	WriteBillboards(out, right, up, color, 0, m_count);
+}
+
+void ParticleArrays::WriteBillboards(VertexPCU* out, const Vector3& right, const Vector3& up, const Rgba& color, uint first, uint count) const
+{
+	WriteBillboards(out, right, up, color, nullptr, first, count);
+}
+
+void ParticleArrays::WriteBillboards(VertexPCU* out, const Vector3& right, const Vector3& up, const Rgba& color, const uint* order, uint first, uint count) const
+{
+	unsigned int colorBits;
+	memcpy(&colorBits, &color, sizeof(colorBits));
+	const __m128 colorLanes = _mm_castsi128_ps(_mm_set1_epi32((int) colorBits));
+	const __m128 half = _mm_set1_ps(0.5f);
+
+	//corner offsets per unit of half size, one register per corner and axis
+	__m128 cornerX[4];
+	__m128 cornerY[4];
+	__m128 cornerZ[4];
+	for (int corner = 0; corner < 4; corner++)
+	{
+		Vector3 offset = (right * BILLBOARD_RIGHT[corner]) + (up * BILLBOARD_UP[corner]);
+		cornerX[corner] = _mm_set1_ps(offset.x);
+		cornerY[corner] = _mm_set1_ps(offset.y);
+		cornerZ[corner] = _mm_set1_ps(offset.z);
+	}
+
+	for (uint block = first; block < first + count; block += BILLBOARD_LANES)
+	{
+		__m128 positionX;
+		__m128 positionY;
+		__m128 positionZ;
+		__m128 size;
+		if (order == nullptr)
+		{
+			positionX = _mm_load_ps(m_positionX + block);
+			positionY = _mm_load_ps(m_positionY + block);
+			positionZ = _mm_load_ps(m_positionZ + block);
+			size = _mm_load_ps(m_size + block);
+		}
+		else
+		{
+			const uint* indices = order + block;
+			positionX = _mm_setr_ps(m_positionX[indices[0]], m_positionX[indices[1]], m_positionX[indices[2]], m_positionX[indices[3]]);
+			positionY = _mm_setr_ps(m_positionY[indices[0]], m_positionY[indices[1]], m_positionY[indices[2]], m_positionY[indices[3]]);
+			positionZ = _mm_setr_ps(m_positionZ[indices[0]], m_positionZ[indices[1]], m_positionZ[indices[2]], m_positionZ[indices[3]]);
+			size = _mm_setr_ps(m_size[indices[0]], m_size[indices[1]], m_size[indices[2]], m_size[indices[3]]);
+		}
+
+		__m128 halfSize = _mm_mul_ps(size, half);
+		VertexPCU* quads = out + (block * 4);
+
+		for (int corner = 0; corner < 4; corner++)
+		{
+			//4 particles' corner as x, y, z, color rows, transposed to one row per vertex
+			__m128 vertex0 = _mm_add_ps(positionX, _mm_mul_ps(cornerX[corner], halfSize));
+			__m128 vertex1 = _mm_add_ps(positionY, _mm_mul_ps(cornerY[corner], halfSize));
+			__m128 vertex2 = _mm_add_ps(positionZ, _mm_mul_ps(cornerZ[corner], halfSize));
+			__m128 vertex3 = colorLanes;
+			_MM_TRANSPOSE4_PS(vertex0, vertex1, vertex2, vertex3);
+
+			__m128 uvs = _mm_castpd_ps(_mm_load_sd((const double*) &BILLBOARD_UVS[corner]));
+			_mm_storeu_ps((float*) &quads[corner].m_position, vertex0);
+			_mm_storeu_ps((float*) &quads[4 + corner].m_position, vertex1);
+			_mm_storeu_ps((float*) &quads[8 + corner].m_position, vertex2);
+			_mm_storeu_ps((float*) &quads[12 + corner].m_position, vertex3);
+			_mm_storel_pi((__m64*) &quads[corner].m_UVs, uvs);
+			_mm_storel_pi((__m64*) &quads[4 + corner].m_UVs, uvs);
+			_mm_storel_pi((__m64*) &quads[8 + corner].m_UVs, uvs);
+			_mm_storel_pi((__m64*) &quads[12 + corner].m_UVs, uvs);
+		}
+	}
+}
+
+void ParticleArrays::SortBackToFront(const Vector3& forward, particle_depth_sort_t* sort) const
+{
+	uint count = m_count;
+	uint paddedCount = (count + BILLBOARD_LANES - 1) & ~(BILLBOARD_LANES - 1);
+	sort->order.resize(paddedCount);
+	sort->scratch.resize(count);
+	sort->keys.resize(count);
+	if (count == 0)
+		return;
+
+	ASSERT_OR_DIE(count <= 0xFFFFFF, "SortBackToFront packs particle indices in 24 bits");
+
+	float nearest = (m_positionX[0] * forward.x) + (m_positionY[0] * forward.y) + (m_positionZ[0] * forward.z);
+	float farthest = nearest;
+	for (uint i = 1; i < count; i++)
+	{
+		float depth = (m_positionX[i] * forward.x) + (m_positionY[i] * forward.y) + (m_positionZ[i] * forward.z);
+		nearest = depth < nearest ? depth : nearest;
+		farthest = depth > farthest ? depth : farthest;
+	}
+
+	//farthest is key 0, so ascending keys are back to front
+	float scale = farthest > nearest ? 65535.f / (farthest - nearest) : 0.f;
+	uint histograms[2][256] = {};
+	unsigned short* keys = sort->keys.data();
+	for (uint i = 0; i < count; i++)
+	{
+		float depth = (m_positionX[i] * forward.x) + (m_positionY[i] * forward.y) + (m_positionZ[i] * forward.z);
+		unsigned short key = (unsigned short) ((farthest - depth) * scale);
+		keys[i] = key;
+		histograms[0][key & 0xFF]++;
+		histograms[1][key >> 8]++;
+	}
+
+	for (int pass = 0; pass < 2; pass++)
+	{
+		uint offset = 0;
+		for (int digit = 0; digit < 256; digit++)
+		{
+			uint digitCount = histograms[pass][digit];
+			histograms[pass][digit] = offset;
+			offset += digitCount;
+		}
+	}
+
+	//low byte in storage order, then high byte; each pass is stable. The first carries the
+	//high byte above the index, so the second reads only what the first wrote.
+	uint* scratch = sort->scratch.data();
+	for (uint i = 0; i < count; i++)
+		scratch[histograms[0][keys[i] & 0xFF]++] = ((uint) (keys[i] >> 8) << 24) | i;
+
+	uint* order = sort->order.data();
+	for (uint i = 0; i < count; i++)
+	{
+		uint packed = scratch[i];
+		order[histograms[1][packed >> 24]++] = packed & 0xFFFFFF;
+	}
+
+	//WriteBillboards reads whole blocks of 4, the padding only has to be a valid particle
+	for (uint i = count; i < paddedCount; i++)
+		order[i] = order[count - 1];
+}
+
+void ParticleArrays::WriteBillboardIndices(uint* out, uint quadCount)
+{
+	//AddPlane's two faces
+	for (uint quad = 0; quad < quadCount; quad++)
+	{
+		uint index = quad * 4;
+		uint* faces = out + (quad * 6);
+		faces[0] = index + 3;
+		faces[1] = index + 1;
+		faces[2] = index + 2;
+		faces[3] = index + 2;
+		faces[4] = index + 1;
+		faces[5] = index + 0;
+	}
+}
+
+//------------------------------------------------------------------------
+void AddParticleRanges(std::vector<particle_range_t>* ranges, ParticleArrays* particles, float time)
+{
+	uint count = particles->GetCount();
+	uint begin = 0;
+	do
+	{
+		uint end = count - begin > PARTICLE_RANGE_SIZE ? begin + PARTICLE_RANGE_SIZE : count;
+		ranges->push_back({ particles, begin, end, time, 0 });
+		begin = end;
+	} while (begin < count);
+}
+
+void IntegrateParticleRanges(WorkerThreadPool* workers, std::vector<particle_range_t>& ranges, float deltaSeconds)
+{
+	auto integrate = [&ranges, deltaSeconds](uint index) {
+		particle_range_t& range = ranges[index];
+		range.survivors = range.particles->IntegrateRange(range.begin, range.end, deltaSeconds, range.time);
+	};
+
+	if (workers != nullptr)
+	{
+		workers->ParallelFor((uint) ranges.size(), integrate);
+	}
+	else
+	{
+		for (uint i = 0; i < (uint) ranges.size(); i++)
+			integrate(i);
+	}
+
+	for (uint first = 0; first < (uint) ranges.size();)
+	{
+		uint last = first;
+		while (last + 1 < (uint) ranges.size() && ranges[last + 1].particles == ranges[first].particles)
+			last++;
+
+		ranges[first].particles->PackRanges(&ranges[first], last - first + 1);
+		first = last + 1;
+	}
+}
+
+//------------------------------------------------------------------------
+static eParticleSIMDLevel GetSupportedParticleSIMDLevel()
+{
+	return IsAVX2Supported() ? PARTICLE_SIMD_AVX2 : PARTICLE_SIMD_NONE;
+}
+
+static eParticleSIMDLevel g_particleSIMDLevel = GetSupportedParticleSIMDLevel();
+
+eParticleSIMDLevel GetParticleSIMDLevel()
+{
+	return g_particleSIMDLevel;
+}
+
+void SetParticleSIMDLevel(eParticleSIMDLevel level)
+{
+	g_particleSIMDLevel = level < GetSupportedParticleSIMDLevel() ? level : GetSupportedParticleSIMDLevel();
+}
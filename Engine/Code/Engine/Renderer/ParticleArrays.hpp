@@ -0,0 +1,116 @@
+#pragma once
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Math/Vector3.hpp"
+#include "Engine/Core/Rgba.hpp"
+#include <vector>
+
+struct VertexPCU;
+class WorkerThreadPool;
+struct particle_range_t;
+
+// Buffers for ParticleArrays::SortBackToFront, kept between frames so sorting doesn't allocate
+struct particle_depth_sort_t
+{
+	std::vector<uint> order; // the result, padded to a multiple of 4 for WriteBillboards
+	std::vector<uint> scratch;
+	std::vector<unsigned short> keys;
+};
+
+// Particle state as parallel arrays (structure of arrays), so Integrate steps 8 particles
+// per AVX2 instruction. Every array has the same capacity, a multiple of PARTICLE_LANES
+// with 32 byte alignment, so the wide loops never need a scalar tail.
+// Particles have unit mass; forces are used up by the step they are applied in.
+class ParticleArrays
+{
+public:
+	~ParticleArrays();
+	ParticleArrays() {}
+	ParticleArrays(const ParticleArrays& copy) = delete;
+
+	uint Add(uint count); // uninitialized, grows as needed. Returns the index of the first one
+	inline void Clear() { m_count = 0; }
+	void Reserve(uint capacity);
+
+	// Forward Euler step for every particle, then removes the ones dead at time
+	// without changing the order of the rest. Returns how many were removed.
+	uint Integrate(float deltaSeconds, float time);
+
+	// Integrate for particles begin to end, with the survivors packed from begin. Ranges starting
+	// on multiples of PARTICLE_LANES can run on different threads at once; PackRanges then closes
+	// the gaps between them, given all the ranges in order. Returns how many survived.
+	uint IntegrateRange(uint begin, uint end, float deltaSeconds, float time);
+	void PackRanges(const particle_range_t* ranges, uint rangeCount);
+
+	// Camera facing quads for every particle, 4 vertices each in MeshBuilder::AddPlane's order and
+	// UVs, so WriteBillboardIndices' fixed pattern draws them. SSE, 4 particles at a time:
+	// out needs room for GetCount() rounded up to a multiple of 4 quads.
+	void WriteBillboards(VertexPCU* out, const Vector3& right, const Vector3& up, const Rgba& color) const;
+	void WriteBillboards(VertexPCU* out, const Vector3& right, const Vector3& up, const Rgba& color, uint first, uint count) const; // first a multiple of 4, to out + (first * 4)
+	void WriteBillboards(VertexPCU* out, const Vector3& right, const Vector3& up, const Rgba& color, const uint* order, uint first, uint count) const; // the particles order lists, in that order
+
+	// Particle indices farthest first along forward, for alpha blended particles to draw back
+	// to front. LSD radix sort of 16 bit depth keys, quantized over the particles' depth range:
+	// two 8 bit passes, so 500k particles take a couple of milliseconds. Ties keep their order.
+	void SortBackToFront(const Vector3& forward, particle_depth_sort_t* sort) const;
+	static void WriteBillboardIndices(uint* out, uint quadCount); // 6 per quad
+
+	inline uint GetCount() const { return m_count; }
+	inline Vector3 GetPosition(uint index) const { return Vector3(m_positionX[index], m_positionY[index], m_positionZ[index]); }
+
+public:
+	static constexpr uint PARTICLE_LANES = 8;
+	static constexpr uint BILLBOARD_LANES = 4;
+
+	float* m_positionX = nullptr;
+	float* m_positionY = nullptr;
+	float* m_positionZ = nullptr;
+	float* m_velocityX = nullptr;
+	float* m_velocityY = nullptr;
+	float* m_velocityZ = nullptr;
+	float* m_forceX = nullptr;
+	float* m_forceY = nullptr;
+	float* m_forceZ = nullptr;
+	float* m_size = nullptr;
+	float* m_timeBorn = nullptr;
+	float* m_timeDead = nullptr;
+
+private:
+	void MoveParticles(uint to, uint from, uint count);
+
+private:
+	uint m_count = 0;
+	uint m_capacity = 0;
+	float* m_memory = nullptr; // one block, the arrays above point into it
+};
+
+//------------------------------------------------------------------------
+enum eParticleSIMDLevel
+{
+	PARTICLE_SIMD_NONE, // one particle at a time, same results
+	PARTICLE_SIMD_AVX2,
+};
+
+eParticleSIMDLevel GetParticleSIMDLevel();
+void SetParticleSIMDLevel(eParticleSIMDLevel level); // clamped to what the CPU supports, for benchmarking
+
+//------------------------------------------------------------------------
+// A slice of one ParticleArrays, so a large emitter can be integrated on several threads
+constexpr uint PARTICLE_RANGE_SIZE = 16384;
+
+struct particle_range_t
+{
+	ParticleArrays* particles;
+	uint begin;
+	uint end;
+	float time;
+	uint survivors;
+};
+
+// Splits particles into PARTICLE_RANGE_SIZE ranges; always at least one, even when empty
+void AddParticleRanges(std::vector<particle_range_t>* ranges, ParticleArrays* particles, float time);
+
+// Integrates every range, on workers and this thread (workers nullptr: this thread only), then
+// packs each ParticleArrays. A ParticleArrays' ranges have to be next to each other, in order.
+// Ranges never change the results, so they come out the same on any number of threads.
+void IntegrateParticleRanges(WorkerThreadPool* workers, std::vector<particle_range_t>& ranges, float deltaSeconds);
@@ -0,0 +1,458 @@
+#include "Engine/Renderer/ParticleBenchmark.hpp"
+#include "Engine/Renderer/ParticleArrays.hpp"
+#include "Engine/Renderer/MeshBuilder.hpp"
+#include "Engine/Renderer/VertexPCU.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Core/WorkerThreadPool.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+constexpr int BENCH_STEPS = 60;
+constexpr float BENCH_STEP_SECONDS = 1.f / 60.f;
+constexpr float BENCH_MIN_LIFETIME = 0.25f; //about a fifth die within the run, so compaction does real work
+constexpr float BENCH_MAX_LIFETIME = 2.f;
+constexpr int BENCH_BILLBOARD_FRAMES = 10;
+constexpr uint BENCH_SMALL_EMITTERS = 64; //like the ships' exhaust, next to one big emitter
+constexpr uint BENCH_SMALL_EMITTER_COUNT = 500;
+
+// How ParticleEmitter stored particles before ParticleArrays, kept as the baseline
+struct bench_particle_t
+{
+	Vector3 position;
+	Vector3 velocity;
+	Vector3 force;
+	float size;
+	float mass;
+	float timeBorn;
+	float timeDead;
+};
+
+struct particle_bench_result_t
+{
+	double integrateSeconds = 0.0;
+	double spawnSeconds = 0.0;
+	uint64_t particleSteps = 0;
+};
+
+//------------------------------------------------------------------------
+static void SpawnArrays(ParticleArrays& particles, RandomNumberGenerator& random, uint count, float time)
+{
+	//same fills as ParticleEmitter::SpawnParticles for a sphere emitter
+	constexpr uint SPAWN_BATCH = 256;
+	Vector3 points[SPAWN_BATCH];
+
+	uint first = particles.Add(count);
+	for (uint batchStart = 0; batchStart < count; batchStart += SPAWN_BATCH)
+	{
+		uint batchCount = (uint) MinInt((int) SPAWN_BATCH, (int) (count - batchStart));
+		uint index = first + batchStart;
+
+		random.FillRandomPointsOnSphere(points, batchCount);
+		for (uint i = 0; i < batchCount; i++)
+		{
+			particles.m_positionX[index + i] = 0.f;
+			particles.m_positionY[index + i] = 0.f;
+			particles.m_positionZ[index + i] = 0.f;
+			particles.m_velocityX[index + i] = points[i].x;
+			particles.m_velocityY[index + i] = points[i].y;
+			particles.m_velocityZ[index + i] = points[i].z;
+		}
+	}
+
+	random.FillRandomFloatsInRange(particles.m_timeDead + first, count, BENCH_MIN_LIFETIME, BENCH_MAX_LIFETIME);
+	random.FillRandomFloatsInRange(particles.m_size + first, count, 0.1f, 0.2f);
+	for (uint i = first; i < first + count; i++)
+	{
+		particles.m_forceX[i] = 0.f;
+		particles.m_forceY[i] = -9.8f;
+		particles.m_forceZ[i] = 0.f;
+		particles.m_timeBorn[i] = time;
+		particles.m_timeDead[i] += time;
+	}
+}
+
+static particle_bench_result_t RunArrays(ParticleArrays& particles, uint count, unsigned int seed)
+{
+	particle_bench_result_t result;
+	RandomNumberGenerator random(seed);
+	float time = 0.f;
+
+	particles.Clear();
+	particles.Reserve(count);
+	SpawnArrays(particles, random, count, time);
+
+	//steady state like an emitter at its cap: step everything, then spawn back up to count
+	for (int step = 0; step < BENCH_STEPS; step++)
+	{
+		time += BENCH_STEP_SECONDS;
+
+		uint64_t start = GetPerformanceCounter();
+		particles.Integrate(BENCH_STEP_SECONDS, time);
+		uint64_t integrated = GetPerformanceCounter();
+		SpawnArrays(particles, random, count - particles.GetCount(), time);
+		uint64_t spawned = GetPerformanceCounter();
+
+		result.integrateSeconds += PerformanceCounterToSeconds(integrated - start);
+		result.spawnSeconds += PerformanceCounterToSeconds(spawned - integrated);
+		result.particleSteps += count;
+	}
+
+	return result;
+}
+
+static void SpawnStructs(std::vector<bench_particle_t>& particles, RandomNumberGenerator& random, uint count, float time)
+{
+	for (uint i = 0; i < count; i++)
+	{
+		bench_particle_t p;
+		p.position = Vector3::zero;
+		p.velocity = random.RandomPointOnSphere();
+		p.timeBorn = time;
+		p.timeDead = time + random.GetRandomFloatInRange(BENCH_MIN_LIFETIME, BENCH_MAX_LIFETIME);
+		p.size = random.GetRandomFloatInRange(0.1f, 0.2f);
+		p.force = Vector3(0.f, -9.8f, 0.f);
+		p.mass = 1.f;
+		particles.push_back(p);
+	}
+}
+
+static particle_bench_result_t RunStructs(uint count, unsigned int seed)
+{
+	particle_bench_result_t result;
+	RandomNumberGenerator random(seed);
+	float time = 0.f;
+
+	std::vector<bench_particle_t> particles;
+	particles.reserve(count);
+	SpawnStructs(particles, random, count, time);
+
+	for (int step = 0; step < BENCH_STEPS; step++)
+	{
+		time += BENCH_STEP_SECONDS;
+
+		uint64_t start = GetPerformanceCounter();
+		uint particleCount = (uint) particles.size();
+		for (uint i = particleCount - 1U; i < particleCount; --i)
+		{
+			bench_particle_t& p = particles[i];
+			Vector3 accel = p.force / p.mass;
+			p.velocity += accel * BENCH_STEP_SECONDS;
+			p.position += p.velocity * BENCH_STEP_SECONDS;
+			p.force = Vector3::zero;
+
+			if (time >= p.timeDead)
+			{
+				particles[i] = particles.back();
+				particles.pop_back();
+			}
+		}
+		uint64_t integrated = GetPerformanceCounter();
+		SpawnStructs(particles, random, count - (uint) particles.size(), time);
+		uint64_t spawned = GetPerformanceCounter();
+
+		result.integrateSeconds += PerformanceCounterToSeconds(integrated - start);
+		result.spawnSeconds += PerformanceCounterToSeconds(spawned - integrated);
+		result.particleSteps += count;
+	}
+
+	return result;
+}
+
+static void PrintParticleResult(const char* name, const particle_bench_result_t& result, const particle_bench_result_t& baseline)
+{
+	//ns per particle is also ms per million particles
+	double integrateNs = result.integrateSeconds * 1000000000.0 / (double) result.particleSteps;
+	double spawnMs = result.spawnSeconds * 1000.0 / BENCH_STEPS;
+	ConsolePrintf("  %-8s integrate %6.2f ms per 1M (%.2fx aos)  spawn %6.2f ms per step",
+		name, integrateNs, baseline.integrateSeconds / result.integrateSeconds, spawnMs);
+}
+
+//------------------------------------------------------------------------
+static void BenchmarkBillboards(const ParticleArrays& particles)
+{
+	uint count = particles.GetCount();
+	Vector3 right = Vector3(0.6f, 0.f, 0.8f);
+	Vector3 up = Vector3(0.f, 1.f, 0.f);
+	Rgba color = Rgba(255, 128, 0, 255);
+
+	//how ParticleEmitter::UpdateMesh built its vertices before: a builder, then a VertexPCU copy of it
+	double builderSeconds = 0.0;
+	std::vector<VertexPCU> builderVertices;
+	for (int frame = 0; frame < BENCH_BILLBOARD_FRAMES; frame++)
+	{
+		uint64_t start = GetPerformanceCounter();
+		MeshBuilder mb;
+		for (uint i = 0; i < count; ++i)
+		{
+			float size = particles.m_size[i];
+			mb.AddPlane(particles.GetPosition(i), right, up, AABB2(0, 0, size, size), AABB2::ZERO_TO_ONE, color);
+		}
+
+		builderVertices.resize(mb.m_vertices.size());
+		for (uint i = 0; i < (uint) mb.m_vertices.size(); ++i)
+			builderVertices[i] = VertexPCU(mb.m_vertices[i]);
+		builderSeconds += PerformanceCounterToSeconds(GetPerformanceCounter() - start);
+	}
+
+	double directSeconds = 0.0;
+	std::vector<VertexPCU> directVertices((count + ParticleArrays::BILLBOARD_LANES) * 4);
+	for (int frame = 0; frame < BENCH_BILLBOARD_FRAMES; frame++)
+	{
+		uint64_t start = GetPerformanceCounter();
+		particles.WriteBillboards(directVertices.data(), right, up, color);
+		directSeconds += PerformanceCounterToSeconds(GetPerformanceCounter() - start);
+	}
+
+	//the order of operations differs from AddPlane, so positions only agree to rounding
+	bool matches = builderVertices.size() == count * 4;
+	for (uint i = 0; matches && i < count * 4; ++i)
+	{
+		const VertexPCU& a = builderVertices[i];
+		const VertexPCU& b = directVertices[i];
+		matches = fabsf(a.m_position.x - b.m_position.x) < 0.0001f
+			&& fabsf(a.m_position.y - b.m_position.y) < 0.0001f
+			&& fabsf(a.m_position.z - b.m_position.z) < 0.0001f
+			&& a.m_UVs.x == b.m_UVs.x && a.m_UVs.y == b.m_UVs.y
+			&& memcmp(&a.m_color, &b.m_color, sizeof(Rgba)) == 0;
+	}
+
+	double particleFrames = (double) count * BENCH_BILLBOARD_FRAMES;
+	ConsolePrintf("  billboards: builder %6.2f ns per particle  direct %6.2f ns per particle (%.2fx)",
+		builderSeconds * 1000000000.0 / particleFrames, directSeconds * 1000000000.0 / particleFrames, builderSeconds / directSeconds);
+	ConsolePrintf("  direct billboards match builder: %s", matches ? "ok" : "FAIL");
+}
+
+//------------------------------------------------------------------------
+static void BenchmarkDepthSort(const ParticleArrays& particles)
+{
+	uint count = particles.GetCount();
+	Vector3 forward = Vector3(0.6f, 0.f, 0.8f);
+
+	particle_depth_sort_t sort;
+	particles.SortBackToFront(forward, &sort); //sized once, like an emitter after its first frame
+	uint64_t start = GetPerformanceCounter();
+	for (int frame = 0; frame < BENCH_BILLBOARD_FRAMES; frame++)
+		particles.SortBackToFront(forward, &sort);
+	double radixSeconds = PerformanceCounterToSeconds(GetPerformanceCounter() - start);
+
+	//what a comparison sort on the exact depths costs
+	std::vector<float> depths(count);
+	for (uint i = 0; i < count; i++)
+		depths[i] = (particles.m_positionX[i] * forward.x) + (particles.m_positionY[i] * forward.y) + (particles.m_positionZ[i] * forward.z);
+
+	std::vector<uint> order(count);
+	double comparisonSeconds = 0.0;
+	for (int frame = 0; frame < BENCH_BILLBOARD_FRAMES; frame++)
+	{
+		for (uint i = 0; i < count; i++)
+			order[i] = i;
+
+		start = GetPerformanceCounter();
+		std::sort(order.begin(), order.end(), [&depths](uint a, uint b) { return depths[a] > depths[b]; });
+		comparisonSeconds += PerformanceCounterToSeconds(GetPerformanceCounter() - start);
+	}
+
+	//has to be exactly a stable sort of the same keys
+	for (uint i = 0; i < count; i++)
+		order[i] = i;
+	const std::vector<unsigned short>& keys = sort.keys;
+	std::stable_sort(order.begin(), order.end(), [&keys](uint a, uint b) { return keys[a] < keys[b]; });
+	bool matches = memcmp(order.data(), sort.order.data(), count * sizeof(uint)) == 0;
+
+	ConsolePrintf("  depth sort: radix %6.2f ms per frame  std::sort %6.2f ms per frame (%.2fx)",
+		radixSeconds * 1000.0 / BENCH_BILLBOARD_FRAMES, comparisonSeconds * 1000.0 / BENCH_BILLBOARD_FRAMES, comparisonSeconds / radixSeconds);
+	ConsolePrintf("  radix sort matches a stable sort of its keys: %s", matches ? "ok" : "FAIL");
+}
+
+//------------------------------------------------------------------------
+struct thread_bench_result_t
+{
+	double integrateSeconds = 0.0;
+	double billboardSeconds = 0.0;
+};
+
+// ParticleSystem's parallel path on one big emitter and many small ones
+static thread_bench_result_t RunThreaded(WorkerThreadPool* workers, std::vector<ParticleArrays*>& emitters, const std::vector<uint>& counts, unsigned int seed)
+{
+	thread_bench_result_t result;
+	RandomNumberGenerator random(seed);
+	float time = 0.f;
+
+	std::vector<std::vector<VertexPCU>> vertices(emitters.size());
+	for (uint i = 0; i < (uint) emitters.size(); i++)
+	{
+		emitters[i]->Clear();
+		emitters[i]->Reserve(counts[i]);
+		SpawnArrays(*emitters[i], random, counts[i], time);
+		vertices[i].resize((counts[i] + ParticleArrays::BILLBOARD_LANES) * 4);
+	}
+
+	struct bench_billboard_range_t
+	{
+		uint emitter;
+		uint first;
+		uint count;
+	};
+
+	std::vector<particle_range_t> ranges;
+	std::vector<bench_billboard_range_t> billboardRanges;
+	Vector3 right = Vector3(1.f, 0.f, 0.f);
+	Vector3 up = Vector3(0.f, 1.f, 0.f);
+	auto writeBillboards = [&](uint index) {
+		const bench_billboard_range_t& range = billboardRanges[index];
+		emitters[range.emitter]->WriteBillboards(vertices[range.emitter].data(), right, up, Rgba::white, range.first, range.count);
+	};
+
+	for (int step = 0; step < BENCH_STEPS; step++)
+	{
+		time += BENCH_STEP_SECONDS;
+
+		uint64_t start = GetPerformanceCounter();
+		ranges.clear();
+		for (ParticleArrays* particles : emitters)
+			AddParticleRanges(&ranges, particles, time);
+		IntegrateParticleRanges(workers, ranges, BENCH_STEP_SECONDS);
+		uint64_t integrated = GetPerformanceCounter();
+
+		billboardRanges.clear();
+		for (uint i = 0; i < (uint) emitters.size(); i++)
+		{
+			uint count = emitters[i]->GetCount();
+			for (uint first = 0; first < count; first += PARTICLE_RANGE_SIZE)
+				billboardRanges.push_back({ i, first, (uint) MinInt((int) PARTICLE_RANGE_SIZE, (int) (count - first)) });
+		}
+
+		if (workers != nullptr)
+		{
+			workers->ParallelFor((uint) billboardRanges.size(), writeBillboards);
+		}
+		else
+		{
+			for (uint i = 0; i < (uint) billboardRanges.size(); i++)
+				writeBillboards(i);
+		}
+		uint64_t written = GetPerformanceCounter();
+
+		//untimed, ParticleSystem spawns per emitter and that's small next to the rest
+		for (uint i = 0; i < (uint) emitters.size(); i++)
+			SpawnArrays(*emitters[i], random, counts[i] - emitters[i]->GetCount(), time);
+
+		result.integrateSeconds += PerformanceCounterToSeconds(integrated - start);
+		result.billboardSeconds += PerformanceCounterToSeconds(written - integrated);
+	}
+
+	return result;
+}
+
+static void BenchmarkParticleThreads(uint count, unsigned int seed)
+{
+	std::vector<uint> counts;
+	counts.push_back(count);
+	for (uint i = 0; i < BENCH_SMALL_EMITTERS; i++)
+		counts.push_back(BENCH_SMALL_EMITTER_COUNT);
+
+	std::vector<ParticleArrays*> reference;
+	std::vector<ParticleArrays*> emitters;
+	for (uint i = 0; i < (uint) counts.size(); i++)
+	{
+		reference.push_back(new ParticleArrays());
+		emitters.push_back(new ParticleArrays());
+	}
+
+	//a pool of its own per thread count, the shared one may be busy with other work
+	uint maxThreads = std::thread::hardware_concurrency();
+	maxThreads = maxThreads > 1 ? maxThreads : 1;
+	ConsolePrintf("  threads: 1 emitter of %u and %u of %u, %u particles per range", count, BENCH_SMALL_EMITTERS, BENCH_SMALL_EMITTER_COUNT, PARTICLE_RANGE_SIZE);
+
+	std::vector<uint> threadCounts;
+	for (uint threads = 1; threads < maxThreads; threads *= 2)
+		threadCounts.push_back(threads);
+	threadCounts.push_back(maxThreads);
+
+	thread_bench_result_t single = RunThreaded(nullptr, reference, counts, seed);
+	bool matches = true;
+	for (uint threads : threadCounts)
+	{
+		WorkerThreadPool* workers = threads > 1 ? new WorkerThreadPool(threads - 1) : nullptr;
+		thread_bench_result_t result = threads > 1 ? RunThreaded(workers, emitters, counts, seed) : single;
+		delete workers;
+
+		ConsolePrintf("  %2u threads: integrate %6.2f ms per step (%.2fx)  billboards %6.2f ms per step (%.2fx)", threads,
+			result.integrateSeconds * 1000.0 / BENCH_STEPS, single.integrateSeconds / result.integrateSeconds,
+			result.billboardSeconds * 1000.0 / BENCH_STEPS, single.billboardSeconds / result.billboardSeconds);
+
+		//ranges don't change the results, so every thread count has to end up the same
+		for (uint i = 0; threads > 1 && i < (uint) emitters.size(); i++)
+		{
+			uint particleCount = reference[i]->GetCount();
+			matches = matches && particleCount == emitters[i]->GetCount()
+				&& memcmp(reference[i]->m_positionX, emitters[i]->m_positionX, particleCount * sizeof(float)) == 0
+				&& memcmp(reference[i]->m_timeDead, emitters[i]->m_timeDead, particleCount * sizeof(float)) == 0;
+		}
+	}
+	ConsolePrintf("  threaded matches single thread: %s", matches ? "ok" : "FAIL");
+
+	for (uint i = 0; i < (uint) counts.size(); i++)
+	{
+		delete reference[i];
+		delete emitters[i];
+	}
+}
+
+//------------------------------------------------------------------------
+void RegisterParticleBenchmarkCommands()
+{
+	CommandRegister("bench_particles", BenchmarkParticles, "Times particle integration and spawning (the old array of structs against ParticleArrays, scalar and AVX2) billboard vertex generation, the back to front sort, and how both scale from 1 thread up. Option: live particle count");
+}
+
+void BenchmarkParticles(Command& cmd)
+{
+	int count = 1000000;
+	cmd.GetNextInt(&count);
+	count = MaxInt(count, 1);
+
+	const unsigned int seed = 1;
+	eParticleSIMDLevel previousLevel = GetParticleSIMDLevel();
+	SetParticleSIMDLevel(PARTICLE_SIMD_AVX2);
+	bool hasAVX2 = GetParticleSIMDLevel() == PARTICLE_SIMD_AVX2;
+
+	ConsolePrintf("bench_particles: %d live particles, %d steps of %.4f s, lifetimes %.2f-%.2f s%s", count, BENCH_STEPS, BENCH_STEP_SECONDS,
+		BENCH_MIN_LIFETIME, BENCH_MAX_LIFETIME, hasAVX2 ? "" : ", no AVX2 on this CPU");
+
+	particle_bench_result_t structs = RunStructs((uint) count, seed);
+	PrintParticleResult("aos", structs, structs);
+
+	ParticleArrays scalarParticles;
+	SetParticleSIMDLevel(PARTICLE_SIMD_NONE);
+	particle_bench_result_t scalar = RunArrays(scalarParticles, (uint) count, seed);
+	PrintParticleResult("scalar", scalar, structs);
+
+	if (hasAVX2)
+	{
+		ParticleArrays simdParticles;
+		SetParticleSIMDLevel(PARTICLE_SIMD_AVX2);
+		particle_bench_result_t simd = RunArrays(simdParticles, (uint) count, seed);
+		PrintParticleResult("avx2", simd, structs);
+
+		//same seed and same order of operations, every particle has to come out the same
+		uint particleCount = scalarParticles.GetCount();
+		bool matches = particleCount == simdParticles.GetCount()
+			&& memcmp(scalarParticles.m_positionX, simdParticles.m_positionX, particleCount * sizeof(float)) == 0
+			&& memcmp(scalarParticles.m_positionY, simdParticles.m_positionY, particleCount * sizeof(float)) == 0
+			&& memcmp(scalarParticles.m_positionZ, simdParticles.m_positionZ, particleCount * sizeof(float)) == 0
+			&& memcmp(scalarParticles.m_timeDead, simdParticles.m_timeDead, particleCount * sizeof(float)) == 0;
+		ConsolePrintf("  avx2 matches scalar: %s", matches ? "ok" : "FAIL");
+	}
+
+	BenchmarkBillboards(scalarParticles);
+	BenchmarkDepthSort(scalarParticles);
+
+	SetParticleSIMDLevel(previousLevel);
+	BenchmarkParticleThreads((uint) count, seed);
+}
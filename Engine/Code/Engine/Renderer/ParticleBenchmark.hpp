@@ -0,0 +1,9 @@
+#pragma once
+
+#include "Engine/Core/Command.hpp"
+
+// Dev console benchmark for particle simulation: the old array of structs update against
+// ParticleArrays, scalar and AVX2.
+void RegisterParticleBenchmarkCommands();
+
+void BenchmarkParticles(Command& cmd);
@@ -3,11 +3,13 @@
 #include "Engine/Renderer/Renderable.hpp"
 #include "Engine/Renderer/Mesh.hpp"
 #include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Engine/Renderer/MeshBuilder.hpp"
 #include "Engine/Renderer/Material/Material.hpp"
 #include "Engine/Renderer/RenderScene.hpp"
 #include "Engine/Debug/DebugRender.hpp"
 #include "Engine/Core/Time.hpp"
+#include "Engine/Profiler/Profiler.hpp"
 
 ParticleEmitter::~ParticleEmitter()
 {
@@ -33,108 +35,157 @@ ParticleEmitter::ParticleEmitter()
 	scene->AddRenderable(m_renderable); 
 	m_renderable->m_isLit = false;
 
+	//seeded in creation order on the main thread
+	m_random.SetSeed(GetThreadRandom().GetRandomUint());
 	SetSpawnRate(30.f);
 }
 
-void ParticleEmitter::Update(Camera* cam, float dt)
+void ParticleEmitter::Update(float deltaSeconds)
 {
-	UNUSED(dt);
+	BeginStep(deltaSeconds);
+
+	PROFILE_COUNTER_ADD("particles simulated", m_particles.GetCount());
+	m_particles.Integrate(deltaSeconds, m_time);
+}
+
+void ParticleEmitter::UpdateMesh(Camera* cam)
+{
+	PrepareMesh(cam);
+	SortBillboards();
+	WriteBillboards(0, m_particles.GetCount());
+	UploadMesh();
+}
+
+void ParticleEmitter::BeginStep(float deltaSeconds)
+{
+	m_time += deltaSeconds;
 
 	if (m_spawnsOverTime)
 	{
-		//Hacky: to avoid first frame particles built up
-		if (!m_burstSpawned)
-		{
-			m_spawnInterval.DecrementAll();
-			m_burstSpawned = true;
-		}
-		else
-		{
-			uint particles = m_spawnInterval.DecrementAll();
-			SpawnParticles(MinInt(m_maxParticles - (int) m_particles.size(), particles));
-		}
+		m_spawnDebt += m_spawnRate * deltaSeconds;
+		uint particles = (uint) m_spawnDebt;
+		m_spawnDebt -= (float) particles;
+		SpawnParticles(MinInt(m_maxParticles - (int) m_particles.GetCount(), particles));
 	}
 	else if (!m_burstSpawned)
 	{
 		SpawnParticles(m_maxParticles);
 		m_burstSpawned = true;
 	}
+}
 
-	float t = (float) GetCurrentTimeSeconds();
-
-	uint particleCount = (uint) m_particles.size();  
-	for (uint i = particleCount - 1U; i < particleCount; --i) 
-	{
-		particle_t &p = m_particles[i]; 
-		//p.force = Vector3(0.0f, -9.8f, 0.0f); 
-		p.Update(0.1f); 
-
-		if (p.IsDead(t)) 
-		{
-			//quick remove
-			size_t size = m_particles.size();
-			m_particles[i] = m_particles[size - 1];
-			m_particles.pop_back();
-			i--;
-		} 
-	}
-
+void ParticleEmitter::PrepareMesh(Camera* cam)
+{
 	//compensate for Renderable drawing mesh at model
   	Matrix44 temp = Matrix44::MakeInverseFast(m_transform.GetWorldMatrix());
  	temp.Append(cam->m_transform.GetWorldMatrix());
 
- 	Vector3 right = temp.GetRight();
- 	Vector3 up = temp.GetUp();
-	particleCount = (uint) m_particles.size(); 
+	m_billboardRight = temp.GetRight();
+	m_billboardUp = temp.GetUp();
+	m_billboardForward = temp.GetForward();
+	ReserveBillboards(m_particles.GetCount());
+}
 
-	MeshBuilder mb; 
-	for (uint i = 0; i < particleCount; ++i) 
-	{
-		particle_t &p = m_particles[i]; 
-		mb.AddPlane(p.position, right, up, AABB2(0, 0, p.size, p.size), AABB2::ZERO_TO_ONE, m_color);
-	}
+void ParticleEmitter::SortBillboards()
+{
+	//in the emitter's space, same as the particles
+	if (m_sortsBackToFront)
+		m_particles.SortBackToFront(m_billboardForward, &m_depthSort);
+}
 
-	m_mesh->FromBuilderForType<VertexPCU>(mb);
+void ParticleEmitter::WriteBillboards(uint first, uint count)
+{
+	//quads straight into the staging vertices, indices never change
+	const uint* order = m_sortsBackToFront ? m_depthSort.order.data() : nullptr;
+	m_particles.WriteBillboards(m_billboardVertices.data(), m_billboardRight, m_billboardUp, m_color, order, first, count);
 }
 
-bool ParticleEmitter::IsReadyToCleanUp()
+void ParticleEmitter::UploadMesh()
 {
-	return !m_spawnsOverTime && m_particles.size() == 0;
+	uint particleCount = m_particles.GetCount();
+	if (particleCount > 0)
+		m_mesh->UpdateVertices<VertexPCU>(0, particleCount * 4, m_billboardVertices.data());
+	m_mesh->SetDrawInstruction(eDrawPrimitive::TRIANGLES, true, 0, particleCount * 6);
 }
 
-void ParticleEmitter::SpawnParticle()
+void ParticleEmitter::ReserveBillboards(uint quadCount)
 {
-	particle_t p; 
+	if (quadCount <= m_billboardCapacity)
+		return;
 
-	//TODO: make this more robust later
-	switch (m_emitterShape)
-	{
-	case EMITTER_SPHERE:
-		p.velocity = RandomPointOnSphere() * m_velocityFactor; 
-		p.position = Vector3::zero; 
-		break;
-	case EMITTER_CUBE:
-		p.position = RandomPointInCube(m_shapeScale);
-		p.velocity = Vector3::zero;
-		break;
-	}
-  
-	float lifetime = GetRandomFloatInRange(m_lifeTime.min, m_lifeTime.max); 
-	p.timeBorn = (float) GetCurrentTimeSeconds(); 
-	p.timeDead = p.timeBorn + lifetime; 
+	//whole blocks for WriteBillboards, and room to grow so this stays rare
+	uint capacity = (uint) MaxInt((int) quadCount, MaxInt((int) m_billboardCapacity * 2, 64));
+	capacity = (capacity + ParticleArrays::BILLBOARD_LANES - 1) & ~(ParticleArrays::BILLBOARD_LANES - 1);
+
+	std::vector<uint> indices(capacity * 6);
+	ParticleArrays::WriteBillboardIndices(indices.data(), capacity);
+	m_billboardVertices.resize(capacity * 4);
+
+	m_mesh->SetVertices<VertexPCU>(capacity * 4, m_billboardVertices.data());
+	m_mesh->SetIndices(capacity * 6, indices.data());
+	m_billboardCapacity = capacity;
+}
 
-	p.size = GetRandomFloatInRange(m_size.min, m_size.max);
-	p.force = m_force; 
-	p.mass = 1.0f; 
+bool ParticleEmitter::IsReadyToCleanUp()
+{
+	return !m_spawnsOverTime && m_particles.GetCount() == 0;
+}
 
-	m_particles.push_back(p); 
+void ParticleEmitter::SpawnParticle()
+{
+	SpawnParticles(1);
 }
 
 void ParticleEmitter::SpawnParticles(uint count)
 {
-	for (uint i = 0; i < count; ++i) 
+	//batches keep the random points on the stack
+	constexpr uint SPAWN_BATCH = 256;
+	Vector3 points[SPAWN_BATCH];
+	uint first = m_particles.Add(count);
+	for (uint batchStart = 0; batchStart < count; batchStart += SPAWN_BATCH)
+	{
+		uint batchCount = (uint) MinInt((int) SPAWN_BATCH, (int) (count - batchStart));
+		uint index = first + batchStart;
+
+		//TODO: make this more robust later
+		switch (m_emitterShape)
+		{
+		case EMITTER_SPHERE:
+			m_random.FillRandomPointsOnSphere(points, batchCount, m_velocityFactor);
+			for (uint i = 0; i < batchCount; i++)
+			{
+				m_particles.m_positionX[index + i] = 0.f;
+				m_particles.m_positionY[index + i] = 0.f;
+				m_particles.m_positionZ[index + i] = 0.f;
+				m_particles.m_velocityX[index + i] = points[i].x;
+				m_particles.m_velocityY[index + i] = points[i].y;
+				m_particles.m_velocityZ[index + i] = points[i].z;
+			}
+			break;
+		case EMITTER_CUBE:
+			m_random.FillRandomPointsInCube(points, batchCount, m_shapeScale);
+			for (uint i = 0; i < batchCount; i++)
+			{
+				m_particles.m_positionX[index + i] = points[i].x;
+				m_particles.m_positionY[index + i] = points[i].y;
+				m_particles.m_positionZ[index + i] = points[i].z;
+				m_particles.m_velocityX[index + i] = 0.f;
+				m_particles.m_velocityY[index + i] = 0.f;
+				m_particles.m_velocityZ[index + i] = 0.f;
+			}
+			break;
+		}
+	}
+
+	m_random.FillRandomFloatsInRange(m_particles.m_timeDead + first, count, m_lifeTime.min, m_lifeTime.max);
+	m_random.FillRandomFloatsInRange(m_particles.m_size + first, count, m_size.min, m_size.max);
+	for (uint i = first; i < first + count; i++)
 	{
-		SpawnParticle(); 
+		m_particles.m_forceX[i] = m_force.x;
+		m_particles.m_forceY[i] = m_force.y;
+		m_particles.m_forceZ[i] = m_force.z;
+		m_particles.m_timeBorn[i] = m_time;
+		m_particles.m_timeDead[i] += m_time;
 	}
 }
 
@@ -148,7 +199,6 @@ void ParticleEmitter::SetSpawnRate(float particlesPerSecond)
 	{
 		m_spawnsOverTime = true; 
 		m_spawnRate = particlesPerSecond;
-		m_spawnInterval.SetTimer(1.0f / particlesPerSecond);
 	}
 }
 
@@ -156,5 +206,5 @@ void ParticleEmitter::Destroy()
 {
 	//hacky...make IsReadyToCleanUp fail
 	m_spawnsOverTime = false;
-	m_particles.clear();
+	m_particles.Clear();
 }
@@ -4,9 +4,11 @@
 #include "Engine/Core/Transform.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Renderer/MeshBuilder.hpp"
-#include "Engine/Core/Stopwatch.hpp"
+#include "Engine/Renderer/VertexPCU.hpp"
+#include "Engine/Renderer/ParticleArrays.hpp"
 #include "Engine/Math/IntRange.hpp"
 #include "Engine/Math/FloatRange.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
 #include <vector>
 
 class Mesh;
@@ -19,56 +21,26 @@ enum eEmitterShape
 	EMITTER_CUBE,
 };
 
-struct particle_t
-{
-	Vector3 position;
-	Vector3 velocity;
-	Vector3 force;
-	float size;
-	float mass;
-
-	float timeBorn;
-	float timeDead;
-
-	void operator=(const particle_t& copyFrom)
-	{
-		position = copyFrom.position;
-		velocity = copyFrom.velocity;
-		force = copyFrom.force;
-		size = copyFrom.size;
-		mass = copyFrom.mass;
-		timeBorn = copyFrom.timeBorn;
-		timeDead = copyFrom.timeDead;
-	}
-
-	void Update(float dt)
-	{
-		//forward euler
-		Vector3 accel = force / mass;
-		velocity += accel * dt;
-		position += velocity * dt;
-
-		force = Vector3::zero;
-	}
-
-	inline bool IsDead(float time) { return time >= timeDead; }
-
-	float GetNormalizedAge(float t)
-	{
-		return (t - timeBorn) / (timeDead - timeBorn);
-	}
-};
-
 class ParticleEmitter
 {
 public:
 	~ParticleEmitter();
 	ParticleEmitter();
 
-	void Update(Camera *cam, float dt); 
+	void Update(float deltaSeconds); // simulation, on the game clock's fixed step
+	void UpdateMesh(Camera* cam); // camera facing quads, once a frame
+
+	// Update and UpdateMesh in pieces, for ParticleSystem to spread over worker threads.
+	// BeginStep and WriteBillboards are safe on any thread; PrepareMesh and UploadMesh are main thread.
+	void BeginStep(float deltaSeconds); // advances the time, spawns what's due
+	inline float GetTime() const { return m_time; }
+	void PrepareMesh(Camera* cam);
+	void SortBillboards(); // when m_sortsBackToFront
+	void WriteBillboards(uint first, uint count);
+	void UploadMesh();
 	bool IsReadyToCleanUp();
 	void SpawnParticle(); 
-	void SpawnParticles(uint count); 
+	void SpawnParticles(uint count); // fills the particle arrays a batch at a time
 
 	void SetSpawnRate(float particlesPerSecond); 
 	inline float GetSpawnRate() { return m_spawnRate; }
@@ -79,12 +51,11 @@ public:
 	Renderable* m_renderable;
 
 	Mesh* m_mesh; 
-	MeshBuilder m_builder; 
+	std::vector<VertexPCU> m_billboardVertices; // staging for the vertex buffer, reused every frame
 
-	std::vector<particle_t> m_particles; 
+	ParticleArrays m_particles; 
 
 	bool m_spawnsOverTime; 
-	StopWatch m_spawnInterval; 
 	IntRange m_burst; 
 
 	eEmitterShape m_emitterShape = EMITTER_SPHERE;
@@ -95,8 +66,20 @@ public:
 	FloatRange m_lifeTime = FloatRange(1.f, 3.f);
 	FloatRange m_size = FloatRange(0.1f, 0.2f);
 	Rgba m_color = Rgba::white;
+	bool m_sortsBackToFront = false; // for alpha blended materials, additive ones don't care about order
+
+private:
+	void ReserveBillboards(uint quadCount);
 
 private:
+	uint m_billboardCapacity = 0; // quads the vertex and index buffers hold
+	Vector3 m_billboardRight = Vector3::zero;
+	Vector3 m_billboardUp = Vector3::zero;
+	Vector3 m_billboardForward = Vector3::zero;
+	particle_depth_sort_t m_depthSort;
+	RandomNumberGenerator m_random; // its own, so emitters can spawn on any thread and still replay the same
 	bool m_burstSpawned = false;
 	float m_spawnRate = 0.f;
+	float m_spawnDebt = 0.f; // fraction of a particle owed by the spawn rate
+	float m_time = 0.f; // simulated seconds, particles are born and die on it
 };
@@ -1,7 +1,24 @@
 #include "Engine/Renderer/ParticleSystem.hpp"
+#include "Engine/Core/WorkerThreadPool.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Profiler/Profiler.hpp"
 
 static ParticleSystem* g_ParticleSystem = nullptr; 
 
+static void RunParticleJobs(uint jobCount, const std::function<void(uint)>& job)
+{
+	WorkerThreadPool* workers = GetWorkerThreads();
+	if (workers != nullptr)
+	{
+		workers->ParallelFor(jobCount, job);
+	}
+	else
+	{
+		for (uint i = 0; i < jobCount; i++)
+			job(i);
+	}
+}
+
 ParticleSystem::~ParticleSystem()
 {
 	CleanUp();
@@ -21,12 +38,20 @@ void ParticleSystem::CleanUp()
 	m_emitters.clear();
 }
 
-void ParticleSystem::Update(Camera* cam, float deltaSeconds)
+void ParticleSystem::Update(float deltaSeconds)
 {
+	//every emitter spawns from its own random numbers, so which thread does it doesn't matter
+	RunParticleJobs((uint) m_emitters.size(), [this, deltaSeconds](uint index) {
+		m_emitters[index]->BeginStep(deltaSeconds);
+	});
+
+	m_particleRanges.clear();
 	for each (ParticleEmitter* emitter in m_emitters)
 	{
-		emitter->Update(cam, deltaSeconds);
+		PROFILE_COUNTER_ADD("particles simulated", emitter->m_particles.GetCount());
+		AddParticleRanges(&m_particleRanges, &emitter->m_particles, emitter->GetTime());
 	}
+	IntegrateParticleRanges(GetWorkerThreads(), m_particleRanges, deltaSeconds);
 
 	//quick erase
 	for (int i = 0; i < m_emitters.size(); ++i)
@@ -44,6 +69,34 @@ void ParticleSystem::Update(Camera* cam, float deltaSeconds)
 	}
 }
 
+void ParticleSystem::UpdateMeshes(Camera* cam)
+{
+	//buffers are grown and uploaded here, only sorting and the vertex writing go wide
+	m_billboardRanges.clear();
+	for each (ParticleEmitter* emitter in m_emitters)
+	{
+		emitter->PrepareMesh(cam);
+
+		uint count = emitter->m_particles.GetCount();
+		for (uint first = 0; first < count; first += PARTICLE_RANGE_SIZE)
+			m_billboardRanges.push_back({ emitter, first, (uint) MinInt((int) PARTICLE_RANGE_SIZE, (int) (count - first)) });
+	}
+
+	RunParticleJobs((uint) m_emitters.size(), [this](uint index) {
+		m_emitters[index]->SortBillboards();
+	});
+
+	RunParticleJobs((uint) m_billboardRanges.size(), [this](uint index) {
+		const billboard_range_t& range = m_billboardRanges[index];
+		range.emitter->WriteBillboards(range.first, range.count);
+	});
+
+	for each (ParticleEmitter* emitter in m_emitters)
+	{
+		emitter->UploadMesh();
+	}
+}
+
 void ParticleSystem::AddEmitter(ParticleEmitter* e)
 {
 	m_emitters.push_back(e);
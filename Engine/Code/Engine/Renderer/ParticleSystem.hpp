@@ -5,6 +5,13 @@
 
 class Camera;
 
+struct billboard_range_t
+{
+	ParticleEmitter* emitter;
+	uint first;
+	uint count;
+};
+
 class ParticleSystem
 {
 public:
@@ -12,7 +19,10 @@ public:
 	ParticleSystem();
 
 	void CleanUp();
-	void Update(Camera* cam, float deltaSeconds);
+	// Emitters spawn, simulate and write their billboards in parallel on the worker threads, large
+	// ones split into ranges. Creating and removing emitters stays on the main thread, in order.
+	void Update(float deltaSeconds); // on the game clock's fixed step
+	void UpdateMeshes(Camera* cam); // once a frame, before rendering
 	void AddEmitter(ParticleEmitter* e);
 
 public:
@@ -21,4 +31,6 @@ public:
 
 private:
 	std::vector<ParticleEmitter*> m_emitters;
+	std::vector<particle_range_t> m_particleRanges; // reused every step
+	std::vector<billboard_range_t> m_billboardRanges;
 };
\ No newline at end of file
@@ -41,3 +41,15 @@ bool RenderBuffer::UpdateFromCPU(size_t const byte_count, void const * data)
 {
 	return CopyToGPU(byte_count, data);
 }
+
+bool RenderBuffer::UpdateRangeFromCPU(size_t const byte_offset, size_t const byte_count, void const * data)
+{
+	// rewrites part of the buffer in place, no reallocation
+	if (m_handle == NULL || byte_offset + byte_count > m_bufferSize) {
+		return false;
+	}
+
+	glBindBuffer( GL_ARRAY_BUFFER, m_handle ); 
+	glBufferSubData( GL_ARRAY_BUFFER, byte_offset, byte_count, data ); 
+	return true; 
+}
@@ -12,6 +12,7 @@ public:
 
 	bool CopyToGPU(size_t const byte_count, void const *data); 
 	bool UpdateFromCPU(size_t const byte_count, void const *data);
+	bool UpdateRangeFromCPU(size_t const byte_offset, size_t const byte_count, void const *data); // must fit in the current buffer
 
 public:
 	GLuint m_handle;       // OpenGL handle to the GPU buffer, defualt = NULL; 
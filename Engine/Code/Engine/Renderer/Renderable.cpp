@@ -94,5 +94,6 @@ Transform* Renderable::GetTransform() const
 
 Matrix44 Renderable::GetModelMatrix() const
 {
-	return m_transform->GetWorldMatrix();
+	//blended between simulation steps when the transform (or a parent) is interpolated
+	return m_transform->GetRenderMatrix();
 }
@@ -21,6 +21,10 @@
 #include "Engine/Renderer/Material/MaterialProperty.hpp"
 #include "Engine/Renderer/TextureCube.hpp"
 #include "Engine/Renderer/Shader.hpp"
+#include "Engine/Renderer/SDFFont.hpp"
+#include "Engine/Renderer/MeshFile.hpp"
+#include "Engine/Renderer/ObjImport.hpp"
+#include "Engine/Core/WorkerThreadPool.hpp"
 #include "Engine/Profiler/Profiler.hpp"
 
 #pragma region Built-in Shaders
@@ -80,6 +84,25 @@ void main( void )
 	outColor = vec4( 1, 0, 1, 1 );
 })");
 
+// Text from an SDF font atlas: distance to the glyph edge is in alpha, 0.5 on the edge.
+// Blended over about a screen pixel at any scale, so text stays sharp
+const BuiltInShaders BuiltInShaders::sdfTextShader = BuiltInShaders("sdf_text",
+	//vertex
+	BuiltInShaders::defaultShader.m_vertexShader,
+	//fragment
+R"(#version 420 core
+layout(binding = 0) uniform sampler2D gTexDiffuse;
+in vec4 passColor;
+in vec2 passUV; 
+out vec4 outColor; 
+void main() 
+{
+   float distance = texture( gTexDiffuse, passUV ).a;
+   float edgeWidth = max( 0.7 * fwidth( distance ), 0.0001 );
+   float coverage = smoothstep( 0.5 - edgeWidth, 0.5 + edgeWidth, distance );
+   outColor = vec4( passColor.rgb, passColor.a * coverage );  
+})");
+
 #pragma endregion
 
 void light_t::SetUp(const Vector3& position, bool usesShadow, const Rgba& color, float intensity, const Vector3& attenuation, const Vector3& spec_attunation, const Vector3& direction, 
@@ -159,6 +182,7 @@ bool Renderer::RenderStartup( HWND hwnd )
 void Renderer::PostStartup()
 {
 	m_immediateMesh = new Mesh();
+	m_textMesh = new Mesh();
 
 	// default_vao is a GLuint member variable
 	glGenVertexArrays(1, &m_default_vao); 
@@ -167,6 +191,7 @@ void Renderer::PostStartup()
 	//create built-in shaders
 	RegisterBuiltInShaders(BuiltInShaders::defaultShader);
 	RegisterBuiltInShaders(BuiltInShaders::errorShader);
+	RegisterBuiltInShaders(BuiltInShaders::sdfTextShader);
 	m_defaultShader = new Shader();
 	SetShader(nullptr);
 	m_defaultShader->m_is_resource = true;
@@ -247,6 +272,9 @@ void Renderer::BeginFrame()
 
 void Renderer::EndFrame()
 {
+	FlushTextBatch();
+	m_textLayouts.EndFrame();
+
 	// copies the default camera's frame-buffer to the "null" frame-buffer, 
 	// also known as the back buffer.
 	CopyFrameBuffer(nullptr, &m_defaultCamera->m_output); 
@@ -296,11 +324,31 @@ BitmapFont* Renderer::CreateOrGetBitmapFont(const char * bitmapFontName)
 	{
 		SpriteSheet* glyphSheet = new SpriteSheet(*CreateOrGetTexture("Data/Fonts/" + std::string(bitmapFontName) + ".png"), 16, 16); //should we clean this up?
 		BitmapFont* loadedFont = new BitmapFont(bitmapFontName, *glyphSheet, 1);
+		if (g_gameConfigBlackboard.GetValue("sdfFonts", false))
+			LoadSDFAtlasForFont(loadedFont);
 		m_loadedFonts.insert(std::pair<std::string, BitmapFont*>(bitmapFontName, loadedFont));
 		return loadedFont;
 	}
 }
 
+void Renderer::LoadSDFAtlasForFont(BitmapFont* font)
+{
+	PROFILE_SCOPE_FUNCTION();
+
+	//made offline by font_sdf if it's there, made from the glyph sheet otherwise
+	std::string path = "Data/Fonts/" + font->m_fontName + ".sdf";
+	sdf_atlas_t* atlas = new sdf_atlas_t();
+	if (!LoadSDFAtlas(atlas, path))
+	{
+		Image glyphSheet("Data/Fonts/" + font->m_fontName + ".png");
+		GenerateSDFAtlas(atlas, glyphSheet, 16, 16, sdf_atlas_options_t(), GetWorkerThreads());
+	}
+
+	Image atlasImage((unsigned char*) atlas->texels.data(), 4, atlas->dimensions);
+	font->SetSDFAtlas(*atlas, AddTextureFromImage(path, &atlasImage));
+	delete atlas;
+}
+
 Mesh* Renderer::CreateOrGetMesh(const std::string& path)
 {
 	std::map<std::string, Mesh*>::iterator search = m_loadedMesh.find(path);
@@ -310,10 +358,20 @@ Mesh* Renderer::CreateOrGetMesh(const std::string& path)
 	}
 	else
 	{
+		PROFILE_SCOPE_FUNCTION();
+
+		//the cooked file skips the OBJ import; cooked here the first time, or again once the OBJ changes
 		Mesh* loadedMesh = new Mesh();
-		MeshBuilder mb;
-		mb.AddFromObjFile(path);
-		loadedMesh->FromBuilderForType<VertexLit>(mb);
+		bool useMeshFile = g_gameConfigBlackboard.GetValue("meshCache", true);
+		std::string meshPath = GetMeshFilePath(path);
+		if (!useMeshFile || !LoadMeshFile(loadedMesh, meshPath, path))
+		{
+			MeshBuilder mb;
+			bool isImported = ImportObjFile(&mb, path, GetWorkerThreads());
+			loadedMesh->FromBuilderForType<VertexLit>(mb);
+			if (useMeshFile && isImported)
+				SaveMeshFileFromBuilder<VertexLit>(meshPath, mb, path);
+		}
 		m_loadedMesh.insert(std::pair<std::string, Mesh*>(path, loadedMesh));
 		loadedMesh->m_isResource = true;
 		return loadedMesh;
@@ -400,6 +458,7 @@ void Renderer::ReloadShaders()
 
 void Renderer::SetShaderProgram(ShaderProgram* shaderProgram)
 {
+	FlushTextBatch();
 	if (shaderProgram == nullptr)
 		m_defaultShader->m_program = CreateOrGetShaderProgram("default");
 	else
@@ -464,6 +523,7 @@ Texture* Renderer::GetDefaultDepthTarget()
 
 bool Renderer::CopyFrameBuffer(FrameBuffer* dst, FrameBuffer* src)
 {
+	FlushTextBatch();
 	// we need at least the src.
 	if (src == nullptr) 
 		return false; 
@@ -513,16 +573,19 @@ bool Renderer::CopyFrameBuffer(FrameBuffer* dst, FrameBuffer* src)
 
 void Renderer::EnableDepth(eCompare compare, bool shouldWrite)
 {
+	FlushTextBatch();
 	m_defaultShader->SetDepth(compare, shouldWrite);
 }
 
 void Renderer::DisableDepth()
 {
+	FlushTextBatch();
 	m_defaultShader->DisableDepth();
 }
 
 void Renderer::ClearDepth(float depth)
 {
+	FlushTextBatch();
 	glDepthMask(true);
 	glClearDepthf(depth);
 	glClear( GL_DEPTH_BUFFER_BIT ); 
@@ -530,12 +593,14 @@ void Renderer::ClearDepth(float depth)
 
 void Renderer::ClearColor(const Rgba& color)
 {
+	FlushTextBatch();
 	glClearColor(color.r, color.g, color.b, color.a);
 	glClear(GL_COLOR_BUFFER_BIT);
 }
 
 void Renderer::BindTexture(const uint bindPoint, const Texture* texture)
 {
+	FlushTextBatch();
 	TODO("find a gl function to check if we have a sampler binded");
 
 	if (texture == nullptr)
@@ -543,16 +608,19 @@ void Renderer::BindTexture(const uint bindPoint, const Texture* texture)
 
 	glActiveTexture(GL_TEXTURE0 + bindPoint); 
 	glBindTexture(GL_TEXTURE_2D, texture->m_handle); 
+	PROFILE_COUNTER_ADD("state changes", 1);
 }
 
 void Renderer::BindCubeMap(const uint bindPoint, const TextureCube* textureCube)
 {
+	FlushTextBatch();
 	glActiveTexture(GL_TEXTURE0 + bindPoint);
 	glBindTexture(GL_TEXTURE_CUBE_MAP, textureCube->GetHandle());
 }
 
 void Renderer::BindSampler(const uint bindPoint, Sampler* sampler)
 {
+	FlushTextBatch();
 	if (sampler == nullptr)
 		glBindSampler(bindPoint, m_defaultSampler->GetHandle()); 
 	else
@@ -595,6 +663,7 @@ void Renderer::BindMeshToProgram(ShaderProgram* program, Mesh* mesh)
 
 void Renderer::SetWireFrameDrawModeActive(bool active)
 {
+	FlushTextBatch();
 	m_defaultShader->SetFillMode(active ? eFillMode::FILLMODE_WIRE : eFillMode::FILLMODE_SOLID);
 }
 
@@ -602,6 +671,7 @@ void Renderer::BindShaderProgram(ShaderProgram* shaderProgram)
 {
 	glUseProgram(shaderProgram->m_programHandle);
 	GL_CHECK_ERROR();
+	PROFILE_COUNTER_ADD("state changes", 1);
 }
 
 void Renderer::BindRenderState(const RenderState_t& state)
@@ -630,10 +700,12 @@ void Renderer::BindRenderState(const RenderState_t& state)
 	//blend
 	glBlendFuncSeparate(ToGLBlendFactor(state.m_colorSrcFactor), ToGLBlendFactor(state.m_colorDstFactor), ToGLBlendFactor(state.m_alphaSrcFactor), ToGLBlendFactor(state.m_alphaDstFactor));
 	glBlendEquationSeparate(ToGLBlendOp(state.m_colorBlendOp), ToGLBlendOp(state.m_alphaBlendOp));
+	PROFILE_COUNTER_ADD("state changes", 1);
 }
 
 void Renderer::SetShader(Shader* shader) 
 {
+	FlushTextBatch();
 	if (shader == nullptr)
 	{
 		m_defaultShader->m_program = CreateOrGetShaderProgram("default");
@@ -648,6 +720,7 @@ void Renderer::SetShader(Shader* shader)
 
 void Renderer::BindMaterial(Material* mat)
 {
+	FlushTextBatch();
 	SetShader(mat->GetShader());
 
 	//bind textures
@@ -861,131 +934,83 @@ void Renderer::DrawText2D(const Vector2 & drawMins, const std::string & asciiTex
 		fontToUse = m_loadedFonts.begin()->second;
 	}
 
-	float cellWidth = cellHeight * aspectScale; //TODO: make cellWidth dynamic when we upgrade from Bitmap font
-	float anchorX = drawMins.x;
-	float anchorY = drawMins.y;
-	AABB2 characterUV;
-
-	MeshBuilder mb;
-
-	for (unsigned int character = 0; character < asciiText.length(); character++)
-	{
-		characterUV = fontToUse->GetUVsForGlyph(asciiText[character]);
-		mb.AddSprite(Vector3(AABB2(anchorX, anchorY, anchorX  + cellWidth, anchorY + cellHeight).GetCenter(), 0.f), Vector2(cellWidth, cellHeight), Vector3::one, tint, characterUV);
- 		anchorX += cellWidth;
-	}
-
-	Mesh* mesh = new Mesh();
-	mesh->FromBuilderForType<VertexPCU>(mb);
-	BindSampler();
-	BindTexture(0, &fontToUse->m_spriteSheet.GetTexture());
-	DrawMesh(mesh);
-	delete mesh;
+	//one line is cheap to lay out, it goes straight into the batch
+	if (fontToUse != m_textBatchFont)
+		FlushTextBatch();
+	m_textBatchFont = fontToUse;
+	AddTextGlyphs2D(&m_textBatch, drawMins, asciiText.c_str(), (uint) asciiText.length(), cellHeight, aspectScale, fontToUse, tint);
 }
 
 void Renderer::DrawTextInBox2D(const AABB2 & bounds, const std::string & asciiText, float cellHeight, const Rgba & tint, float aspectScale, const BitmapFont * font, eTextDrawMode textDrawMode, const Vector2 & alignment)
 {
 	PROFILE_SCOPE_FUNCTION();
 
-	float scale = 1;
-	float leftPadding = 0;
-	float topPadding = 0;
-	float boxHeight = bounds.GetDimensions().y;
-	float boxWidth = bounds.GetDimensions().x;
-	float cellHeightWithScale = cellHeight;
-	float cellWidthWithScale = cellHeightWithScale * aspectScale; //TODO: make cellWidth dynamic when we upgrade from Bitmap font
-	Strings textList = Split(asciiText, '\n');
-	float textHeight = cellHeightWithScale * textList.size();
+	const BitmapFont* fontToUse = font;
+	if (fontToUse == nullptr)
+	{
+		if (m_loadedFonts.size() == 0)
+			return;
+
+		fontToUse = m_loadedFonts.begin()->second;
+	}
 
 	//DEBUG draw box
 	//DrawAABB(bounds, Rgba::cyan);
 
-	if (textDrawMode == eTextDrawMode::SHRINK_TO_FIT)
-	{
-		float textMaxWidth = 0;
-		for (unsigned int line = 0; line < textList.size(); line++)
-		{
-			float lineWidth = textList[line].size() * cellWidthWithScale;
-			if (lineWidth > textMaxWidth)
-				textMaxWidth = lineWidth;
-		}
-
-		//determine exact scale to shrink
-		float scaleX = 1;
-		float scaleY = 1;
-		if (textHeight > boxHeight)
-			scaleY = boxHeight / textHeight;
-		if (textMaxWidth > boxWidth)
-			scaleX = boxWidth / textMaxWidth;
-		scale = min(scaleX, scaleY);
+	const std::vector<VertexPCU>& layout = m_textLayouts.GetLayoutInBox2D(bounds, asciiText, cellHeight, aspectScale, fontToUse, textDrawMode, alignment);
 
-		//apply scale
-		cellHeightWithScale *= scale;
-		cellWidthWithScale *= scale;
-		textHeight = cellHeightWithScale * textList.size();
-	}
+	if (fontToUse != m_textBatchFont)
+		FlushTextBatch();
+	m_textBatchFont = fontToUse;
 
-	if (textDrawMode == eTextDrawMode::WORD_WRAP)
-	{
-		Strings wrappedTextList;
-		for (unsigned int line = 0; line < textList.size(); line++)
-		{
-			float lineWidth = textList[line].size() * cellWidthWithScale;
-			if (lineWidth > boxWidth)
-			{
-				Strings choppedLine = Split(textList[line], ' ');
+	size_t first = m_textBatch.size();
+	m_textBatch.insert(m_textBatch.end(), layout.begin(), layout.end());
+	for (size_t i = first; i < m_textBatch.size(); i++)
+		m_textBatch[i].m_color = tint;
+}
 
-				//in case there is no way to split a line
-				if (choppedLine.size() <= 1)
-				{
-					wrappedTextList.push_back(textList[line]);
-					continue;
-				}
+void Renderer::FlushTextBatch()
+{
+	if (m_textBatch.empty())
+		return;
 
-				while (choppedLine.size() > 0)
-				{
-					std::string newLine = choppedLine[0];
-					for (unsigned int index = 0; index < choppedLine.size(); index++)
-					{
-						// there is only one word left, forced to use it; there is no next word; when you add a new word and a space (hence +1), you will overflow
-						if (choppedLine.size() == 1 || index + 1 == choppedLine.size() || (newLine.size() + choppedLine[index + 1].size() + 1) * cellWidthWithScale > boxWidth)
-						{
-							wrappedTextList.push_back(newLine);
-							choppedLine.erase(choppedLine.begin(), choppedLine.begin() + index + 1);
-							break;
-						}
-						// keep adding a word otherwise
-						newLine = newLine + " " + choppedLine[index + 1];
-					}
-				}
-			}
-			else
-				wrappedTextList.push_back(textList[line]);
-		}
+	PROFILE_SCOPE_FUNCTION();
 
-		//replace text list used to draw
-		textList = wrappedTextList;
+	uint glyphCount = (uint) m_textBatch.size() / 4;
+	if (glyphCount > m_textMeshCapacity)
+	{
+		uint capacity = (uint) MaxInt((int) glyphCount, MaxInt((int) m_textMeshCapacity * 2, 256));
+		std::vector<uint> indices(capacity * 6);
+		WriteTextQuadIndices(indices.data(), capacity);
 
-		//scale down
-		textHeight = cellHeightWithScale * textList.size();
-		if (textHeight > boxHeight)
-		{
-			scale = boxHeight / textHeight;
-			cellHeightWithScale *= scale;
-			cellWidthWithScale *= scale;
-			textHeight = cellHeightWithScale * textList.size();
-		}
+		m_textMesh->SetVertices<VertexPCU>(capacity * 4, nullptr);
+		m_textMesh->SetIndices(capacity * 6, indices.data());
+		m_textMeshCapacity = capacity;
 	}
 
-	topPadding = (boxHeight - textHeight) * alignment.y;
-	float startY = bounds.mins.y + boxHeight - topPadding - cellHeightWithScale;
-	for (unsigned int line = 0; line < textList.size(); line++)
+	m_textMesh->UpdateVertices<VertexPCU>(0, glyphCount * 4, m_textBatch.data());
+	m_textMesh->SetDrawInstruction(eDrawPrimitive::TRIANGLES, true, 0, glyphCount * 6);
+
+	//emptied first, binding and drawing below would flush again
+	m_textBatch.clear();
+	DrawTextMesh(m_textMesh, m_textBatchFont);
+}
+
+void Renderer::DrawTextMesh(Mesh* mesh, const BitmapFont* font)
+{
+	BindSampler();
+	BindTexture(0, &font->GetTexture());
+	if (!font->IsSDF())
 	{
-		leftPadding = (boxWidth - (textList[line].size() * cellWidthWithScale)) * alignment.x;
-		float startX = bounds.mins.x + leftPadding;
-		DrawText2D(Vector2(startX, startY), textList[line], cellHeightWithScale, tint, aspectScale, font);
-		startY -= cellHeightWithScale;
+		DrawMesh(mesh);
+		return;
 	}
+
+	//same state as the rest of the text, only the program differs
+	ShaderProgram* program = m_currentShader->m_program;
+	m_currentShader->m_program = CreateOrGetShaderProgram("sdf_text");
+	DrawMesh(mesh);
+	m_currentShader->m_program = program;
 }
 
 void Renderer::DrawTextInBox3D(const Vector3& position, const AABB2& bounds, const Matrix44& orientation, const std::string& asciiText, float cellHeight, const Vector2& alignment, const Rgba& tint, eTextDrawMode textDrawMode, float aspectScale, const BitmapFont * font)
@@ -1114,7 +1139,7 @@ void Renderer::DrawText3D(const Vector3& botLeftText, std::string& asciiText, fl
 
 	for (unsigned int character = 0; character < asciiText.length(); character++)
 	{
-		characterUV = fontToUse->GetUVsForGlyph(asciiText[character]);
+		characterUV = fontToUse->m_spriteSheet.GetTexCoordsForSpriteIndex(asciiText[character]); //3D text stays on the glyph sheet
 
 		float left = 0;
 		float right = left + cellWidth;
@@ -1202,6 +1227,7 @@ void Renderer::DrawMeshImmediate(const VertexPCU* verts, int numVerts, eDrawPrim
 
 void Renderer::DrawMesh(Mesh* mesh, const Matrix44& model)
 {
+	FlushTextBatch();
 	ProfilerPush(__FUNCTION__);
 
 	BindShaderProgram(m_currentShader->m_program); 
@@ -1232,11 +1258,13 @@ void Renderer::DrawMesh(Mesh* mesh, const Matrix44& model)
 	GLint bind = glGetUniformLocation(program_handle, "MODEL");
 	if (bind >= 0) {
 		glUniformMatrix4fv(bind, 1, GL_FALSE, (GLfloat*) &model);
+		PROFILE_COUNTER_ADD("uniform uploads", 1);
 	}
 	bind = glGetUniformLocation(program_handle, "TIME");
 	if (bind >= 0) {
 		float time = static_cast<float>(GetSystemCurrentTime());
 		glUniform1f(bind, time);
+		PROFILE_COUNTER_ADD("uniform uploads", 1);
 	}
 
 	glBindFramebuffer(GL_FRAMEBUFFER, m_activeCamera->GetFrameBufferHandle());
@@ -1247,16 +1275,20 @@ void Renderer::DrawMesh(Mesh* mesh, const Matrix44& model)
 			ToGLPrimitive(mesh->m_drawCall.m_primitiveType),      // mode
 			mesh->m_drawCall.m_elemCount,    // count
 			GL_UNSIGNED_INT,  
-			(void*) 0 // element array buffer offset
+			(void*) (mesh->m_drawCall.m_startIndex * sizeof(uint)) // element array buffer offset
 		);
 	}
 	else
 	{
-		glDrawArrays(ToGLPrimitive(mesh->m_drawCall.m_primitiveType), 0, mesh->m_drawCall.m_elemCount);
+		glDrawArrays(ToGLPrimitive(mesh->m_drawCall.m_primitiveType), mesh->m_drawCall.m_startIndex, mesh->m_drawCall.m_elemCount);
 	}
 
 	GL_CHECK_ERROR();
 
+	PROFILE_COUNTER_ADD("draws", 1);
+	if (mesh->m_drawCall.m_primitiveType == eDrawPrimitive::TRIANGLES)
+		PROFILE_COUNTER_ADD("triangles", mesh->m_drawCall.m_elemCount / 3);
+
 	ProfilerPop();
 }
 
@@ -1271,6 +1303,7 @@ void Renderer::DrawMeshWithMaterial(Material* mat, Mesh* mesh, const Matrix44& m
 
 void Renderer::SetCamera(Camera* camera)
 {
+	FlushTextBatch();
 	if (camera == nullptr) 
 		camera = m_defaultCamera; 
 
@@ -1288,6 +1321,7 @@ Camera* Renderer::GetActiveCamera()
 
 void Renderer::SetProjectionOrtho(float width, float height, float orthoNear, float orthoFar)
 {
+	FlushTextBatch();
 	if (m_activeCamera != nullptr)
 	{
 		m_activeCamera->SetProjectionOrtho(width, height, orthoNear, orthoFar);
@@ -1296,6 +1330,7 @@ void Renderer::SetProjectionOrtho(float width, float height, float orthoNear, fl
 
 void Renderer::SetProjectionMatrix(const Matrix44& projection)
 {
+	FlushTextBatch();
 	if (m_activeCamera != nullptr)
 	{
 		m_activeCamera->SetProjection(projection);
@@ -1329,6 +1364,7 @@ void Renderer::PopMatrix()
 
 void Renderer::SetAdditiveBlendingActive(bool active)
 {
+	FlushTextBatch();
 	if (active)
 		m_defaultShader->EnableColorBlend();
 	else
@@ -1337,32 +1373,48 @@ void Renderer::SetAdditiveBlendingActive(bool active)
 
 void Renderer::SetUniform(const char* name, float f)
 {
+	FlushTextBatch();
 	GLint bind_idx = glGetUniformLocation(m_currentShader->m_program->m_programHandle, name);
 	if (bind_idx >= 0) 
+	{
 		glUniform1fv(bind_idx, 1, &f);
+		PROFILE_COUNTER_ADD("uniform uploads", 1);
+	}
 }
 
 void Renderer::SetUniform(const char* name, const Vector3& v)
 {
+	FlushTextBatch();
 	GLint bind_idx = glGetUniformLocation(m_currentShader->m_program->m_programHandle, name);
 	if (bind_idx >= 0) 
+	{
 		glUniform3fv(bind_idx, 1, (GLfloat*) &v);
+		PROFILE_COUNTER_ADD("uniform uploads", 1);
+	}
 }
 
 void Renderer::SetUniform(const char* name, const Vector4& v)
 {
+	FlushTextBatch();
 	GLint bind_idx = glGetUniformLocation(m_currentShader->m_program->m_programHandle, name);
 	if (bind_idx >= 0) 
+	{
 		glUniform4fv(bind_idx, 1, (GLfloat*) &v);
+		PROFILE_COUNTER_ADD("uniform uploads", 1);
+	}
 }
 
 void Renderer::SetUniform(const char* name, const Rgba& color)
 {
+	FlushTextBatch();
 	Vector4 out;
 	color.GetAsFloats(out.x, out.y, out.z, out.w);
 	GLint bind_idx = glGetUniformLocation(m_currentShader->m_program->m_programHandle, name);
 	if (bind_idx >= 0) 
+	{
 		glUniform4fv(bind_idx, 1, (GLfloat*) &out);
+		PROFILE_COUNTER_ADD("uniform uploads", 1);
+	}
 }
 
 void Renderer::ApplyEffect(Shader* shader)
@@ -1403,6 +1455,7 @@ void Renderer::FinishEffects()
 
 void Renderer::SetAmbientLight(float intensity, const Rgba& color)
 {
+	FlushTextBatch();
 	light_buffer_t* buff = m_lightBuffer.as<light_buffer_t>();
 	float r, g, b, a;
 	color.GetAsFloats(r, g, b, a);
@@ -1411,6 +1464,7 @@ void Renderer::SetAmbientLight(float intensity, const Rgba& color)
 
 void Renderer::DisableAllLights()
 {
+	FlushTextBatch();
 	light_buffer_t* buff = m_lightBuffer.as<light_buffer_t>();
 	for (int i = 0; i < MAX_LIGHTS; i++)
 	{
@@ -1420,6 +1474,7 @@ void Renderer::DisableAllLights()
 
 void Renderer::EnableLight(Light* light, uint index)
 {
+	FlushTextBatch();
 	light_buffer_t* buff = m_lightBuffer.as<light_buffer_t>();
 	buff->m_lights[index].SetUp(light->m_transform.GetWorldPosition(), light->m_usesShadow, light->m_color, light->m_intensity, light->m_attenuation,
 		light->m_spec_attunation, light->m_transform.GetWorldMatrix().GetForward(), light->m_directionFactor, light->m_dotInnerAngle, light->m_dotOuterAngle, light->m_shadowVP);
@@ -1434,6 +1489,7 @@ void Renderer::EnableLight(Light* light, uint index)
 
 void Renderer::SetSpecularConstants(float specAmount, float specPower)
 {
+	FlushTextBatch();
 	light_object_buffer_t* buff = m_lightObjectBuffer.as<light_object_buffer_t>();
 	buff->m_specAmount = specAmount;
 	buff->m_specPower = specPower;
@@ -1441,6 +1497,7 @@ void Renderer::SetSpecularConstants(float specAmount, float specPower)
 
 void Renderer::SetFog(const Rgba& color, float nearPlane, float farPlane, float nearFactor, float farFactor)
 {
+	FlushTextBatch();
 	fog_buffer_t* buff = m_fogBuffer.as<fog_buffer_t>();
 	float r, g, b, a;
 	color.GetAsFloats(r, g, b, a);
@@ -1454,6 +1511,7 @@ void Renderer::SetFog(const Rgba& color, float nearPlane, float farPlane, float
 
 void Renderer::UpdateTimeBlock(float currentTime)
 {
+	FlushTextBatch();
 	m_gameTimeRef = currentTime;
 }
 
@@ -1464,6 +1522,7 @@ Texture* Renderer::GetPlainWhiteTexture()
 
 void Renderer::TakeScreenShot()
 {
+	FlushTextBatch();
 	GLint viewport[4];
 	glGetIntegerv(GL_VIEWPORT, viewport);
 	int* width  = &viewport[2];
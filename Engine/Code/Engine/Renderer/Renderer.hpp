@@ -7,6 +7,7 @@
 #include "Engine/Core/Rgba.hpp"
 #include "Engine/Math/AABB2.hpp"
 #include "Engine/Renderer/BitmapFont.hpp"
+#include "Engine/Renderer/TextLayout.hpp"
 #include "Engine/Renderer/Sprite.hpp"
 #include "Engine/Math/MatrixStack.hpp"
 #include "Engine/Core/EngineCommon.hpp"
@@ -40,6 +41,7 @@ struct BuiltInShaders
 
 	static const BuiltInShaders defaultShader;
 	static const BuiltInShaders errorShader;
+	static const BuiltInShaders sdfTextShader;
 };
 
 #pragma endregion
@@ -190,6 +192,12 @@ public:
 		float aspectScale = 1.f,
 		const BitmapFont * font = nullptr);
 	void DrawText3D(const Vector3& botLeftText, std::string& asciiText, float cellHeight, const Matrix44& orientation, const Rgba& tint = Rgba::white, const BitmapFont* font = nullptr, float aspectScale = 1.f);
+
+	// DrawText2D and DrawTextInBox2D queue glyphs for their font, drawn as one mesh once something
+	// else is drawn or any state changes, so draw order is kept. Call this before any GL of your own.
+	void FlushTextBatch();
+	void DrawTextMesh(Mesh* mesh, const BitmapFont* font); // binds the font's texture, and the sdf text program for atlas fonts
+	inline TextLayoutCache& GetTextLayoutCache() { return m_textLayouts; }
 	
 	void DrawCube(const Vector3& center, 
 		const Vector3& dimensions, // width, height, depth
@@ -266,6 +274,9 @@ public:
 	static HDC gHDC;    // our device context
 	static HGLRC gGLContext;    // our rendering context; 
 
+private:
+	void LoadSDFAtlasForFont(BitmapFont* font);
+
 private:
 	std::map<std::string, Texture*> m_textureMap;
 	std::map<std::string, BitmapFont*> m_loadedFonts;
@@ -275,6 +286,12 @@ private:
 	std::map<std::string, Shader*> m_loadedShaders;
 	Mesh* m_immediateMesh;
 
+	TextLayoutCache m_textLayouts;
+	std::vector<VertexPCU> m_textBatch; // white glyph layouts tinted into here
+	const BitmapFont* m_textBatchFont = nullptr;
+	Mesh* m_textMesh = nullptr; // streamed, indices only rewritten when it grows
+	uint m_textMeshCapacity = 0; // glyphs
+
 	MatrixStack m_matrixStack;
 
 	GLuint m_default_vao;
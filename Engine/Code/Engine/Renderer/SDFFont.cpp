@@ -0,0 +1,399 @@
+#include "Engine/Renderer/SDFFont.hpp"
+#include "Engine/Core/Command.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/Image.hpp"
+#include "Engine/Core/WorkerThreadPool.hpp"
+#include "Engine/File/File.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/ThirdParty/stb_write.h"
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+// Metrics file layout (little endian):
+//   header  SDFAtlasHeader below
+//   glyphs  SDF_GLYPH_COUNT of uvs and box (8 floats), then hasInk (uint8)
+
+static const char SDF_ATLAS_MAGIC[4] = { 'T', 'W', 'S', 'F' };
+static const unsigned short SDF_ATLAS_VERSION = 1;
+static const float SDF_FAR = 1e20f;
+static const int SDF_ATLAS_GAP = 1; // texels between packed glyphs, so filtering never reaches a neighbour
+
+struct SDFAtlasHeader
+{
+	char magic[4];
+	unsigned short version;
+	unsigned short reserved;
+	int width;
+	int height;
+	int spread;
+};
+static_assert(sizeof(SDFAtlasHeader) == 20, "SDFAtlasHeader is written as is, keep it free of padding");
+
+// One glyph's field before packing, bottom row first like the sheet
+struct sdf_glyph_field_t
+{
+	IntVector2 dimensions;
+	std::vector<unsigned char> distances;
+	IntVector2 atlasPosition;
+};
+
+//------------------------------------------------------------------------
+// Squared distance from each sample to the nearest zero of f (Felzenszwalb & Huttenlocher):
+// the lower envelope of the parabolas rooted at every sample, found in one pass.
+// v and z are scratch, n and n + 1 long
+static void DistanceTransform1D(const float* f, float* out_d, int n, int* v, float* z)
+{
+	int k = 0;
+	v[0] = 0;
+	z[0] = -SDF_FAR;
+	z[1] = SDF_FAR;
+	for (int q = 1; q < n; q++)
+	{
+		float s = ((f[q] + (float) (q * q)) - (f[v[k]] + (float) (v[k] * v[k]))) / (float) (2 * q - 2 * v[k]);
+		while (s <= z[k])
+		{
+			k--;
+			s = ((f[q] + (float) (q * q)) - (f[v[k]] + (float) (v[k] * v[k]))) / (float) (2 * q - 2 * v[k]);
+		}
+		k++;
+		v[k] = q;
+		z[k] = s;
+		z[k + 1] = SDF_FAR;
+	}
+
+	k = 0;
+	for (int q = 0; q < n; q++)
+	{
+		while (z[k + 1] < (float) q)
+			k++;
+		float offset = (float) (q - v[k]);
+		out_d[q] = (offset * offset) + f[v[k]];
+	}
+}
+
+// Separable: columns, then rows of the column distances, leaves grid holding squared distances
+static void DistanceTransform2D(std::vector<float>* grid, int width, int height)
+{
+	int n = MaxInt(width, height);
+	std::vector<float> f(n);
+	std::vector<float> d(n);
+	std::vector<float> z(n + 1);
+	std::vector<int> v(n);
+	float* texels = grid->data();
+
+	for (int x = 0; x < width; x++)
+	{
+		for (int y = 0; y < height; y++)
+			f[y] = texels[x + (y * width)];
+		DistanceTransform1D(f.data(), d.data(), height, v.data(), z.data());
+		for (int y = 0; y < height; y++)
+			texels[x + (y * width)] = d[y];
+	}
+
+	for (int y = 0; y < height; y++)
+	{
+		float* row = texels + (y * width);
+		DistanceTransform1D(row, d.data(), width, v.data(), z.data());
+		memcpy(row, d.data(), width * sizeof(float));
+	}
+}
+
+static void GenerateGlyphField(sdf_glyph_t* out_glyph, sdf_glyph_field_t* out_field, int glyphIndex, const Image& glyphSheet, int cols, int rows, const sdf_atlas_options_t& options)
+{
+	IntVector2 sheetDimensions = glyphSheet.GetDimensions();
+	int cellWidth = sheetDimensions.x / cols;
+	int cellHeight = sheetDimensions.y / rows;
+	int cellX = (glyphIndex % cols) * cellWidth;
+	int cellY = sheetDimensions.y - (((glyphIndex / cols) + 1) * cellHeight); //row 0 is the top of the sheet, the image is flipped
+
+	//ink bounds in the cell
+	int minX = cellWidth;
+	int minY = cellHeight;
+	int maxX = -1;
+	int maxY = -1;
+	for (int y = 0; y < cellHeight; y++)
+	{
+		for (int x = 0; x < cellWidth; x++)
+		{
+			if (glyphSheet.GetTexel(cellX + x, cellY + y).a < options.threshold)
+				continue;
+
+			minX = MinInt(minX, x);
+			minY = MinInt(minY, y);
+			maxX = MaxInt(maxX, x);
+			maxY = MaxInt(maxY, y);
+		}
+	}
+
+	*out_glyph = sdf_glyph_t();
+	if (maxX < 0)
+		return;
+
+	//the ink box upscaled, with room for the distance to run out on every side
+	int upscale = options.upscale;
+	int spread = options.spread;
+	int width = ((maxX - minX + 1) * upscale) + (2 * spread);
+	int height = ((maxY - minY + 1) * upscale) + (2 * spread);
+	std::vector<float> toInk(width * height);
+	std::vector<float> toBlank(width * height);
+	std::vector<bool> isInk(width * height);
+	for (int y = 0; y < height; y++)
+	{
+		for (int x = 0; x < width; x++)
+		{
+			int index = x + (y * width);
+			int sheetX = minX + ((x - spread) / upscale); //past the padding, so never below zero
+			int sheetY = minY + ((y - spread) / upscale);
+			bool ink = x >= spread && y >= spread && sheetX <= maxX && sheetY <= maxY
+				&& glyphSheet.GetTexel(cellX + sheetX, cellY + sheetY).a >= options.threshold;
+
+			isInk[index] = ink;
+			toInk[index] = ink ? 0.f : SDF_FAR;
+			toBlank[index] = ink ? SDF_FAR : 0.f;
+		}
+	}
+
+	DistanceTransform2D(&toInk, width, height);
+	DistanceTransform2D(&toBlank, width, height);
+
+	//the edge sits half a texel past the last texel on either side of it
+	out_field->dimensions = IntVector2(width, height);
+	out_field->distances.resize(width * height);
+	for (int index = 0; index < width * height; index++)
+	{
+		float distance = isInk[index] ? -(sqrtf(toBlank[index]) - 0.5f) : (sqrtf(toInk[index]) - 0.5f);
+		float value = ClampFloat(0.5f - (distance / (float) (2 * spread)), 0.f, 1.f);
+		out_field->distances[index] = (unsigned char) ((value * 255.f) + 0.5f);
+	}
+
+	float cellTexelsX = (float) (cellWidth * upscale);
+	float cellTexelsY = (float) (cellHeight * upscale);
+	out_glyph->hasInk = true;
+	out_glyph->box = AABB2(
+		(float) ((minX * upscale) - spread) / cellTexelsX,
+		(float) ((minY * upscale) - spread) / cellTexelsY,
+		(float) (((maxX + 1) * upscale) + spread) / cellTexelsX,
+		(float) (((maxY + 1) * upscale) + spread) / cellTexelsY);
+}
+
+// Shelves of glyphs sorted tallest first, in the narrowest power of two width that keeps the atlas about square
+static IntVector2 PackGlyphFields(std::vector<sdf_glyph_field_t>* fields)
+{
+	std::vector<int> order;
+	int area = 0;
+	int widest = 0;
+	for (int index = 0; index < (int) fields->size(); index++)
+	{
+		const sdf_glyph_field_t& field = (*fields)[index];
+		if (field.distances.empty())
+			continue;
+
+		order.push_back(index);
+		area += (field.dimensions.x + SDF_ATLAS_GAP) * (field.dimensions.y + SDF_ATLAS_GAP);
+		widest = MaxInt(widest, field.dimensions.x + SDF_ATLAS_GAP);
+	}
+
+	std::stable_sort(order.begin(), order.end(), [fields](int a, int b) { return (*fields)[a].dimensions.y > (*fields)[b].dimensions.y; });
+
+	int width = 16;
+	while (width < widest || width * width < area)
+		width *= 2;
+
+	int shelfX = 0;
+	int shelfY = 0;
+	int shelfHeight = 0;
+	for each (int index in order)
+	{
+		sdf_glyph_field_t& field = (*fields)[index];
+		if (shelfX + field.dimensions.x + SDF_ATLAS_GAP > width)
+		{
+			shelfX = 0;
+			shelfY += shelfHeight;
+			shelfHeight = 0;
+		}
+
+		field.atlasPosition = IntVector2(shelfX + SDF_ATLAS_GAP, shelfY + SDF_ATLAS_GAP);
+		shelfX += field.dimensions.x + SDF_ATLAS_GAP;
+		shelfHeight = MaxInt(shelfHeight, field.dimensions.y + SDF_ATLAS_GAP);
+	}
+
+	int height = shelfY + shelfHeight + SDF_ATLAS_GAP;
+	return IntVector2(width, (height + 3) & ~3);
+}
+
+void GenerateSDFAtlas(sdf_atlas_t* out, const Image& glyphSheet, int cols, int rows, const sdf_atlas_options_t& options, WorkerThreadPool* workers)
+{
+	int glyphCount = MinInt(cols * rows, SDF_GLYPH_COUNT);
+	std::vector<sdf_glyph_field_t> fields(glyphCount);
+	*out = sdf_atlas_t();
+	out->spread = options.spread;
+
+	//glyphs share nothing but the sheet they read, a job each
+	auto generate = [&](uint glyph) { GenerateGlyphField(&out->glyphs[glyph], &fields[glyph], (int) glyph, glyphSheet, cols, rows, options); };
+	if (workers != nullptr)
+	{
+		workers->ParallelFor((uint) glyphCount, generate);
+	}
+	else
+	{
+		for (int glyph = 0; glyph < glyphCount; glyph++)
+			generate((uint) glyph);
+	}
+
+	out->dimensions = PackGlyphFields(&fields);
+	out->texels.assign(out->dimensions.x * out->dimensions.y, Rgba(255, 255, 255, 0));
+
+	float atlasWidth = (float) out->dimensions.x;
+	float atlasHeight = (float) out->dimensions.y;
+	for (int glyph = 0; glyph < glyphCount; glyph++)
+	{
+		const sdf_glyph_field_t& field = fields[glyph];
+		if (field.distances.empty())
+			continue;
+
+		for (int y = 0; y < field.dimensions.y; y++)
+		{
+			Rgba* texel = &out->texels[field.atlasPosition.x + ((field.atlasPosition.y + y) * out->dimensions.x)];
+			const unsigned char* distance = &field.distances[y * field.dimensions.x];
+			for (int x = 0; x < field.dimensions.x; x++)
+				texel[x].a = distance[x];
+		}
+
+		out->glyphs[glyph].uvs = AABB2(
+			(float) field.atlasPosition.x / atlasWidth,
+			(float) (field.atlasPosition.y + field.dimensions.y) / atlasHeight,
+			(float) (field.atlasPosition.x + field.dimensions.x) / atlasWidth,
+			(float) field.atlasPosition.y / atlasHeight);
+	}
+}
+
+//------------------------------------------------------------------------
+template <typename T>
+static void Write(std::vector<unsigned char>& bytes, const T& value)
+{
+	const unsigned char* data = (const unsigned char*) &value;
+	bytes.insert(bytes.end(), data, data + sizeof(T));
+}
+
+template <typename T>
+static bool Read(const std::vector<unsigned char>& bytes, size_t* cursor, T* out_value)
+{
+	if (*cursor + sizeof(T) > bytes.size())
+		return false;
+
+	memcpy(out_value, bytes.data() + *cursor, sizeof(T));
+	*cursor += sizeof(T);
+	return true;
+}
+
+bool SaveSDFAtlas(const sdf_atlas_t& atlas, const std::string& path)
+{
+	std::vector<unsigned char> bytes;
+	SDFAtlasHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, SDF_ATLAS_MAGIC, sizeof(SDF_ATLAS_MAGIC));
+	header.version = SDF_ATLAS_VERSION;
+	header.width = atlas.dimensions.x;
+	header.height = atlas.dimensions.y;
+	header.spread = atlas.spread;
+	Write(bytes, header);
+
+	for each (const sdf_glyph_t& glyph in atlas.glyphs)
+	{
+		Write(bytes, glyph.uvs);
+		Write(bytes, glyph.box);
+		Write(bytes, (unsigned char) (glyph.hasInk ? 1 : 0));
+	}
+
+	if (!WriteBinaryFile(path.c_str(), bytes.data(), bytes.size()))
+		return false;
+
+	//stored bottom row first, png wants the top one
+	stbi_flip_vertically_on_write(1);
+	int written = stbi_write_png((path + ".png").c_str(), atlas.dimensions.x, atlas.dimensions.y, 4, atlas.texels.data(), atlas.dimensions.x * 4);
+	stbi_flip_vertically_on_write(0);
+	return written != 0;
+}
+
+bool LoadSDFAtlas(sdf_atlas_t* out, const std::string& path)
+{
+	std::vector<unsigned char> bytes;
+	size_t cursor = 0;
+	SDFAtlasHeader header;
+	if (!ReadBinaryFile(path.c_str(), &bytes)
+		|| !Read(bytes, &cursor, &header)
+		|| memcmp(header.magic, SDF_ATLAS_MAGIC, sizeof(SDF_ATLAS_MAGIC)) != 0
+		|| header.version != SDF_ATLAS_VERSION)
+	{
+		return false;
+	}
+
+	*out = sdf_atlas_t();
+	out->dimensions = IntVector2(header.width, header.height);
+	out->spread = header.spread;
+	for (int glyph = 0; glyph < SDF_GLYPH_COUNT; glyph++)
+	{
+		unsigned char hasInk = 0;
+		if (!Read(bytes, &cursor, &out->glyphs[glyph].uvs)
+			|| !Read(bytes, &cursor, &out->glyphs[glyph].box)
+			|| !Read(bytes, &cursor, &hasInk))
+		{
+			return false;
+		}
+		out->glyphs[glyph].hasInk = hasInk != 0;
+	}
+
+	if (!FileExists((path + ".png").c_str()))
+		return false;
+
+	Image image(path + ".png");
+	if (image.GetDimensions() != out->dimensions || image.GetNumComponents() != 4)
+		return false;
+
+	out->texels.resize(out->dimensions.x * out->dimensions.y);
+	memcpy(out->texels.data(), image.GetData(), out->texels.size() * sizeof(Rgba));
+	return true;
+}
+
+//------------------------------------------------------------------------
+void RegisterSDFFontCommands()
+{
+	CommandRegister("font_sdf", GenerateSDFFontFiles, "Writes the signed distance field atlas for Data/Fonts/<name>.png, used when sdfFonts is on. Options: name, upscale (2), spread (4)");
+}
+
+void GenerateSDFFontFiles(Command& cmd)
+{
+	std::string fontName = cmd.GetNextString();
+	if (fontName.empty())
+	{
+		ConsoleErrorf("font_sdf needs a font name");
+		return;
+	}
+
+	sdf_atlas_options_t options;
+	cmd.GetNextInt(&options.upscale);
+	cmd.GetNextInt(&options.spread);
+	options.upscale = MaxInt(options.upscale, 1);
+	options.spread = MaxInt(options.spread, 1);
+
+	std::string sheetPath = "Data/Fonts/" + fontName + ".png";
+	if (!FileExists(sheetPath.c_str()))
+	{
+		ConsoleErrorf("Couldn't find %s", sheetPath.c_str());
+		return;
+	}
+
+	Image glyphSheet(sheetPath);
+
+	sdf_atlas_t* atlas = new sdf_atlas_t();
+	GenerateSDFAtlas(atlas, glyphSheet, 16, 16, options, GetWorkerThreads());
+
+	std::string path = "Data/Fonts/" + fontName + ".sdf";
+	if (SaveSDFAtlas(*atlas, path))
+		ConsolePrintf("Wrote %s (%d x %d atlas)", path.c_str(), atlas->dimensions.x, atlas->dimensions.y);
+	else
+		ConsoleErrorf("Couldn't write %s", path.c_str());
+
+	delete atlas;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/Rgba.hpp"
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/IntVector2.hpp"
+#include <string>
+#include <vector>
+
+class Command;
+class Image;
+class WorkerThreadPool;
+
+constexpr int SDF_GLYPH_COUNT = 256;
+
+struct sdf_glyph_t
+{
+	AABB2 uvs = AABB2(0.f, 0.f, 0.f, 0.f); // in the atlas, same corners as SpriteSheet::GetTexCoordsForSpriteIndex (mins is top left)
+	AABB2 box = AABB2(0.f, 0.f, 0.f, 0.f); // where the quad goes in its cell, 0 to 1 from the cell's bottom left; covers the ink and the spread
+	bool hasInk = false; // blank glyphs have no quad in the atlas
+};
+
+struct sdf_atlas_options_t
+{
+	int upscale = 2; // atlas texels per sheet texel, the field is smoother than the source pixels
+	int spread = 4; // atlas texels the distance runs out to on either side of an edge
+	unsigned char threshold = 128; // sheet alpha at or above this is ink
+};
+
+// Distance to the nearest glyph edge in alpha, 128 on the edge and higher inside, out to
+// spread texels either way. Texels are white and stored bottom row first, like a loaded Image.
+struct sdf_atlas_t
+{
+	IntVector2 dimensions;
+	std::vector<Rgba> texels;
+	int spread = 0;
+	sdf_glyph_t glyphs[SDF_GLYPH_COUNT];
+};
+
+// Euclidean distance transform of every cell of a cols x rows glyph sheet (loaded flipped, as
+// textures are), one glyph per job on workers when given, then the inked ones packed into one atlas
+void GenerateSDFAtlas(sdf_atlas_t* out, const Image& glyphSheet, int cols, int rows, const sdf_atlas_options_t& options, WorkerThreadPool* workers = nullptr);
+
+// <path>.png for the texels and <path> for the glyph metrics
+bool SaveSDFAtlas(const sdf_atlas_t& atlas, const std::string& path);
+bool LoadSDFAtlas(sdf_atlas_t* out, const std::string& path);
+
+// font_sdf writes Data/Fonts/<name>.sdf(.png) from the font's glyph sheet, picked up by
+// Renderer::CreateOrGetBitmapFont instead of generating the atlas at load
+void RegisterSDFFontCommands();
+
+void GenerateSDFFontFiles(Command& cmd);
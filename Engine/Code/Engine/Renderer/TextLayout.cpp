@@ -0,0 +1,232 @@
+#include "Engine/Renderer/TextLayout.hpp"
+#include "Engine/Renderer/BitmapFont.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include <string.h>
+
+constexpr uint TEXT_LAYOUT_MAX_UNUSED_FRAMES = 120;
+constexpr uint TEXT_LAYOUT_SWEEP_FRAMES = 60;
+
+void AddTextGlyphs2D(std::vector<VertexPCU>* out, const Vector2& drawMins, const char* text, uint length, float cellHeight, float aspectScale, const BitmapFont* font, const Rgba& tint)
+{
+	float cellWidth = cellHeight * aspectScale; //TODO: make cellWidth dynamic when we upgrade from Bitmap font
+	float anchorX = drawMins.x;
+	float bottom = drawMins.y;
+	float top = drawMins.y + cellHeight;
+
+	size_t first = out->size();
+	out->resize(first + (length * 4));
+	VertexPCU* glyph = out->data() + first;
+	if (!font->IsSDF())
+	{
+		for (uint character = 0; character < length; character++)
+		{
+			AABB2 uv = font->GetUVsForGlyph(text[character]);
+			float right = anchorX + cellWidth;
+
+			glyph[0] = VertexPCU(Vector3(anchorX, bottom, 0.f), tint, Vector2(uv.mins.x, uv.maxs.y));
+			glyph[1] = VertexPCU(Vector3(right, bottom, 0.f), tint, Vector2(uv.maxs.x, uv.maxs.y));
+			glyph[2] = VertexPCU(Vector3(anchorX, top, 0.f), tint, Vector2(uv.mins.x, uv.mins.y));
+			glyph[3] = VertexPCU(Vector3(right, top, 0.f), tint, Vector2(uv.maxs.x, uv.mins.y));
+
+			glyph += 4;
+			anchorX = right;
+		}
+		return;
+	}
+
+	//atlas glyphs are cropped to their ink, still one cell apart
+	for (uint character = 0; character < length; character++)
+	{
+		AABB2 uv = font->GetUVsForGlyph(text[character]);
+		AABB2 box = font->GetGlyphBox(text[character]);
+		float left = anchorX + (box.mins.x * cellWidth);
+		float right = anchorX + (box.maxs.x * cellWidth);
+		float glyphBottom = bottom + (box.mins.y * cellHeight);
+		float glyphTop = bottom + (box.maxs.y * cellHeight);
+
+		glyph[0] = VertexPCU(Vector3(left, glyphBottom, 0.f), tint, Vector2(uv.mins.x, uv.maxs.y));
+		glyph[1] = VertexPCU(Vector3(right, glyphBottom, 0.f), tint, Vector2(uv.maxs.x, uv.maxs.y));
+		glyph[2] = VertexPCU(Vector3(left, glyphTop, 0.f), tint, Vector2(uv.mins.x, uv.mins.y));
+		glyph[3] = VertexPCU(Vector3(right, glyphTop, 0.f), tint, Vector2(uv.maxs.x, uv.mins.y));
+
+		glyph += 4;
+		anchorX += cellWidth;
+	}
+}
+
+void LayoutTextInBox2D(std::vector<VertexPCU>* out, const AABB2& bounds, const std::string& asciiText, float cellHeight, float aspectScale, const BitmapFont* font, eTextDrawMode textDrawMode, const Vector2& alignment)
+{
+	float scale = 1;
+	float leftPadding = 0;
+	float topPadding = 0;
+	float boxHeight = bounds.GetDimensions().y;
+	float boxWidth = bounds.GetDimensions().x;
+	float cellHeightWithScale = cellHeight;
+	float cellWidthWithScale = cellHeightWithScale * aspectScale; //TODO: make cellWidth dynamic when we upgrade from Bitmap font
+	Strings textList = Split(asciiText, '\n');
+	float textHeight = cellHeightWithScale * textList.size();
+
+	if (textDrawMode == eTextDrawMode::SHRINK_TO_FIT)
+	{
+		float textMaxWidth = 0;
+		for (unsigned int line = 0; line < textList.size(); line++)
+		{
+			float lineWidth = textList[line].size() * cellWidthWithScale;
+			if (lineWidth > textMaxWidth)
+				textMaxWidth = lineWidth;
+		}
+
+		//determine exact scale to shrink
+		float scaleX = 1;
+		float scaleY = 1;
+		if (textHeight > boxHeight)
+			scaleY = boxHeight / textHeight;
+		if (textMaxWidth > boxWidth)
+			scaleX = boxWidth / textMaxWidth;
+		scale = MinFloat(scaleX, scaleY);
+
+		//apply scale
+		cellHeightWithScale *= scale;
+		cellWidthWithScale *= scale;
+		textHeight = cellHeightWithScale * textList.size();
+	}
+
+	if (textDrawMode == eTextDrawMode::WORD_WRAP)
+	{
+		Strings wrappedTextList;
+		for (unsigned int line = 0; line < textList.size(); line++)
+		{
+			float lineWidth = textList[line].size() * cellWidthWithScale;
+			if (lineWidth > boxWidth)
+			{
+				Strings choppedLine = Split(textList[line], ' ');
+
+				//in case there is no way to split a line
+				if (choppedLine.size() <= 1)
+				{
+					wrappedTextList.push_back(textList[line]);
+					continue;
+				}
+
+				while (choppedLine.size() > 0)
+				{
+					std::string newLine = choppedLine[0];
+					for (unsigned int index = 0; index < choppedLine.size(); index++)
+					{
+						// there is only one word left, forced to use it; there is no next word; when you add a new word and a space (hence +1), you will overflow
+						if (choppedLine.size() == 1 || index + 1 == choppedLine.size() || (newLine.size() + choppedLine[index + 1].size() + 1) * cellWidthWithScale > boxWidth)
+						{
+							wrappedTextList.push_back(newLine);
+							choppedLine.erase(choppedLine.begin(), choppedLine.begin() + index + 1);
+							break;
+						}
+						// keep adding a word otherwise
+						newLine = newLine + " " + choppedLine[index + 1];
+					}
+				}
+			}
+			else
+				wrappedTextList.push_back(textList[line]);
+		}
+
+		//replace text list used to draw
+		textList = wrappedTextList;
+
+		//scale down
+		textHeight = cellHeightWithScale * textList.size();
+		if (textHeight > boxHeight)
+		{
+			scale = boxHeight / textHeight;
+			cellHeightWithScale *= scale;
+			cellWidthWithScale *= scale;
+			textHeight = cellHeightWithScale * textList.size();
+		}
+	}
+
+	topPadding = (boxHeight - textHeight) * alignment.y;
+	float startY = bounds.mins.y + boxHeight - topPadding - cellHeightWithScale;
+	for (unsigned int line = 0; line < textList.size(); line++)
+	{
+		leftPadding = (boxWidth - (textList[line].size() * cellWidthWithScale)) * alignment.x;
+		float startX = bounds.mins.x + leftPadding;
+		AddTextGlyphs2D(out, Vector2(startX, startY), textList[line].c_str(), (uint) textList[line].size(), cellHeightWithScale, aspectScale, font);
+		startY -= cellHeightWithScale;
+	}
+}
+
+void WriteTextQuadIndices(uint* out, uint quadCount)
+{
+	for (uint quad = 0; quad < quadCount; quad++)
+	{
+		uint index = quad * 4;
+		uint* faces = out + (quad * 6);
+		faces[0] = index + 0;
+		faces[1] = index + 1;
+		faces[2] = index + 2;
+		faces[3] = index + 2;
+		faces[4] = index + 1;
+		faces[5] = index + 3;
+	}
+}
+
+//------------------------------------------------------------------------
+static size_t HashTextLayout(const AABB2& bounds, const std::string& asciiText, float cellHeight, float aspectScale, const BitmapFont* font, eTextDrawMode textDrawMode, const Vector2& alignment)
+{
+	float numbers[8] = { bounds.mins.x, bounds.mins.y, bounds.maxs.x, bounds.maxs.y, cellHeight, aspectScale, alignment.x, alignment.y };
+	uint bits[8];
+	memcpy(bits, numbers, sizeof(bits));
+
+	size_t hash = std::hash<std::string>()(asciiText);
+	auto combine = [&hash](size_t value) { hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2); };
+	for (uint i = 0; i < 8; i++)
+		combine(bits[i]);
+	combine((size_t) font);
+	combine((size_t) textDrawMode);
+	return hash;
+}
+
+const std::vector<VertexPCU>& TextLayoutCache::GetLayoutInBox2D(const AABB2& bounds, const std::string& asciiText, float cellHeight, float aspectScale, const BitmapFont* font, eTextDrawMode textDrawMode, const Vector2& alignment)
+{
+	size_t hash = HashTextLayout(bounds, asciiText, cellHeight, aspectScale, font, textDrawMode, alignment);
+	text_layout_t& layout = m_layouts[hash];
+	layout.lastUsedFrame = m_frame;
+
+	bool isSame = layout.font == font
+		&& layout.text == asciiText
+		&& layout.bounds.mins == bounds.mins && layout.bounds.maxs == bounds.maxs
+		&& layout.cellHeight == cellHeight
+		&& layout.aspectScale == aspectScale
+		&& layout.drawMode == textDrawMode
+		&& layout.alignment == alignment;
+	if (isSame)
+		return layout.vertices;
+
+	//new, or another layout with the same hash: this one replaces it
+	m_missCount++;
+	layout.text = asciiText;
+	layout.font = font;
+	layout.bounds = bounds;
+	layout.cellHeight = cellHeight;
+	layout.aspectScale = aspectScale;
+	layout.drawMode = textDrawMode;
+	layout.alignment = alignment;
+	layout.vertices.clear();
+	LayoutTextInBox2D(&layout.vertices, bounds, asciiText, cellHeight, aspectScale, font, textDrawMode, alignment);
+	return layout.vertices;
+}
+
+void TextLayoutCache::EndFrame()
+{
+	m_frame++;
+	if ((m_frame % TEXT_LAYOUT_SWEEP_FRAMES) != 0)
+		return;
+
+	for (auto it = m_layouts.begin(); it != m_layouts.end();)
+	{
+		if (m_frame - it->second.lastUsedFrame > TEXT_LAYOUT_MAX_UNUSED_FRAMES)
+			it = m_layouts.erase(it);
+		else
+			++it;
+	}
+}
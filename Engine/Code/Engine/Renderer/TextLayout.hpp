@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/Rgba.hpp"
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/Vector2.hpp"
+#include "Engine/Renderer/RendererTypes.hpp"
+#include "Engine/Renderer/VertexPCU.hpp"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class BitmapFont;
+
+// One line of glyphs from drawMins, 4 vertices per glyph in MeshBuilder::AddSprite's order
+void AddTextGlyphs2D(std::vector<VertexPCU>* out, const Vector2& drawMins, const char* text, uint length, float cellHeight, float aspectScale, const BitmapFont* font, const Rgba& tint = Rgba::white);
+
+// Text laid out in a box the way Renderer::DrawTextInBox2D always has: split into lines on '\n',
+// then shrunk or word wrapped to fit by the draw mode, and placed by alignment
+void LayoutTextInBox2D(std::vector<VertexPCU>* out, const AABB2& bounds, const std::string& asciiText, float cellHeight, float aspectScale, const BitmapFont* font, eTextDrawMode textDrawMode, const Vector2& alignment);
+
+void WriteTextQuadIndices(uint* out, uint quadCount); // AddSprite's two faces for each glyph
+
+//------------------------------------------------------------------------
+// Box layouts keyed by everything that goes into them, so text that stays the same from frame
+// to frame is only split and wrapped once. Layouts are white, tint them when drawing.
+// Ones that go unused for a couple of seconds' worth of frames are dropped.
+class TextLayoutCache
+{
+public:
+	const std::vector<VertexPCU>& GetLayoutInBox2D(const AABB2& bounds, const std::string& asciiText, float cellHeight, float aspectScale, const BitmapFont* font, eTextDrawMode textDrawMode, const Vector2& alignment);
+	void EndFrame();
+
+	inline uint GetLayoutCount() const { return (uint) m_layouts.size(); }
+	inline uint GetMissCount() const { return m_missCount; }
+
+private:
+	struct text_layout_t
+	{
+		std::string text;
+		const BitmapFont* font = nullptr; // nullptr until laid out
+		AABB2 bounds;
+		float cellHeight = 0.f;
+		float aspectScale = 0.f;
+		eTextDrawMode drawMode = OVERRUN;
+		Vector2 alignment;
+		uint lastUsedFrame = 0;
+		std::vector<VertexPCU> vertices;
+	};
+
+private:
+	std::unordered_map<size_t, text_layout_t> m_layouts; // by a hash of the inputs, checked in full on a hit
+	uint m_frame = 0;
+	uint m_missCount = 0;
+};
@@ -1,5 +1,6 @@
 #include "Engine/Renderer/UniformBuffer.hpp"
 #include "Engine/Renderer/glFunctions.hpp"
+#include "Engine/Profiler/Profiler.hpp"
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -63,6 +64,7 @@ void UniformBuffer::UpdateGPU()
 
 		m_renderBuffer.CopyToGPU(m_bufferSize, m_buffer);
 		m_isDirty = false;
+		PROFILE_COUNTER_ADD("uniform uploads", 1);
 	}
 }
 
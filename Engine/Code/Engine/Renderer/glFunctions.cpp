@@ -17,6 +17,7 @@ void BindGLFunctions()
 	GL_BIND_FUNCTION(glGenBuffers);
 	GL_BIND_FUNCTION(glBindBuffer);
 	GL_BIND_FUNCTION(glBufferData);
+	GL_BIND_FUNCTION(glBufferSubData);
 	GL_BIND_FUNCTION(glCreateProgram);
 	GL_BIND_FUNCTION(glAttachShader);
 	GL_BIND_FUNCTION(glLinkProgram);
@@ -106,6 +107,7 @@ PFNGLDELETEBUFFERSPROC glDeleteBuffers = nullptr;
 PFNGLGENBUFFERSPROC glGenBuffers = nullptr;
 PFNGLBINDBUFFERPROC glBindBuffer = nullptr;
 PFNGLBUFFERDATAPROC glBufferData = nullptr;
+PFNGLBUFFERSUBDATAPROC glBufferSubData = nullptr;
 PFNGLCREATEPROGRAMPROC glCreateProgram = nullptr;
 PFNGLATTACHSHADERPROC glAttachShader = nullptr;
 PFNGLLINKPROGRAMPROC glLinkProgram = nullptr;
@@ -5,8 +5,10 @@
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Math/Vector2.hpp"
 #include "Engine/Math/Vector3.hpp"
+#include "Engine/Math/Vector4.hpp"
 #include <math.h>
-//#include "Engine/Math/Vector4.hpp"
+
+const float fSQRT_3_OVER_3 = 0.5773502691896257645091f;
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 // For all fractal (and Perlin) noise functions, the following internal naming conventions
@@ -449,7 +451,6 @@ float Compute2dPerlinNoise( float posX, float posY, float scale, unsigned int nu
 	return totalNoise;
 }
 
-/*
 //-----------------------------------------------------------------------------------------------
 // Perlin noise is fractal noise with "gradient vector smoothing" applied.
 //
@@ -566,9 +567,7 @@ float Compute3dPerlinNoise( float posX, float posY, float posZ, float scale, uns
 
 	return totalNoise;
 }
-*/
 
-/*
 //-----------------------------------------------------------------------------------------------
 // Perlin noise is fractal noise with "gradient vector smoothing" applied.
 //
@@ -740,4 +739,301 @@ float Compute4dPerlinNoise( float posX, float posY, float posZ, float posT, floa
 
 	return totalNoise;
 }
-*/
+
+
+//-----------------------------------------------------------------------------------------------
+// Simplex noise sums the contributions of only N+1 corners (instead of Perlin's 2^N), the corners
+//	of the triangle / tetrahedron / 5-cell containing the point in a skewed grid.  Each corner's
+//	contribution is (0.5 - distSquared)^4 * dot( gradient, displacement ), zero beyond radius
+//	sqrt(0.5).  Using 0.5 (not the 0.6 often seen in 3D/4D) keeps contributions at exactly zero
+//	by the time a corner drops out of the simplex, so there are no seams.
+//
+static inline float ComputeSimplexCornerNoise( float distanceSquared, float gradientDot )
+{
+	float falloff = 0.5f - distanceSquared;
+	falloff = falloff > 0.f ? falloff : 0.f; // select, not a branch; which corners drop out is random
+	falloff *= falloff;
+	return falloff * falloff * gradientDot;
+}
+
+// Largest possible sum of corner contributions (every corner's gradient pointing straight at
+//	the sample), found by numeric search; dividing by these maps each octave to ~[-1,1].
+const float SIMPLEX_MAX_2D = 0.009995992f;
+const float SIMPLEX_MAX_3D = 0.009197449f;
+const float SIMPLEX_MAX_4D = 0.009196740f;
+
+
+//-----------------------------------------------------------------------------------------------
+// In 2D, the simplex is a triangle; gradients are the same 8 unit vectors 2D Perlin uses.
+//
+float Compute2dSimplexNoise( float posX, float posY, float scale, unsigned int numOctaves, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed )
+{
+	const float OCTAVE_OFFSET = 0.636764989593174f; // Translation/bias to add to each octave
+	const float SKEW_2D = 0.366025403784438647f;	// (sqrt(3)-1)/2; squares -> pairs of equilateral triangles
+	const float UNSKEW_2D = 0.211324865405187118f;	// (3-sqrt(3))/6; and back again
+	const Vector2 gradients[ 8 ] = // Normalized unit vectors in 8 quarter-cardinal directions
+	{
+		Vector2( +0.923879533f, +0.382683432f ), //  22.5 degrees (ENE)
+		Vector2( +0.382683432f, +0.923879533f ), //  67.5 degrees (NNE)
+		Vector2( -0.382683432f, +0.923879533f ), // 112.5 degrees (NNW)
+		Vector2( -0.923879533f, +0.382683432f ), // 157.5 degrees (WNW)
+		Vector2( -0.923879533f, -0.382683432f ), // 202.5 degrees (WSW)
+		Vector2( -0.382683432f, -0.923879533f ), // 247.5 degrees (SSW)
+		Vector2( +0.382683432f, -0.923879533f ), // 292.5 degrees (SSE)
+		Vector2( +0.923879533f, -0.382683432f )	 // 337.5 degrees (ESE)
+	};
+
+	float totalNoise = 0.f;
+	float totalAmplitude = 0.f;
+	float currentAmplitude = 1.f;
+	float invScale = (1.f / scale);
+	Vector2 currentPos( posX * invScale, posY * invScale );
+
+	for( unsigned int octaveNum = 0; octaveNum < numOctaves; ++ octaveNum )
+	{
+		// Find the skewed cell, and the displacement from its first corner (in unskewed space)
+		float skew = (currentPos.x + currentPos.y) * SKEW_2D;
+		Vector2 cellMins( floorf( currentPos.x + skew ), floorf( currentPos.y + skew ) );
+		int indexX = (int) cellMins.x;
+		int indexY = (int) cellMins.y;
+		float unskew = (cellMins.x + cellMins.y) * UNSKEW_2D;
+		Vector2 displacementFromFirst( currentPos.x - (cellMins.x - unskew), currentPos.y - (cellMins.y - unskew) );
+
+		// Below or above the cell's diagonal decides whether we step east or north first
+		int stepX = displacementFromFirst.x > displacementFromFirst.y ? 1 : 0;
+		int stepY = 1 - stepX;
+
+		Vector2 displacementFromSecond( displacementFromFirst.x - (float) stepX + UNSKEW_2D, displacementFromFirst.y - (float) stepY + UNSKEW_2D );
+		Vector2 displacementFromThird( displacementFromFirst.x - 1.f + (2.f * UNSKEW_2D), displacementFromFirst.y - 1.f + (2.f * UNSKEW_2D) );
+
+		const Vector2& gradientFirst  = gradients[ Get2dNoiseUint( indexX, indexY, seed ) & 0x00000007 ];
+		const Vector2& gradientSecond = gradients[ Get2dNoiseUint( indexX + stepX, indexY + stepY, seed ) & 0x00000007 ];
+		const Vector2& gradientThird  = gradients[ Get2dNoiseUint( indexX + 1, indexY + 1, seed ) & 0x00000007 ];
+
+		float noiseThisOctave = ComputeSimplexCornerNoise( DotProduct( displacementFromFirst, displacementFromFirst ), DotProduct( gradientFirst, displacementFromFirst ) );
+		noiseThisOctave += ComputeSimplexCornerNoise( DotProduct( displacementFromSecond, displacementFromSecond ), DotProduct( gradientSecond, displacementFromSecond ) );
+		noiseThisOctave += ComputeSimplexCornerNoise( DotProduct( displacementFromThird, displacementFromThird ), DotProduct( gradientThird, displacementFromThird ) );
+		noiseThisOctave *= (1.f / SIMPLEX_MAX_2D);
+
+		// Accumulate results and prepare for next octave (if any)
+		totalNoise += noiseThisOctave * currentAmplitude;
+		totalAmplitude += currentAmplitude;
+		currentAmplitude *= octavePersistence;
+		currentPos *= octaveScale;
+		currentPos.x += OCTAVE_OFFSET; // Add "irrational" offset to de-align octave grids
+		currentPos.y += OCTAVE_OFFSET; // Add "irrational" offset to de-align octave grids
+		++ seed; // Eliminates octaves "echoing" each other (since each octave is uniquely seeded)
+	}
+
+	// Re-normalize total noise to within [-1,1] and fix octaves pulling us far away from limits
+	if( renormalize && totalAmplitude > 0.f )
+	{
+		totalNoise /= totalAmplitude;				// Amplitude exceeds 1.0 if octaves are used
+		totalNoise = (totalNoise * 0.5f) + 0.5f;	// Map to [0,1]
+		totalNoise = SmoothStep3( totalNoise );		// Push towards extents (octaves pull us away)
+		totalNoise = (totalNoise * 2.0f) - 1.f;		// Map back to [-1,1]
+	}
+
+	return totalNoise;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// In 3D, the simplex is a tetrahedron; gradients are the 12 cube edge directions, padded out to
+//	16 (with 4 repeats, as in Perlin's "improved" noise) so they can be picked with a bit-mask.
+//
+float Compute3dSimplexNoise( float posX, float posY, float posZ, float scale, unsigned int numOctaves, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed )
+{
+	const float OCTAVE_OFFSET = 0.636764989593174f; // Translation/bias to add to each octave
+	const float SKEW_3D = 1.f / 3.f;
+	const float UNSKEW_3D = 1.f / 6.f;
+	const float E = 0.7071067811865475244f; // sqrt(2)/2, normalizes the edge directions
+	const Vector3 gradients[ 16 ] =
+	{
+		Vector3( +E, +E, 0.f ), Vector3( -E, +E, 0.f ), Vector3( +E, -E, 0.f ), Vector3( -E, -E, 0.f ),
+		Vector3( +E, 0.f, +E ), Vector3( -E, 0.f, +E ), Vector3( +E, 0.f, -E ), Vector3( -E, 0.f, -E ),
+		Vector3( 0.f, +E, +E ), Vector3( 0.f, -E, +E ), Vector3( 0.f, +E, -E ), Vector3( 0.f, -E, -E ),
+		Vector3( +E, +E, 0.f ), Vector3( -E, +E, 0.f ), Vector3( 0.f, -E, +E ), Vector3( 0.f, -E, -E )
+	};
+
+	float totalNoise = 0.f;
+	float totalAmplitude = 0.f;
+	float currentAmplitude = 1.f;
+	float invScale = (1.f / scale);
+	Vector3 currentPos( posX * invScale, posY * invScale, posZ * invScale );
+
+	for( unsigned int octaveNum = 0; octaveNum < numOctaves; ++ octaveNum )
+	{
+		// Find the skewed cell, and the displacement from its first corner (in unskewed space)
+		float skew = (currentPos.x + currentPos.y + currentPos.z) * SKEW_3D;
+		Vector3 cellMins( floorf( currentPos.x + skew ), floorf( currentPos.y + skew ), floorf( currentPos.z + skew ) );
+		int indexX = (int) cellMins.x;
+		int indexY = (int) cellMins.y;
+		int indexZ = (int) cellMins.z;
+		float unskew = (cellMins.x + cellMins.y + cellMins.z) * UNSKEW_3D;
+		Vector3 displacementFromFirst( currentPos.x - (cellMins.x - unskew), currentPos.y - (cellMins.y - unskew), currentPos.z - (cellMins.z - unskew) );
+
+		// Rank the axes by displacement; the simplex steps along the largest first (compares, no 6-way case table)
+		int xOverY = displacementFromFirst.x > displacementFromFirst.y ? 1 : 0;
+		int xOverZ = displacementFromFirst.x > displacementFromFirst.z ? 1 : 0;
+		int yOverZ = displacementFromFirst.y > displacementFromFirst.z ? 1 : 0;
+		int rankX = xOverY + xOverZ;
+		int rankY = (1 - xOverY) + yOverZ;
+		int rankZ = (1 - xOverZ) + (1 - yOverZ);
+
+		int secondX = rankX >= 2 ? 1 : 0;
+		int secondY = rankY >= 2 ? 1 : 0;
+		int secondZ = rankZ >= 2 ? 1 : 0;
+		int thirdX = rankX >= 1 ? 1 : 0;
+		int thirdY = rankY >= 1 ? 1 : 0;
+		int thirdZ = rankZ >= 1 ? 1 : 0;
+
+		Vector3 displacementFromSecond( displacementFromFirst.x - (float) secondX + UNSKEW_3D, displacementFromFirst.y - (float) secondY + UNSKEW_3D, displacementFromFirst.z - (float) secondZ + UNSKEW_3D );
+		Vector3 displacementFromThird( displacementFromFirst.x - (float) thirdX + (2.f * UNSKEW_3D), displacementFromFirst.y - (float) thirdY + (2.f * UNSKEW_3D), displacementFromFirst.z - (float) thirdZ + (2.f * UNSKEW_3D) );
+		Vector3 displacementFromFourth( displacementFromFirst.x - 1.f + (3.f * UNSKEW_3D), displacementFromFirst.y - 1.f + (3.f * UNSKEW_3D), displacementFromFirst.z - 1.f + (3.f * UNSKEW_3D) );
+
+		const Vector3& gradientFirst  = gradients[ Get3dNoiseUint( indexX, indexY, indexZ, seed ) & 0x0000000F ];
+		const Vector3& gradientSecond = gradients[ Get3dNoiseUint( indexX + secondX, indexY + secondY, indexZ + secondZ, seed ) & 0x0000000F ];
+		const Vector3& gradientThird  = gradients[ Get3dNoiseUint( indexX + thirdX, indexY + thirdY, indexZ + thirdZ, seed ) & 0x0000000F ];
+		const Vector3& gradientFourth = gradients[ Get3dNoiseUint( indexX + 1, indexY + 1, indexZ + 1, seed ) & 0x0000000F ];
+
+		float noiseThisOctave = ComputeSimplexCornerNoise( DotProduct( displacementFromFirst, displacementFromFirst ), DotProduct( gradientFirst, displacementFromFirst ) );
+		noiseThisOctave += ComputeSimplexCornerNoise( DotProduct( displacementFromSecond, displacementFromSecond ), DotProduct( gradientSecond, displacementFromSecond ) );
+		noiseThisOctave += ComputeSimplexCornerNoise( DotProduct( displacementFromThird, displacementFromThird ), DotProduct( gradientThird, displacementFromThird ) );
+		noiseThisOctave += ComputeSimplexCornerNoise( DotProduct( displacementFromFourth, displacementFromFourth ), DotProduct( gradientFourth, displacementFromFourth ) );
+		noiseThisOctave *= (1.f / SIMPLEX_MAX_3D);
+
+		// Accumulate results and prepare for next octave (if any)
+		totalNoise += noiseThisOctave * currentAmplitude;
+		totalAmplitude += currentAmplitude;
+		currentAmplitude *= octavePersistence;
+		currentPos *= octaveScale;
+		currentPos.x += OCTAVE_OFFSET; // Add "irrational" offset to de-align octave grids
+		currentPos.y += OCTAVE_OFFSET; // Add "irrational" offset to de-align octave grids
+		currentPos.z += OCTAVE_OFFSET; // Add "irrational" offset to de-align octave grids
+		++ seed; // Eliminates octaves "echoing" each other (since each octave is uniquely seeded)
+	}
+
+	// Re-normalize total noise to within [-1,1] and fix octaves pulling us far away from limits
+	if( renormalize && totalAmplitude > 0.f )
+	{
+		totalNoise /= totalAmplitude;				// Amplitude exceeds 1.0 if octaves are used
+		totalNoise = (totalNoise * 0.5f) + 0.5f;	// Map to [0,1]
+		totalNoise = SmoothStep3( totalNoise );		// Push towards extents (octaves pull us away)
+		totalNoise = (totalNoise * 2.0f) - 1.f;		// Map back to [-1,1]
+	}
+
+	return totalNoise;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// In 4D, the simplex is a 5-cell; gradients are the 32 hypercube edge directions (one component
+//	zero, the other three +/-1, normalized), which happens to be a power of two already.
+//
+float Compute4dSimplexNoise( float posX, float posY, float posZ, float posT, float scale, unsigned int numOctaves, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed )
+{
+	const float OCTAVE_OFFSET = 0.636764989593174f; // Translation/bias to add to each octave
+	const float SKEW_4D = 0.309016994374947424f;	// (sqrt(5)-1)/4
+	const float UNSKEW_4D = 0.138196601125010515f;	// (5-sqrt(5))/20
+	const float E = fSQRT_3_OVER_3;
+	const Vector4 gradients[ 32 ] =
+	{
+		Vector4( 0.f, +E, +E, +E ), Vector4( 0.f, +E, +E, -E ), Vector4( 0.f, +E, -E, +E ), Vector4( 0.f, +E, -E, -E ),
+		Vector4( 0.f, -E, +E, +E ), Vector4( 0.f, -E, +E, -E ), Vector4( 0.f, -E, -E, +E ), Vector4( 0.f, -E, -E, -E ),
+		Vector4( +E, 0.f, +E, +E ), Vector4( +E, 0.f, +E, -E ), Vector4( +E, 0.f, -E, +E ), Vector4( +E, 0.f, -E, -E ),
+		Vector4( -E, 0.f, +E, +E ), Vector4( -E, 0.f, +E, -E ), Vector4( -E, 0.f, -E, +E ), Vector4( -E, 0.f, -E, -E ),
+		Vector4( +E, +E, 0.f, +E ), Vector4( +E, +E, 0.f, -E ), Vector4( +E, -E, 0.f, +E ), Vector4( +E, -E, 0.f, -E ),
+		Vector4( -E, +E, 0.f, +E ), Vector4( -E, +E, 0.f, -E ), Vector4( -E, -E, 0.f, +E ), Vector4( -E, -E, 0.f, -E ),
+		Vector4( +E, +E, +E, 0.f ), Vector4( +E, +E, -E, 0.f ), Vector4( +E, -E, +E, 0.f ), Vector4( +E, -E, -E, 0.f ),
+		Vector4( -E, +E, +E, 0.f ), Vector4( -E, +E, -E, 0.f ), Vector4( -E, -E, +E, 0.f ), Vector4( -E, -E, -E, 0.f )
+	};
+
+	float totalNoise = 0.f;
+	float totalAmplitude = 0.f;
+	float currentAmplitude = 1.f;
+	float invScale = (1.f / scale);
+	Vector4 currentPos( posX * invScale, posY * invScale, posZ * invScale, posT * invScale );
+
+	for( unsigned int octaveNum = 0; octaveNum < numOctaves; ++ octaveNum )
+	{
+		// Find the skewed cell, and the displacement from its first corner (in unskewed space)
+		float skew = (currentPos.x + currentPos.y + currentPos.z + currentPos.w) * SKEW_4D;
+		Vector4 cellMins( floorf( currentPos.x + skew ), floorf( currentPos.y + skew ), floorf( currentPos.z + skew ), floorf( currentPos.w + skew ) );
+		int indexX = (int) cellMins.x;
+		int indexY = (int) cellMins.y;
+		int indexZ = (int) cellMins.z;
+		int indexT = (int) cellMins.w;
+		float unskew = (cellMins.x + cellMins.y + cellMins.z + cellMins.w) * UNSKEW_4D;
+		Vector4 displacementFromFirst( currentPos.x - (cellMins.x - unskew), currentPos.y - (cellMins.y - unskew), currentPos.z - (cellMins.z - unskew), currentPos.w - (cellMins.w - unskew) );
+
+		// Rank the axes by displacement; 6 compares instead of a 24-way case table
+		int xOverY = displacementFromFirst.x > displacementFromFirst.y ? 1 : 0;
+		int xOverZ = displacementFromFirst.x > displacementFromFirst.z ? 1 : 0;
+		int xOverT = displacementFromFirst.x > displacementFromFirst.w ? 1 : 0;
+		int yOverZ = displacementFromFirst.y > displacementFromFirst.z ? 1 : 0;
+		int yOverT = displacementFromFirst.y > displacementFromFirst.w ? 1 : 0;
+		int zOverT = displacementFromFirst.z > displacementFromFirst.w ? 1 : 0;
+		int rankX = xOverY + xOverZ + xOverT;
+		int rankY = (1 - xOverY) + yOverZ + yOverT;
+		int rankZ = (1 - xOverZ) + (1 - yOverZ) + zOverT;
+		int rankT = (1 - xOverT) + (1 - yOverT) + (1 - zOverT);
+
+		int secondX = rankX >= 3 ? 1 : 0;
+		int secondY = rankY >= 3 ? 1 : 0;
+		int secondZ = rankZ >= 3 ? 1 : 0;
+		int secondT = rankT >= 3 ? 1 : 0;
+		int thirdX = rankX >= 2 ? 1 : 0;
+		int thirdY = rankY >= 2 ? 1 : 0;
+		int thirdZ = rankZ >= 2 ? 1 : 0;
+		int thirdT = rankT >= 2 ? 1 : 0;
+		int fourthX = rankX >= 1 ? 1 : 0;
+		int fourthY = rankY >= 1 ? 1 : 0;
+		int fourthZ = rankZ >= 1 ? 1 : 0;
+		int fourthT = rankT >= 1 ? 1 : 0;
+
+		Vector4 displacementFromSecond( displacementFromFirst.x - (float) secondX + UNSKEW_4D, displacementFromFirst.y - (float) secondY + UNSKEW_4D,
+			displacementFromFirst.z - (float) secondZ + UNSKEW_4D, displacementFromFirst.w - (float) secondT + UNSKEW_4D );
+		Vector4 displacementFromThird( displacementFromFirst.x - (float) thirdX + (2.f * UNSKEW_4D), displacementFromFirst.y - (float) thirdY + (2.f * UNSKEW_4D),
+			displacementFromFirst.z - (float) thirdZ + (2.f * UNSKEW_4D), displacementFromFirst.w - (float) thirdT + (2.f * UNSKEW_4D) );
+		Vector4 displacementFromFourth( displacementFromFirst.x - (float) fourthX + (3.f * UNSKEW_4D), displacementFromFirst.y - (float) fourthY + (3.f * UNSKEW_4D),
+			displacementFromFirst.z - (float) fourthZ + (3.f * UNSKEW_4D), displacementFromFirst.w - (float) fourthT + (3.f * UNSKEW_4D) );
+		Vector4 displacementFromFifth( displacementFromFirst.x - 1.f + (4.f * UNSKEW_4D), displacementFromFirst.y - 1.f + (4.f * UNSKEW_4D),
+			displacementFromFirst.z - 1.f + (4.f * UNSKEW_4D), displacementFromFirst.w - 1.f + (4.f * UNSKEW_4D) );
+
+		const Vector4& gradientFirst  = gradients[ Get4dNoiseUint( indexX, indexY, indexZ, indexT, seed ) & 0x0000001F ];
+		const Vector4& gradientSecond = gradients[ Get4dNoiseUint( indexX + secondX, indexY + secondY, indexZ + secondZ, indexT + secondT, seed ) & 0x0000001F ];
+		const Vector4& gradientThird  = gradients[ Get4dNoiseUint( indexX + thirdX, indexY + thirdY, indexZ + thirdZ, indexT + thirdT, seed ) & 0x0000001F ];
+		const Vector4& gradientFourth = gradients[ Get4dNoiseUint( indexX + fourthX, indexY + fourthY, indexZ + fourthZ, indexT + fourthT, seed ) & 0x0000001F ];
+		const Vector4& gradientFifth  = gradients[ Get4dNoiseUint( indexX + 1, indexY + 1, indexZ + 1, indexT + 1, seed ) & 0x0000001F ];
+
+		float noiseThisOctave = ComputeSimplexCornerNoise( DotProduct( displacementFromFirst, displacementFromFirst ), DotProduct( gradientFirst, displacementFromFirst ) );
+		noiseThisOctave += ComputeSimplexCornerNoise( DotProduct( displacementFromSecond, displacementFromSecond ), DotProduct( gradientSecond, displacementFromSecond ) );
+		noiseThisOctave += ComputeSimplexCornerNoise( DotProduct( displacementFromThird, displacementFromThird ), DotProduct( gradientThird, displacementFromThird ) );
+		noiseThisOctave += ComputeSimplexCornerNoise( DotProduct( displacementFromFourth, displacementFromFourth ), DotProduct( gradientFourth, displacementFromFourth ) );
+		noiseThisOctave += ComputeSimplexCornerNoise( DotProduct( displacementFromFifth, displacementFromFifth ), DotProduct( gradientFifth, displacementFromFifth ) );
+		noiseThisOctave *= (1.f / SIMPLEX_MAX_4D);
+
+		// Accumulate results and prepare for next octave (if any)
+		totalNoise += noiseThisOctave * currentAmplitude;
+		totalAmplitude += currentAmplitude;
+		currentAmplitude *= octavePersistence;
+		currentPos *= octaveScale;
+		currentPos.x += OCTAVE_OFFSET; // Add "irrational" offset to de-align octave grids
+		currentPos.y += OCTAVE_OFFSET; // Add "irrational" offset to de-align octave grids
+		currentPos.z += OCTAVE_OFFSET; // Add "irrational" offset to de-align octave grids
+		currentPos.w += OCTAVE_OFFSET; // Add "irrational" offset to de-align octave grids
+		++ seed; // Eliminates octaves "echoing" each other (since each octave is uniquely seeded)
+	}
+
+	// Re-normalize total noise to within [-1,1] and fix octaves pulling us far away from limits
+	if( renormalize && totalAmplitude > 0.f )
+	{
+		totalNoise /= totalAmplitude;				// Amplitude exceeds 1.0 if octaves are used
+		totalNoise = (totalNoise * 0.5f) + 0.5f;	// Map to [0,1]
+		totalNoise = SmoothStep3( totalNoise );		// Push towards extents (octaves pull us away)
+		totalNoise = (totalNoise * 2.0f) - 1.f;		// Map back to [-1,1]
+	}
+
+	return totalNoise;
+}
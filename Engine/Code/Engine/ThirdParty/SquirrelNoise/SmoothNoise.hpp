@@ -71,8 +71,8 @@ float Compute3dFractalNoise( float posX, float posY, float posZ, float scale=1.f
 //
 float Compute1dPerlinNoise( float position, float scale=1.f, unsigned int numOctaves=1, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
 float Compute2dPerlinNoise( float posX, float posY, float scale=1.f, unsigned int numOctaves=1, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
-//float Compute3dPerlinNoise( float posX, float posY, float posZ, float scale=1.f, unsigned int numOctaves=1, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
-//float Compute4dPerlinNoise( float posX, float posY, float posZ, float posT, float scale=1.f, unsigned int numOctaves=1, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
+float Compute3dPerlinNoise( float posX, float posY, float posZ, float scale=1.f, unsigned int numOctaves=1, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
+float Compute4dPerlinNoise( float posX, float posY, float posZ, float posT, float scale=1.f, unsigned int numOctaves=1, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
 
 
 //-----------------------------------------------------------------------------------------------
@@ -82,11 +82,14 @@ float Compute2dPerlinNoise( float posX, float posY, float scale=1.f, unsigned in
 //	Perlin noise, in that it is more organic-looking.  I'm not sure I like the look of it better,
 //	however; examples of cross-sectional 4D simplex noise look worse to me than 4D Perlin does.
 //
-// Also, Simplex noise is based on a regular simplex (2D triangle, 3D tetrahedron, 4-simplex/5-cell)
-//	grid, which is slightly more fiddly, so I haven't bothered writing my own yet.
+// Simplex noise is based on a regular simplex (2D triangle, 3D tetrahedron, 4-simplex/5-cell)
+//	grid, so it only blends N+1 corners per octave instead of Perlin's 2^N: 3 vs. 4 in 2D, 4 vs. 8
+//	in 3D, 5 vs. 16 in 4D.  Same parameters (and gradient-by-bitmask trick) as the Perlin functions.
+//	(1D simplex would be identical to 1D Perlin, so there isn't one.)
 //
-// #TODO: Implement simplex noise in 2D, 3D, 4D (1D simplex is identical to 1D Perlin, I think?)
-// #TODO: Test actual simplex noise implementation in 2D/3D to compare speeds (branches vs. ops!)
+// "bench_noise_types" in the dev console times these against fractal and Perlin noise and prints
+//	their value distributions, to pick the cheapest one that looks right for a given effect.
 //
-
-
+float Compute2dSimplexNoise( float posX, float posY, float scale=1.f, unsigned int numOctaves=1, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
+float Compute3dSimplexNoise( float posX, float posY, float posZ, float scale=1.f, unsigned int numOctaves=1, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
+float Compute4dSimplexNoise( float posX, float posY, float posZ, float posT, float scale=1.f, unsigned int numOctaves=1, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
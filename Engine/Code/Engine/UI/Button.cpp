@@ -1,6 +1,6 @@
 #include "Engine/UI/Button.hpp"
 #include "Engine/Math/MathUtils.hpp"
-#include "Engine/Renderer/Renderer.hpp"
+#include <algorithm>
 
 Button::Button(Canvas* canvas)
 	: CanvasElement(canvas)
@@ -8,20 +8,23 @@ Button::Button(Canvas* canvas)
 	ChangeButtonState(BUTTON_STATE_IDLE);
 }
 
-void Button::Render()
+void Button::AppendQuads(std::vector<VertexPCU>* out)
 {
-	Renderer* r = Renderer::GetInstance();
-
 	if (m_texture != nullptr)
 	{
-		r->DrawTexturedAABB(m_screenBounds, *m_texture, Vector2::one, Vector2::zero, m_currentTint);
+		AppendCanvasQuad(out, m_screenBounds, Vector2::one, Vector2::zero, m_currentTint);
 	}
 	else
 	{
-		r->DrawAABB(m_screenBounds, m_currentTint);
+		AppendCanvasQuad(out, m_screenBounds, Vector2(0, 1), Vector2(1, 0), m_currentTint);
 	}
 }
 
+const Texture* Button::GetTexture()
+{
+	return m_texture;
+}
+
 bool Button::MouseDownInteract(int screenX, int screenY)
 {
 	if (m_buttonState == BUTTON_STATE_DISABLE)
@@ -61,6 +64,8 @@ void Button::ChangeButtonState(BUTTON_STATE newState)
 		m_currentTint = m_disableTint;
 		break;
 	}
+
+	MarkDirty();
 }
 
 void Button::OnClicked()
@@ -23,7 +23,8 @@ public:
 	~Button() {};
 	Button(Canvas* canvas);
 
-	virtual void Render() override;
+	virtual void AppendQuads(std::vector<VertexPCU>* out) override;
+	virtual const Texture* GetTexture() override;
 	virtual bool MouseDownInteract(int screenX, int screenY) override;
 	virtual bool MouseUpInteract(int screenX, int screenY) override;
 	virtual void OnClicked() override;
@@ -36,7 +37,7 @@ public:
 	void RemoveOnClicked(click_cb_int cb);
 
 public:
-	Texture* m_texture;
+	Texture* m_texture = nullptr;
 	std::string m_stringValue = "";
 	int m_intValue = 0;
 
@@ -1,10 +1,17 @@
 #include "Engine/UI/Canvas.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Renderer/Camera.hpp"
+#include "Engine/Renderer/Mesh.hpp"
+#include "Engine/Renderer/TextLayout.hpp"
 #include "Engine/Core/Window.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include <string.h>
+
+constexpr uint CANVAS_QUAD_ROUNDING = 8;
 
 Canvas::~Canvas()
 {
+	delete m_mesh;
 }
 
 Canvas::Canvas()
@@ -15,17 +22,19 @@ Canvas::Canvas()
 
 bool Canvas::IsMouseBlocked(int screenX, int screenY)
 {
-	for each (CanvasGroup* group in m_canvasGroups)
+	UpdateElements();
+	if (m_needsHitGrid)
+		RebuildHitGrid();
+
+	int x = screenX;
+	int y = m_screenHeight - screenY;
+	int cell = GetHitCell(x, y);
+	for (uint i = m_cellStarts[cell]; i < m_cellStarts[cell + 1]; i++)
 	{
-		if (group->m_isActive)
+		const canvas_element_range_t& range = m_ranges[m_cellElements[i]];
+		if (range.group->m_isActive && range.element->IsActive() && range.element->IsMouseWithinBounds(x, y))
 		{
-			for each (CanvasElement* element in group->m_elements)
-			{
-				if (element->IsActive() && element->IsMouseWithinBounds(screenX, m_screenHeight - screenY))
-				{
-					return true;
-				}
-			}
+			return true;
 		}
 	}
 
@@ -40,17 +49,19 @@ void Canvas::SetUICamera(Camera* camera)
 
 void Canvas::OnMouseDown(int screenX, int screenY)
 {
-	for each (CanvasGroup* group in m_canvasGroups)
+	UpdateElements();
+	if (m_needsHitGrid)
+		RebuildHitGrid();
+
+	int x = screenX;
+	int y = m_screenHeight - screenY;
+	m_mouseDownCell = GetHitCell(x, y);
+	for (uint i = m_cellStarts[m_mouseDownCell]; i < m_cellStarts[m_mouseDownCell + 1]; i++)
 	{
-		if (group->m_isActive)
+		const canvas_element_range_t& range = m_ranges[m_cellElements[i]];
+		if (range.group->m_isActive && range.element->IsActive() && range.element->MouseDownInteract(x, y))
 		{
-			for each (CanvasElement* element in group->m_elements)
-			{
-				if (element->IsActive() && element->MouseDownInteract(screenX, m_screenHeight - screenY))
-				{
-					m_selectedElement = element;
-				}
-			}
+			m_selectedElement = range.element;
 		}
 	}
 }
@@ -59,17 +70,31 @@ void Canvas::OnMouseUp(int screenX, int screenY)
 {
 	CanvasElement* potential = nullptr;
 
-	for each (CanvasGroup* group in m_canvasGroups)
+	UpdateElements();
+	if (m_needsHitGrid)
+		RebuildHitGrid();
+
+	int x = screenX;
+	int y = m_screenHeight - screenY;
+	int cell = GetHitCell(x, y);
+
+	//anything pressed was under the mouse when it went down, let those go too
+	if (m_mouseDownCell >= 0 && m_mouseDownCell != cell)
 	{
-		if (group->m_isActive)
+		for (uint i = m_cellStarts[m_mouseDownCell]; i < m_cellStarts[m_mouseDownCell + 1]; i++)
 		{
-			for each (CanvasElement* element in group->m_elements)
-			{
-				if (element->IsActive() && element->MouseUpInteract(screenX, m_screenHeight - screenY))
-				{
-					potential = element;
-				}
-			}
+			const canvas_element_range_t& range = m_ranges[m_cellElements[i]];
+			if (range.group->m_isActive && range.element->IsActive())
+				range.element->MouseUpInteract(x, y);
+		}
+	}
+
+	for (uint i = m_cellStarts[cell]; i < m_cellStarts[cell + 1]; i++)
+	{
+		const canvas_element_range_t& range = m_ranges[m_cellElements[i]];
+		if (range.group->m_isActive && range.element->IsActive() && range.element->MouseUpInteract(x, y))
+		{
+			potential = range.element;
 		}
 	}
 
@@ -79,27 +104,57 @@ void Canvas::OnMouseUp(int screenX, int screenY)
 	}
 
 	m_selectedElement = nullptr;
+	m_mouseDownCell = -1;
 }
 
 void Canvas::Render()
 {
+	UpdateElements();
+	if (m_needsHitGrid)
+		RebuildHitGrid();
+	UpdateGeometry();
+
 	Renderer* r = Renderer::GetInstance();
 	r->SetShader(nullptr);
 	r->SetCamera(m_UICamera);
 	r->DisableDepth();
 
-	for each (CanvasGroup* group in m_canvasGroups)
+	//a run spans elements drawn one after another in the buffer with the same texture and font;
+	//slack and empty elements inside it are degenerate quads, so they draw nothing
+	bool inRun = false;
+	uint runFirst = 0;
+	uint runEnd = 0;
+	const canvas_element_range_t* runStart = nullptr;
+	for each (const canvas_element_range_t& range in m_ranges)
 	{
-		if (group->m_isActive)
+		if (range.quadCount == 0)
+			continue;
+
+		if (!IsDrawn(range))
 		{
-			for each (CanvasElement* element in group->m_elements)
-			{
-				if (element->IsActive())
-					element->Render();
-			}
+			if (inRun)
+				DrawQuads(runFirst, runEnd - runFirst, *runStart);
+			inRun = false;
+			continue;
 		}
+
+		if (inRun && range.texture == runStart->texture && range.font == runStart->font)
+		{
+			runEnd = range.firstQuad + range.quadCount;
+			continue;
+		}
+
+		if (inRun)
+			DrawQuads(runFirst, runEnd - runFirst, *runStart);
+		inRun = true;
+		runFirst = range.firstQuad;
+		runEnd = range.firstQuad + range.quadCount;
+		runStart = &range;
 	}
 
+	if (inRun)
+		DrawQuads(runFirst, runEnd - runFirst, *runStart);
+
 	//reset depth setting
 	r->EnableDepth(COMPARE_LESS, true); 
 }
@@ -118,3 +173,194 @@ void Canvas::SetDefaultFont(BitmapFont* font)
 {
 	m_defaultFont = font;
 }
+
+bool Canvas::IsDrawn(const canvas_element_range_t& range)
+{
+	return range.group->m_isActive && range.element->IsActive() && range.quadCount > 0;
+}
+
+void Canvas::UpdateElements()
+{
+	uint index = 0;
+	bool isSame = true;
+	for each (CanvasGroup* group in m_canvasGroups)
+	{
+		for each (CanvasElement* element in group->m_elements)
+		{
+			if (index >= m_ranges.size() || m_ranges[index].element != element || m_ranges[index].group != group)
+				isSame = false;
+			index++;
+		}
+	}
+
+	if (!isSame || index != m_ranges.size())
+	{
+		m_ranges.clear();
+		for each (CanvasGroup* group in m_canvasGroups)
+		{
+			for each (CanvasElement* element in group->m_elements)
+			{
+				canvas_element_range_t range = { element, group, nullptr, nullptr, 0, 0, 0 };
+				m_ranges.push_back(range);
+			}
+		}
+
+		m_needsRebuild = true;
+		m_needsHitGrid = true;
+		m_mouseDownCell = -1;
+		return;
+	}
+
+	for each (const canvas_element_range_t& range in m_ranges)
+	{
+		if ((range.element->GetDirtyFlags() & CANVAS_ELEMENT_DIRTY_BOUNDS) != 0)
+			m_needsHitGrid = true;
+	}
+}
+
+void Canvas::UpdateGeometry()
+{
+	//dirty elements rewrite their own quads in place while they fit
+	for (uint rangeIndex = 0; rangeIndex < m_ranges.size() && !m_needsRebuild; rangeIndex++)
+	{
+		canvas_element_range_t& range = m_ranges[rangeIndex];
+		if ((range.element->GetDirtyFlags() & CANVAS_ELEMENT_DIRTY_GEOMETRY) == 0)
+			continue;
+
+		m_elementQuads.clear();
+		range.element->AppendQuads(&m_elementQuads);
+		uint quadCount = (uint) m_elementQuads.size() / 4;
+		if (quadCount > range.quadCapacity)
+		{
+			m_needsRebuild = true;
+			break;
+		}
+
+		//quads it no longer uses go back to degenerate
+		uint writeCount = (uint) MaxInt((int) quadCount, (int) range.quadCount);
+		m_elementQuads.resize(writeCount * 4, VertexPCU(Vector3::zero, Rgba(0, 0, 0, 0)));
+		memcpy(m_vertices.data() + (range.firstQuad * 4), m_elementQuads.data(), writeCount * 4 * sizeof(VertexPCU));
+		m_mesh->UpdateVertices<VertexPCU>(range.firstQuad * 4, writeCount * 4, m_elementQuads.data());
+
+		range.quadCount = quadCount;
+		range.texture = range.element->GetTexture();
+		range.font = range.element->GetFont();
+		range.element->ClearDirtyFlags(CANVAS_ELEMENT_DIRTY_GEOMETRY);
+	}
+
+	if (m_needsRebuild)
+		RebuildGeometry();
+}
+
+void Canvas::RebuildGeometry()
+{
+	m_needsRebuild = false;
+	m_vertices.clear();
+
+	uint firstQuad = 0;
+	for (uint rangeIndex = 0; rangeIndex < m_ranges.size(); rangeIndex++)
+	{
+		canvas_element_range_t& range = m_ranges[rangeIndex];
+		m_elementQuads.clear();
+		range.element->AppendQuads(&m_elementQuads);
+		uint quadCount = (uint) m_elementQuads.size() / 4;
+
+		//room for the element to grow a quarter before it moves everything after it
+		range.firstQuad = firstQuad;
+		range.quadCount = quadCount;
+		range.quadCapacity = ((quadCount + (quadCount / 4) + CANVAS_QUAD_ROUNDING) / CANVAS_QUAD_ROUNDING) * CANVAS_QUAD_ROUNDING;
+		range.texture = range.element->GetTexture();
+		range.font = range.element->GetFont();
+		range.element->ClearDirtyFlags(CANVAS_ELEMENT_DIRTY_GEOMETRY);
+
+		m_vertices.insert(m_vertices.end(), m_elementQuads.begin(), m_elementQuads.end());
+		m_vertices.resize((firstQuad + range.quadCapacity) * 4, VertexPCU(Vector3::zero, Rgba(0, 0, 0, 0)));
+		firstQuad += range.quadCapacity;
+	}
+
+	if (firstQuad == 0)
+		return;
+
+	if (m_mesh == nullptr)
+		m_mesh = new Mesh();
+
+	if (firstQuad > m_meshQuadCapacity)
+	{
+		std::vector<uint> indices(firstQuad * 6);
+		WriteTextQuadIndices(indices.data(), firstQuad);
+		m_mesh->SetIndices(firstQuad * 6, indices.data());
+		m_meshQuadCapacity = firstQuad;
+	}
+
+	m_mesh->SetVertices<VertexPCU>(firstQuad * 4, m_vertices.data());
+}
+
+void Canvas::RebuildHitGrid()
+{
+	m_needsHitGrid = false;
+
+	int cellCount = CANVAS_GRID_CELLS * CANVAS_GRID_CELLS;
+	m_cellStarts.assign(cellCount + 1, 0);
+
+	//count, then place, so each cell's elements stay in draw order
+	for (int pass = 0; pass < 2; pass++)
+	{
+		for (uint rangeIndex = 0; rangeIndex < m_ranges.size(); rangeIndex++)
+		{
+			CanvasElement* element = m_ranges[rangeIndex].element;
+			const AABB2& bounds = element->GetScreenBounds();
+			int minCell = GetHitCell((int) bounds.mins.x, (int) bounds.mins.y);
+			int maxCell = GetHitCell((int) bounds.maxs.x, (int) bounds.maxs.y);
+
+			for (int cellY = minCell / CANVAS_GRID_CELLS; cellY <= maxCell / CANVAS_GRID_CELLS; cellY++)
+			{
+				for (int cellX = minCell % CANVAS_GRID_CELLS; cellX <= maxCell % CANVAS_GRID_CELLS; cellX++)
+				{
+					int cell = (cellY * CANVAS_GRID_CELLS) + cellX;
+					if (pass == 0)
+						m_cellStarts[cell + 1]++;
+					else
+						m_cellElements[m_cellStarts[cell + 1]++] = rangeIndex;
+				}
+			}
+
+			if (pass == 1)
+				element->ClearDirtyFlags(CANVAS_ELEMENT_DIRTY_BOUNDS);
+		}
+
+		//running totals: after the count pass each cell's start, after placing each cell's end
+		if (pass == 0)
+		{
+			for (int cell = 0; cell < cellCount; cell++)
+				m_cellStarts[cell + 1] += m_cellStarts[cell];
+			m_cellElements.resize(m_cellStarts[cellCount]);
+
+			//place from each cell's start, shifted down a slot so the place pass leaves the ends
+			for (int cell = cellCount; cell > 0; cell--)
+				m_cellStarts[cell] = m_cellStarts[cell - 1];
+		}
+	}
+}
+
+int Canvas::GetHitCell(int x, int y)
+{
+	int cellX = ClampInt((x * CANVAS_GRID_CELLS) / MaxInt(m_screenWidth, 1), 0, CANVAS_GRID_CELLS - 1);
+	int cellY = ClampInt((y * CANVAS_GRID_CELLS) / MaxInt(m_screenHeight, 1), 0, CANVAS_GRID_CELLS - 1);
+	return (cellY * CANVAS_GRID_CELLS) + cellX;
+}
+
+void Canvas::DrawQuads(uint firstQuad, uint quadCount, const canvas_element_range_t& run)
+{
+	Renderer* r = Renderer::GetInstance();
+
+	m_mesh->SetDrawInstruction(eDrawPrimitive::TRIANGLES, true, firstQuad * 6, quadCount * 6);
+	if (run.font != nullptr)
+	{
+		r->DrawTextMesh(m_mesh, run.font);
+		return;
+	}
+
+	r->BindSampler();
+	r->BindTexture(0, run.texture);
+	r->DrawMesh(m_mesh);
+}
@@ -1,11 +1,20 @@
 #pragma once
 
 #include "Engine/UI/CanvasGroup.hpp"
+#include "Engine/Renderer/VertexPCU.hpp"
 #include <vector>
 
 class Camera;
 class BitmapFont;
+class Mesh;
+class Texture;
 
+constexpr int CANVAS_GRID_CELLS = 8; // hit test grid cells along each side of the screen
+
+// Retained: every element's quads live in one vertex buffer, in group and element order, and
+// only dirty elements are built again. Each element owns a run of quads with some room to grow,
+// so changing a string rewrites just that run. Active elements next to each other with the same
+// texture and font draw together. Mouse hits only test the elements in the grid cell under the mouse.
 class Canvas 
 {
 public: 
@@ -25,6 +34,26 @@ public:
 	void SetDefaultFont(BitmapFont* font);
 	inline BitmapFont* GetDefaultFont() { return m_defaultFont; };
 
+private:
+	struct canvas_element_range_t
+	{
+		CanvasElement* element;
+		CanvasGroup* group;
+		const Texture* texture;
+		const BitmapFont* font;
+		uint firstQuad;
+		uint quadCount;
+		uint quadCapacity;
+	};
+
+	bool IsDrawn(const canvas_element_range_t& range);
+	void UpdateElements(); // catches elements added, removed or moved between groups
+	void UpdateGeometry();
+	void RebuildGeometry();
+	void RebuildHitGrid();
+	int GetHitCell(int x, int y);
+	void DrawQuads(uint firstQuad, uint quadCount, const canvas_element_range_t& run);
+
 public:
 	std::vector<CanvasGroup*> m_canvasGroups;
 
@@ -35,4 +64,17 @@ private:
 
 	CanvasElement* m_selectedElement = nullptr;
 	BitmapFont* m_defaultFont = nullptr;
+
+	std::vector<canvas_element_range_t> m_ranges;
+	std::vector<VertexPCU> m_vertices; // quadCapacity * 4 for each range
+	std::vector<VertexPCU> m_elementQuads; // scratch for one element
+	bool m_needsRebuild = true;
+	Mesh* m_mesh = nullptr;
+	uint m_meshQuadCapacity = 0;
+
+	// element range indices for each cell, cell by cell: cell i's are m_cellElements[m_cellStarts[i], m_cellStarts[i + 1])
+	std::vector<uint> m_cellStarts;
+	std::vector<uint> m_cellElements;
+	bool m_needsHitGrid = true;
+	int m_mouseDownCell = -1;
 };
@@ -30,4 +30,14 @@ void CanvasElement::SetBounds(const AABB2& bounds)
 	m_screenBounds.maxs.x = RangeMapFloat(m_bounds.maxs.x, 0, 1, 0, m_canvasAttached->GetWidth());
 	m_screenBounds.mins.y = RangeMapFloat(m_bounds.mins.y, 0, 1, 0, m_canvasAttached->GetHeight());
 	m_screenBounds.maxs.y = RangeMapFloat(m_bounds.maxs.y, 0, 1, 0, m_canvasAttached->GetHeight());
+
+	MarkDirty(CANVAS_ELEMENT_DIRTY_GEOMETRY | CANVAS_ELEMENT_DIRTY_BOUNDS);
+}
+
+void AppendCanvasQuad(std::vector<VertexPCU>* out, const AABB2& bounds, const Vector2& texCoordsAtMins, const Vector2& texCoordsAtMaxs, const Rgba& tint)
+{
+	out->push_back(VertexPCU(Vector2(bounds.mins.x, bounds.mins.y), tint, Vector2(texCoordsAtMins.x, texCoordsAtMaxs.y)));
+	out->push_back(VertexPCU(Vector2(bounds.maxs.x, bounds.mins.y), tint, Vector2(texCoordsAtMaxs.x, texCoordsAtMaxs.y)));
+	out->push_back(VertexPCU(Vector2(bounds.mins.x, bounds.maxs.y), tint, Vector2(texCoordsAtMins.x, texCoordsAtMins.y)));
+	out->push_back(VertexPCU(Vector2(bounds.maxs.x, bounds.maxs.y), tint, Vector2(texCoordsAtMaxs.x, texCoordsAtMins.y)));
 }
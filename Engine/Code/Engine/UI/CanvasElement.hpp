@@ -1,8 +1,18 @@
 #pragma once
 
 #include "Engine/Math/AABB2.hpp"
+#include "Engine/Renderer/VertexPCU.hpp"
+#include <vector>
 
+class BitmapFont;
 class Canvas;
+class Texture;
+
+enum eCanvasElementDirty
+{
+	CANVAS_ELEMENT_DIRTY_GEOMETRY = 1 << 0, // quads need to be built again
+	CANVAS_ELEMENT_DIRTY_BOUNDS   = 1 << 1, // hit test index needs to be built again
+};
 
 class CanvasElement
 {
@@ -14,8 +24,18 @@ public:
 	bool IsMouseWithinBounds(int x, int y);
 	void SetActive(bool active);
 	void SetBounds(const AABB2& bounds);
+	inline const AABB2& GetScreenBounds() const { return m_screenBounds; }
 
-	virtual void Render() = 0;
+	// The canvas keeps every element's quads and only builds them again for dirty elements,
+	// so call this after changing how one looks through its public members
+	inline void MarkDirty(uint flags = CANVAS_ELEMENT_DIRTY_GEOMETRY) { m_dirtyFlags |= flags; }
+	inline uint GetDirtyFlags() const { return m_dirtyFlags; }
+	inline void ClearDirtyFlags(uint flags) { m_dirtyFlags &= ~flags; }
+
+	// Quads the element draws, 4 vertices each in MeshBuilder::AddSprite's order, all with GetTexture()
+	virtual void AppendQuads(std::vector<VertexPCU>* out) = 0;
+	virtual const Texture* GetTexture() = 0; // nullptr for plain white
+	virtual const BitmapFont* GetFont() { return nullptr; } // text is drawn with its font's program
 	virtual bool MouseDownInteract(int screenX, int screenY) { return false; };
 	virtual bool MouseUpInteract(int screenX, int screenY) { return false; };
 	virtual void OnClicked() {};
@@ -26,4 +46,8 @@ protected:
 	bool m_isActive = true;
 	AABB2 m_bounds;
 	AABB2 m_screenBounds;
+	uint m_dirtyFlags = CANVAS_ELEMENT_DIRTY_GEOMETRY | CANVAS_ELEMENT_DIRTY_BOUNDS;
 };
+
+// A box as one quad with DrawTexturedAABB's UVs
+void AppendCanvasQuad(std::vector<VertexPCU>* out, const AABB2& bounds, const Vector2& texCoordsAtMins, const Vector2& texCoordsAtMaxs, const Rgba& tint);
@@ -1,20 +1,23 @@
 #include "Engine/UI/ImageUI.hpp"
-#include "Engine/Renderer/Renderer.hpp"
 
 ImageUI::ImageUI(Canvas* canvas)
 	: CanvasElement(canvas)
 {
 }
 
-void ImageUI::Render()
+void ImageUI::AppendQuads(std::vector<VertexPCU>* out)
 {
-	Renderer* r = Renderer::GetInstance();
 	if (m_texture != nullptr)
 	{	
-		r->DrawTexturedAABB(m_screenBounds, *m_texture, Vector2::zero, Vector2::one, m_tint);
+		AppendCanvasQuad(out, m_screenBounds, Vector2::zero, Vector2::one, m_tint);
 	}
 	else
 	{
-		r->DrawAABB(m_screenBounds, m_tint);
+		AppendCanvasQuad(out, m_screenBounds, Vector2(0, 1), Vector2(1, 0), m_tint);
 	}
 }
+
+const Texture* ImageUI::GetTexture()
+{
+	return m_texture;
+}
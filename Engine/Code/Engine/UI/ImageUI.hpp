@@ -11,9 +11,10 @@ public:
 	~ImageUI() {};
 	ImageUI(Canvas* canvas);
 
-	virtual void Render() override;
+	virtual void AppendQuads(std::vector<VertexPCU>* out) override;
+	virtual const Texture* GetTexture() override;
 
 public:
-	Texture* m_texture;
+	Texture* m_texture = nullptr;
 	Rgba m_tint = Rgba::white;
 };
\ No newline at end of file
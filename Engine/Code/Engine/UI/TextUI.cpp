@@ -10,17 +10,43 @@ TextUI::TextUI(Canvas* canvas)
 
 void TextUI::SetText(const std::string& text)
 {
+	//HUDs set the same text most frames, that shouldn't cost a rebuild
+	if (text == m_text)
+		return;
+
 	m_text = text;
+	MarkDirty();
 }
 
 void TextUI::SetFont(BitmapFont* font)
 {
 	m_font = font;
+	MarkDirty();
+}
+
+void TextUI::AppendQuads(std::vector<VertexPCU>* out)
+{
+	const BitmapFont* font = GetFont();
+	if (font == nullptr)
+		return;
+
+	const std::vector<VertexPCU>& layout = Renderer::GetInstance()->GetTextLayoutCache().GetLayoutInBox2D(m_screenBounds, m_text, m_height, 1.f, font, m_drawMode, m_alignment);
+
+	size_t first = out->size();
+	out->insert(out->end(), layout.begin(), layout.end());
+	for (size_t vertex = first; vertex < out->size(); vertex++)
+	{
+		(*out)[vertex].m_color = m_color;
+	}
 }
 
-void TextUI::Render()
+const Texture* TextUI::GetTexture()
 {
-	Renderer* r = Renderer::GetInstance();
+	const BitmapFont* font = GetFont();
+	return font != nullptr ? &font->GetTexture() : nullptr;
+}
 
-	r->DrawTextInBox2D(m_screenBounds, m_text, m_height, m_color, 1.f, m_font, m_drawMode, m_alignment);
+const BitmapFont* TextUI::GetFont()
+{
+	return m_font != nullptr ? m_font : m_canvasAttached->GetDefaultFont();
 }
@@ -15,7 +15,9 @@ public:
 
 	void SetText(const std::string& text);
 	void SetFont(BitmapFont* font);
-	virtual void Render() override;
+	virtual void AppendQuads(std::vector<VertexPCU>* out) override;
+	virtual const Texture* GetTexture() override;
+	virtual const BitmapFont* GetFont() override;
 
 public:
 	std::string m_text;
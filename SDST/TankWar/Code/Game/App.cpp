@@ -5,10 +5,21 @@
 #include "Engine/ThirdParty/tinyxml2.h"
 #include "Engine/Core/DevConsole.hpp"
 #include "Engine/Core/Clock.hpp"
+#include "Engine/Core/Transform.hpp"
 #include "Engine/Debug/DebugRender.hpp"
 #include "Engine/Renderer/RenderScene.hpp"
 #include "Engine/Profiler/Profiler.hpp"
 #include "Engine/Profiler/ProfilerView.hpp"
+#include "Engine/Core/MemoryTracker.hpp"
+#include "Engine/Core/AllocatorBenchmark.hpp"
+#include "Engine/Math/MathBenchmark.hpp"
+#include "Engine/Renderer/ParticleBenchmark.hpp"
+#include "Engine/Renderer/SDFFont.hpp"
+#include "Engine/Renderer/MeshFile.hpp"
+#include "Engine/Renderer/ObjBenchmark.hpp"
+#include "Engine/Core/LinearAllocator.hpp"
+#include "Engine/Core/WorkerThreadPool.hpp"
+#include "Engine/Input/InputReplay.hpp"
 
 static MOUSEMODE PREV_MOUSE_MODE;
 
@@ -18,6 +29,9 @@ App::App()
 	doc.LoadFile("Data/GameConfig.xml");
 	g_gameConfigBlackboard.PopulateFromXmlElementAttributes(*doc.RootElement());
 
+	FrameAllocatorStartup();
+	WorkerThreadsStartup();
+
 	g_theRenderer = Renderer::CreateInstance();
 	g_theInput = new InputSystem();
 	g_audio = AudioSystem::CreateInstance();
@@ -27,17 +41,28 @@ App::App()
 	ClockSystemStartup();
 	DebugRender::CreateInstance();
 	ProfilingSystemStartup();
+	MemoryTrackerStartup();
+	RegisterAllocatorBenchmarkCommands();
+	RegisterMathBenchmarkCommands();
+	RegisterParticleBenchmarkCommands();
+	RegisterSDFFontCommands();
+	RegisterMeshFileCommands();
+	RegisterObjBenchmarkCommands();
 
 	m_quitting = false;	
 }
 
 App::~App()
 {
+	InputReplayShutdown();
+	MemoryTrackerShutdown();
 	ProfilingSystemShutdown();
 	delete g_theGame;
+	WorkerThreadsShutdown();
 	delete g_audio;
 	delete g_theInput;
 	delete g_theRenderer;
+	FrameAllocatorShutdown();
 }
 
 bool App::IsQuitting()
@@ -57,6 +82,11 @@ void App::Update()
 	DevConsole* console = DevConsole::GetInstance();
 	ProfilerView* profilerView = ProfilerView::GetInstance();
 
+	//nobody is watching a headless replay, done once it runs out; still mid level, so ~Game cleans it up
+	if (IsInputReplayHeadless() && GetInputReplayMode() == INPUT_REPLAY_MODE::FINISHED)
+	{
+		Quit();
+	}
 	if (g_theInput->WasKeyJustPressed(KEY_CODE::ESC) && !console->IsOpen() 
 		|| (g_theInput->WasKeyJustPressed(KEY_CODE::RETURN) && g_theGame->m_currentState == GAME_STATE::ATTRACT && g_theGame->tempMenuIndex == 1)) //hacky remove later
 	{
@@ -103,6 +133,11 @@ void App::Update()
 		{
 			profilerView->m_sortSelf = !profilerView->m_sortSelf;
 		}
+		//Cycle counter shown in the counter graph
+		if (g_theInput->WasKeyJustPressed(KEY_CODE::C))
+		{
+			profilerView->CycleSelectedCounter();
+		}
 		//Toggle mouse
 		if (g_theInput->WasKeyJustPressed(KEY_CODE::M))
 		{
@@ -144,6 +179,15 @@ void App::Render()
 {
 	PROFILE_SCOPE_FUNCTION(); 
 
+	{
+		//refresh every transform moved this frame, parents first, before anything reads model matrices
+		PROFILE_SCOPE("Transform::UpdateDirtyHierarchy");
+		Transform::UpdateDirtyHierarchy();
+	}
+
+	if (IsInputReplayHeadless())
+		return;
+
 	g_theGame->Render();
 
 	DebugRender::GetInstance()->DebugRenderUpdateAndRender();
@@ -163,16 +207,27 @@ void App::Render()
 
 void App::BeginFrame()
 {
-	ClockSystemBeginFrame();
-	g_theInput->BeginFrame();
-	g_theRenderer->BeginFrame();
+	//a replay drives the clocks and input itself, recording them or feeding back a recorded frame
+	if (IsInputReplayActive())
+	{
+		InputReplayBeginFrame();
+	}
+	else
+	{
+		ClockSystemBeginFrame();
+		g_theInput->BeginFrame();
+	}
+	FrameAllocatorBeginFrame();
+	if (!IsInputReplayHeadless())
+		g_theRenderer->BeginFrame();
 	g_audio->BeginFrame();
 }
 
 void App::EndFrame()
 {
 	g_audio->EndFrame();
-	g_theRenderer->EndFrame();
+	if (!IsInputReplayHeadless())
+		g_theRenderer->EndFrame();
 	g_theInput->EndFrame();
 }
 
@@ -26,6 +26,7 @@ Enemy::Enemy(const Vector3& spawnPos, int spawnerID)
 	Material* mat = Material::GetOrCreate("Data/Materials/asteroid.xml");
 
 	m_transform.SetLocalPosition(spawnPos);
+	m_transform.SetInterpolated(true);
 	m_renderable = new Renderable(mesh, &m_transform, mat);
 	g_theGame->m_renderScene->AddRenderable(m_renderable);
 
@@ -62,10 +63,12 @@ void Enemy::Update(float deltaSeconds)
 	m_transform.TranslateLocal(Vector3(moveFactor.x, 0, moveFactor.y));
 
 	//turn toward player
-	Matrix44 lookAt = Matrix44::LookAt(m_transform.GetWorldPosition(), g_theGame->m_ship->m_transform.GetWorldPosition(), m_transform.GetLocalMatrix().GetUp());
+	Quaternion currentRotation = m_transform.GetWorldRotation();
+	Vector3 toPlayer = g_theGame->m_ship->m_transform.GetWorldPosition() - m_transform.GetWorldPosition();
+	Quaternion lookAt = Quaternion::LookRotation(toPlayer, currentRotation.GetUp());
 	float turnSpeed = 4.f;
 	float turnThisFrame = turnSpeed * deltaSeconds;
-	m_transform.SetWorldMatrix(Matrix44::TurnToward(m_transform.GetWorldMatrix(), lookAt, turnThisFrame));
+	m_transform.SetWorldRotation(RotateTowards(currentRotation, lookAt, turnThisFrame));
 
 	ProfilerPop();
 }
@@ -10,3 +10,6 @@
 
 //#define ENGINE_DISABLE_AUDIO	// (If uncommented) Disables AudioSystem code and fmod linkage.
 //#define ENGINE_DISABLE_PROFILING // (If uncommented) Disables Profiling
+//#define ENGINE_TRACK_MEMORY // (If uncommented) Tracks heap allocations per profiler scope (memory_report)
+//#define ENGINE_DEBUG_PAGE_ALLOCATOR // (If uncommented) Poisons freed pool objects and asserts on double frees
+//#define ENGINE_DISABLE_SIMD // (If uncommented) Uses the scalar Matrix44 code instead of the SSE kernels
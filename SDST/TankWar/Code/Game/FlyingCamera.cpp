@@ -19,7 +19,7 @@ FlyingCamera::FlyingCamera()
 	m_camera->SetColorTarget(g_theRenderer->GetDefaultColorTarget());
 	m_camera->SetDepthStencilTarget(g_theRenderer->GetDefaultDepthTarget());
 	m_camera->SetProjectionPerspective(60.f, 16.f / 9.f, 1, 800);
-	m_camera->SetLocalRotationEuler(Vector3(0, 0, 0));
+	m_camera->SetLocalRotation(Quaternion::identity);
 }
 
 void FlyingCamera::Update(float deltaSeconds)
@@ -27,18 +27,10 @@ void FlyingCamera::Update(float deltaSeconds)
 	//Apply Rotation
 	Vector2 mouse_delta = g_theInput->GetMouseDelta();
 
-	Vector3 local_euler = Vector3::zero;
-	local_euler.y = mouse_delta.x * ROTATIONAL_SPEED * deltaSeconds;
-	local_euler.x = mouse_delta.y * ROTATIONAL_SPEED * deltaSeconds;
+	m_yaw = BetterMod(m_yaw + (mouse_delta.x * ROTATIONAL_SPEED * deltaSeconds), 2.0f * MathUtils::PI);
+	m_pitch = ClampFloat(m_pitch + (mouse_delta.y * ROTATIONAL_SPEED * deltaSeconds), -MathUtils::PI/2.0f, MathUtils::PI/2.0f);
 
-	m_camera->RotateLocalByEuler(local_euler);
-	Vector3 currentEuler = m_camera->m_transform.GetLocalEulerAngles();
-
-	Vector3 eulerToSet = Vector3::zero;
-	eulerToSet.x = ClampFloat(currentEuler.x, -MathUtils::PI/2.0f, MathUtils::PI/2.0f);
-	eulerToSet.y = BetterMod(currentEuler.y, 2.0f * MathUtils::PI); //better mod handle wrap case from negative?
-
-	m_camera->SetLocalRotationEuler(eulerToSet);
+	m_camera->SetLocalRotation(Quaternion::MakeFromEuler(Vector3(m_pitch, m_yaw, 0.f)));
 
 	//Apply movement
 	float left_right = 0;
@@ -12,4 +12,6 @@ public:
 
 public:
 	Camera* m_camera = nullptr;
+	float m_pitch = 0.f; //radians, kept here so nothing has to be read back out of the rotation
+	float m_yaw = 0.f;
 };
@@ -12,6 +12,7 @@
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Renderer/Sprite.hpp"
 #include "Engine/Core/Clock.hpp"
+#include "Engine/Core/Transform.hpp"
 #include "Engine/Renderer/Camera.hpp"
 #include "Engine/Renderer/MeshBuilder.hpp"
 #include "Game/FlyingCamera.hpp"
@@ -34,6 +35,8 @@
 #include "Engine/UI/TextUI.hpp"
 #include "Engine/Profiler/ProfileLogScoped.hpp"
 #include "Engine/Profiler/Profiler.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Engine/Input/InputReplay.hpp"
 #include <string>
 
 constexpr float LIGHT_ROTATE_RATE = 0.5f;
@@ -41,8 +44,58 @@ constexpr float FADE_IN_TIME = 0.85f;
 constexpr float FADE_OUT_TIME = 0.85f;
 constexpr float BREAD_CRUMB_INTERVAL = 0.5f;
 
+static void BenchmarkCraters(Command& cmd)
+{
+	Terrain* terrain = g_theGame->m_terrain;
+	if (terrain == nullptr || terrain->m_heights.empty())
+	{
+		ConsolePrintf("bench_crater: needs the image terrain loaded");
+		return;
+	}
+
+	int count = 100;
+	cmd.GetNextInt(&count);
+	count = MaxInt(count, 1);
+
+	//fixed seed so runs compare, and the game's own random stream is left alone
+	RandomNumberGenerator random(1);
+	std::vector<float> savedHeights = terrain->m_heights;
+	AABB3 savedBounds = terrain->m_bounds;
+	IntVector2 lastCoord = terrain->m_dimensions - IntVector2(1, 1);
+
+	const float radii[] = { 2.f, 5.f, 10.f, 20.f, 40.f };
+	ConsolePrintf("bench_crater: %d craters per radius, depth radius / 4, cell size %.2f", count, terrain->m_cellSize.x);
+	for (float radius : radii)
+	{
+		double totalMs = 0.0;
+		double worstMs = 0.0;
+		for (int i = 0; i < count; i++)
+		{
+			Vector2 xz = Vector2(random.GetRandomFloatInRange(terrain->m_extents.mins.x, terrain->m_extents.maxs.x),
+				random.GetRandomFloatInRange(terrain->m_extents.mins.y, terrain->m_extents.maxs.y));
+
+			uint64_t start = GetPerformanceCounter();
+			terrain->Deform(xz, radius, radius * 0.25f);
+			double ms = PerformanceCounterToSeconds(GetPerformanceCounter() - start) * 1000.0;
+
+			totalMs += ms;
+			worstMs = ms > worstMs ? ms : worstMs;
+		}
+
+		ConsolePrintf("  radius %4.1f: %.3f ms avg, %.3f ms worst", radius, totalMs / count, worstMs);
+
+		//undo the craters through the same path, so it gets exercised on the whole grid too
+		terrain->m_heights = savedHeights;
+		terrain->RefreshDiscreteRegion(IntVector2(0, 0), lastCoord);
+		terrain->m_bounds = savedBounds;
+	}
+}
+
 Game::~Game()
 {
+	//the ship and spawners take themselves out of the render scene, so the level goes first
+	CleanUpPlay();
+
 	delete m_forwardRenderingPath;
 	m_forwardRenderingPath = nullptr;
 	delete m_renderScene;
@@ -56,7 +109,10 @@ Game::Game()
 
 void Game::Initialize()
 {
+	CommandRegister("bench_crater", BenchmarkCraters, "Times terrain craters (height, normal and partial mesh updates) at several radii. Option: craters per radius");
+
 	m_gameClock = new Clock(GetMasterClock());
+	m_gameClock->SetFixedStepRate(g_gameConfigBlackboard.GetValue("simulationHz", 60.f));
 	m_fadeStopWatch.SetClock(m_gameClock);
 
 	g_mainFont = g_theRenderer->CreateOrGetBitmapFont("SquirrelFixedFont");
@@ -131,14 +187,41 @@ void Game::Initialize()
 	text->m_height = 50.f;
 	m_canvas->m_canvasGroups[1]->m_elements.push_back(text);
 	m_canvas->m_canvasGroups[1]->m_isActive = false;
+
+	//replays start here, before the first frame, so the seed and the game clock line up from frame one
+	std::string replayPlay = g_gameConfigBlackboard.GetValue("replayPlay", "");
+	std::string replayRecord = g_gameConfigBlackboard.GetValue("replayRecord", "");
+	if (!replayPlay.empty())
+		StartInputPlayback(replayPlay, g_theInput, m_gameClock, g_gameConfigBlackboard.GetValue("replayHeadless", false));
+	else if (!replayRecord.empty())
+		StartInputRecording(replayRecord, g_theInput, m_gameClock);
 }
 
 void Game::Update()
 {
+	//the simulation runs on whole steps of game clock time, so it costs the same and plays out
+	//the same at any frame rate. input, camera and UI below stay once a frame
+	if (m_gameClock->IsFixedStep())
+	{
+		while (m_gameClock->StepFixed())
+		{
+			Transform::BeginSimulationStep();
+			UpdateSimulation((float) m_gameClock->GetFixedStepSeconds());
+		}
+	}
+	Transform::SetRenderInterpolation(m_gameClock->GetFixedStepAlpha());
+
+	//game time this frame: whole steps, already capped by the clock
 	float currentTime = static_cast<float>(m_gameClock->GetClockCurrentTime());	
-	float deltaSeconds = MinFloat(currentTime - m_lastTime, 0.05f);
+	float deltaSeconds = currentTime - m_lastTime;
 	m_lastTime = currentTime;
 
+	if (!m_gameClock->IsFixedStep())
+	{
+		deltaSeconds = MinFloat(deltaSeconds, 0.05f);
+		UpdateSimulation(deltaSeconds);
+	}
+
 	//do fading transition
 	if (m_fadingIn || m_fadingOut)
 	{
@@ -237,7 +320,7 @@ void Game::SetUpToPlay()
 	m_isGameSetUp = true;
 
 	RenderScene::SetCurrentScene(m_renderScene);
-	m_ship = new Ship();
+	m_ship = m_levelArena.Create<Ship>();
 
 	//Spawn Spawners
 	float margin = 50.f;
@@ -245,7 +328,7 @@ void Game::SetUpToPlay()
 	{
 		Vector2 xy = Vector2(GetRandomFloatInRange(m_terrain->m_extents.mins.x + margin, m_terrain->m_extents.maxs.x - margin), 
 			GetRandomFloatInRange(m_terrain->m_extents.mins.y + margin, m_terrain->m_extents.maxs.y - margin));
-		Spawner* s = new Spawner(Vector3(xy.x, m_terrain->GetHeight(xy), xy.y), i);
+		Spawner* s = m_levelArena.Create<Spawner>(Vector3(xy.x, m_terrain->GetHeight(xy), xy.y), i);
 		m_spawners.push_back(s);
 	}
 
@@ -257,29 +340,27 @@ void Game::CleanUpPlay()
 	if (!m_isGameSetUp)
 		return;
 
-	delete m_ship;
-	m_ship = nullptr;
-
 	for each (Enemy* e in m_enemies)
 	{
 		if (e != nullptr)
-			delete e;
+			m_enemyPool.Destroy(e);
 	}
 	m_enemies.clear();
+	m_enemyPool.Clear();
 
-	for each (Spawner* s in m_spawners)
-	{
-		if (s != nullptr)
-			delete s;
-	}
 	m_spawners.clear();
 
 	for each (Projectile* p in m_projectiles)
 	{
 		if (p != nullptr)
-			delete p;
+			m_projectilePool.Destroy(p);
 	}
 	m_projectiles.clear();
+	m_projectilePool.Clear();
+
+	//destroys the ship and the spawners still alive
+	m_levelArena.Release();
+	m_ship = nullptr;
 
 	m_isGameSetUp = false;
 }
@@ -389,7 +470,16 @@ void Game::Update_INIT()
 	m_terrain = new Terrain();
 	g_theRenderer->CreateOrGetShader("Data/Shaders/rolling.xml");
 	m_terrain->SetMaterialStamp("Data/Materials/grass.xml", "Data/Materials/water.xml");
-	m_terrain->LoadFromImage("Data/Images/heightmap.jpg", AABB2(-164, -164, 164, 164), 0, 32, IntVector2(16, 16));
+	if (g_gameConfigBlackboard.GetValue("proceduralTerrain", false))
+	{
+		terrain_noise_t noise;
+		noise.seed = (unsigned int) g_gameConfigBlackboard.GetValue("terrainSeed", 0);
+		m_terrain->LoadProcedural(noise, AABB2(-164, -164, 164, 164), 0, 32, 1.25f, 32, 6);
+	}
+	else
+	{
+		m_terrain->LoadFromImage("Data/Images/heightmap.jpg", AABB2(-164, -164, 164, 164), 0, 32, IntVector2(16, 16));
+	}
 	m_terrain->SetUp()
 
 	TODO("remove sleep later");
@@ -444,59 +534,34 @@ void Game::Update_SETUP(float deltaSeconds)
 	}
 }
 
-void Game::Update_PLAYING(float deltaSeconds)
+void Game::UpdateSimulation(float deltaSeconds)
 {
-	RenderScene::SetCurrentScene(m_renderScene);
-	m_forwardRenderingPath->m_skybox = m_skybox;
+	switch (m_currentState)
+	{
+	case PLAYING:
+	case DEFEAT:
+	case VICTORY:
+		Simulate_PLAYING(deltaSeconds);
+		break;
+	default:
+		break;
+	}
+}
 
+void Game::Simulate_PLAYING(float deltaSeconds)
+{
 	if (!m_isGameSetUp)
 		return;
 
-	//update camera
-	float camRotateSpeed = 0.01f;
-	m_rot -= g_theInput->GetMouseDelta().x * camRotateSpeed;
-	m_azi += g_theInput->GetMouseDelta().y * camRotateSpeed;
-	m_azi = ClampFloat(m_azi, -m_aziLimit, m_aziLimit);
-
-	m_gameCamera->SetTarget(m_ship->m_transform.GetLocalPosition() + (m_ship->m_transform.GetLocalMatrix().GetUp() * 8.f) + 
-		(m_ship->m_transform.GetLocalMatrix().GetForward() * 0.f));
-	m_gameCamera->SetSphericalCoordinate(25, m_rot, m_azi);
-
 	m_ship->UpdateMovement(deltaSeconds);
-	m_ship->UpdateTarget(deltaSeconds);
-
-	if (g_theInput->WasKeyJustPressed(KEY_CODE::F))
-	{
-		m_currentRenderMode--;
-		if (m_currentRenderMode < 0)
-			m_currentRenderMode = (int) m_debugTypes.size() - 1;
-	}
-	if (g_theInput->WasKeyJustPressed(KEY_CODE::G))
-	{
-		m_currentRenderMode++;
-		if (m_currentRenderMode >= m_debugTypes.size())
-			m_currentRenderMode = 0;
-	}
-
-	DebugLogf("WASD to move", Rgba::red, 0);
-	DebugLogf("Left Click to shoot", Rgba::red, 0);
-	DebugLogf("Z for Godmode", Rgba::red, 0);
-	DebugLogf("X for Instant Win", Rgba::red, 0);
-
-	if (g_theInput->WasKeyJustPressed(KEY_CODE::Z))
-	{
-		m_DEBUG = !m_DEBUG;
-		if (m_DEBUG)
-			DebugLogf("Godmode ON", Rgba::green, 4);
-		else
-			DebugLogf("Godmode OFF", Rgba::blue, 4);
-	}
+	m_ship->UpdateTurret(deltaSeconds);
 
 	//Game Objects
 	for each (Enemy* e in m_enemies)
 	{
 		e->Update(deltaSeconds);
 	}
+	PROFILE_COUNTER_ADD("enemies updated", m_enemies.size());
 
 	for each (Spawner* s in m_spawners)
 	{
@@ -514,10 +579,8 @@ void Game::Update_PLAYING(float deltaSeconds)
 		}
 	}
 
-	int enemiesRemaining = 0;
 	for (int i = 0; i < m_enemies.size(); ++i)
 	{
-		enemiesRemaining++;
 		Enemy* e = m_enemies[i];
 		for each (Projectile* p in m_projectiles)
 		{
@@ -527,8 +590,7 @@ void Game::Update_PLAYING(float deltaSeconds)
 
 		if (e->IsDead())
 		{
-			enemiesRemaining--;
-			delete e;
+			m_enemyPool.Destroy(e);
 
 			size_t size = m_enemies.size();
 			m_enemies[i] = m_enemies[size - 1];
@@ -538,14 +600,12 @@ void Game::Update_PLAYING(float deltaSeconds)
 	}
 
 	//hacky -- don't resize the spawner array
-	int spawnersRemaining = 0;
 	for (int i = 0; i < m_spawners.size(); ++i)
 	{
 		Spawner* s = m_spawners[i];
 
 		if (s != nullptr)
 		{
-			spawnersRemaining++;
 			for each (Projectile* p in m_projectiles)
 			{
 				if (p != nullptr)
@@ -554,8 +614,7 @@ void Game::Update_PLAYING(float deltaSeconds)
 
 			if (s->IsDead())
 			{
-				spawnersRemaining--;
-				delete s;
+				m_levelArena.Destroy(s);
 				m_spawners[i] = nullptr;
 			}
 		}
@@ -567,7 +626,7 @@ void Game::Update_PLAYING(float deltaSeconds)
 		p->Update(deltaSeconds);
 		if (p->IsDead())
 		{
-			delete p;
+			m_projectilePool.Destroy(p);
 
 			size_t size = m_projectiles.size();
 			m_projectiles[i] = m_projectiles[size - 1];
@@ -578,6 +637,72 @@ void Game::Update_PLAYING(float deltaSeconds)
 
 	m_ship->ApplyStickToTerrain(m_terrain);
 
+	m_particleSystem->Update(deltaSeconds);
+}
+
+void Game::Update_PLAYING(float deltaSeconds)
+{
+	UNUSED(deltaSeconds);
+
+	RenderScene::SetCurrentScene(m_renderScene);
+	m_forwardRenderingPath->m_skybox = m_skybox;
+
+	if (!m_isGameSetUp)
+		return;
+
+	//update camera, following the ship where it is drawn rather than where the last step left it
+	float camRotateSpeed = 0.01f;
+	m_rot -= g_theInput->GetMouseDelta().x * camRotateSpeed;
+	m_azi += g_theInput->GetMouseDelta().y * camRotateSpeed;
+	m_azi = ClampFloat(m_azi, -m_aziLimit, m_aziLimit);
+
+	Matrix44 shipMatrix = m_ship->m_transform.GetRenderMatrix();
+	m_gameCamera->SetTarget(shipMatrix.GetPosition() + (shipMatrix.GetUp() * 8.f) + 
+		(shipMatrix.GetForward() * 0.f));
+	m_gameCamera->SetSphericalCoordinate(25, m_rot, m_azi);
+
+	m_ship->UpdateInput();
+	m_ship->UpdateTarget();
+
+	if (g_theInput->WasKeyJustPressed(KEY_CODE::F))
+	{
+		m_currentRenderMode--;
+		if (m_currentRenderMode < 0)
+			m_currentRenderMode = (int) m_debugTypes.size() - 1;
+	}
+	if (g_theInput->WasKeyJustPressed(KEY_CODE::G))
+	{
+		m_currentRenderMode++;
+		if (m_currentRenderMode >= m_debugTypes.size())
+			m_currentRenderMode = 0;
+	}
+
+	DebugLogf("WASD to move", Rgba::red, 0);
+	DebugLogf("Left Click to shoot", Rgba::red, 0);
+	DebugLogf("Z for Godmode", Rgba::red, 0);
+	DebugLogf("X for Instant Win", Rgba::red, 0);
+
+	if (g_theInput->WasKeyJustPressed(KEY_CODE::Z))
+	{
+		m_DEBUG = !m_DEBUG;
+		if (m_DEBUG)
+			DebugLogf("Godmode ON", Rgba::green, 4);
+		else
+			DebugLogf("Godmode OFF", Rgba::blue, 4);
+	}
+
+	int enemiesRemaining = (int) m_enemies.size();
+	int spawnersRemaining = 0;
+	for each (Spawner* s in m_spawners)
+	{
+		if (s != nullptr)
+			spawnersRemaining++;
+	}
+
+	PROFILE_COUNTER_ADD("projectiles alive", m_projectiles.size());
+
+	m_terrain->Update(m_ship->m_transform.GetWorldPosition());
+
 	//DebugRenderBasis(0, m_ship->m_transform.GetLocalMatrix());
 
 	//drop bread crumb
@@ -586,21 +711,35 @@ void Game::Update_PLAYING(float deltaSeconds)
 		//DebugRenderPoint(4.0f, m_ship->m_transform.GetWorldPosition(), Rgba::green, Rgba::red);
 	}
 	
-	m_particleSystem->Update(m_gameCamera, deltaSeconds);
+	m_particleSystem->UpdateMeshes(m_gameCamera);
 
 	//Update UI Elements
-	TextUI* text = (TextUI*) m_canvas->m_canvasGroups[0]->m_elements[2];
-	text->SetText("Bases: " + std::to_string(spawnersRemaining));
-	text = (TextUI*) m_canvas->m_canvasGroups[0]->m_elements[1];
-	text->SetText("Enemies: " + std::to_string(enemiesRemaining));
-	text = (TextUI*) m_canvas->m_canvasGroups[0]->m_elements[0];
-	text->SetText("Health: " + std::to_string(m_ship->m_currentHP));
+	TextUI* text = nullptr;
+	if (spawnersRemaining != m_shownBases)
+	{
+		text = (TextUI*) m_canvas->m_canvasGroups[0]->m_elements[2];
+		text->SetText("Bases: " + std::to_string(spawnersRemaining));
+		m_shownBases = spawnersRemaining;
+	}
+	if (enemiesRemaining != m_shownEnemies)
+	{
+		text = (TextUI*) m_canvas->m_canvasGroups[0]->m_elements[1];
+		text->SetText("Enemies: " + std::to_string(enemiesRemaining));
+		m_shownEnemies = enemiesRemaining;
+	}
+	if (m_ship->m_currentHP != m_shownHealth)
+	{
+		text = (TextUI*) m_canvas->m_canvasGroups[0]->m_elements[0];
+		text->SetText("Health: " + std::to_string(m_ship->m_currentHP));
+		m_shownHealth = m_ship->m_currentHP;
+	}
 
 	//All enemy dead - VICTORY
 	if (g_theInput->WasKeyJustPressed(KEY_CODE::X) || (spawnersRemaining == 0 && enemiesRemaining == 0))
 	{
 		text = (TextUI*) m_canvas->m_canvasGroups[1]->m_elements[0];
 		text->SetText("VICTORY!\n\nPRESS ENTER TO EXIT");
+		m_shownRespawnSeconds = -1;
 		m_canvas->m_canvasGroups[1]->m_isActive = true;
 		StartTransitionToState(GAME_STATE::VICTORY, false);
 	}
@@ -611,13 +750,22 @@ void Game::Update_DEFEAT(float deltaSeconds)
 	Update_PLAYING(deltaSeconds);
 
 	TextUI* text = (TextUI*) m_canvas->m_canvasGroups[1]->m_elements[0];
-	text->SetText("YOU DIED!\n\nRESPAWNING IN " + std::to_string((int) m_timeTilRespawn + 1));
+	int respawnSeconds = (int) m_timeTilRespawn + 1;
+	if (m_timeTilRespawn > 0 && respawnSeconds != m_shownRespawnSeconds)
+	{
+		text->SetText("YOU DIED!\n\nRESPAWNING IN " + std::to_string(respawnSeconds));
+		m_shownRespawnSeconds = respawnSeconds;
+	}
 	m_canvas->m_canvasGroups[1]->m_isActive = true;
 
 	m_timeTilRespawn -= deltaSeconds;
 	if (m_timeTilRespawn <= 0)
 	{
-		text->SetText("LEFT CLICK TO RESPAWN");
+		if (m_shownRespawnSeconds != 0)
+		{
+			text->SetText("LEFT CLICK TO RESPAWN");
+			m_shownRespawnSeconds = 0;
+		}
 
 		if (g_theInput->WasMouseJustPressed(MOUSE_CODE::BUTTON_LEFT))
 		{
@@ -746,7 +894,7 @@ void Game::SetDefeat()
 
 Enemy* Game::SpawnEnemy(const Vector3& pos, Spawner* spawner)
 {
-	Enemy* e = new Enemy(pos, spawner->m_id);
+	Enemy* e = m_enemyPool.Create(pos, spawner->m_id);
 	m_enemies.push_back(e);
 	return e;
 }
@@ -9,6 +9,8 @@
 #include "Engine/Math/Ray.hpp"
 #include "Engine/Physics/Contact.hpp"
 #include "Engine/Audio/AudioSystem.hpp"
+#include "Engine/Core/PageAllocator.hpp"
+#include "Engine/Core/ArenaAllocator.hpp"
 #include "Game/Ship.hpp"
 
 struct debug_shader_render_t
@@ -68,6 +70,9 @@ public:
 	GAME_STATE GetCurrentState();
 	void StartTransitionToState(GAME_STATE newGameState, bool applyFadeInOut);
 
+	void UpdateSimulation(float deltaSeconds); //one fixed step of game clock time
+	void Simulate_PLAYING(float deltaSeconds); //also runs under DEFEAT and VICTORY
+
 	void Update_NONE(); //only exist for a frame to change state to INIT
 	void Update_INIT(); //only exist for a frame to change state to ATTRACT
 	void Update_ATTRACT(float deltaSeconds);
@@ -127,6 +132,9 @@ public:
 
 	std::vector<Enemy*> m_enemies;
 	std::vector<Projectile*> m_projectiles;
+	TPageAllocator<Enemy, 64> m_enemyPool;
+	TPageAllocator<Projectile, 32> m_projectilePool;
+	ArenaAllocator m_levelArena; //ship, spawners and anything else that lives exactly as long as a level
 
 	int m_spawnersToSpawn = 7;
 	std::vector<Spawner*> m_spawners;
@@ -148,6 +156,10 @@ public:
 	int tempMenuIndex = 0;
 	Camera* m_HUD_camera = nullptr;
 	Canvas* m_canvas = nullptr;
+	int m_shownHealth = -1; //HUD text is only rebuilt when these change
+	int m_shownEnemies = -1;
+	int m_shownBases = -1;
+	int m_shownRespawnSeconds = -1; //0 once it says to click
 
 private:
 	float m_lastTime = 0;
@@ -12,6 +12,7 @@
 #include "Engine/Debug/DebugRender.hpp"
 #include "Engine/Profiler/ProfilerView.hpp"
 #include "Engine/Profiler/Profiler.hpp"
+#include "Engine/Input/InputReplay.hpp"
 
 #pragma comment( lib, "opengl32" )	// Link in the OpenGL32.lib static library
 
@@ -105,11 +106,14 @@ void RunFrame()
 }
 
 //-----------------------------------------------------------------------------------------------
-void Initialize( HINSTANCE applicationInstanceHandle )
+void Initialize( HINSTANCE applicationInstanceHandle, const char* commandLine )
 {
 	CreateOpenGLWindow( applicationInstanceHandle, CLIENT_ASPECT );
 	g_theApp = new App();
 
+	//key=value arguments override GameConfig.xml, e.g. replayPlay=Data/nightly.replay replayHeadless
+	g_gameConfigBlackboard.PopulateFromCommandLine(commandLine);
+
 	CommandRegister("quit", QuitGameCommand, "Quits the application.");
 
 	g_theRenderer->RenderStartup((HWND) Window::GetInstance()->GetHandle());
@@ -139,8 +143,7 @@ void Shutdown()
 
 //-----------------------------------------------------------------------------------------------
 int WINAPI WinMain( HINSTANCE applicationInstanceHandle, HINSTANCE, LPSTR commandLineString, int ){
-	UNUSED( commandLineString );
-	Initialize( applicationInstanceHandle );
+	Initialize( applicationInstanceHandle, commandLineString );
 
 	// Program main loop; keep running frames until it's time to quit
 	while( !g_theApp->IsQuitting() )
@@ -148,6 +151,8 @@ int WINAPI WinMain( HINSTANCE applicationInstanceHandle, HINSTANCE, LPSTR comman
 		RunFrame();
 	}
 
+	//a failed headless replay has to show up as a failed run
+	int exitCode = HasInputReplayFailed() ? 1 : 0;
 	Shutdown();
-	return 0;
+	return exitCode;
 }
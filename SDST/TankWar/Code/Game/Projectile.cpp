@@ -21,6 +21,7 @@ Projectile::Projectile(const Vector3& spawnPos, const Vector3& direction)
 	: m_direction(direction)
 {
 	m_transform.SetLocalPosition(spawnPos);
+	m_transform.SetInterpolated(true);
 	m_dieClock.SetClock(g_theGame->m_gameClock);
 	m_dieClock.SetTimer(m_timeToLive);
 
@@ -59,6 +60,10 @@ void Projectile::Update(float deltaSeconds)
 
 void Projectile::Destroy()
 {
+	//a shot landing in a group hits several things in one frame, but blows up and carves once
+	if (m_hitEnemy)
+		return;
+
 	m_hitEnemy = true;
 
 	//chargedShot aoe
@@ -81,6 +86,9 @@ void Projectile::Destroy()
 			}
 		}
 
+		Vector3 pos = m_transform.GetWorldPosition();
+		g_theGame->m_terrain->Deform(Vector2(pos.x, pos.z), m_chargedShotRadius, m_craterDepth);
+
 		DebugRenderSphere(0.3f, m_transform.GetWorldPosition(), m_chargedShotRadius, Rgba::red);
 	}
 }
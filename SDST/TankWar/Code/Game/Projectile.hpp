@@ -40,4 +40,5 @@ public:
 	bool m_isChargedShot = false;
 	float m_chargedShotScale = 3.f;
 	float m_chargedShotRadius = 20.f;
+	float m_craterDepth = 4.f; // carved over the whole aoe radius
 };
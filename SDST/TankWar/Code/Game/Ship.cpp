@@ -57,7 +57,7 @@ Ship::Ship()
 	m_exhaust = new ParticleEmitter();
 	m_exhaust->m_emitterShape = EMITTER_CUBE;
 	m_exhaust->m_shapeScale = 0.4f;
-	m_exhaust->m_force = Vector3(0, 0, -8.f);
+	m_exhaust->m_force = Vector3(0, 0, -288.f);
 	m_exhaust->SetSpawnRate(20.f);
 	m_exhaust->m_lifeTime = FloatRange(2.f, 2.5f);
 	m_exhaust->m_size = FloatRange(0.2f, 0.25f);
@@ -71,6 +71,7 @@ Ship::Ship()
 	m_chargeParticle = new ParticleEmitter();
 	m_chargeParticle->m_emitterShape = EMITTER_SPHERE;
 	m_chargeParticle->m_shapeScale = 0.2f;
+	m_chargeParticle->m_velocityFactor = 6.f;
 	m_chargeParticle->SetSpawnRate(800.f);
 	m_chargeParticle->m_lifeTime = FloatRange(0.f);
 	m_chargeParticle->m_color = Rgba::red;
@@ -83,34 +84,16 @@ Ship::Ship()
 
 	m_currentHP = m_maxHP;
 	m_currentOffset = m_playHeightOffset;
+
+	m_transform.SetInterpolated(true);
+	m_turrentTransform.SetInterpolated(true);
 }
 
-void Ship::UpdateMovement(float deltaSeconds)
+void Ship::UpdateInput()
 {
 	if (!IsAlive())
 		return;
 
-	//Apply movement
-	float forward_back = 0;
-
-	if (g_theInput->IsKeyPressed(KEY_CODE::W))
-		forward_back += 1.f;
-	if (g_theInput->IsKeyPressed(KEY_CODE::S))
-		forward_back -= 1.f;
-
-	Vector3 forward = m_transform.GetLocalMatrix().GetForward();
-	Vector3 world_offset = forward * forward_back * MOVEMENT_SPEED * deltaSeconds;
-	m_transform.TranslateLocal(world_offset);
-
-	//Apply rotate
-	Vector3 local_euler = Vector3::zero;
-	if (g_theInput->IsKeyPressed(KEY_CODE::D))
-		local_euler.y += ROTATIONAL_SPEED * deltaSeconds;
-	if (g_theInput->IsKeyPressed(KEY_CODE::A))
-		local_euler.y -= ROTATIONAL_SPEED * deltaSeconds;
-
-	m_transform.RotateLocalByEuler(local_euler);
-
 	if (g_theInput->WasMouseJustPressed(MOUSE_CODE::BUTTON_LEFT))
 	{
 		m_chargeWatch.Reset();
@@ -124,7 +107,7 @@ void Ship::UpdateMovement(float deltaSeconds)
 	//Spawn Projectile
 	if (g_theInput->WasMouseJustReleased(MOUSE_CODE::BUTTON_LEFT) && m_shootWatch.CheckAndReset())
 	{
-		Projectile* p = new Projectile(m_bulletSpawnTransform.GetWorldPosition(), m_turrentTransform.GetWorldMatrix().GetForward());
+		Projectile* p = g_theGame->m_projectilePool.Create(m_bulletSpawnTransform.GetWorldPosition(), m_turrentTransform.GetWorldMatrix().GetForward());
 		g_theGame->m_projectiles.push_back(p);
 
 		if (m_chargeWatch.CheckAndReset())
@@ -136,17 +119,18 @@ void Ship::UpdateMovement(float deltaSeconds)
 		m_chargeParticle->m_lifeTime = FloatRange(0);
 	}
 
-	if (forward_back > 0 && m_exhaust->GetSpawnRate() != 100.f)
+	bool isMovingForward = g_theInput->IsKeyPressed(KEY_CODE::W) && !g_theInput->IsKeyPressed(KEY_CODE::S);
+	if (isMovingForward && m_exhaust->GetSpawnRate() != 100.f)
 	{
 		m_exhaust->SetSpawnRate(100.f);
 	}
-	else if (forward_back <= 0 && m_exhaust->GetSpawnRate() != 20.f)
+	else if (!isMovingForward && m_exhaust->GetSpawnRate() != 20.f)
 	{
 		m_exhaust->SetSpawnRate(20.f);
 	}
 }
 
-void Ship::UpdateTarget(float deltaSeconds)
+void Ship::UpdateTarget()
 {
 	if (!IsAlive())
 		return;
@@ -177,15 +161,47 @@ void Ship::UpdateTarget(float deltaSeconds)
 	DebugRenderLineSegment(0, camPos, Rgba::red, m_target, Rgba::red);
 	DebugRenderPoint(0, m_target, Rgba::red, Rgba::red);
 
-	DebugRenderLineSegment(0, m_target, Rgba::red,  m_turrentTransform.GetWorldPosition(), Rgba::red);
+	DebugRenderLineSegment(0, m_target, Rgba::red,  m_turrentTransform.GetRenderMatrix().GetPosition(), Rgba::red);
+
+	ProfilerPop();
+}
+
+void Ship::UpdateMovement(float deltaSeconds)
+{
+	if (!IsAlive())
+		return;
+
+	//Apply movement
+	float forward_back = 0;
+
+	if (g_theInput->IsKeyPressed(KEY_CODE::W))
+		forward_back += 1.f;
+	if (g_theInput->IsKeyPressed(KEY_CODE::S))
+		forward_back -= 1.f;
+
+	Vector3 forward = m_transform.GetLocalMatrix().GetForward();
+	Vector3 world_offset = forward * forward_back * MOVEMENT_SPEED * deltaSeconds;
+	m_transform.TranslateLocal(world_offset);
+
+	//Apply rotate
+	Vector3 local_euler = Vector3::zero;
+	if (g_theInput->IsKeyPressed(KEY_CODE::D))
+		local_euler.y += ROTATIONAL_SPEED * deltaSeconds;
+	if (g_theInput->IsKeyPressed(KEY_CODE::A))
+		local_euler.y -= ROTATIONAL_SPEED * deltaSeconds;
 
+	m_transform.RotateLocalByEuler(local_euler);
+}
 
-	Matrix44 lookAt = Matrix44::LookAt(m_turrentTransform.GetWorldPosition(), m_target, m_transform.GetLocalMatrix().GetUp());
-	float turnThisFrame = TURRENT_TURN_SPEED * deltaSeconds;
+void Ship::UpdateTurret(float deltaSeconds)
+{
+	if (!IsAlive())
+		return;
 
-	m_turrentTransform.SetWorldMatrix(Matrix44::TurnToward(m_turrentTransform.GetWorldMatrix(), lookAt, turnThisFrame));
+	Quaternion lookAt = Quaternion::LookRotation(m_target - m_turrentTransform.GetWorldPosition(), m_transform.GetLocalRotation().GetUp());
+	float turnThisStep = TURRENT_TURN_SPEED * deltaSeconds;
 
-	ProfilerPop();
+	m_turrentTransform.SetWorldRotation(RotateTowards(m_turrentTransform.GetWorldRotation(), lookAt, turnThisStep));
 }
 
 void Ship::ApplyStickToTerrain(Terrain* terrain)
@@ -221,8 +237,7 @@ void Ship::ApplyStickToTerrain(Terrain* terrain)
 		Vector3 newForward = CrossProduct(right, normal);
 		newForward.NormalizeAndGetLength();
 
-		Matrix44 newMat = Matrix44(right, normal, newForward, m_transform.GetWorldPosition());
-		m_transform.SetLocalMatrix(newMat);
+		m_transform.SetLocalRotation(Quaternion::MakeFromBasis(right, normal, newForward));
 	}
 }
 
@@ -250,6 +265,7 @@ void Ship::Respawn(const Vector3& pos)
 	m_timeToHitGround = static_cast<float>(g_theGame->m_gameClock->GetClockCurrentTime()) + m_fallAirTime;
 	m_currentOffset = m_respawnOffset;
 	m_transform.SetLocalRotationEuler(Vector3::zero);
+	m_transform.ResetInterpolation();
 }
 
 Vector2 Ship::Get_XZ_pos()
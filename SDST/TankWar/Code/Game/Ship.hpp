@@ -16,8 +16,10 @@ public:
 	~Ship();
 	Ship();
 
-	void UpdateMovement(float deltaSeconds);
-	void UpdateTarget(float deltaSeconds);
+	void UpdateInput(); // once a frame: charging and firing
+	void UpdateTarget(); // once a frame: aim from the camera
+	void UpdateMovement(float deltaSeconds); // fixed step
+	void UpdateTurret(float deltaSeconds); // fixed step
 	void ApplyStickToTerrain(Terrain* terrain);
 	void TakeDamage(int damage);
 	void Respawn(const Vector3& pos);
@@ -7,6 +7,7 @@
 #include "Game/Terrain.hpp"
 #include "Game/Projectile.hpp"
 #include "Engine/Debug/DebugRender.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
 
 Spawner::~Spawner()
 {
@@ -73,10 +74,11 @@ void Spawner::SpawnEnemies()
 {
 	float spawnExtends = 10.f;
 	int enemiesToSpawn = MinFloat(m_spawnsPerInterval, m_maxSpawns - m_currentSpawns);
+	RandomNumberGenerator& random = GetThreadRandom();
+	Vector3 pos = m_transform.GetWorldPosition();
 	for (int i = 0; i < enemiesToSpawn; i++)
 	{
-		Vector3 pos = m_transform.GetWorldPosition();
-		g_theGame->SpawnEnemy(Vector3(GetRandomFloatInRange(pos.x - spawnExtends, pos.x + spawnExtends), -50.f, GetRandomFloatInRange(pos.z - spawnExtends, pos.z + spawnExtends)), this);
+		g_theGame->SpawnEnemy(Vector3(random.GetRandomFloatInRange(pos.x - spawnExtends, pos.x + spawnExtends), -50.f, random.GetRandomFloatInRange(pos.z - spawnExtends, pos.z + spawnExtends)), this);
 		m_currentSpawns++;
 	}
 }
@@ -7,6 +7,14 @@
 #include "Engine/Renderer/Renderable.hpp"
 #include "Engine/Debug/DebugRender.hpp"
 #include "Engine/Math/Vector4.hpp"
+#include "Engine/Math/NoiseSIMD.hpp"
+#include "Engine/ThirdParty/SquirrelNoise/SmoothNoise.hpp"
+#include "Engine/Core/WorkerThreadPool.hpp"
+#include "Engine/Profiler/Profiler.hpp"
+#include <thread>
+
+// for compensate camera's delta so we don't raycast when camera is out of bound and hit bound from the outside
+static const float BOUNDS_PADDING = 60.f;
 
 Terrain::~Terrain()
 {
@@ -19,6 +27,13 @@ Terrain::Terrain()
 
 void Terrain::SetUp()
 {
+	if (m_isProcedural)
+	{
+		//nothing to build up front, chunks stream in from Update
+		SetUpProceduralWater();
+		return;
+	}
+
 	m_cellSize.x = m_extents.GetDimensions().x / m_dimensions.x;
 	m_cellSize.y = m_extents.GetDimensions().y / m_dimensions.y;
 
@@ -40,16 +55,7 @@ void Terrain::SetUp()
 	{
 		for (int x = 0; x < m_dimensions.x; x++)
 		{
-			IntVector2 coord = IntVector2(x, y);
-
-			Vector3 du = GetPosAtDiscreteCoordinate(coord + IntVector2(1, 0)) - GetPosAtDiscreteCoordinate(coord - IntVector2(1, 0));
-			Vector3 tangent =  du.GetNormalized();
-
-			Vector3 dv = GetPosAtDiscreteCoordinate(coord + IntVector2(0, 1)) - GetPosAtDiscreteCoordinate(coord - IntVector2(0, 1));
-			Vector3 bitan = dv.GetNormalized();
-
-			Vector3 normal = CrossProduct(bitan, tangent);
-			m_normals.push_back(normal);
+			m_normals.push_back(ComputeNormalAtDiscreteCoordinate(IntVector2(x, y)));
 		}
 	}
 
@@ -107,19 +113,29 @@ void Terrain::SetUp()
 	RenderScene::GetCurrentScene()->AddRenderable(m_waterRenderable);
 
 	//Set bounds
-	// for compensate camera's delta so we don't raycast when camera is out of bound and hit bound from the outside
-	Vector3 offset = Vector3(60);
+	Vector3 offset = Vector3(BOUNDS_PADDING);
 	m_bounds = AABB3(Vector3(m_extents.mins.x, m_minHeight, m_extents.mins.y) - offset, Vector3(m_extents.maxs.x, m_maxHeight, m_extents.maxs.y) + offset);
 }
 
 void Terrain::FreeAllChunks()
 {
+	WaitForChunkJobs();
+
 	for each (TerrainChunk* chunk in m_chunks)
 	{
 		delete chunk;
 		chunk = nullptr;
 	}
 	m_chunks.clear();
+
+	for (auto& pair : m_loadedChunks)
+		delete pair.second;
+	m_loadedChunks.clear();
+	m_requestedChunks.clear();
+
+	for (terrain_chunk_data_t* data : m_finishedChunks)
+		delete data;
+	m_finishedChunks.clear();
 }
 
 void Terrain::LoadFromImage(const std::string& path, const AABB2& extents, float min_height, float max_height, const IntVector2& chunk_counts)
@@ -132,8 +148,234 @@ void Terrain::LoadFromImage(const std::string& path, const AABB2& extents, float
 	m_dimensions = m_image.GetDimensions();
 }
 
+void Terrain::LoadProcedural(const terrain_noise_t& noise, const AABB2& playExtents, float min_height, float max_height, float cellSize, int chunkCells, int loadRadius)
+{
+	m_isProcedural = true;
+	m_noise = noise;
+	m_extents = playExtents;
+	m_minHeight = min_height;
+	m_maxHeight = max_height;
+	m_cellSize = Vector2(cellSize, cellSize);
+	m_chunkCells = chunkCells;
+	m_loadRadius = loadRadius;
+
+	WorkerThreadPool* workers = GetWorkerThreads();
+	m_maxChunkJobsInFlight = workers != nullptr ? workers->GetThreadCount() * 2 : 1;
+}
+
+void Terrain::Update(const Vector3& viewerPosition)
+{
+	if (!m_isProcedural)
+		return;
+
+	PROFILE_SCOPE_FUNCTION();
+
+	IntVector2 viewerChunk = GetChunkIndexForXZ(Vector2(viewerPosition.x, viewerPosition.z));
+	int unloadRadius = m_loadRadius + 1;
+	auto getChunkDistanceSquared = [&viewerChunk](const IntVector2& chunkIndex) {
+		IntVector2 offset = chunkIndex - viewerChunk;
+		return (offset.x * offset.x) + (offset.y * offset.y);
+	};
+
+	//swap in finished chunks, only a few uploads a frame so a burst of them can't hitch
+	int uploadCount = 0;
+	while (uploadCount < m_maxChunkUploadsPerFrame)
+	{
+		terrain_chunk_data_t* data = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(m_finishedLock);
+			if (m_finishedChunks.empty())
+				break;
+
+			data = m_finishedChunks.back();
+			m_finishedChunks.pop_back();
+		}
+
+		uint64_t key = GetChunkKey(data->chunkIndex);
+		m_requestedChunks.erase(key);
+
+		//the viewer may have moved on while it was being built
+		if (getChunkDistanceSquared(data->chunkIndex) <= unloadRadius * unloadRadius)
+		{
+			TerrainChunk* chunk = new TerrainChunk();
+			chunk->SetUpFromBuilder(this, data->chunkIndex, data->builder, m_terrainChunkMat);
+			m_loadedChunks[key] = chunk;
+			uploadCount++;
+		}
+
+		delete data;
+	}
+
+	//drop chunks a ring past the load radius, so moving back and forth on a border doesn't thrash
+	for (auto it = m_loadedChunks.begin(); it != m_loadedChunks.end();)
+	{
+		if (getChunkDistanceSquared(it->second->m_chunkIndex) > unloadRadius * unloadRadius)
+		{
+			delete it->second;
+			it = m_loadedChunks.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	//request missing chunks nearest first, keeping the queue short so a fast viewer doesn't leave stale work behind
+	bool isQueueFull = false;
+	for (int ring = 0; ring <= m_loadRadius && !isQueueFull; ring++)
+	{
+		for (int y = -ring; y <= ring && !isQueueFull; y++)
+		{
+			for (int x = -ring; x <= ring && !isQueueFull; x++)
+			{
+				if (MaxInt(abs(x), abs(y)) != ring || (x * x) + (y * y) > m_loadRadius * m_loadRadius)
+					continue;
+
+				IntVector2 chunkIndex = viewerChunk + IntVector2(x, y);
+				uint64_t key = GetChunkKey(chunkIndex);
+				if (m_loadedChunks.find(key) != m_loadedChunks.end() || m_requestedChunks.find(key) != m_requestedChunks.end())
+					continue;
+
+				if ((uint) m_chunkJobsInFlight >= m_maxChunkJobsInFlight)
+				{
+					isQueueFull = true;
+					continue;
+				}
+
+				RequestChunk(chunkIndex);
+			}
+		}
+	}
+
+	//water moves along a whole chunk at a time, its UVs repeat per chunk so that doesn't show
+	float chunkSize = (float) m_chunkCells * m_cellSize.x;
+	m_transform.SetLocalPosition(Vector3((float) viewerChunk.x * chunkSize, 0.f, (float) viewerChunk.y * chunkSize));
+
+	PROFILE_COUNTER_ADD("terrain chunks loaded", m_loadedChunks.size());
+	PROFILE_COUNTER_ADD("terrain chunk jobs", (int) m_chunkJobsInFlight);
+}
+
+void Terrain::Deform(const Vector2& xz, float radius, float depth)
+{
+	//procedural heights come straight from the noise, there is nothing to carve into
+	if (m_isProcedural || m_heights.empty() || radius <= 0.f)
+		return;
+
+	PROFILE_SCOPE_FUNCTION();
+
+	//window of coordinates the bowl can reach, measured the way the chunk meshes place them
+	IntVector2 center = IntVector2((int) floorf((xz.x - m_extents.mins.x) / m_cellSize.x), (int) floorf((xz.y - m_extents.mins.y) / m_cellSize.y));
+	IntVector2 reach = IntVector2((int) ceilf(radius / m_cellSize.x), (int) ceilf(radius / m_cellSize.y));
+	IntVector2 mins = IntVector2(MaxInt(center.x - reach.x, 0), MaxInt(center.y - reach.y, 0));
+	IntVector2 maxs = IntVector2(MinInt(center.x + reach.x + 1, m_dimensions.x - 1), MinInt(center.y + reach.y + 1, m_dimensions.y - 1));
+	if (mins.x > maxs.x || mins.y > maxs.y)
+		return;
+
+	for (int y = mins.y; y <= maxs.y; y++)
+	{
+		for (int x = mins.x; x <= maxs.x; x++)
+		{
+			Vector2 cellXZ = m_extents.mins + Vector2(x * m_cellSize.x, y * m_cellSize.y);
+			float distance = GetDistance(cellXZ, xz);
+			if (distance < radius)
+				m_heights[(y * m_dimensions.x) + x] -= depth * SmoothStep3(1.f - (distance / radius));
+		}
+	}
+
+	RefreshDiscreteRegion(mins, maxs);
+}
+
+void Terrain::RefreshDiscreteRegion(const IntVector2& mins, const IntVector2& maxs)
+{
+	PROFILE_SCOPE_FUNCTION();
+
+	IntVector2 last = m_dimensions - IntVector2(1, 1);
+
+	//bounds only ever grow, a shallower terrain inside them just costs a few raycast steps
+	float lowest = m_heights[(mins.y * m_dimensions.x) + mins.x];
+	float highest = lowest;
+	for (int y = mins.y; y <= maxs.y; y++)
+	{
+		for (int x = mins.x; x <= maxs.x; x++)
+		{
+			float height = m_heights[(y * m_dimensions.x) + x];
+			lowest = MinFloat(lowest, height);
+			highest = MaxFloat(highest, height);
+		}
+	}
+	m_bounds.mins.y = MinFloat(m_bounds.mins.y, lowest - BOUNDS_PADDING);
+	m_bounds.maxs.y = MaxFloat(m_bounds.maxs.y, highest + BOUNDS_PADDING);
+
+	//normals and tangents are central differences, so they change one coordinate further out.
+	//the height lookups run on past the end of a row into the next one, widen to whole rows at the x edges
+	IntVector2 vertexMins = IntVector2(MaxInt(mins.x - 1, 0), MaxInt(mins.y - 1, 0));
+	IntVector2 vertexMaxs = IntVector2(MinInt(maxs.x + 1, last.x), MinInt(maxs.y + 1, last.y));
+	if (mins.x == 0 || maxs.x == last.x)
+	{
+		vertexMins.x = 0;
+		vertexMaxs.x = last.x;
+	}
+
+	for (int y = vertexMins.y; y <= vertexMaxs.y; y++)
+	{
+		for (int x = vertexMins.x; x <= vertexMaxs.x; x++)
+			m_normals[(y * m_dimensions.x) + x] = ComputeNormalAtDiscreteCoordinate(IntVector2(x, y));
+	}
+
+	//a quad also uses the coordinates above and to the right of its own
+	IntVector2 quadMins = IntVector2(MaxInt(vertexMins.x - 1, 0), MaxInt(vertexMins.y - 1, 0));
+	IntVector2 quadMaxs = vertexMaxs;
+
+	AABB2 chunkData = GetChunkDataExtents(IntVector2(0, 0));
+	IntVector2 chunkDims = IntVector2((int) chunkData.maxs.x, (int) chunkData.maxs.y);
+	IntVector2 firstChunk = IntVector2(MinInt(quadMins.x / chunkDims.x, m_chunkCounts.x - 1), MinInt(quadMins.y / chunkDims.y, m_chunkCounts.y - 1));
+	IntVector2 lastChunk = IntVector2(MinInt(quadMaxs.x / chunkDims.x, m_chunkCounts.x - 1), MinInt(quadMaxs.y / chunkDims.y, m_chunkCounts.y - 1));
+
+	//chunks rewrite whole rows of quads, so build every vertex those rows use once up front
+	m_refreshMins = IntVector2(firstChunk.x * chunkDims.x, quadMins.y);
+	IntVector2 refreshMaxs = IntVector2(MinInt((lastChunk.x + 1) * chunkDims.x, last.x), MinInt(quadMaxs.y + 1, last.y));
+	m_refreshWidth = refreshMaxs.x - m_refreshMins.x + 1;
+	m_refreshVertices.resize(m_refreshWidth * (refreshMaxs.y - m_refreshMins.y + 1));
+
+	for (int y = m_refreshMins.y; y <= refreshMaxs.y; y++)
+	{
+		for (int x = m_refreshMins.x; x <= refreshMaxs.x; x++)
+		{
+			IntVector2 coord = IntVector2(x, y);
+			m_refreshVertices[((y - m_refreshMins.y) * m_refreshWidth) + (x - m_refreshMins.x)] = VertexLit(GetPosAtDiscreteCoordinate(coord), 
+				GetNormalAtDiscreteCoordinate(coord), Rgba::white, Vector2::zero, Vector4(GetTangentAtDiscreteCoordinate(coord), 1));
+		}
+	}
+
+	int chunksRefreshed = 0;
+	for (int y = firstChunk.y; y <= lastChunk.y; y++)
+	{
+		for (int x = firstChunk.x; x <= lastChunk.x; x++)
+		{
+			m_chunks[(y * m_chunkCounts.x) + x]->RefreshQuadRows(quadMins.y, quadMaxs.y, &m_refreshUploads);
+			chunksRefreshed++;
+		}
+	}
+
+	PROFILE_COUNTER_ADD("terrain chunks refreshed", chunksRefreshed);
+}
+
 float Terrain::GetHeight(const Vector2& xz)
 {
+	if (m_isProcedural)
+	{
+		//same bilinear blend of the cell corners as the chunk meshes
+		float x_data = xz.x / m_cellSize.x;
+		float z_data = xz.y / m_cellSize.y;
+		IntVector2 bl = IntVector2((int) floorf(x_data), (int) floorf(z_data));
+		float fractionX = x_data - (float) bl.x;
+		float fractionZ = z_data - (float) bl.y;
+
+		float height_bottom = Interpolate(GetProceduralHeight(bl), GetProceduralHeight(IntVector2(bl.x + 1, bl.y)), fractionX);
+		float height_top = Interpolate(GetProceduralHeight(IntVector2(bl.x, bl.y + 1)), GetProceduralHeight(IntVector2(bl.x + 1, bl.y + 1)), fractionX);
+		return Interpolate(height_bottom, height_top, fractionZ);
+	}
+
 	float x_data = RangeMapFloat(xz.x, m_extents.mins.x, m_extents.maxs.x, 0, (float) m_dimensions.x - 1);
 	float z_data = RangeMapFloat(xz.y, m_extents.mins.y, m_extents.maxs.y, 0, (float) m_dimensions.y - 1);
 
@@ -152,6 +394,9 @@ float Terrain::GetHeight(const Vector2& xz)
 
 float Terrain::GetHeightAtDiscreteCoordinate(const IntVector2& coord)
 {
+	if (m_isProcedural)
+		return GetProceduralHeight(coord);
+
 	uint index = (coord.y * m_dimensions.x) + coord.x;
 
 	//temporary fix
@@ -160,7 +405,8 @@ float Terrain::GetHeightAtDiscreteCoordinate(const IntVector2& coord)
 
 Vector3 Terrain::GetPosAtDiscreteCoordinate(const IntVector2& coord)
 {
-	Vector2 origin_xz = m_extents.mins;
+	//procedural cell coordinates are unbounded, counted from the world origin
+	Vector2 origin_xz = m_isProcedural ? Vector2::zero : m_extents.mins;
 	Vector2 xz = origin_xz + Vector2(coord.x * m_cellSize.x, coord.y * m_cellSize.y);
 
 	float height = GetHeightAtDiscreteCoordinate(coord);
@@ -170,6 +416,9 @@ Vector3 Terrain::GetPosAtDiscreteCoordinate(const IntVector2& coord)
 
 Vector3 Terrain::GetNormalAtDiscreteCoordinate(const IntVector2& coord)
 {
+	if (m_isProcedural)
+		return GetProceduralNormal(coord);
+
 	uint index = (coord.y * m_dimensions.x) + coord.x;
 
 	return m_normals[ClampInt(index, 0, (int) m_heights.size() - 1)];
@@ -185,6 +434,19 @@ Vector3 Terrain::GetTangentAtDiscreteCoordinate(const IntVector2& coord)
 
 Vector3 Terrain::GetNormalForXZ(const Vector2& xz)
 {
+	if (m_isProcedural)
+	{
+		float x_data = xz.x / m_cellSize.x;
+		float z_data = xz.y / m_cellSize.y;
+		IntVector2 bl = IntVector2((int) floorf(x_data), (int) floorf(z_data));
+		float fractionX = x_data - (float) bl.x;
+		float fractionZ = z_data - (float) bl.y;
+
+		Vector3 normal_bottom = Interpolate(GetProceduralNormal(bl), GetProceduralNormal(IntVector2(bl.x + 1, bl.y)), fractionX);
+		Vector3 normal_top = Interpolate(GetProceduralNormal(IntVector2(bl.x, bl.y + 1)), GetProceduralNormal(IntVector2(bl.x + 1, bl.y + 1)), fractionX);
+		return Interpolate(normal_bottom, normal_top, fractionZ);
+	}
+
 	float x_data = RangeMapFloat(xz.x, m_extents.mins.x, m_extents.maxs.x, 0, (float) m_dimensions.x - 1);
 	float z_data = RangeMapFloat(xz.y, m_extents.mins.y, m_extents.maxs.y, 0, (float) m_dimensions.y - 1);
 
@@ -231,7 +493,16 @@ bool Terrain::IsPointBelowTerrain(const Vector3& point)
 
 bool Terrain::Raycast(RayCastHit3* outResults, const Ray3& ray)
 {
-	*outResults = RayCheckAABB3(ray, m_bounds);
+	if (m_isProcedural)
+	{
+		//no bounds to clip against, march out to the edge of the streamed area instead
+		float maxDistance = (float) (m_loadRadius * m_chunkCells) * m_cellSize.x;
+		*outResults = RayCastHit3(ray.Evaluate(maxDistance), Vector3::up);
+	}
+	else
+	{
+		*outResults = RayCheckAABB3(ray, m_bounds);
+	}
 
 	//If we don't hit the bounds, early out without a hit
 	if (!outResults->hit)
@@ -275,7 +546,7 @@ bool Terrain::Raycast(RayCastHit3* outResults, const Ray3& ray)
 
 	//If the point we are aiming is outside of terrain, early out 
 	//this happen because of bounds offset in SetUp
-	if (!m_extents.IsPointInside(Vector2(belowPoint.x, belowPoint.z)))
+	if (!m_isProcedural && !m_extents.IsPointInside(Vector2(belowPoint.x, belowPoint.z)))
 	{
 		//DebugLogf("out of bound", Rgba::white, 0);
 		*outResults = RayCastHit3();
@@ -328,3 +599,161 @@ void Terrain::SetMaterialStamp(const std::string& groundPath, const std::string&
 	m_terrainChunkMat = Material::GetOrCreate(groundPath);
 	m_waterMat = Material::GetOrCreate(waterPath);
 }
+
+//------------------------------------------------------------------------
+Vector3 Terrain::ComputeNormalAtDiscreteCoordinate(const IntVector2& coord)
+{
+	Vector3 du = GetPosAtDiscreteCoordinate(coord + IntVector2(1, 0)) - GetPosAtDiscreteCoordinate(coord - IntVector2(1, 0));
+	Vector3 tangent =  du.GetNormalized();
+
+	Vector3 dv = GetPosAtDiscreteCoordinate(coord + IntVector2(0, 1)) - GetPosAtDiscreteCoordinate(coord - IntVector2(0, 1));
+	Vector3 bitan = dv.GetNormalized();
+
+	return CrossProduct(bitan, tangent);
+}
+
+void Terrain::SetUpProceduralWater()
+{
+	//one quad over the streamed area, Update keeps it centered on the viewer's chunk
+	float waterHeight = 10.f;
+	float halfExtent = (float) ((m_loadRadius + 1) * m_chunkCells) * m_cellSize.x;
+	float uvPerChunk = 16.f; //whole number, so moving by a chunk doesn't shift the texture
+	float uvExtent = (float) (m_loadRadius + 1) * uvPerChunk;
+
+	MeshBuilder mb = MeshBuilder();
+	mb.Begin(eDrawPrimitive::TRIANGLES, true);
+	mb.SetColor(Rgba::white);
+	mb.SetNormal(Vector3::up);
+	mb.SetTangent(Vector4(1.f, 0.f, 0.f, 1.f));
+	mb.SetUV(Vector2(-uvExtent, -uvExtent));
+	int index = mb.PushVertex(Vector3(-halfExtent, waterHeight, -halfExtent));
+	mb.SetUV(Vector2(uvExtent, -uvExtent));
+	mb.PushVertex(Vector3(halfExtent, waterHeight, -halfExtent));
+	mb.SetUV(Vector2(-uvExtent, uvExtent));
+	mb.PushVertex(Vector3(-halfExtent, waterHeight, halfExtent));
+	mb.SetUV(Vector2(uvExtent, uvExtent));
+	mb.PushVertex(Vector3(halfExtent, waterHeight, halfExtent));
+	mb.AddQuad(index + 0, index + 1, index + 2, index + 3);
+	mb.End();
+
+	Mesh* mesh = new Mesh();
+	mesh->FromBuilderForType<VertexLit>(mb);
+	m_waterRenderable = new Renderable(mesh, &m_transform, m_waterMat);
+	RenderScene::GetCurrentScene()->AddRenderable(m_waterRenderable);
+}
+
+float Terrain::GetProceduralHeight(const IntVector2& coord) const
+{
+	//noise is sampled at whole cell coordinates, scale converted to cells to match
+	float noise = Compute2dPerlinNoise((float) coord.x, (float) coord.y, m_noise.scale / m_cellSize.x, m_noise.numOctaves, m_noise.octavePersistence, m_noise.octaveScale, true, m_noise.seed);
+	return RangeMapFloat(noise, -1.f, 1.f, m_minHeight, m_maxHeight);
+}
+
+Vector3 Terrain::GetProceduralNormal(const IntVector2& coord) const
+{
+	Vector3 east = Vector3((float) (coord.x + 1) * m_cellSize.x, GetProceduralHeight(coord + IntVector2(1, 0)), (float) coord.y * m_cellSize.y);
+	Vector3 west = Vector3((float) (coord.x - 1) * m_cellSize.x, GetProceduralHeight(coord - IntVector2(1, 0)), (float) coord.y * m_cellSize.y);
+	Vector3 north = Vector3((float) coord.x * m_cellSize.x, GetProceduralHeight(coord + IntVector2(0, 1)), (float) (coord.y + 1) * m_cellSize.y);
+	Vector3 south = Vector3((float) coord.x * m_cellSize.x, GetProceduralHeight(coord - IntVector2(0, 1)), (float) (coord.y - 1) * m_cellSize.y);
+
+	Vector3 tangent = (east - west).GetNormalized();
+	Vector3 bitan = (north - south).GetNormalized();
+	return CrossProduct(bitan, tangent).GetNormalized();
+}
+
+// Worker thread: reads only settings that are fixed once streaming starts
+void Terrain::GenerateChunkData(terrain_chunk_data_t* data) const
+{
+	//one extra sample all around so edge normals get central differences too
+	int verticesPerSide = m_chunkCells + 1;
+	int samplesPerSide = verticesPerSide + 2;
+	IntVector2 firstSample = IntVector2((data->chunkIndex.x * m_chunkCells) - 1, (data->chunkIndex.y * m_chunkCells) - 1);
+
+	//whole number origin and step, so every sample is bit identical to GetProceduralHeight
+	std::vector<float> heights(samplesPerSide * samplesPerSide);
+	Fill2dPerlinNoise(heights.data(), samplesPerSide, samplesPerSide, Vector2((float) firstSample.x, (float) firstSample.y), Vector2::one,
+		m_noise.scale / m_cellSize.x, m_noise.numOctaves, m_noise.octavePersistence, m_noise.octaveScale, true, m_noise.seed);
+
+	for (float& height : heights)
+		height = RangeMapFloat(height, -1.f, 1.f, m_minHeight, m_maxHeight);
+
+	auto getSamplePosition = [&](int x, int y) {
+		return Vector3((float) (firstSample.x + x) * m_cellSize.x, heights[(y * samplesPerSide) + x], (float) (firstSample.y + y) * m_cellSize.y);
+	};
+
+	MeshBuilder& mb = data->builder;
+	mb.Begin(eDrawPrimitive::TRIANGLES, true);
+	mb.SetColor(Rgba::white);
+
+	for (int y = 0; y < verticesPerSide; y++)
+	{
+		for (int x = 0; x < verticesPerSide; x++)
+		{
+			//vertex (x, y) is sample (x + 1, y + 1)
+			Vector3 tangent = (getSamplePosition(x + 2, y + 1) - getSamplePosition(x, y + 1)).GetNormalized();
+			Vector3 bitan = (getSamplePosition(x + 1, y + 2) - getSamplePosition(x + 1, y)).GetNormalized();
+
+			//texture repeats once per chunk
+			mb.SetUV(Vector2((float) x / m_chunkCells, (float) y / m_chunkCells));
+			mb.SetNormal(CrossProduct(bitan, tangent).GetNormalized());
+			mb.SetTangent(Vector4(tangent, 1));
+			mb.PushVertex(getSamplePosition(x + 1, y + 1));
+		}
+	}
+
+	//shared vertices, a quarter of what the image path pushes
+	for (int y = 0; y < m_chunkCells; y++)
+	{
+		for (int x = 0; x < m_chunkCells; x++)
+		{
+			uint bl = (y * verticesPerSide) + x;
+			mb.AddQuad(bl, bl + 1, bl + verticesPerSide, bl + verticesPerSide + 1);
+		}
+	}
+	mb.End();
+}
+
+void Terrain::RequestChunk(const IntVector2& chunkIndex)
+{
+	m_requestedChunks.insert(GetChunkKey(chunkIndex));
+	m_chunkJobsInFlight++;
+
+	auto job = [this, chunkIndex]() {
+		if (!m_isCancellingJobs)
+		{
+			terrain_chunk_data_t* data = new terrain_chunk_data_t();
+			data->chunkIndex = chunkIndex;
+			GenerateChunkData(data);
+
+			std::lock_guard<std::mutex> lock(m_finishedLock);
+			m_finishedChunks.push_back(data);
+		}
+		m_chunkJobsInFlight--;
+	};
+
+	WorkerThreadPool* workers = GetWorkerThreads();
+	if (workers != nullptr)
+		workers->AddJob(job);
+	else
+		job();
+}
+
+void Terrain::WaitForChunkJobs()
+{
+	//jobs still queued see the flag and return straight away
+	m_isCancellingJobs = true;
+	while (m_chunkJobsInFlight > 0)
+		std::this_thread::yield();
+	m_isCancellingJobs = false;
+}
+
+IntVector2 Terrain::GetChunkIndexForXZ(const Vector2& xz) const
+{
+	float chunkSize = (float) m_chunkCells * m_cellSize.x;
+	return IntVector2((int) floorf(xz.x / chunkSize), (int) floorf(xz.y / chunkSize));
+}
+
+uint64_t Terrain::GetChunkKey(const IntVector2& chunkIndex)
+{
+	return ((uint64_t) (uint32_t) chunkIndex.x << 32) | (uint64_t) (uint32_t) chunkIndex.y;
+}
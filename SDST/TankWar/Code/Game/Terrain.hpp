@@ -9,13 +9,36 @@
 #include "Engine/Physics/Contact.hpp"
 #include "Engine/Math/Ray.hpp"
 #include "Engine/Math/AABB3.hpp"
-#include <vector>
+#include "Engine/Renderer/MeshBuilder.hpp"
+#include "Engine/Renderer/VertexLit.hpp"
+#include <atomic>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 class TerrainChunk;
 class Material;
 class Renderable;
 
+// Noise parameters for procedural terrain, scale is in world units
+struct terrain_noise_t
+{
+	unsigned int seed = 0;
+	float scale = 120.f;
+	unsigned int numOctaves = 5;
+	float octavePersistence = 0.45f;
+	float octaveScale = 2.f;
+};
+
+// Built on a worker thread, turned into a TerrainChunk on the main thread
+struct terrain_chunk_data_t
+{
+	IntVector2 chunkIndex;
+	MeshBuilder builder;
+};
+
 class Terrain 
 {
 public:
@@ -25,6 +48,17 @@ public:
 	void SetUp();
 	void FreeAllChunks(); 
 	void LoadFromImage(const std::string& path, const AABB2& extents, float min_height, float max_height,const IntVector2& chunk_counts);
+	void LoadProcedural(const terrain_noise_t& noise, const AABB2& playExtents, float min_height, float max_height, float cellSize, int chunkCells, int loadRadius);
+
+	// Procedural only: streams chunks in and out around the viewer
+	void Update(const Vector3& viewerPosition);
+
+	// Image terrain only: lowers a smooth bowl depth deep at the center
+	void Deform(const Vector2& xz, float radius, float depth);
+	// After m_heights changed in [mins, maxs]: recomputes the normals, bounds and chunk vertices
+	// that depend on them, and re-uploads just those parts of the chunk meshes
+	void RefreshDiscreteRegion(const IntVector2& mins, const IntVector2& maxs);
+	inline const VertexLit& GetRefreshVertex(const IntVector2& coord) const { return m_refreshVertices[((coord.y - m_refreshMins.y) * m_refreshWidth) + (coord.x - m_refreshMins.x)]; }
 
 	float GetHeight(const Vector2& xz);
 	float GetHeightAtDiscreteCoordinate(const IntVector2& coord);
@@ -43,6 +77,17 @@ public:
 
 	void SetMaterialStamp(const std::string& groundPath, const std::string& waterPath);
 
+private:
+	Vector3 ComputeNormalAtDiscreteCoordinate(const IntVector2& coord);
+	void SetUpProceduralWater();
+	float GetProceduralHeight(const IntVector2& coord) const;
+	Vector3 GetProceduralNormal(const IntVector2& coord) const;
+	void GenerateChunkData(terrain_chunk_data_t* data) const;
+	void RequestChunk(const IntVector2& chunkIndex);
+	void WaitForChunkJobs();
+	IntVector2 GetChunkIndexForXZ(const Vector2& xz) const;
+	static uint64_t GetChunkKey(const IntVector2& chunkIndex);
+
 public:
 	AABB2 m_extents; 
 	float m_minHeight; 
@@ -63,4 +108,28 @@ public:
 
 	Material* m_waterMat = nullptr;
 	Renderable* m_waterRenderable = nullptr;
+
+	// RefreshDiscreteRegion scratch: one vertex per coordinate of the window (UVs left to the chunk),
+	// and the vertices of one chunk's upload
+	std::vector<VertexLit> m_refreshVertices;
+	IntVector2 m_refreshMins;
+	int m_refreshWidth = 0;
+	std::vector<VertexLit> m_refreshUploads;
+
+	// Procedural: unbounded, heights come straight from noise at integer cell coordinates
+	// so chunks built on different threads (and GetHeight) always agree on shared edges.
+	// m_extents is only the play area (spawning); m_heights/m_normals stay empty.
+	bool m_isProcedural = false;
+	terrain_noise_t m_noise;
+	int m_chunkCells = 32; // cells per chunk side
+	int m_loadRadius = 6; // in chunks, unloaded one chunk further out
+	int m_maxChunkUploadsPerFrame = 2; // mesh uploads are the only main thread cost
+	uint m_maxChunkJobsInFlight = 8;
+
+	std::unordered_map<uint64_t, TerrainChunk*> m_loadedChunks;
+	std::unordered_set<uint64_t> m_requestedChunks; // queued or running on a worker
+	std::vector<terrain_chunk_data_t*> m_finishedChunks; // guarded by m_finishedLock
+	std::mutex m_finishedLock;
+	std::atomic<int> m_chunkJobsInFlight{0};
+	std::atomic<bool> m_isCancellingJobs{false};
 };
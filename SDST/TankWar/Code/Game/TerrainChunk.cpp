@@ -75,6 +75,64 @@ void TerrainChunk::SetUp(Terrain* terrain, const IntVector2& chunkIndex, Materia
 	RenderScene::GetCurrentScene()->AddRenderable(m_renderable);
 }
 
+void TerrainChunk::SetUpFromBuilder(Terrain* terrain, const IntVector2& chunkIndex, const MeshBuilder& builder, Material* mat)
+{
+	m_terrain = terrain;
+	m_chunkIndex = chunkIndex;
+
+	//vertices are already in world space
+	Mesh* mesh = new Mesh();
+	mesh->FromBuilderForType<VertexLit>(builder);
+	m_renderable = new Renderable(mesh, &m_transform, mat);
+	RenderScene::GetCurrentScene()->AddRenderable(m_renderable);
+}
+
+void TerrainChunk::RefreshQuadRows(int firstRow, int lastRow, std::vector<VertexLit>* scratch)
+{
+	AABB2 dataPoint = m_terrain->GetChunkDataExtents(m_chunkIndex);
+	int minX = (int) dataPoint.mins.x;
+	int maxX = (int) dataPoint.maxs.x;
+	int minY = (int) dataPoint.mins.y;
+	firstRow = MaxInt(firstRow, minY);
+	lastRow = MinInt(lastRow, (int) dataPoint.maxs.y - 1);
+	if (firstRow > lastRow || m_renderable == nullptr)
+		return;
+
+	//same quad order and UVs as SetUp, whole rows keep the range contiguous
+	IntVector2 dimensions = m_terrain->m_dimensions;
+	auto pushVertex = [&](int x, int y, const Vector2& uv) {
+		VertexLit vertex = m_terrain->GetRefreshVertex(IntVector2(x, y));
+		vertex.m_UVs = uv;
+		scratch->push_back(vertex);
+	};
+
+	scratch->clear();
+	for (int y = firstRow; y <= lastRow; y++)
+	{
+		for (int x = minX; x < maxX; x++)
+		{
+			int right = MinInt(x + 1, dimensions.x - 1);
+			int top = MinInt(y + 1, dimensions.y - 1);
+			pushVertex(x, y, Vector2((float) x / dimensions.x, (float) y / dimensions.y));
+			pushVertex(right, y, Vector2((float) (x + 1) / dimensions.x, (float) y / dimensions.y));
+			pushVertex(x, top, Vector2((float) x / dimensions.x, (float) (y + 1) / dimensions.y));
+			pushVertex(right, top, Vector2((float) (x + 1) / dimensions.x, (float) (y + 1) / dimensions.y));
+		}
+	}
+
+	uint firstVertex = (uint) ((firstRow - minY) * (maxX - minX) * 4);
+	m_renderable->GetMesh()->UpdateVertices<VertexLit>(firstVertex, (uint) scratch->size(), scratch->data());
+}
+
 void TerrainChunk::CleanUp()
 {
+	if (m_renderable == nullptr)
+		return;
+
+	//the renderable reads its mesh on delete, so the mesh goes last
+	Mesh* mesh = m_renderable->GetMesh();
+	RenderScene::GetCurrentScene()->RemoveRenderable(m_renderable);
+	delete m_renderable;
+	m_renderable = nullptr;
+	delete mesh;
 }
@@ -4,10 +4,13 @@
 #include "Engine/Math/Vector3.hpp"
 #include "Engine/Math/Vector2.hpp"
 #include "Engine/Core/Transform.hpp"
+#include "Engine/Renderer/VertexLit.hpp"
+#include <vector>
 
 class Renderable;
 class Terrain;
 class Material;
+class MeshBuilder;
 
 class TerrainChunk
 {
@@ -16,8 +19,13 @@ public:
 	TerrainChunk();
 
 	void SetUp(Terrain* terrain, const IntVector2& chunkIndex, Material* mat);
+	void SetUpFromBuilder(Terrain* terrain, const IntVector2& chunkIndex, const MeshBuilder& builder, Material* mat); // mesh already built (procedural)
 	void CleanUp();
 
+	// Rewrites the quads of rows [firstRow, lastRow] (terrain coordinates, clipped to this chunk)
+	// from the terrain's refresh vertices, as one ranged upload
+	void RefreshQuadRows(int firstRow, int lastRow, std::vector<VertexLit>* scratch);
+
 public:
 	Terrain* m_terrain = nullptr; 
 	IntVector2 m_chunkIndex; 